@@ -0,0 +1,32 @@
+# Copyright 2021 gRPC authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# lz4 is optional: message compression with GRPC_COMPRESS_LZ4 is only
+# available when it is found, and GRPC_HAVE_LZ4 is defined so that
+# src/core/lib/compression can use it. There is no "module" provider since
+# lz4 is not vendored under third_party.
+
+if(gRPC_LZ4_PROVIDER STREQUAL "package")
+  # The lz4 installation can be located by setting LZ4_ROOT_DIR.
+  find_path(LZ4_INCLUDE_DIR NAMES lz4frame.h HINTS ${LZ4_ROOT_DIR}/include)
+  find_library(LZ4_LIBRARY NAMES lz4 HINTS ${LZ4_ROOT_DIR}/lib)
+  if(NOT LZ4_INCLUDE_DIR OR NOT LZ4_LIBRARY)
+    message(FATAL_ERROR "gRPC_LZ4_PROVIDER is \"package\" but lz4 was not found")
+  endif()
+
+  set(_gRPC_LZ4_LIBRARIES ${LZ4_LIBRARY})
+  set(_gRPC_LZ4_INCLUDE_DIR ${LZ4_INCLUDE_DIR})
+  include_directories(${_gRPC_LZ4_INCLUDE_DIR})
+  add_definitions(-DGRPC_HAVE_LZ4)
+endif()
@@ -0,0 +1,32 @@
+# Copyright 2021 gRPC authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# zstd is optional: message compression with GRPC_COMPRESS_ZSTD is only
+# available when it is found, and GRPC_HAVE_ZSTD is defined so that
+# src/core/lib/compression can use it. There is no "module" provider since
+# zstd is not vendored under third_party.
+
+if(gRPC_ZSTD_PROVIDER STREQUAL "package")
+  # The zstd installation can be located by setting ZSTD_ROOT_DIR.
+  find_path(ZSTD_INCLUDE_DIR NAMES zstd.h HINTS ${ZSTD_ROOT_DIR}/include)
+  find_library(ZSTD_LIBRARY NAMES zstd HINTS ${ZSTD_ROOT_DIR}/lib)
+  if(NOT ZSTD_INCLUDE_DIR OR NOT ZSTD_LIBRARY)
+    message(FATAL_ERROR "gRPC_ZSTD_PROVIDER is \"package\" but zstd was not found")
+  endif()
+
+  set(_gRPC_ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+  set(_gRPC_ZSTD_INCLUDE_DIR ${ZSTD_INCLUDE_DIR})
+  include_directories(${_gRPC_ZSTD_INCLUDE_DIR})
+  add_definitions(-DGRPC_HAVE_ZSTD)
+endif()
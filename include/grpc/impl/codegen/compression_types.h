@@ -52,6 +52,37 @@ extern "C" {
  * be ignored). */
 #define GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET \
   "grpc.compression_enabled_algorithms_bitset"
+/** If non-zero, keep one compression context per stream: messages sent on a
+ * stream may refer back to earlier messages of the same stream whenever the
+ * peer has enabled this too, and messages received are decompressed with one
+ * context per stream. Applies to deflate, gzip and zstd. Contexts are pooled
+ * per channel. Defaults to 0. */
+#define GRPC_COMPRESSION_CHANNEL_STREAM_CONTEXT \
+  "grpc.experimental.compression_stream_context"
+/** Pre-trained zstd dictionaries, as written by `zstd --train`: a string of
+ * comma-separated file paths. Peers advertise the ids of theirs, and zstd
+ * messages are compressed against the first dictionary the peer has
+ * advertised, which makes small messages compress well. Clients and servers
+ * must share dictionaries out of band. Has no effect unless zstd is supported
+ * by the build. */
+#define GRPC_COMPRESSION_CHANNEL_ZSTD_DICTIONARIES \
+  "grpc.experimental.compression_zstd_dictionaries"
+/** Messages of at least this many bytes are compressed on executor threads
+ * rather than inline on the thread sending them, which then does not block
+ * for the duration. 0 (the default) compresses every message inline. */
+#define GRPC_COMPRESSION_CHANNEL_OFFLOAD_THRESHOLD \
+  "grpc.experimental.compression_offload_threshold"
+/** Offloaded messages larger than this many bytes are compressed as
+ * independent chunks of this size, in parallel. The peer decompresses them as
+ * any other message. 0 disables chunking; defaults to 1MB. Has no effect on
+ * messages compressed with a zstd dictionary or a per-stream context. */
+#define GRPC_COMPRESSION_CHANNEL_CHUNK_SIZE \
+  "grpc.experimental.compression_chunk_size"
+/** If non-zero, messages are only compressed when they are likely to shrink:
+ * methods whose recent messages did not compress well send their messages
+ * uncompressed, and large messages are sampled first. Defaults to 0. */
+#define GRPC_COMPRESSION_CHANNEL_ADAPTIVE \
+  "grpc.experimental.compression_adaptive"
 /** \} */
 
 /** The various compression algorithms supported by gRPC (not sorted by
@@ -60,6 +91,10 @@ typedef enum {
   GRPC_COMPRESS_NONE = 0,
   GRPC_COMPRESS_DEFLATE,
   GRPC_COMPRESS_GZIP,
+  /** Only available when gRPC is built with zstd support */
+  GRPC_COMPRESS_ZSTD,
+  /** Only available when gRPC is built with lz4 support */
+  GRPC_COMPRESS_LZ4,
   /* TODO(ctiller): snappy */
   GRPC_COMPRESS_ALGORITHMS_COUNT
 } grpc_compression_algorithm;
@@ -195,12 +195,23 @@ typedef struct {
 /** How much memory to use for hpack encoding. Int valued, bytes. */
 #define GRPC_ARG_HTTP2_HPACK_TABLE_SIZE_ENCODER \
   "grpc.http2.hpack_table_size.encoder"
+/** If set, the hpack tables start at the HTTP/2 default size and double, up to
+    this many bytes, whenever most insertions into them evict older entries.
+    Decoder growth is advertised to the peer and charged against the resource
+    quota. Int valued, bytes; 0 (the default) disables adaptive sizing. */
+#define GRPC_ARG_HTTP2_MAX_ADAPTIVE_HPACK_TABLE_SIZE \
+  "grpc.http2.max_adaptive_hpack_table_size"
 /** How big a frame are we willing to receive via HTTP2.
     Min 16384, max 16777215. Larger values give lower CPU usage for large
     messages, but more head of line blocking for small messages. */
 #define GRPC_ARG_HTTP2_MAX_FRAME_SIZE "grpc.http2.max_frame_size"
 /** Should BDP probing be performed? */
 #define GRPC_ARG_HTTP2_BDP_PROBE "grpc.http2.bdp_probe"
+/** Should the transport and stream flow control windows be bounded by the
+    memory available in the resource quota, shrinking as memory pressure rises?
+    Boolean, defaults to false. */
+#define GRPC_ARG_HTTP2_MEMORY_AWARE_FLOW_CONTROL \
+  "grpc.http2.memory_aware_flow_control"
 /** (DEPRECATED) Does not have any effect.
     Earlier, this arg configured the minimum time between successive ping frames
     without receiving any data/header frame, Int valued, milliseconds. This put
@@ -231,6 +242,12 @@ typedef struct {
 /** How much data are we willing to queue up per stream if
     GRPC_WRITE_BUFFER_HINT is set? This is an upper bound */
 #define GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE "grpc.http2.write_buffer_size"
+/** How many bytes of DATA may a stream write before yielding to the other
+    writable streams on the same connection? Writable streams are served round
+    robin in quanta of this size, so a large streaming response cannot starve
+    small responses multiplexed beside it. 0 lets each stream drain everything
+    flow control allows in one turn. Int valued, defaults to 0. */
+#define GRPC_ARG_HTTP2_WRITE_QUANTUM_BYTES "grpc.http2.write_quantum_bytes"
 /** Should we allow receipt of true-binary data on http2 connections?
     Defaults to on (1) */
 #define GRPC_ARG_HTTP2_ENABLE_TRUE_BINARY "grpc.http2.true_binary"
@@ -335,6 +352,10 @@ typedef struct {
   "grpc.experimental.tcp_min_read_chunk_size"
 #define GRPC_ARG_TCP_MAX_READ_CHUNK_SIZE \
   "grpc.experimental.tcp_max_read_chunk_size"
+/* If non-zero, TCP endpoints read into fixed-size buffers recycled through a
+   process-wide pool instead of allocating a slice sized to the expected read
+   each time. By default, it is disabled. */
+#define GRPC_ARG_TCP_READ_BUFFER_POOL "grpc.experimental.tcp_read_buffer_pool"
 /* TCP TX Zerocopy enable state: zero is disabled, non-zero is enabled. By
    default, it is disabled. */
 #define GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED \
@@ -349,6 +370,16 @@ typedef struct {
    issued by the tcp_write(). By default, this is set to 4. */
 #define GRPC_ARG_TCP_TX_ZEROCOPY_MAX_SIMULT_SENDS \
   "grpc.experimental.tcp_tx_zerocopy_max_simultaneous_sends"
+/* TCP RX Zerocopy enable state: zero is disabled, non-zero is enabled. When
+   enabled, large reads map page-aligned payload out of the socket receive
+   queue (TCP_ZEROCOPY_RECEIVE) instead of copying it. By default, it is
+   disabled. */
+#define GRPC_ARG_TCP_RX_ZEROCOPY_ENABLED \
+  "grpc.experimental.tcp_rx_zerocopy_enabled"
+/* TCP RX Zerocopy receive threshold: only try to map reads expected to be at
+   least this many bytes. By default, this is set to 64KB. */
+#define GRPC_ARG_TCP_RX_ZEROCOPY_RECV_BYTES_THRESHOLD \
+  "grpc.experimental.tcp_rx_zerocopy_recv_bytes_threshold"
 /* Timeout in milliseconds to use for calls to the grpclb load balancer.
    If 0 or unset, the balancer calls will have no deadline. */
 #define GRPC_ARG_GRPCLB_CALL_TIMEOUT_MS "grpc.grpclb_call_timeout_ms"
@@ -455,6 +486,11 @@ typedef struct {
  * channel arg. Int valued, milliseconds. Defaults to 10 minutes.*/
 #define GRPC_ARG_SERVER_CONFIG_CHANGE_DRAIN_GRACE_TIME_MS \
   "grpc.experimental.server_config_change_drain_grace_time_ms"
+/** EXPERIMENTAL. Maximum number of call arenas a channel keeps on a free list
+ * for reuse by subsequent calls, avoiding a large malloc/free per RPC. Idle
+ * pooled arenas are charged against the channel's resource quota. Int valued.
+ * Defaults to 0 (no recycling). */
+#define GRPC_ARG_CALL_ARENA_POOL_SIZE "grpc.experimental.call_arena_pool_size"
 /** \} */
 
 /** Result of a grpc call. If the caller satisfies the prerequisites of a
@@ -21,6 +21,7 @@
 
 // IWYU pragma: private
 
+#include <chrono>
 #include <cstring>
 #include <map>
 #include <memory>
@@ -198,6 +199,89 @@ class WriteOptions {
   bool last_message_;
 };
 
+namespace experimental {
+
+/// Groups consecutive writes on a stream into fewer transport writes.
+///
+/// Writes are corked (given the buffer hint, so the transport accumulates
+/// them instead of flushing each one) until a flush is triggered by the number
+/// of corked messages, their total size, the age of the oldest corked message,
+/// or an explicit Flush(). The triggering write is sent uncorked and carries
+/// everything buffered before it onto the wire. It can be used with any
+/// streaming writer (sync, async or callback), e.g.:
+///
+///     WriteCorkingPolicy cork;
+///     for (const auto& update : updates) {
+///       writer->Write(update, cork.NextWriteOptions(update.ByteSizeLong()));
+///     }
+///
+/// There is no timer: the age limit is checked when the next write is issued,
+/// and corked messages otherwise stay buffered until an uncorked write or the
+/// end of the stream. Call Flush() before the last write ahead of an idle
+/// period. Not thread-safe; use one policy per stream.
+class WriteCorkingPolicy {
+ public:
+  struct Options {
+    /// Flush once this many messages are corked (0 for no limit).
+    size_t max_corked_messages = 16;
+    /// Flush once this many bytes are corked (0 for no limit).
+    size_t max_corked_bytes = 64 * 1024;
+    /// Flush the first write issued at least this long after the oldest
+    /// corked one (0 for no limit).
+    std::chrono::microseconds max_cork_delay = std::chrono::milliseconds(1);
+  };
+
+  WriteCorkingPolicy() : WriteCorkingPolicy(Options()) {}
+  explicit WriteCorkingPolicy(const Options& options) : options_(options) {}
+
+  /// Returns \a options adjusted for the next write, of \a message_bytes
+  /// bytes. Passing 0 for \a message_bytes disables the byte limit for this
+  /// write. Last-message writes are left untouched.
+  WriteOptions NextWriteOptions(size_t message_bytes = 0,
+                                WriteOptions options = WriteOptions()) {
+    if (options.is_last_message()) {
+      Reset();
+      return options;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (corked_messages_ == 0) first_corked_ = now;
+    ++corked_messages_;
+    corked_bytes_ += message_bytes;
+    if (flush_requested_ ||
+        (options_.max_corked_messages != 0 &&
+         corked_messages_ >= options_.max_corked_messages) ||
+        (options_.max_corked_bytes != 0 &&
+         corked_bytes_ >= options_.max_corked_bytes) ||
+        (options_.max_cork_delay.count() != 0 &&
+         now - first_corked_ >= options_.max_cork_delay)) {
+      Reset();
+      return options.clear_buffer_hint();
+    }
+    return options.set_buffer_hint();
+  }
+
+  /// Make the next write flush everything corked so far.
+  void Flush() { flush_requested_ = true; }
+
+  /// Number of messages corked since the last flush.
+  size_t corked_messages() const { return corked_messages_; }
+
+ private:
+  void Reset() {
+    corked_messages_ = 0;
+    corked_bytes_ = 0;
+    flush_requested_ = false;
+  }
+
+  const Options options_;
+  size_t corked_messages_ = 0;
+  size_t corked_bytes_ = 0;
+  bool flush_requested_ = false;
+  std::chrono::steady_clock::time_point first_corked_;
+};
+
+}  // namespace experimental
+
 namespace internal {
 
 /// Default argument for CallOpSet. The Unused parameter is unused by
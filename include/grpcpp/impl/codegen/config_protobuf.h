@@ -65,6 +65,12 @@
 #define GRPC_CUSTOM_CODEDINPUTSTREAM ::google::protobuf::io::CodedInputStream
 #endif
 
+#ifndef GRPC_CUSTOM_ARENA
+#include <google/protobuf/arena.h>
+#define GRPC_CUSTOM_ARENA ::google::protobuf::Arena
+#define GRPC_CUSTOM_ARENAOPTIONS ::google::protobuf::ArenaOptions
+#endif
+
 #ifndef GRPC_CUSTOM_JSONUTIL
 #include <google/protobuf/util/json_util.h>
 #include <google/protobuf/util/type_resolver_util.h>
@@ -78,6 +84,9 @@ namespace protobuf {
 typedef GRPC_CUSTOM_MESSAGE Message;
 typedef GRPC_CUSTOM_MESSAGELITE MessageLite;
 
+typedef GRPC_CUSTOM_ARENA Arena;
+typedef GRPC_CUSTOM_ARENAOPTIONS ArenaOptions;
+
 typedef GRPC_CUSTOM_DESCRIPTOR Descriptor;
 typedef GRPC_CUSTOM_DESCRIPTORPOOL DescriptorPool;
 typedef GRPC_CUSTOM_DESCRIPTORDATABASE DescriptorDatabase;
@@ -21,6 +21,7 @@
 
 // IWYU pragma: private, include <grpcpp/support/proto_buffer_reader.h>
 
+#include <climits>
 #include <type_traits>
 
 #include <grpc/impl/codegen/byte_buffer_reader.h>
@@ -39,6 +40,9 @@ namespace grpc {
 
 extern CoreCodegenInterface* g_core_codegen_interface;
 
+template <class ProtoBufferReader, class T>
+Status GenericDeserialize(ByteBuffer* buffer, protobuf::MessageLite* msg);
+
 /// This is a specialization of the protobuf class ZeroCopyInputStream
 /// The principle is to get one chunk of data at a time from the proto layer,
 /// with options to backup (re-see some bytes) or skip (forward past some bytes)
@@ -138,6 +142,29 @@ class ProtoBufferReader : public ::grpc::protobuf::io::ZeroCopyInputStream {
   grpc_slice** mutable_slice_ptr() { return &slice_; }
 
  private:
+  template <class R, class T>
+  friend Status GenericDeserialize(ByteBuffer* buffer,
+                                   protobuf::MessageLite* msg);
+
+  // If \a buffer holds a single uncompressed slice, point \a data and \a size
+  // at its contents and return true. This lets callers parse such messages
+  // in place without going through the ZeroCopyInputStream interface.
+  // Only GenericDeserialize uses it, for the default reader type.
+  static bool PeekSingleSlice(ByteBuffer* buffer, const void** data,
+                              int* size) {
+    grpc_byte_buffer* c_buffer = buffer->c_buffer();
+    if (c_buffer == nullptr || c_buffer->type != GRPC_BB_RAW ||
+        c_buffer->data.raw.compression != GRPC_COMPRESS_NONE ||
+        c_buffer->data.raw.slice_buffer.count != 1) {
+      return false;
+    }
+    const grpc_slice& slice = c_buffer->data.raw.slice_buffer.slices[0];
+    if (GRPC_SLICE_LENGTH(slice) > INT_MAX) return false;
+    *data = GRPC_SLICE_START_PTR(slice);
+    *size = static_cast<int>(GRPC_SLICE_LENGTH(slice));
+    return true;
+  }
+
   int64_t byte_count_;              ///< total bytes read since object creation
   int64_t backup_count_;            ///< how far backed up in the stream we are
   grpc_byte_buffer_reader reader_;  ///< internal object to read \a grpc_slice
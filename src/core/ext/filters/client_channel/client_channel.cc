@@ -532,6 +532,16 @@ class ClientChannel::SubchannelWrapper : public SubchannelInterface {
     return subchannel_->channel_args();
   }
 
+  absl::optional<channelz::SocketNode::TransportLatency> GetTransportLatency()
+      override {
+    auto* subchannel_node = subchannel_->channelz_node();
+    if (subchannel_node == nullptr) return absl::nullopt;
+    RefCountedPtr<channelz::SocketNode> socket =
+        subchannel_node->child_socket();
+    if (socket == nullptr) return absl::nullopt;
+    return socket->transport_latency();
+  }
+
   void ThrottleKeepaliveTime(int new_keepalive_time) {
     subchannel_->ThrottleKeepaliveTime(new_keepalive_time);
   }
@@ -1286,6 +1296,12 @@ void ClientChannel::OnResolverResultChangedLocked(Resolver::Result result) {
     // Check if the ConfigSelector has changed.
     const bool config_selector_changed = !ConfigSelector::Equals(
         saved_config_selector_.get(), config_selector.get());
+    // The dynamic filters depend only on the ConfigSelector and the global
+    // parsed configs, which the resolver may have shared with the previous
+    // ServiceConfig if only method configs changed.
+    const bool dynamic_filters_changed =
+        config_selector_changed || saved_service_config_ == nullptr ||
+        !service_config->SharesGlobalParsedConfigsWith(*saved_service_config_);
     // If either has changed, apply the global parameters now.
     if (service_config_changed || config_selector_changed) {
       // Update service config in control plane.
@@ -1304,7 +1320,7 @@ void ClientChannel::OnResolverResultChangedLocked(Resolver::Result result) {
       // This needs to happen after the LB policy has been updated, since
       // the ConfigSelector may need the LB policy to know about new
       // destinations before it can send RPCs to those destinations.
-      UpdateServiceConfigInDataPlaneLocked();
+      UpdateServiceConfigInDataPlaneLocked(dynamic_filters_changed);
       // TODO(ncteisen): might be worth somehow including a snippet of the
       // config in the trace, at the risk of bloating the trace logs.
       trace_strings.push_back("Service config changed");
@@ -1460,7 +1476,8 @@ void ClientChannel::UpdateServiceConfigInControlPlaneLocked(
   }
 }
 
-void ClientChannel::UpdateServiceConfigInDataPlaneLocked() {
+void ClientChannel::UpdateServiceConfigInDataPlaneLocked(
+    bool rebuild_dynamic_filters) {
   // Grab ref to service config.
   RefCountedPtr<ServiceConfig> service_config = saved_service_config_;
   // Grab ref to config selector.  Use default if resolver didn't supply one.
@@ -1473,31 +1490,44 @@ void ClientChannel::UpdateServiceConfigInDataPlaneLocked() {
     config_selector =
         MakeRefCounted<DefaultConfigSelector>(saved_service_config_);
   }
-  absl::InlinedVector<grpc_arg, 2> args_to_add = {
-      grpc_channel_arg_pointer_create(
-          const_cast<char*>(GRPC_ARG_CLIENT_CHANNEL), this,
-          &kClientChannelArgPointerVtable),
-      grpc_channel_arg_pointer_create(
-          const_cast<char*>(GRPC_ARG_SERVICE_CONFIG_OBJ), service_config.get(),
-          &kServiceConfigObjArgPointerVtable),
-  };
-  grpc_channel_args* new_args = grpc_channel_args_copy_and_add(
-      channel_args_, args_to_add.data(), args_to_add.size());
-  new_args = config_selector->ModifyChannelArgs(new_args);
-  bool enable_retries =
-      grpc_channel_args_find_bool(new_args, GRPC_ARG_ENABLE_RETRIES, true);
-  // Construct dynamic filter stack.
-  std::vector<const grpc_channel_filter*> filters =
-      config_selector->GetFilters();
-  if (enable_retries) {
-    filters.push_back(&kRetryFilterVtable);
-  } else {
-    filters.push_back(&DynamicTerminationFilter::kFilterVtable);
+  // Keep the existing dynamic filters if they do not depend on anything
+  // that has changed.  Their channel args still refer to the ServiceConfig
+  // they were created with, but the global parsed configs that the filters
+  // read from it are the current ones.
+  RefCountedPtr<DynamicFilters> dynamic_filters;
+  if (!rebuild_dynamic_filters) {
+    MutexLock lock(&resolution_mu_);
+    dynamic_filters = dynamic_filters_;
+  }
+  if (dynamic_filters == nullptr) {
+    absl::InlinedVector<grpc_arg, 2> args_to_add = {
+        grpc_channel_arg_pointer_create(
+            const_cast<char*>(GRPC_ARG_CLIENT_CHANNEL), this,
+            &kClientChannelArgPointerVtable),
+        grpc_channel_arg_pointer_create(
+            const_cast<char*>(GRPC_ARG_SERVICE_CONFIG_OBJ),
+            service_config.get(), &kServiceConfigObjArgPointerVtable),
+    };
+    grpc_channel_args* new_args = grpc_channel_args_copy_and_add(
+        channel_args_, args_to_add.data(), args_to_add.size());
+    new_args = config_selector->ModifyChannelArgs(new_args);
+    bool enable_retries =
+        grpc_channel_args_find_bool(new_args, GRPC_ARG_ENABLE_RETRIES, true);
+    // Construct dynamic filter stack.
+    std::vector<const grpc_channel_filter*> filters =
+        config_selector->GetFilters();
+    if (enable_retries) {
+      filters.push_back(&kRetryFilterVtable);
+    } else {
+      filters.push_back(&DynamicTerminationFilter::kFilterVtable);
+    }
+    dynamic_filters = DynamicFilters::Create(new_args, std::move(filters));
+    GPR_ASSERT(dynamic_filters != nullptr);
+    grpc_channel_args_destroy(new_args);
+  } else if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
+    gpr_log(GPR_INFO, "chand=%p: keeping dynamic filters %p", this,
+            dynamic_filters.get());
   }
-  RefCountedPtr<DynamicFilters> dynamic_filters =
-      DynamicFilters::Create(new_args, std::move(filters));
-  GPR_ASSERT(dynamic_filters != nullptr);
-  grpc_channel_args_destroy(new_args);
   // Grab data plane lock to update service config.
   //
   // We defer unreffing the old values (and deallocating memory) until
@@ -124,6 +124,17 @@ class ClientChannel {
     return static_cast<int>(external_watchers_.size());
   }
 
+  // The service config and dynamic filters currently used for new calls.
+  // For tests only.
+  RefCountedPtr<ServiceConfig> TestOnlyServiceConfig() const {
+    MutexLock lock(&resolution_mu_);
+    return service_config_;
+  }
+  RefCountedPtr<DynamicFilters> TestOnlyDynamicFilters() const {
+    MutexLock lock(&resolution_mu_);
+    return dynamic_filters_;
+  }
+
   // Starts and stops a connectivity watch.  The watcher will be initially
   // notified as soon as the state changes from initial_state and then on
   // every subsequent state change until either the watch is stopped or
@@ -238,7 +249,7 @@ class ClientChannel {
       RefCountedPtr<ConfigSelector> config_selector, const char* lb_policy_name)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(*work_serializer_);
 
-  void UpdateServiceConfigInDataPlaneLocked()
+  void UpdateServiceConfigInDataPlaneLocked(bool rebuild_dynamic_filters)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(*work_serializer_);
 
   void CreateResolverLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(*work_serializer_);
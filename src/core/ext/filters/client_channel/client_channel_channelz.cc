@@ -48,6 +48,11 @@ void SubchannelNode::SetChildSocket(RefCountedPtr<SocketNode> socket) {
   child_socket_ = std::move(socket);
 }
 
+RefCountedPtr<SocketNode> SubchannelNode::child_socket() {
+  MutexLock lock(&socket_mu_);
+  return child_socket_;
+}
+
 Json SubchannelNode::RenderJson() {
   // Create and fill the data child.
   grpc_connectivity_state state =
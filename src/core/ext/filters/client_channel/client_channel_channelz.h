@@ -43,6 +43,7 @@ class SubchannelNode : public BaseNode {
   // the subchannel's transport is created and set to nullptr when the
   // subchannel unrefs the transport.
   void SetChildSocket(RefCountedPtr<SocketNode> socket);
+  RefCountedPtr<SocketNode> child_socket();
 
   Json RenderJson() override;
 
@@ -500,9 +500,10 @@ void XdsClusterResolverLb::LogicalDNSDiscoveryMechanism::ResolverResultHandler::
   // child policy.
   XdsEndpointResource update;
   XdsEndpointResource::Priority::Locality locality;
-  locality.name = MakeRefCounted<XdsLocalityName>("", "", "");
+  locality.name = XdsLocalityName::Intern("", "", "");
   locality.lb_weight = 1;
-  locality.endpoints = std::move(*result.addresses);
+  locality.endpoints =
+      std::make_shared<const ServerAddressList>(std::move(*result.addresses));
   XdsEndpointResource::Priority priority;
   priority.localities.emplace(locality.name.get(), std::move(locality));
   update.priorities.emplace_back(std::move(priority));
@@ -762,7 +763,7 @@ ServerAddressList XdsClusterResolverLb::CreateChildPolicyAddressesLocked() {
       const auto& locality = p.second;
       std::vector<std::string> hierarchical_path = {
           priority_child_name, locality_name->AsHumanReadableString()};
-      for (const auto& endpoint : locality.endpoints) {
+      for (const auto& endpoint : *locality.endpoints) {
         const ServerAddressWeightAttribute* weight_attribute = static_cast<
             const ServerAddressWeightAttribute*>(endpoint.GetAttribute(
             ServerAddressWeightAttribute::kServerAddressWeightAttributeKey));
@@ -122,6 +122,9 @@ class AresClientChannelDNSResolver : public Resolver {
   std::unique_ptr<ServerAddressList> balancer_addresses_;
   /// currently resolving service config
   char* service_config_json_ = nullptr;
+  /// last service config reported, whose parsed configs the next one shares
+  /// where they have not changed
+  RefCountedPtr<ServiceConfig> service_config_;
   // has shutdown been initiated
   bool shutdown_initiated_ = false;
 };
@@ -345,8 +348,9 @@ void AresClientChannelDNSResolver::OnResolvedLocked(grpc_error_handle error) {
           !service_config_string.empty()) {
         GRPC_CARES_TRACE_LOG("resolver:%p selected service config choice: %s",
                              this, service_config_string.c_str());
-        service_config = ServiceConfig::Create(
-            channel_args_, service_config_string, &service_config_error);
+        service_config =
+            ServiceConfig::Create(channel_args_, service_config_string,
+                                  service_config_.get(), &service_config_error);
       }
       if (service_config_error != GRPC_ERROR_NONE) {
         result.service_config = absl::UnavailableError(
@@ -354,6 +358,7 @@ void AresClientChannelDNSResolver::OnResolvedLocked(grpc_error_handle error) {
                          grpc_error_std_string(service_config_error)));
         GRPC_ERROR_UNREF(service_config_error);
       } else {
+        if (service_config != nullptr) service_config_ = service_config;
         result.service_config = std::move(service_config);
       }
     }
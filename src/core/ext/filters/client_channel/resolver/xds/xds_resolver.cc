@@ -295,6 +295,7 @@ class XdsResolver : public Resolver {
 
     RefCountedPtr<XdsResolver> resolver_;
     RouteTable route_table_;
+    XdsRouting::CompiledRouteList compiled_route_table_;
     std::map<absl::string_view, RefCountedPtr<ClusterState>> clusters_;
     std::vector<const grpc_channel_filter*> filters_;
   };
@@ -433,6 +434,8 @@ XdsResolver::XdsConfigSelector::XdsConfigSelector(
       }
     }
   }
+  compiled_route_table_ =
+      XdsRouting::CompiledRouteList(RouteListIterator(&route_table_));
   // Populate filter list.
   for (const auto& http_filter :
        resolver_->current_listener_.http_connection_manager.http_filters) {
@@ -589,7 +592,7 @@ absl::optional<uint64_t> HeaderHashHelper(
 
 ConfigSelector::CallConfig XdsResolver::XdsConfigSelector::GetCallConfig(
     GetCallConfigArgs args) {
-  auto route_index = XdsRouting::GetRouteForRequest(
+  auto route_index = compiled_route_table_.GetRouteForRequest(
       RouteListIterator(&route_table_), StringViewFromSlice(*args.path),
       args.initial_metadata);
   if (!route_index.has_value()) {
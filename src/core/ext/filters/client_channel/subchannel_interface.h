@@ -24,6 +24,7 @@
 #include <grpc/impl/codegen/connectivity_state.h>
 #include <grpc/impl/codegen/grpc_types.h>
 
+#include "src/core/lib/channel/channelz.h"
 #include "src/core/lib/gprpp/ref_counted.h"
 #include "src/core/lib/iomgr/pollset_set.h"
 
@@ -89,6 +90,15 @@ class SubchannelInterface : public RefCounted<SubchannelInterface> {
 
   // TODO(roth): Need a better non-grpc-specific abstraction here.
   virtual const grpc_channel_args* channel_args() = 0;
+
+  // Returns the latency (RTT, queueing delay, BDP) last measured by the
+  // subchannel's connected transport, for latency-aware LB policies.
+  // Measurements are published through channelz, so this returns nullopt
+  // when channelz is disabled or nothing has been measured yet.
+  virtual absl::optional<channelz::SocketNode::TransportLatency>
+  GetTransportLatency() {
+    return absl::nullopt;
+  }
 };
 
 // A class that delegates to another subchannel, to be used in cases
@@ -120,6 +130,10 @@ class DelegatingSubchannel : public SubchannelInterface {
   const grpc_channel_args* channel_args() override {
     return wrapped_subchannel_->channel_args();
   }
+  absl::optional<channelz::SocketNode::TransportLatency> GetTransportLatency()
+      override {
+    return wrapped_subchannel_->GetTransportLatency();
+  }
 
  private:
   RefCountedPtr<SubchannelInterface> wrapped_subchannel_;
@@ -25,6 +25,7 @@
 #include "src/core/ext/filters/http/message_compress/message_decompress_filter.h"
 #include "src/core/ext/filters/http/server/http_server_filter.h"
 #include "src/core/lib/channel/channel_stack_builder.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/config/core_configuration.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/transport/transport_impl.h"
@@ -83,5 +84,9 @@ void RegisterHttpFilters(CoreConfiguration::Builder* builder) {
   required(GRPC_CLIENT_SUBCHANNEL, &grpc_http_client_filter);
   required(GRPC_CLIENT_DIRECT_CHANNEL, &grpc_http_client_filter);
   required(GRPC_SERVER_CHANNEL, &grpc_http_server_filter);
+  // Load zstd dictionaries once per channel rather than in the filters, which
+  // are created again for every connection.
+  builder->channel_args_preconditioning()->RegisterStage(
+      ZstdDictionarySet::LoadFromChannelArgs);
 }
 }  // namespace grpc_core
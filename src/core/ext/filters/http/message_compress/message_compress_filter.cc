@@ -21,20 +21,34 @@
 #include "src/core/ext/filters/http/message_compress/message_compress_filter.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "absl/types/optional.h"
 
 #include <grpc/compression.h>
 #include <grpc/slice_buffer.h>
 #include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
+#include <grpc/support/time.h>
 
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/compression/compression_internal.h"
 #include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
@@ -42,6 +56,18 @@
 
 namespace {
 
+constexpr int kDefaultCompressionChunkSize = 1024 * 1024;
+// Smaller chunks would cost more in lost compression than they save in time.
+constexpr int kMinCompressionChunkSize = 64 * 1024;
+
+// Counts the time since start as time spent compressing.
+void AddCompressionTime(gpr_timespec start) {
+  GRPC_STATS_ADD_COUNTER(
+      GRPC_STATS_COUNTER_MESSAGE_COMPRESS_MICROS,
+      gpr_timespec_to_micros(
+          gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start)));
+}
+
 class ChannelData {
  public:
   explicit ChannelData(grpc_channel_element_args* args) {
@@ -65,6 +91,57 @@ class ChannelData {
               name);
       default_compression_algorithm_ = GRPC_COMPRESS_NONE;
     }
+    // Algorithms that keep a context per stream, in both directions. That
+    // needs the decompress filter, which applications can turn off to
+    // decompress messages themselves.
+    if (grpc_channel_args_find_bool(args->channel_args,
+                                    GRPC_COMPRESSION_CHANNEL_STREAM_CONTEXT,
+                                    false) &&
+        grpc_channel_args_find_bool(args->channel_args,
+                                    GRPC_ARG_ENABLE_PER_MESSAGE_DECOMPRESSION,
+                                    true)) {
+      stream_context_enabled_ = true;
+      for (auto algorithm :
+           {GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_ZSTD}) {
+        if (enabled_compression_algorithms_.IsSet(algorithm)) {
+          stream_compression_algorithms_.Set(algorithm);
+        }
+      }
+    }
+    // zstd dictionaries are used for sending whenever the peer has them, but
+    // only advertised to the peer when the decompress filter is there to use
+    // them. They were loaded when the channel args were preconditioned.
+    grpc_core::ZstdDictionarySet* zstd_dictionaries =
+        grpc_core::ZstdDictionarySet::GetFromChannelArgs(args->channel_args);
+    if (zstd_dictionaries != nullptr) {
+      zstd_dictionaries_ = zstd_dictionaries->Ref();
+    }
+    if (zstd_dictionaries_ != nullptr &&
+        grpc_channel_args_find_bool(args->channel_args,
+                                    GRPC_ARG_ENABLE_PER_MESSAGE_DECOMPRESSION,
+                                    true)) {
+      std::vector<uint32_t> ids;
+      for (const auto& dictionary : zstd_dictionaries_->dictionaries()) {
+        ids.push_back(dictionary->id());
+      }
+      accept_zstd_dictionaries_ =
+          grpc_core::Slice::FromCopiedString(absl::StrJoin(ids, ","));
+    }
+    offload_threshold_ = grpc_channel_args_find_integer(
+        args->channel_args, GRPC_COMPRESSION_CHANNEL_OFFLOAD_THRESHOLD,
+        {0, 0, INT_MAX});
+    compression_chunk_size_ = grpc_channel_args_find_integer(
+        args->channel_args, GRPC_COMPRESSION_CHANNEL_CHUNK_SIZE,
+        {kDefaultCompressionChunkSize, 0, INT_MAX});
+    if (compression_chunk_size_ != 0) {
+      compression_chunk_size_ =
+          std::max(compression_chunk_size_, kMinCompressionChunkSize);
+    }
+    if (grpc_channel_args_find_bool(args->channel_args,
+                                    GRPC_COMPRESSION_CHANNEL_ADAPTIVE, false)) {
+      compressibility_ =
+          absl::make_unique<grpc_core::CompressibilityByMethod>();
+    }
     GPR_ASSERT(!args->is_last);
   }
 
@@ -76,18 +153,82 @@ class ChannelData {
     return enabled_compression_algorithms_;
   }
 
+  bool stream_context_enabled() const { return stream_context_enabled_; }
+
+  grpc_core::CompressionAlgorithmSet stream_compression_algorithms() const {
+    return stream_compression_algorithms_;
+  }
+
+  grpc_core::MessageCompressionContextPool<grpc_core::MessageCompressor>*
+  compressor_pool() {
+    return &compressor_pool_;
+  }
+
+  grpc_core::ZstdDictionarySet* zstd_dictionaries() const {
+    return zstd_dictionaries_.get();
+  }
+
+  grpc_core::ZstdDictionary* peer_zstd_dictionary() const {
+    return peer_zstd_dictionary_.load(std::memory_order_relaxed);
+  }
+  void set_peer_zstd_dictionary(grpc_core::ZstdDictionary* dictionary) {
+    peer_zstd_dictionary_.store(dictionary, std::memory_order_relaxed);
+  }
+
+  const grpc_core::Slice& accept_zstd_dictionaries() const {
+    return accept_zstd_dictionaries_;
+  }
+
+  size_t offload_threshold() const { return offload_threshold_; }
+  size_t compression_chunk_size() const { return compression_chunk_size_; }
+
+  grpc_core::CompressibilityByMethod* compressibility() const {
+    return compressibility_.get();
+  }
+
+  // Whether calls need to see the peer's initial metadata. Server calls learn
+  // their method from it.
+  bool intercept_recv_initial_metadata() const {
+    return stream_context_enabled_ || zstd_dictionaries_ != nullptr ||
+           compressibility_ != nullptr;
+  }
+
  private:
   /** The default, channel-level, compression algorithm */
   grpc_compression_algorithm default_compression_algorithm_;
   /** Enabled compression algorithms */
   grpc_core::CompressionAlgorithmSet enabled_compression_algorithms_;
+  /** Whether calls keep a compression context per stream */
+  bool stream_context_enabled_ = false;
+  /** Algorithms we accept compressed with a per-stream context */
+  grpc_core::CompressionAlgorithmSet stream_compression_algorithms_;
+  /** Idle compressors, reused by new calls */
+  grpc_core::MessageCompressionContextPool<grpc_core::MessageCompressor>
+      compressor_pool_;
+  /** zstd dictionaries, the first one preferred; null if none */
+  grpc_core::RefCountedPtr<grpc_core::ZstdDictionarySet> zstd_dictionaries_;
+  /** On clients, the one of our zstd dictionaries the server last announced:
+   * calls use it from their first message, before the server's initial
+   * metadata arrives */
+  std::atomic<grpc_core::ZstdDictionary*> peer_zstd_dictionary_{nullptr};
+  /** Ids of the zstd dictionaries we decompress with, or empty */
+  grpc_core::Slice accept_zstd_dictionaries_;
+  /** Messages this large are compressed on the executor; 0 to never */
+  int offload_threshold_;
+  /** Offloaded messages are compressed in chunks this large; 0 to never */
+  int compression_chunk_size_;
+  /** How well each method's messages compress; null unless adaptive */
+  std::unique_ptr<grpc_core::CompressibilityByMethod> compressibility_;
 };
 
 class CallData {
  public:
   CallData(grpc_call_element* elem, const grpc_call_element_args& args)
-      : call_combiner_(args.call_combiner) {
-    ChannelData* channeld = static_cast<ChannelData*>(elem->channel_data);
+      : call_combiner_(args.call_combiner),
+        channeld_(static_cast<ChannelData*>(elem->channel_data)),
+        is_server_(args.server_transport_data != nullptr),
+        method_(grpc_slice_ref_internal(args.path)) {
+    ChannelData* channeld = channeld_;
     // The call's message compression algorithm is set to channel's default
     // setting. It can be overridden later by initial metadata.
     if (GPR_LIKELY(channeld->enabled_compression_algorithms().IsSet(
@@ -96,12 +237,17 @@ class CallData {
     }
     GRPC_CLOSURE_INIT(&start_send_message_batch_in_call_combiner_,
                       StartSendMessageBatch, elem, grpc_schedule_on_exec_ctx);
+    GRPC_CLOSURE_INIT(&on_recv_initial_metadata_ready_,
+                      OnRecvInitialMetadataReady, this,
+                      grpc_schedule_on_exec_ctx);
   }
 
   ~CallData() {
     if (state_initialized_) {
       grpc_slice_buffer_destroy_internal(&slices_);
+      grpc_slice_buffer_destroy_internal(&offload_output_);
     }
+    channeld_->compressor_pool()->Return(std::move(compressor_));
     GRPC_ERROR_UNREF(cancel_error_);
   }
 
@@ -115,12 +261,32 @@ class CallData {
   void ProcessSendInitialMetadata(grpc_call_element* elem,
                                   grpc_metadata_batch* initial_metadata);
 
+  static void OnRecvInitialMetadataReady(void* arg, grpc_error_handle error);
+  grpc_core::ZstdDictionary* FindZstdDictionary(
+      absl::string_view peer_ids) const;
+  void MaybeUseZstdDictionary();
+  grpc_core::MessageCompressor* SelectCompressor();
+  bool WorthCompressing();
+  bool CompressSendMessage(grpc_slice_buffer* output,
+                           grpc_error_handle* error);
+  void RecordCompression(size_t compressed_size, bool did_compress);
+
   // Methods for processing a send_message batch
   static void StartSendMessageBatch(void* elem_arg, grpc_error_handle unused);
   static void OnSendMessageNextDone(void* elem_arg, grpc_error_handle error);
   grpc_error_handle PullSliceFromSendMessage();
   void ContinueReadingSendMessage(grpc_call_element* elem);
   void FinishSendMessage(grpc_call_element* elem);
+  void SendCompressedMessage(grpc_call_element* elem,
+                             grpc_slice_buffer* compressed, bool did_compress,
+                             grpc_error_handle error);
+  bool ShouldCompressInChunks() const;
+  void OffloadCompression();
+  static void CompressInExecutor(void* calld_arg, grpc_error_handle unused);
+  static void CompressChunksInExecutor(void* calld_arg,
+                                       grpc_error_handle unused);
+  static void OnOffloadedCompressionDone(void* elem_arg,
+                                         grpc_error_handle unused);
   void SendMessageBatchContinue(grpc_call_element* elem);
   static void FailSendMessageBatchInCallCombiner(void* calld_arg,
                                                  grpc_error_handle error);
@@ -128,10 +294,36 @@ class CallData {
   static void SendMessageOnComplete(void* calld_arg, grpc_error_handle error);
 
   grpc_core::CallCombiner* call_combiner_;
+  ChannelData* channeld_;
+  const bool is_server_;
   grpc_compression_algorithm compression_algorithm_ = GRPC_COMPRESS_NONE;
   grpc_error_handle cancel_error_ = GRPC_ERROR_NONE;
   grpc_transport_stream_op_batch* send_message_batch_ = nullptr;
   bool seen_initial_metadata_ = false;
+  /* Fields for learning from the peer's initial metadata whether it
+   * decompresses with a context per stream */
+  grpc_closure on_recv_initial_metadata_ready_;
+  grpc_closure* original_recv_initial_metadata_ready_ = nullptr;
+  grpc_metadata_batch* recv_initial_metadata_ = nullptr;
+  /* Legacy bitmask of the algorithms the peer accepts with stream context;
+   * written when the peer's initial metadata arrives */
+  std::atomic<uint32_t> peer_stream_compression_algorithms_{0};
+  /* Set once a message has been compressed with history: every later
+   * compressed message on the stream must be too */
+  bool keep_history_ = false;
+  std::unique_ptr<grpc_core::MessageCompressor> compressor_;
+  /* On servers, the first of our zstd dictionaries that the client also has;
+   * written when the client's initial metadata arrives */
+  std::atomic<grpc_core::ZstdDictionary*> peer_zstd_dictionary_{nullptr};
+  /* Compresses against a zstd dictionary. Once set, every later message of
+   * the call is compressed with it rather than with compressor_ */
+  std::unique_ptr<grpc_core::MessageCompressor> zstd_dictionary_compressor_;
+  /* The call's method; on servers, set when the client's initial metadata
+   * arrives */
+  grpc_core::Slice method_;
+  /* How well the method's messages compress; set on the first message with
+   * adaptive compression */
+  grpc_core::RefCountedPtr<grpc_core::MethodCompressibility> compressibility_;
   /* Set to true, if the fields below are initialized. */
   bool state_initialized_ = false;
   grpc_closure start_send_message_batch_in_call_combiner_;
@@ -146,6 +338,19 @@ class CallData {
   grpc_closure* original_send_message_on_complete_ = nullptr;
   grpc_closure send_message_on_complete_;
   grpc_closure on_send_message_next_done_;
+  /* Fields for compressing a message on the executor, off the call
+   * combiner */
+  grpc_closure compress_in_executor_;
+  grpc_closure on_offloaded_compression_done_;
+  grpc_slice_buffer offload_output_;
+  bool offload_did_compress_ = false;
+  grpc_error_handle offload_error_ = GRPC_ERROR_NONE;
+  std::unique_ptr<grpc_core::ChunkedMessageCompressor> chunked_compressor_;
+  /* One closure per executor job; each job compresses chunks until none are
+   * left */
+  std::unique_ptr<grpc_closure[]> chunk_jobs_;
+  std::atomic<size_t> next_chunk_{0};
+  std::atomic<size_t> running_chunk_jobs_{0};
 };
 
 // Returns true if we should skip message compression for the current message.
@@ -170,6 +375,12 @@ void CallData::InitializeState(grpc_call_element* elem) {
                     grpc_schedule_on_exec_ctx);
   GRPC_CLOSURE_INIT(&on_send_message_next_done_, OnSendMessageNextDone, elem,
                     grpc_schedule_on_exec_ctx);
+  grpc_slice_buffer_init(&offload_output_);
+  GRPC_CLOSURE_INIT(&compress_in_executor_, CompressInExecutor, this,
+                    grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&on_offloaded_compression_done_,
+                    OnOffloadedCompressionDone, elem,
+                    grpc_schedule_on_exec_ctx);
 }
 
 void CallData::ProcessSendInitialMetadata(
@@ -184,6 +395,8 @@ void CallData::ProcessSendInitialMetadata(
       break;
     case GRPC_COMPRESS_DEFLATE:
     case GRPC_COMPRESS_GZIP:
+    case GRPC_COMPRESS_ZSTD:
+    case GRPC_COMPRESS_LZ4:
       InitializeState(elem);
       initial_metadata->Set(grpc_core::GrpcEncodingMetadata(),
                             compression_algorithm_);
@@ -194,6 +407,170 @@ void CallData::ProcessSendInitialMetadata(
   // Convey supported compression algorithms.
   initial_metadata->Set(grpc_core::GrpcAcceptEncodingMetadata(),
                         channeld->enabled_compression_algorithms());
+  if (channeld->stream_context_enabled()) {
+    initial_metadata->Set(grpc_core::GrpcAcceptStreamEncodingMetadata(),
+                          channeld->stream_compression_algorithms());
+  }
+  if (!channeld->accept_zstd_dictionaries().empty()) {
+    initial_metadata->Set(grpc_core::GrpcAcceptEncodingDictionaryMetadata(),
+                          channeld->accept_zstd_dictionaries().Ref());
+  }
+}
+
+void CallData::OnRecvInitialMetadataReady(void* arg, grpc_error_handle error) {
+  CallData* calld = static_cast<CallData*>(arg);
+  if (error == GRPC_ERROR_NONE) {
+    auto algorithms = calld->recv_initial_metadata_->Take(
+        grpc_core::GrpcAcceptStreamEncodingMetadata());
+    if (algorithms.has_value()) {
+      calld->peer_stream_compression_algorithms_.store(
+          algorithms->ToLegacyBitmask(), std::memory_order_relaxed);
+    }
+    auto dictionaries = calld->recv_initial_metadata_->Take(
+        grpc_core::GrpcAcceptEncodingDictionaryMetadata());
+    grpc_core::ZstdDictionary* dictionary =
+        dictionaries.has_value()
+            ? calld->FindZstdDictionary(dictionaries->as_string_view())
+            : nullptr;
+    if (calld->is_server_) {
+      calld->peer_zstd_dictionary_.store(dictionary,
+                                         std::memory_order_relaxed);
+    } else {
+      calld->channeld_->set_peer_zstd_dictionary(dictionary);
+    }
+    const grpc_core::Slice* path = calld->recv_initial_metadata_->get_pointer(
+        grpc_core::HttpPathMetadata());
+    if (calld->is_server_ && path != nullptr) calld->method_ = path->Ref();
+  }
+  grpc_closure* closure = calld->original_recv_initial_metadata_ready_;
+  calld->original_recv_initial_metadata_ready_ = nullptr;
+  grpc_core::Closure::Run(DEBUG_LOCATION, closure, GRPC_ERROR_REF(error));
+}
+
+// Returns the first of our zstd dictionaries listed in peer_ids, if any.
+grpc_core::ZstdDictionary* CallData::FindZstdDictionary(
+    absl::string_view peer_ids) const {
+  if (channeld_->zstd_dictionaries() == nullptr) return nullptr;
+  std::vector<uint32_t> ids;
+  for (absl::string_view id_str :
+       absl::StrSplit(peer_ids, ',', absl::SkipWhitespace())) {
+    uint32_t id;
+    if (absl::SimpleAtoi(id_str, &id)) ids.push_back(id);
+  }
+  for (const auto& dictionary :
+       channeld_->zstd_dictionaries()->dictionaries()) {
+    if (std::find(ids.begin(), ids.end(), dictionary->id()) != ids.end()) {
+      return dictionary.get();
+    }
+  }
+  return nullptr;
+}
+
+// Switches the call to compressing against a zstd dictionary once the peer
+// has announced one of ours, unless messages already refer back to earlier
+// ones. Each message compressed against the dictionary names it, so the peer
+// needs no other notice. Clients go by the server's latest announcement, which
+// may have come on an earlier call.
+void CallData::MaybeUseZstdDictionary() {
+  if (compression_algorithm_ != GRPC_COMPRESS_ZSTD ||
+      zstd_dictionary_compressor_ != nullptr || keep_history_) {
+    return;
+  }
+  grpc_core::ZstdDictionary* dictionary =
+      is_server_ ? peer_zstd_dictionary_.load(std::memory_order_relaxed)
+                 : channeld_->peer_zstd_dictionary();
+  if (dictionary != nullptr) {
+    zstd_dictionary_compressor_ = dictionary->CreateCompressor();
+  }
+}
+
+// With adaptive compression, returns false if slices_ is predicted not to
+// shrink by enough to be worth compressing.
+bool CallData::WorthCompressing() {
+  grpc_core::CompressibilityByMethod* compressibility =
+      channeld_->compressibility();
+  if (compressibility == nullptr) return true;
+  if (compressibility_ == nullptr) {
+    compressibility_ = compressibility->Get(method_.as_string_view());
+  }
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  grpc_core::MessageCompressor* compressor = SelectCompressor();
+  bool worth = compressibility_->ShouldCompress(
+      compression_algorithm_, &slices_, compressor, keep_history_);
+  AddCompressionTime(start);
+  if (!worth) {
+    GRPC_STATS_INC_MESSAGE_COMPRESS_SKIPPED_MESSAGES();
+  }
+  return worth;
+}
+
+// Returns the compressor for the next message, with keep_history_ set for
+// it, or null if the message is to be compressed on its own with
+// grpc_msg_compress.
+grpc_core::MessageCompressor* CallData::SelectCompressor() {
+  if (zstd_dictionary_compressor_ != nullptr) {
+    return zstd_dictionary_compressor_.get();
+  }
+  const bool stream_context =
+      channeld_->stream_compression_algorithms().IsSet(compression_algorithm_);
+  // zstd contexts are costly to set up, so messages compressed on their own
+  // reuse one too.
+  if (!stream_context && compression_algorithm_ != GRPC_COMPRESS_ZSTD) {
+    return nullptr;
+  }
+  if (compressor_ == nullptr) {
+    compressor_ = channeld_->compressor_pool()->Get(compression_algorithm_);
+    if (compressor_ == nullptr) return nullptr;
+  }
+  // Once the peer has told us it keeps a context per stream, compress with
+  // history so that messages can refer back to earlier ones.
+  keep_history_ =
+      keep_history_ ||
+      (stream_context &&
+       grpc_core::CompressionAlgorithmSet::FromUint32(
+           peer_stream_compression_algorithms_.load(std::memory_order_relaxed))
+           .IsSet(compression_algorithm_));
+  return compressor_.get();
+}
+
+// Compresses slices_ into output. Returns false if the message is to be sent
+// uncompressed, setting *error if the call cannot continue.
+bool CallData::CompressSendMessage(grpc_slice_buffer* output,
+                                   grpc_error_handle* error) {
+  grpc_core::MessageCompressor* compressor = SelectCompressor();
+  if (compressor == nullptr) {
+    return grpc_msg_compress(compression_algorithm_, &slices_, output);
+  }
+  if (compressor->Compress(&slices_, output, keep_history_)) return true;
+  if (keep_history_) {
+    *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "Failed to compress message with stream context");
+  } else {
+    // Keep the contract of grpc_msg_compress: output gets the uncompressed
+    // message.
+    for (size_t i = 0; i < slices_.count; i++) {
+      grpc_slice_buffer_add(output,
+                            grpc_slice_ref_internal(slices_.slices[i]));
+    }
+  }
+  return false;
+}
+
+// Accounts for slices_ having been compressed to compressed_size bytes, or
+// left as is if !did_compress.
+void CallData::RecordCompression(size_t compressed_size, bool did_compress) {
+  const size_t size = slices_.length;
+  if (!did_compress) compressed_size = size;
+  GRPC_STATS_INC_MESSAGE_COMPRESS_MESSAGES();
+  GRPC_STATS_ADD_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_INPUT_BYTES,
+                         size);
+  if (compressed_size < size) {
+    GRPC_STATS_ADD_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SAVED_BYTES,
+                           size - compressed_size);
+  }
+  if (compressibility_ != nullptr) {
+    compressibility_->Record(size, compressed_size);
+  }
 }
 
 void CallData::SendMessageOnComplete(void* calld_arg, grpc_error_handle error) {
@@ -214,17 +591,49 @@ void CallData::SendMessageBatchContinue(grpc_call_element* elem) {
 
 void CallData::FinishSendMessage(grpc_call_element* elem) {
   GPR_DEBUG_ASSERT(compression_algorithm_ != GRPC_COMPRESS_NONE);
+  MaybeUseZstdDictionary();
+  const bool worth_compressing = WorthCompressing();
+  if (worth_compressing && channeld_->offload_threshold() != 0 &&
+      slices_.length >= channeld_->offload_threshold()) {
+    OffloadCompression();
+    return;
+  }
   // Compress the data if appropriate.
   grpc_slice_buffer tmp;
   grpc_slice_buffer_init(&tmp);
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  bool did_compress = false;
+  if (worth_compressing) {
+    gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+    did_compress = CompressSendMessage(&tmp, &error);
+    AddCompressionTime(start);
+    if (error == GRPC_ERROR_NONE) RecordCompression(tmp.length, did_compress);
+  }
+  SendCompressedMessage(elem, &tmp, did_compress, error);
+  grpc_slice_buffer_destroy_internal(&tmp);
+}
+
+// Sends slices_ down, replaced by compressed if did_compress, and leaves
+// compressed empty. Takes ownership of error.
+void CallData::SendCompressedMessage(grpc_call_element* elem,
+                                     grpc_slice_buffer* compressed,
+                                     bool did_compress,
+                                     grpc_error_handle error) {
+  if (error != GRPC_ERROR_NONE) {
+    grpc_slice_buffer_reset_and_unref_internal(compressed);
+    grpc_slice_buffer_reset_and_unref_internal(&slices_);
+    // Closure callback; does not take ownership of error.
+    FailSendMessageBatchInCallCombiner(this, error);
+    GRPC_ERROR_UNREF(error);
+    return;
+  }
   uint32_t send_flags =
       send_message_batch_->payload->send_message.send_message->flags();
-  bool did_compress = grpc_msg_compress(compression_algorithm_, &slices_, &tmp);
   if (did_compress) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_compression_trace)) {
       const char* algo_name;
       const size_t before_size = slices_.length;
-      const size_t after_size = tmp.length;
+      const size_t after_size = compressed->length;
       const float savings_ratio = 1.0f - static_cast<float>(after_size) /
                                              static_cast<float>(before_size);
       GPR_ASSERT(
@@ -234,7 +643,7 @@ void CallData::FinishSendMessage(grpc_call_element* elem) {
               " bytes (%.2f%% savings)",
               algo_name, before_size, after_size, 100 * savings_ratio);
     }
-    grpc_slice_buffer_swap(&slices_, &tmp);
+    grpc_slice_buffer_swap(&slices_, compressed);
     send_flags |= GRPC_WRITE_INTERNAL_COMPRESS;
   } else {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_compression_trace)) {
@@ -247,7 +656,7 @@ void CallData::FinishSendMessage(grpc_call_element* elem) {
               algo_name, slices_.length);
     }
   }
-  grpc_slice_buffer_destroy_internal(&tmp);
+  grpc_slice_buffer_reset_and_unref_internal(compressed);
   // Swap out the original byte stream with our new one and send the
   // batch down.
   new (&replacement_stream_)
@@ -260,6 +669,101 @@ void CallData::FinishSendMessage(grpc_call_element* elem) {
   SendMessageBatchContinue(elem);
 }
 
+bool CallData::ShouldCompressInChunks() const {
+  // Chunks cannot share a dictionary or a context with the stream's other
+  // messages.
+  return channeld_->compression_chunk_size() != 0 &&
+         slices_.length > channeld_->compression_chunk_size() &&
+         grpc_core::ChunkedMessageCompressor::IsSupported(
+             compression_algorithm_) &&
+         zstd_dictionary_compressor_ == nullptr &&
+         !channeld_->stream_compression_algorithms().IsSet(
+             compression_algorithm_);
+}
+
+// Compresses slices_ on the executor, yielding the call combiner to the
+// call's other batches meanwhile.
+void CallData::OffloadCompression() {
+  GRPC_CALL_COMBINER_STOP(call_combiner_,
+                          "compressing send_message on the executor");
+  if (!ShouldCompressInChunks()) {
+    grpc_core::Executor::Run(&compress_in_executor_, GRPC_ERROR_NONE,
+                             grpc_core::ExecutorType::DEFAULT,
+                             grpc_core::ExecutorJobType::LONG);
+    return;
+  }
+  chunked_compressor_ = absl::make_unique<grpc_core::ChunkedMessageCompressor>(
+      compression_algorithm_, &slices_, channeld_->compression_chunk_size());
+  const size_t num_jobs = std::min<size_t>(chunked_compressor_->num_chunks(),
+                                           gpr_cpu_num_cores());
+  chunk_jobs_.reset(new grpc_closure[num_jobs]);
+  next_chunk_.store(0, std::memory_order_relaxed);
+  running_chunk_jobs_.store(num_jobs, std::memory_order_relaxed);
+  for (size_t i = 0; i < num_jobs; i++) {
+    GRPC_CLOSURE_INIT(&chunk_jobs_[i], CompressChunksInExecutor, this,
+                      grpc_schedule_on_exec_ctx);
+    grpc_core::Executor::Run(&chunk_jobs_[i], GRPC_ERROR_NONE,
+                             grpc_core::ExecutorType::DEFAULT,
+                             grpc_core::ExecutorJobType::LONG);
+  }
+}
+
+void CallData::CompressInExecutor(void* calld_arg,
+                                  grpc_error_handle /*unused*/) {
+  CallData* calld = static_cast<CallData*>(calld_arg);
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  calld->offload_did_compress_ = calld->CompressSendMessage(
+      &calld->offload_output_, &calld->offload_error_);
+  AddCompressionTime(start);
+  GRPC_CALL_COMBINER_START(calld->call_combiner_,
+                           &calld->on_offloaded_compression_done_,
+                           GRPC_ERROR_NONE, "send_message compressed");
+}
+
+void CallData::CompressChunksInExecutor(void* calld_arg,
+                                        grpc_error_handle /*unused*/) {
+  CallData* calld = static_cast<CallData*>(calld_arg);
+  grpc_core::ChunkedMessageCompressor* compressor =
+      calld->chunked_compressor_.get();
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  size_t index;
+  while ((index = calld->next_chunk_.fetch_add(
+              1, std::memory_order_relaxed)) < compressor->num_chunks()) {
+    compressor->CompressChunk(index);
+  }
+  AddCompressionTime(start);
+  // The last job to finish joins the chunks.
+  if (calld->running_chunk_jobs_.fetch_sub(1, std::memory_order_acq_rel) ==
+      1) {
+    start = gpr_now(GPR_CLOCK_MONOTONIC);
+    calld->offload_did_compress_ =
+        compressor->Finish(&calld->offload_output_);
+    AddCompressionTime(start);
+    GRPC_CALL_COMBINER_START(calld->call_combiner_,
+                             &calld->on_offloaded_compression_done_,
+                             GRPC_ERROR_NONE, "send_message compressed");
+  }
+}
+
+void CallData::OnOffloadedCompressionDone(void* elem_arg,
+                                          grpc_error_handle /*unused*/) {
+  grpc_call_element* elem = static_cast<grpc_call_element*>(elem_arg);
+  CallData* calld = static_cast<CallData*>(elem->call_data);
+  calld->chunked_compressor_.reset();
+  grpc_error_handle error = calld->offload_error_;
+  calld->offload_error_ = GRPC_ERROR_NONE;
+  // The call may have been cancelled while we were compressing.
+  if (error == GRPC_ERROR_NONE && calld->cancel_error_ != GRPC_ERROR_NONE) {
+    error = GRPC_ERROR_REF(calld->cancel_error_);
+  }
+  if (error == GRPC_ERROR_NONE) {
+    calld->RecordCompression(calld->offload_output_.length,
+                             calld->offload_did_compress_);
+  }
+  calld->SendCompressedMessage(elem, &calld->offload_output_,
+                               calld->offload_did_compress_, error);
+}
+
 void CallData::FailSendMessageBatchInCallCombiner(void* calld_arg,
                                                   grpc_error_handle error) {
   CallData* calld = static_cast<CallData*>(calld_arg);
@@ -369,6 +873,16 @@ void CallData::CompressStartTransportStreamOpBatch(
         batch, GRPC_ERROR_REF(cancel_error_), call_combiner_);
     return;
   }
+  // Handle recv_initial_metadata.
+  if (batch->recv_initial_metadata &&
+      channeld_->intercept_recv_initial_metadata()) {
+    recv_initial_metadata_ =
+        batch->payload->recv_initial_metadata.recv_initial_metadata;
+    original_recv_initial_metadata_ready_ =
+        batch->payload->recv_initial_metadata.recv_initial_metadata_ready;
+    batch->payload->recv_initial_metadata.recv_initial_metadata_ready =
+        &on_recv_initial_metadata_ready_;
+  }
   // Handle send_initial_metadata.
   if (batch->send_initial_metadata) {
     GPR_ASSERT(!seen_initial_metadata_);
@@ -23,6 +23,9 @@
 #include <assert.h>
 #include <string.h>
 
+#include <memory>
+#include <vector>
+
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 
@@ -45,18 +48,40 @@ namespace {
 class ChannelData {
  public:
   explicit ChannelData(const grpc_channel_element_args* args)
-      : max_recv_size_(GetMaxRecvSizeFromChannelArgs(args->channel_args)) {}
+      : max_recv_size_(GetMaxRecvSizeFromChannelArgs(args->channel_args)),
+        stream_context_enabled_(grpc_channel_args_find_bool(
+            args->channel_args, GRPC_COMPRESSION_CHANNEL_STREAM_CONTEXT,
+            false)) {
+    // Loaded when the channel args were preconditioned.
+    ZstdDictionarySet* zstd_dictionaries =
+        ZstdDictionarySet::GetFromChannelArgs(args->channel_args);
+    if (zstd_dictionaries != nullptr) {
+      zstd_dictionaries_ = zstd_dictionaries->Ref();
+    }
+  }
 
   int max_recv_size() const { return max_recv_size_; }
+  bool stream_context_enabled() const { return stream_context_enabled_; }
+  MessageCompressionContextPool<MessageDecompressor>* decompressor_pool() {
+    return &decompressor_pool_;
+  }
+  ZstdDictionary* FindZstdDictionary(uint32_t id) const {
+    if (zstd_dictionaries_ == nullptr) return nullptr;
+    return zstd_dictionaries_->Find(id);
+  }
 
  private:
   int max_recv_size_;
+  bool stream_context_enabled_;
+  MessageCompressionContextPool<MessageDecompressor> decompressor_pool_;
+  RefCountedPtr<ZstdDictionarySet> zstd_dictionaries_;
 };
 
 class CallData {
  public:
-  CallData(const grpc_call_element_args& args, const ChannelData* chand)
+  CallData(const grpc_call_element_args& args, ChannelData* chand)
       : call_combiner_(args.call_combiner),
+        chand_(chand),
         max_recv_message_length_(chand->max_recv_size()) {
     // Initialize state for recv_initial_metadata_ready callback
     GRPC_CLOSURE_INIT(&on_recv_initial_metadata_ready_,
@@ -81,7 +106,10 @@ class CallData {
     }
   }
 
-  ~CallData() { grpc_slice_buffer_destroy_internal(&recv_slices_); }
+  ~CallData() {
+    grpc_slice_buffer_destroy_internal(&recv_slices_);
+    chand_->decompressor_pool()->Return(std::move(decompressor_));
+  }
 
   void DecompressStartTransportStreamOpBatch(
       grpc_call_element* elem, grpc_transport_stream_op_batch* batch);
@@ -96,6 +124,7 @@ class CallData {
   grpc_error_handle PullSliceFromRecvMessage();
   void ContinueReadingRecvMessage();
   void FinishRecvMessage();
+  bool DecompressRecvMessage(grpc_slice_buffer* output);
   void ContinueRecvMessageReadyCallback(grpc_error_handle error);
 
   // Methods for processing a recv_trailing_metadata event
@@ -103,6 +132,7 @@ class CallData {
   static void OnRecvTrailingMetadataReady(void* arg, grpc_error_handle error);
 
   CallCombiner* call_combiner_;
+  ChannelData* chand_;
   // Overall error for the call
   grpc_error_handle error_ = GRPC_ERROR_NONE;
   // Fields for handling recv_initial_metadata_ready callback
@@ -113,6 +143,13 @@ class CallData {
   bool seen_recv_message_ready_ = false;
   int max_recv_message_length_;
   grpc_compression_algorithm algorithm_ = GRPC_COMPRESS_NONE;
+  // Decompresses every message of the stream when the channel keeps a
+  // context per stream.
+  std::unique_ptr<MessageDecompressor> decompressor_;
+  // Decompresses messages compressed against the zstd dictionary with
+  // zstd_dictionary_id_; set on the first such message.
+  uint32_t zstd_dictionary_id_ = 0;
+  std::unique_ptr<MessageDecompressor> zstd_dictionary_decompressor_;
   grpc_closure on_recv_message_ready_;
   grpc_closure* original_recv_message_ready_ = nullptr;
   grpc_closure on_recv_message_next_done_;
@@ -234,11 +271,42 @@ void CallData::OnRecvMessageNextDone(void* arg, grpc_error_handle error) {
   }
 }
 
+bool CallData::DecompressRecvMessage(grpc_slice_buffer* output) {
+  // A zstd message compressed against a dictionary names it in its frame
+  // header. Messages that continue a frame begin with a block header instead,
+  // which cannot match a frame's magic number.
+  const uint32_t zstd_dictionary_id =
+      algorithm_ == GRPC_COMPRESS_ZSTD
+          ? ZstdDictionary::IdOfMessage(&recv_slices_)
+          : 0;
+  if (zstd_dictionary_id != 0) {
+    if (zstd_dictionary_id != zstd_dictionary_id_) {
+      ZstdDictionary* dictionary =
+          chand_->FindZstdDictionary(zstd_dictionary_id);
+      if (dictionary == nullptr) {
+        gpr_log(GPR_ERROR, "unknown zstd dictionary %u", zstd_dictionary_id);
+        return false;
+      }
+      zstd_dictionary_id_ = zstd_dictionary_id;
+      zstd_dictionary_decompressor_ = dictionary->CreateDecompressor();
+    }
+    return zstd_dictionary_decompressor_->Decompress(&recv_slices_, output);
+  }
+  if (chand_->stream_context_enabled()) {
+    if (decompressor_ == nullptr) {
+      decompressor_ = chand_->decompressor_pool()->Get(algorithm_);
+    }
+    if (decompressor_ != nullptr) {
+      return decompressor_->Decompress(&recv_slices_, output);
+    }
+  }
+  return grpc_msg_decompress(algorithm_, &recv_slices_, output) != 0;
+}
+
 void CallData::FinishRecvMessage() {
   grpc_slice_buffer decompressed_slices;
   grpc_slice_buffer_init(&decompressed_slices);
-  if (grpc_msg_decompress(algorithm_, &recv_slices_, &decompressed_slices) ==
-      0) {
+  if (!DecompressRecvMessage(&decompressed_slices)) {
     GPR_DEBUG_ASSERT(error_ == GRPC_ERROR_NONE);
     error_ = GRPC_ERROR_CREATE_FROM_CPP_STRING(
         absl::StrCat("Unexpected error decompressing data for algorithm with "
@@ -24,6 +24,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "absl/strings/str_format.h"
 
 #include <grpc/slice_buffer.h>
@@ -286,6 +289,11 @@ static bool read_channel_args(grpc_chttp2_transport* t,
       if (value >= 0) {
         t->hpack_compressor.SetMaxUsableSize(value);
       }
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_MAX_ADAPTIVE_HPACK_TABLE_SIZE)) {
+      t->max_adaptive_hpack_table_size =
+          static_cast<uint32_t>(grpc_channel_arg_get_integer(
+              &channel_args->args[i], {0, 0, INT32_MAX}));
     } else if (0 == strcmp(channel_args->args[i].key,
                            GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA)) {
       t->ping_policy.max_pings_without_data = grpc_channel_arg_get_integer(
@@ -308,9 +316,18 @@ static bool read_channel_args(grpc_chttp2_transport* t,
                            GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE)) {
       t->write_buffer_size = static_cast<uint32_t>(grpc_channel_arg_get_integer(
           &channel_args->args[i], {0, 0, MAX_WRITE_BUFFER_SIZE}));
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_WRITE_QUANTUM_BYTES)) {
+      t->write_quantum = static_cast<uint32_t>(grpc_channel_arg_get_integer(
+          &channel_args->args[i],
+          {static_cast<int>(t->write_quantum), 0, INT_MAX}));
     } else if (0 ==
                strcmp(channel_args->args[i].key, GRPC_ARG_HTTP2_BDP_PROBE)) {
       enable_bdp = grpc_channel_arg_get_bool(&channel_args->args[i], true);
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_MEMORY_AWARE_FLOW_CONTROL)) {
+      t->memory_aware_flow_control =
+          grpc_channel_arg_get_bool(&channel_args->args[i], false);
     } else if (0 ==
                strcmp(channel_args->args[i].key, GRPC_ARG_KEEPALIVE_TIME_MS)) {
       const int value = grpc_channel_arg_get_integer(
@@ -513,6 +530,13 @@ grpc_chttp2_transport::grpc_chttp2_transport(
   if (g_flow_control_enabled) {
     flow_control.Init<grpc_core::chttp2::TransportFlowControl>(this,
                                                                enable_bdp);
+    // The memory owner drops the watcher when it is reset, in
+    // destroy_transport_locked, before flow_control is destroyed.
+    if (memory_aware_flow_control && memory_owner.is_valid()) {
+      memory_owner.SetPressureWatcher(
+          static_cast<grpc_core::chttp2::TransportFlowControl*>(
+              flow_control.get()));
+    }
   } else {
     flow_control.Init<grpc_core::chttp2::TransportFlowControlDisabled>(this);
     enable_bdp = false;
@@ -548,6 +572,10 @@ static void destroy_transport_locked(void* tp, grpc_error_handle /*error*/) {
       t, grpc_error_set_int(
              GRPC_ERROR_CREATE_FROM_STATIC_STRING("Transport destroyed"),
              GRPC_ERROR_INT_OCCURRED_DURING_WRITE, t->write_state));
+  if (t->hpack_table_reserved_bytes > 0) {
+    t->memory_owner.Release(t->hpack_table_reserved_bytes);
+    t->hpack_table_reserved_bytes = 0;
+  }
   t->memory_owner.Reset();
   // Must be the last line.
   GRPC_CHTTP2_UNREF_TRANSPORT(t, "destroy");
@@ -1508,6 +1536,10 @@ static void perform_stream_op_locked(void* stream_op,
       s->fetching_send_message =
           std::move(op_payload->send_message.send_message);
       s->fetched_send_message_length = 0;
+      s->flow_controlled_message_ends.push_back(
+          s->flow_controlled_bytes_flowed +
+          static_cast<int64_t>(s->flow_controlled_buffer.length) +
+          static_cast<int64_t>(len));
       s->next_message_end_offset =
           s->flow_controlled_bytes_written +
           static_cast<int64_t>(s->flow_controlled_buffer.length) +
@@ -1732,6 +1764,39 @@ static void retry_initiate_ping_locked(void* tp, grpc_error_handle error) {
   GRPC_CHTTP2_UNREF_TRANSPORT(t, "retry_initiate_ping_locked");
 }
 
+// Folds the round trip of the ping just acked into t->latency, and publishes
+// the result to channelz.
+static void update_latency(grpc_chttp2_transport* t) {
+  const gpr_timespec rtt_ts = gpr_cycle_counter_sub(
+      gpr_get_cycle_counter(), t->ping_queue.inflight_sent_at);
+  const int64_t rtt = static_cast<int64_t>(rtt_ts.tv_sec) * GPR_US_PER_SEC +
+                      rtt_ts.tv_nsec / GPR_NS_PER_US;
+  grpc_core::channelz::SocketNode::TransportLatency& latency = t->latency;
+  if (latency.smoothed_rtt_us == 0) {
+    latency.min_rtt_us = rtt;
+    latency.smoothed_rtt_us = rtt;
+    latency.rtt_variance_us = rtt / 2;
+  } else {
+    latency.min_rtt_us = std::min(latency.min_rtt_us, rtt);
+    latency.rtt_variance_us +=
+        (std::abs(latency.smoothed_rtt_us - rtt) - latency.rtt_variance_us) /
+        4;
+    latency.smoothed_rtt_us += (rtt - latency.smoothed_rtt_us) / 8;
+  }
+  grpc_core::BdpEstimator* bdp_est = t->flow_control->bdp_estimator();
+  if (bdp_est != nullptr) latency.bdp_bytes = bdp_est->EstimateBdp();
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_http_trace)) {
+    gpr_log(GPR_INFO,
+            "%s: rtt=%" PRId64 "us srtt=%" PRId64 "us rttvar=%" PRId64
+            "us min_rtt=%" PRId64 "us",
+            t->peer_string.c_str(), rtt, latency.smoothed_rtt_us,
+            latency.rtt_variance_us, latency.min_rtt_us);
+  }
+  if (t->channelz_socket != nullptr) {
+    t->channelz_socket->RecordTransportLatency(latency);
+  }
+}
+
 void grpc_chttp2_ack_ping(grpc_chttp2_transport* t, uint64_t id) {
   grpc_chttp2_ping_queue* pq = &t->ping_queue;
   if (pq->inflight_id != id) {
@@ -1739,6 +1804,9 @@ void grpc_chttp2_ack_ping(grpc_chttp2_transport* t, uint64_t id) {
             t->peer_string.c_str(), id);
     return;
   }
+  if (!grpc_closure_list_empty(pq->lists[GRPC_CHTTP2_PCL_INFLIGHT])) {
+    update_latency(t);
+  }
   grpc_core::ExecCtx::RunList(DEBUG_LOCATION,
                               &pq->lists[GRPC_CHTTP2_PCL_INFLIGHT]);
   if (!grpc_closure_list_empty(pq->lists[GRPC_CHTTP2_PCL_NEXT])) {
@@ -1888,9 +1956,15 @@ void grpc_chttp2_maybe_complete_recv_message(grpc_chttp2_transport* /*t*/,
     if (!s->pending_byte_stream) {
       while (s->unprocessed_incoming_frames_buffer.length > 0 ||
              s->frame_storage.length > 0) {
+        // Gather everything received so far, so that a message split across
+        // several already-received DATA frames can still take the deframer's
+        // whole-message fast path.
         if (s->unprocessed_incoming_frames_buffer.length == 0) {
           grpc_slice_buffer_swap(&s->unprocessed_incoming_frames_buffer,
                                  &s->frame_storage);
+        } else if (s->frame_storage.length > 0) {
+          grpc_slice_buffer_move_into(&s->frame_storage,
+                                      &s->unprocessed_incoming_frames_buffer);
         }
         error = grpc_deframe_unprocessed_incoming_frames(
             &s->data_parser, s, &s->unprocessed_incoming_frames_buffer, nullptr,
@@ -2440,6 +2514,40 @@ static void read_action(void* tp, grpc_error_handle error) {
       GRPC_ERROR_REF(error));
 }
 
+// Adaptive HPACK table sizing: grow whichever dynamic table has been
+// thrashing, up to max_adaptive_hpack_table_size. Growing the decoder's table
+// is advertised via SETTINGS_HEADER_TABLE_SIZE and charged to memory_owner.
+static void maybe_grow_hpack_tables(grpc_chttp2_transport* t) {
+  if (t->max_adaptive_hpack_table_size == 0) return;
+  t->hpack_compressor.MaybeGrowUsableSize(
+      t->max_adaptive_hpack_table_size,
+      t->settings[GRPC_PEER_SETTINGS][GRPC_CHTTP2_SETTINGS_HEADER_TABLE_SIZE]);
+  grpc_core::HPackTable* table = t->hpack_parser.hpack_table();
+  if (table->insertions() <
+      grpc_core::hpack_constants::kChurnSampleInsertions) {
+    return;
+  }
+  const uint32_t current_size =
+      t->settings[GRPC_LOCAL_SETTINGS][GRPC_CHTTP2_SETTINGS_HEADER_TABLE_SIZE];
+  const uint32_t grown_size = grpc_core::hpack_constants::TableSizeForChurn(
+      current_size, t->max_adaptive_hpack_table_size, table->insertions(),
+      table->insertion_evictions());
+  table->ResetChurn();
+  // Wait for the peer to acknowledge the previous growth before judging the
+  // table again, and don't spend memory on compression under memory pressure.
+  static constexpr double kMaxMemoryPressureForGrowth = 0.8;
+  if (grown_size == current_size ||
+      t->settings[GRPC_ACKED_SETTINGS]
+                 [GRPC_CHTTP2_SETTINGS_HEADER_TABLE_SIZE] != current_size ||
+      t->memory_owner.InstantaneousPressure() > kMaxMemoryPressureForGrowth) {
+    return;
+  }
+  t->hpack_table_reserved_bytes += t->memory_owner.Reserve(
+      grpc_core::MemoryRequest(grown_size - current_size));
+  queue_setting_update(t, GRPC_CHTTP2_SETTINGS_HEADER_TABLE_SIZE, grown_size);
+  grpc_chttp2_initiate_write(t, GRPC_CHTTP2_INITIATE_WRITE_SEND_SETTINGS);
+}
+
 static void read_action_locked(void* tp, grpc_error_handle error) {
   GPR_TIMER_SCOPE("reading_action_locked", 0);
 
@@ -2486,6 +2594,7 @@ static void read_action_locked(void* tp, grpc_error_handle error) {
       }
       t->initial_window_update = 0;
     }
+    maybe_grow_hpack_tables(t);
   }
 
   GPR_TIMER_SCOPE("post_reading_action_locked", 0);
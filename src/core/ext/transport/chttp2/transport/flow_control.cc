@@ -296,8 +296,9 @@ void StreamFlowControl::IncomingByteStreamUpdate(size_t max_size_hint,
   uint32_t max_recv_bytes;
 
   /* clamp max recv hint to an allowable size */
-  if (max_size_hint >= kMaxWindowDelta) {
-    max_recv_bytes = kMaxWindowDelta;
+  const uint32_t max_window_delta = tfc_->max_stream_window_delta();
+  if (max_size_hint >= max_window_delta) {
+    max_recv_bytes = max_window_delta;
   } else {
     max_recv_bytes = static_cast<uint32_t>(max_size_hint);
   }
@@ -340,6 +341,31 @@ static double AdjustForMemoryPressure(double memory_pressure, double target) {
   return target;
 }
 
+// Scales this transport's share of the memory quota's recommended allocation
+// size into a window budget. Below kLowMemPressure the full share is available;
+// above it the budget shrinks linearly, reaching kMinMemoryAwareWindow at
+// kMaxMemPressure. Since the shares of all transports on a quota add up to the
+// recommendation, so do their budgets, except for the kMinMemoryAwareWindow
+// floor each transport keeps.
+static int64_t MemoryBudgetForPressure(double memory_pressure, size_t share) {
+  static const double kLowMemPressure = 0.5;
+  static const double kMaxMemPressure = 0.9;
+  double scale = 1.0;
+  if (memory_pressure > kLowMemPressure) {
+    scale = std::max(0.0, (kMaxMemPressure - memory_pressure) /
+                              (kMaxMemPressure - kLowMemPressure));
+  }
+  const double budget =
+      static_cast<double>(share) * scale;
+  return static_cast<int64_t>(Clamp(budget, double(kMinMemoryAwareWindow),
+                                    double(kMaxWindow)));
+}
+
+void TransportFlowControl::OnPressureChanged(double pressure, size_t share) {
+  memory_budget_.store(MemoryBudgetForPressure(pressure, share),
+                       std::memory_order_relaxed);
+}
+
 double TransportFlowControl::TargetLogBdp() {
   return AdjustForMemoryPressure(t_->memory_owner.is_valid()
                                      ? t_->memory_owner.InstantaneousPressure()
@@ -383,6 +409,7 @@ FlowControlAction TransportFlowControl::PeriodicUpdate() {
                    ->ComputeNextTargetInitialWindowSizeFromPeriodicUpdate(
                        target_initial_window_size_ /* current target */);
     }
+    target = std::min(target, static_cast<double>(memory_budget()));
     // Though initial window 'could' drop to 0, we keep the floor at
     // kMinInitialWindowSize
     target_initial_window_size_ = static_cast<int32_t>(Clamp(
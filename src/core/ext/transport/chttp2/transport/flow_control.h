@@ -23,9 +23,13 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include "src/core/ext/transport/chttp2/transport/http2_settings.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
 #include "src/core/lib/transport/bdp_estimator.h"
 #include "src/core/lib/transport/pid_controller.h"
 
@@ -51,6 +55,9 @@ static constexpr const uint32_t kMinInitialWindowSize = 128;
 static constexpr const uint32_t kMaxInitialWindowSize = (1u << 30);
 // The maximum per-stream flow control window delta to advertise.
 static constexpr const uint32_t kMaxWindowDelta = (1u << 20);
+// The smallest window memory aware flow control will shrink to: enough for one
+// minimum sized DATA frame, so that streams keep making progress.
+static constexpr const uint32_t kMinMemoryAwareWindow = 16384;
 
 class TransportFlowControl;
 class StreamFlowControl;
@@ -224,7 +231,11 @@ class TransportFlowControlDisabled final : public TransportFlowControlBase {
 
 // Implementation of flow control that abides to HTTP/2 spec and attempts
 // to be as performant as possible.
-class TransportFlowControl final : public TransportFlowControlBase {
+// With memory aware flow control the transport registers this as the pressure
+// watcher of its memory owner, and windows are bounded by this transport's
+// share of the quota.
+class TransportFlowControl final : public TransportFlowControlBase,
+                                   public BasicMemoryQuota::PressureWatcher {
  public:
   TransportFlowControl(const grpc_chttp2_transport* t, bool enable_bdp_probe);
   ~TransportFlowControl() override {}
@@ -275,9 +286,26 @@ class TransportFlowControl final : public TransportFlowControlBase {
   // logic behind this decision.
   int64_t target_window() const override {
     return static_cast<uint32_t>(
-        std::min(static_cast<int64_t>((1u << 31) - 1),
-                 announced_stream_total_over_incoming_window_ +
-                     target_initial_window_size_));
+        std::min({static_cast<int64_t>((1u << 31) - 1), memory_budget(),
+                  announced_stream_total_over_incoming_window_ +
+                      target_initial_window_size_}));
+  }
+
+  // The most any single stream should have announced beyond what it has
+  // already received. Bounded by kMaxWindowDelta, and further by the memory
+  // quota when memory aware flow control is enabled.
+  uint32_t max_stream_window_delta() const {
+    return static_cast<uint32_t>(
+        std::min(static_cast<int64_t>(kMaxWindowDelta), memory_budget()));
+  }
+
+  // Recomputes the memory budget from this transport's share of the quota.
+  void OnPressureChanged(double pressure, size_t share) override;
+
+  // The most data we are currently willing to have in flight on this
+  // transport: kMaxWindow unless memory aware flow control is enabled.
+  int64_t memory_budget() const {
+    return memory_budget_.load(std::memory_order_relaxed);
   }
 
   const grpc_chttp2_transport* transport() const { return t_; }
@@ -330,6 +358,9 @@ class TransportFlowControl final : public TransportFlowControlBase {
   /** should we probe bdp? */
   const bool enable_bdp_probe_;
 
+  /** written by OnPressureChanged, which may run on any thread */
+  std::atomic<int64_t> memory_budget_{kMaxWindow};
+
   /* bdp estimation */
   BdpEstimator bdp_estimator_;
 
@@ -90,6 +90,65 @@ void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
   stats->data_bytes += write_bytes;
 }
 
+namespace {
+
+// Byte stream handed up the stack when a whole gRPC message was already
+// buffered: unlike its base class it owns its own allocation.
+class BufferedMessageByteStream final
+    : public grpc_core::SliceBufferByteStream {
+ public:
+  using SliceBufferByteStream::SliceBufferByteStream;
+
+  void Orphan() override {
+    SliceBufferByteStream::Orphan();
+    delete this;
+  }
+};
+
+}  // namespace
+
+// Fast path for the common case where the 5-byte gRPC message header sits
+// within the first buffered slice and the whole payload has already arrived:
+// the header is decoded in one go and the payload is spliced out of slices as
+// refcounted sub-slices, so the message is published without a
+// Chttp2IncomingByteStream and its round trips through the combiner.
+// Returns false, leaving everything untouched, if the slow path must be taken.
+static bool deframe_buffered_message(
+    grpc_chttp2_data_parser* p, grpc_chttp2_stream* s,
+    grpc_slice_buffer* slices,
+    grpc_core::OrphanablePtr<grpc_core::ByteStream>* stream_out) {
+  const grpc_slice& first = slices->slices[0];
+  if (GRPC_SLICE_LENGTH(first) < GRPC_HEADER_SIZE_IN_BYTES) return false;
+  const uint8_t* hdr = GRPC_SLICE_START_PTR(first);
+  // Unknown frame types are reported by the slow path.
+  if (hdr[0] > 1) return false;
+  const uint32_t frame_size = (static_cast<uint32_t>(hdr[1]) << 24) |
+                              (static_cast<uint32_t>(hdr[2]) << 16) |
+                              (static_cast<uint32_t>(hdr[3]) << 8) |
+                              static_cast<uint32_t>(hdr[4]);
+  if (slices->length - GRPC_HEADER_SIZE_IN_BYTES < frame_size) return false;
+  p->frame_type = hdr[0];
+  p->is_frame_compressed = hdr[0] == 1;
+  if (GRPC_SLICE_LENGTH(first) == GRPC_HEADER_SIZE_IN_BYTES) {
+    grpc_slice_buffer_remove_first(slices);
+  } else {
+    grpc_slice_buffer_sub_first(slices, GRPC_HEADER_SIZE_IN_BYTES,
+                                GRPC_SLICE_LENGTH(first));
+  }
+  s->stats.incoming.framing_bytes += GRPC_HEADER_SIZE_IN_BYTES;
+  s->stats.incoming.data_bytes += frame_size;
+  if (s->t->channelz_socket != nullptr) {
+    s->t->channelz_socket->RecordMessageReceived();
+  }
+  grpc_slice_buffer payload;
+  grpc_slice_buffer_init(&payload);
+  grpc_slice_buffer_move_first(slices, frame_size, &payload);
+  stream_out->reset(new BufferedMessageByteStream(
+      &payload, p->is_frame_compressed ? GRPC_WRITE_INTERNAL_COMPRESS : 0));
+  grpc_slice_buffer_destroy_internal(&payload);
+  return true;
+}
+
 grpc_error_handle grpc_deframe_unprocessed_incoming_frames(
     grpc_chttp2_data_parser* p, grpc_chttp2_stream* s,
     grpc_slice_buffer* slices, grpc_slice* slice_out,
@@ -113,6 +172,11 @@ grpc_error_handle grpc_deframe_unprocessed_incoming_frames(
       continue;
     }
 
+    if (p->state == GRPC_CHTTP2_DATA_FH_0 && stream_out != nullptr &&
+        deframe_buffered_message(p, s, slices, stream_out)) {
+      return GRPC_ERROR_NONE;
+    }
+
     switch (p->state) {
       case GRPC_CHTTP2_DATA_ERROR:
         p->state = GRPC_CHTTP2_DATA_ERROR;
@@ -35,6 +35,24 @@ static constexpr uint32_t EntriesForBytes(uint32_t bytes) noexcept {
 
 static constexpr uint32_t kInitialTableEntries =
     EntriesForBytes(kInitialTableSize);
+
+// Number of insertions into a dynamic table to observe before deciding whether
+// it is too small for the headers flowing through it.
+static constexpr uint32_t kChurnSampleInsertions = 64;
+
+// Given how many insertions a dynamic table of current_size bytes has seen
+// and how many entries those insertions evicted, returns the size it should
+// grow to: double (capped at max_size) if the table is thrashing, otherwise
+// current_size.
+inline uint32_t TableSizeForChurn(uint32_t current_size, uint32_t max_size,
+                                  uint32_t insertions, uint32_t evictions) {
+  if (insertions < kChurnSampleInsertions || current_size >= max_size) {
+    return current_size;
+  }
+  if (evictions * 2 < insertions) return current_size;
+  if (current_size > max_size / 2) return max_size;
+  return current_size * 2;
+}
 }  // namespace hpack_constants
 }  // namespace grpc_core
 
@@ -264,6 +264,9 @@ class StringKey {
     len_key_.Write(0x00, data + 1);
   }
 
+  size_t key_length() const { return key_.length(); }
+  const uint8_t* key_data() const { return key_.data(); }
+
   Slice key() { return std::move(key_); }
 
  private:
@@ -271,13 +274,29 @@ class StringKey {
   VarintWriter<1> len_key_;
 };
 
+// Keys short enough to share an inlined slice with their length prefix - which
+// covers every well known gRPC key - are copied alongside it, rather than
+// costing the output a slice of their own.
+static constexpr size_t kMaxInlinedKeyLength = GRPC_SLICE_INLINED_SIZE - 2;
+
+void HPackCompressor::Framer::EmitStringKey(uint8_t type, Slice key_slice) {
+  StringKey key(std::move(key_slice));
+  if (key.key_length() <= kMaxInlinedKeyLength) {
+    const size_t prefix_length = key.prefix_length();
+    uint8_t* data = AddTiny(prefix_length + key.key_length());
+    key.WritePrefix(type, data);
+    memcpy(data + prefix_length, key.key_data(), key.key_length());
+    return;
+  }
+  key.WritePrefix(type, AddTiny(key.prefix_length()));
+  Add(key.key());
+}
+
 void HPackCompressor::Framer::EmitLitHdrWithNonBinaryStringKeyIncIdx(
     Slice key_slice, Slice value_slice) {
   GRPC_STATS_INC_HPACK_SEND_LITHDR_INCIDX_V();
   GRPC_STATS_INC_HPACK_SEND_UNCOMPRESSED();
-  StringKey key(std::move(key_slice));
-  key.WritePrefix(0x40, AddTiny(key.prefix_length()));
-  Add(key.key());
+  EmitStringKey(0x40, std::move(key_slice));
   NonBinaryStringValue emit(std::move(value_slice));
   emit.WritePrefix(AddTiny(emit.prefix_length()));
   Add(emit.data());
@@ -287,9 +306,7 @@ void HPackCompressor::Framer::EmitLitHdrWithBinaryStringKeyNotIdx(
     Slice key_slice, Slice value_slice) {
   GRPC_STATS_INC_HPACK_SEND_LITHDR_NOTIDX_V();
   GRPC_STATS_INC_HPACK_SEND_UNCOMPRESSED();
-  StringKey key(std::move(key_slice));
-  key.WritePrefix(0x00, AddTiny(key.prefix_length()));
-  Add(key.key());
+  EmitStringKey(0x00, std::move(key_slice));
   BinaryStringValue emit(std::move(value_slice), use_true_binary_metadata_);
   emit.WritePrefix(AddTiny(emit.prefix_length()));
   Add(emit.data());
@@ -299,9 +316,7 @@ void HPackCompressor::Framer::EmitLitHdrWithBinaryStringKeyIncIdx(
     Slice key_slice, Slice value_slice) {
   GRPC_STATS_INC_HPACK_SEND_LITHDR_INCIDX_V();
   GRPC_STATS_INC_HPACK_SEND_UNCOMPRESSED();
-  StringKey key(std::move(key_slice));
-  key.WritePrefix(0x40, AddTiny(key.prefix_length()));
-  Add(key.key());
+  EmitStringKey(0x40, std::move(key_slice));
   BinaryStringValue emit(std::move(value_slice), use_true_binary_metadata_);
   emit.WritePrefix(AddTiny(emit.prefix_length()));
   Add(emit.data());
@@ -323,20 +338,43 @@ void HPackCompressor::Framer::EmitLitHdrWithNonBinaryStringKeyNotIdx(
     Slice key_slice, Slice value_slice) {
   GRPC_STATS_INC_HPACK_SEND_LITHDR_NOTIDX_V();
   GRPC_STATS_INC_HPACK_SEND_UNCOMPRESSED();
-  StringKey key(std::move(key_slice));
-  key.WritePrefix(0x00, AddTiny(key.prefix_length()));
-  Add(key.key());
+  EmitStringKey(0x00, std::move(key_slice));
   NonBinaryStringValue emit(std::move(value_slice));
   emit.WritePrefix(AddTiny(emit.prefix_length()));
   Add(emit.data());
 }
 
+void HPackCompressor::Framer::EmitLitHdrWithNonBinaryStringKeyIncIdx(
+    uint32_t key_index, Slice value_slice) {
+  GRPC_STATS_INC_HPACK_SEND_LITHDR_INCIDX();
+  GRPC_STATS_INC_HPACK_SEND_UNCOMPRESSED();
+  NonBinaryStringValue emit(std::move(value_slice));
+  VarintWriter<2> key(key_index);
+  uint8_t* data = AddTiny(key.length() + emit.prefix_length());
+  key.Write(0x40, data);
+  emit.WritePrefix(data + key.length());
+  Add(emit.data());
+}
+
+void HPackCompressor::Framer::EmitLitHdrWithNonBinaryStringKeyNotIdx(
+    uint32_t key_index, Slice value_slice) {
+  GRPC_STATS_INC_HPACK_SEND_LITHDR_NOTIDX();
+  GRPC_STATS_INC_HPACK_SEND_UNCOMPRESSED();
+  NonBinaryStringValue emit(std::move(value_slice));
+  VarintWriter<4> key(key_index);
+  uint8_t* data = AddTiny(key.length() + emit.prefix_length());
+  key.Write(0x00, data);
+  emit.WritePrefix(data + key.length());
+  Add(emit.data());
+}
+
 void HPackCompressor::Framer::AdvertiseTableSizeChange() {
   VarintWriter<3> w(compressor_->table_.max_size());
   w.Write(0x20, AddTiny(w.length()));
 }
 
 void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
+                                         uint32_t static_key_index,
                                          const Slice& value, Framer* framer) {
   auto& table = framer->compressor_->table_;
   using It = std::vector<ValueIndex>::iterator;
@@ -344,7 +382,7 @@ void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
   uint32_t transport_length =
       key.length() + value.length() + hpack_constants::kEntryOverhead;
   if (transport_length > HPackEncoderTable::MaxEntrySize()) {
-    framer->EmitLitHdrWithNonBinaryStringKeyNotIdx(Slice::FromStaticString(key),
+    framer->EmitLitHdrWithNonBinaryStringKeyNotIdx(static_key_index,
                                                    value.Ref());
     return;
   }
@@ -358,8 +396,8 @@ void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
       } else {
         // Not current, emit a new literal and update the index.
         it->index = table.AllocateIndex(transport_length);
-        framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(
-            Slice::FromStaticString(key), value.Ref());
+        framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(static_key_index,
+                                                       value.Ref());
       }
       // Bubble this entry up if we can - ensures that the most used values end
       // up towards the start of the array.
@@ -377,8 +415,7 @@ void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
   }
   // No hit, emit a new literal and add it to the index.
   uint32_t index = table.AllocateIndex(transport_length);
-  framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(Slice::FromStaticString(key),
-                                                 value.Ref());
+  framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(static_key_index, value.Ref());
   values_.emplace_back(value.Ref(), index);
 }
 
@@ -391,19 +428,23 @@ void HPackCompressor::Framer::Encode(const Slice& key, const Slice& value) {
 }
 
 void HPackCompressor::Framer::Encode(HttpPathMetadata, const Slice& value) {
-  compressor_->path_index_.EmitTo(HttpPathMetadata::key(), value, this);
+  compressor_->path_index_.EmitTo(HttpPathMetadata::key(),
+                                  HPackStaticNameIndex<HttpPathMetadata>::value,
+                                  value, this);
 }
 
 void HPackCompressor::Framer::Encode(HttpAuthorityMetadata,
                                      const Slice& value) {
-  compressor_->authority_index_.EmitTo(HttpAuthorityMetadata::key(), value,
-                                       this);
+  compressor_->authority_index_.EmitTo(
+      HttpAuthorityMetadata::key(),
+      HPackStaticNameIndex<HttpAuthorityMetadata>::value, value, this);
 }
 
 void HPackCompressor::Framer::Encode(TeMetadata, TeMetadata::ValueType value) {
   GPR_ASSERT(value == TeMetadata::ValueType::kTrailers);
   EncodeAlwaysIndexed(
-      &compressor_->te_index_, "te", Slice::FromStaticString("trailers"),
+      &compressor_->te_index_, "te", HPackStaticNameIndex<TeMetadata>::value,
+      Slice::FromStaticString("trailers"),
       2 /* te */ + 8 /* trailers */ + hpack_constants::kEntryOverhead);
 }
 
@@ -414,6 +455,7 @@ void HPackCompressor::Framer::Encode(ContentTypeMetadata,
     return;
   }
   EncodeAlwaysIndexed(&compressor_->content_type_index_, "content-type",
+                      HPackStaticNameIndex<ContentTypeMetadata>::value,
                       Slice::FromStaticString("application/grpc"),
                       12 /* content-type */ + 16 /* application/grpc */ +
                           hpack_constants::kEntryOverhead);
@@ -473,8 +515,9 @@ void HPackCompressor::Framer::Encode(HttpStatusMetadata, uint32_t status) {
   if (GPR_LIKELY(index != 0)) {
     EmitIndexed(index);
   } else {
-    EmitLitHdrWithNonBinaryStringKeyIncIdx(Slice::FromStaticString(":status"),
-                                           Slice::FromInt64(status));
+    EmitLitHdrWithNonBinaryStringKeyIncIdx(
+        HPackStaticNameIndex<HttpStatusMetadata>::value,
+        Slice::FromInt64(status));
   }
 }
 
@@ -488,8 +531,9 @@ void HPackCompressor::Framer::Encode(HttpMethodMetadata,
       EmitIndexed(3);  // :method: POST
       break;
     case HttpMethodMetadata::ValueType::kPut:
-      EmitLitHdrWithNonBinaryStringKeyNotIdx(Slice::FromStaticString(":method"),
-                                             Slice::FromStaticString("PUT"));
+      EmitLitHdrWithNonBinaryStringKeyNotIdx(
+          HPackStaticNameIndex<HttpMethodMetadata>::value,
+          Slice::FromStaticString("PUT"));
       break;
     case HttpMethodMetadata::ValueType::kInvalid:
       GPR_ASSERT(false);
@@ -499,10 +543,14 @@ void HPackCompressor::Framer::Encode(HttpMethodMetadata,
 
 void HPackCompressor::Framer::EncodeAlwaysIndexed(uint32_t* index,
                                                   absl::string_view key,
+                                                  uint32_t static_key_index,
                                                   Slice value,
                                                   uint32_t transport_length) {
   if (compressor_->table_.ConvertableToDynamicIndex(*index)) {
     EmitIndexed(compressor_->table_.DynamicIndex(*index));
+  } else if (static_key_index != 0) {
+    *index = compressor_->table_.AllocateIndex(transport_length);
+    EmitLitHdrWithNonBinaryStringKeyIncIdx(static_key_index, std::move(value));
   } else {
     *index = compressor_->table_.AllocateIndex(transport_length);
     EmitLitHdrWithNonBinaryStringKeyIncIdx(Slice::FromStaticString(key),
@@ -558,7 +606,7 @@ void HPackCompressor::Framer::Encode(GrpcTimeoutMetadata,
 void HPackCompressor::Framer::Encode(UserAgentMetadata, const Slice& slice) {
   if (slice.length() > HPackEncoderTable::MaxEntrySize()) {
     EmitLitHdrWithNonBinaryStringKeyNotIdx(
-        Slice::FromStaticString(UserAgentMetadata::key()), slice.Ref());
+        HPackStaticNameIndex<UserAgentMetadata>::value, slice.Ref());
     return;
   }
   if (!slice.is_equivalent(compressor_->user_agent_)) {
@@ -566,7 +614,8 @@ void HPackCompressor::Framer::Encode(UserAgentMetadata, const Slice& slice) {
     compressor_->user_agent_index_ = 0;
   }
   EncodeAlwaysIndexed(
-      &compressor_->user_agent_index_, "user-agent", slice.Ref(),
+      &compressor_->user_agent_index_, "user-agent",
+      HPackStaticNameIndex<UserAgentMetadata>::value, slice.Ref(),
       10 /* user-agent */ + slice.size() + hpack_constants::kEntryOverhead);
 }
 
@@ -643,6 +692,18 @@ void HPackCompressor::SetMaxUsableSize(uint32_t max_table_size) {
   SetMaxTableSize(std::min(table_.max_size(), max_table_size));
 }
 
+void HPackCompressor::MaybeGrowUsableSize(uint32_t max_usable_size,
+                                          uint32_t peer_table_size) {
+  if (table_.insertions() < hpack_constants::kChurnSampleInsertions) return;
+  const uint32_t grown_size = hpack_constants::TableSizeForChurn(
+      max_usable_size_, std::min(max_usable_size, peer_table_size),
+      table_.insertions(), table_.insertion_evictions());
+  table_.ResetChurn();
+  if (grown_size == max_usable_size_) return;
+  max_usable_size_ = grown_size;
+  SetMaxTableSize(peer_table_size);
+}
+
 void HPackCompressor::SetMaxTableSize(uint32_t max_table_size) {
   if (table_.SetMaxSize(std::min(max_usable_size_, max_table_size))) {
     advertise_table_size_change_ = true;
@@ -22,6 +22,7 @@
 #include <grpc/support/port_platform.h>
 
 #include <cstdint>
+#include <type_traits>
 
 #include <grpc/slice.h>
 #include <grpc/slice_buffer.h>
@@ -35,6 +36,33 @@ extern grpc_core::TraceFlag grpc_http_trace;
 
 namespace grpc_core {
 
+// Index of the HPACK static table entry (RFC 7541 Appendix A) whose name is
+// Trait::key(), or 0 if the key does not appear there. Literal headers for
+// these traits refer to the name by index rather than spelling it out.
+template <typename Trait>
+struct HPackStaticNameIndex : std::integral_constant<uint32_t, 0> {};
+template <>
+struct HPackStaticNameIndex<HttpAuthorityMetadata>
+    : std::integral_constant<uint32_t, 1> {};
+template <>
+struct HPackStaticNameIndex<HttpMethodMetadata>
+    : std::integral_constant<uint32_t, 2> {};
+template <>
+struct HPackStaticNameIndex<HttpPathMetadata>
+    : std::integral_constant<uint32_t, 4> {};
+template <>
+struct HPackStaticNameIndex<HttpStatusMetadata>
+    : std::integral_constant<uint32_t, 8> {};
+template <>
+struct HPackStaticNameIndex<ContentTypeMetadata>
+    : std::integral_constant<uint32_t, 31> {};
+template <>
+struct HPackStaticNameIndex<HostMetadata>
+    : std::integral_constant<uint32_t, 38> {};
+template <>
+struct HPackStaticNameIndex<UserAgentMetadata>
+    : std::integral_constant<uint32_t, 58> {};
+
 class HPackCompressor {
   class SliceIndex;
 
@@ -47,10 +75,14 @@ class HPackCompressor {
 
   void SetMaxTableSize(uint32_t max_table_size);
   void SetMaxUsableSize(uint32_t max_table_size);
+  // If the table has been thrashing, grow the usable size towards the smaller
+  // of max_usable_size and the table size the peer advertised.
+  void MaybeGrowUsableSize(uint32_t max_usable_size, uint32_t peer_table_size);
 
   uint32_t test_only_table_size() const {
     return table_.test_only_table_size();
   }
+  uint32_t test_only_table_max_size() const { return table_.max_size(); }
 
   struct EncodeHeaderOptions {
     uint32_t stream_id;
@@ -99,7 +131,10 @@ class HPackCompressor {
     template <typename Which>
     void Encode(Which, const typename Which::ValueType& value) {
       const Slice& slice = MetadataValueAsSlice<Which>(value);
-      if (absl::EndsWith(Which::key(), "-bin")) {
+      if (HPackStaticNameIndex<Which>::value != 0) {
+        EmitLitHdrWithNonBinaryStringKeyNotIdx(
+            HPackStaticNameIndex<Which>::value, slice.Ref());
+      } else if (absl::EndsWith(Which::key(), "-bin")) {
         EmitLitHdrWithBinaryStringKeyNotIdx(
             Slice::FromStaticString(Which::key()), slice.Ref());
       } else {
@@ -135,9 +170,15 @@ class HPackCompressor {
                                              Slice value_slice);
     void EmitLitHdrWithNonBinaryStringKeyNotIdx(Slice key_slice,
                                                 Slice value_slice);
+    void EmitLitHdrWithNonBinaryStringKeyIncIdx(uint32_t key_index,
+                                                Slice value_slice);
+    void EmitLitHdrWithNonBinaryStringKeyNotIdx(uint32_t key_index,
+                                                Slice value_slice);
+    void EmitStringKey(uint8_t type, Slice key_slice);
 
     void EncodeAlwaysIndexed(uint32_t* index, absl::string_view key,
-                             Slice value, uint32_t transport_length);
+                             uint32_t static_key_index, Slice value,
+                             uint32_t transport_length);
     void EncodeIndexedKeyWithBinaryValue(uint32_t* index, absl::string_view key,
                                          Slice value);
 
@@ -172,7 +213,8 @@ class HPackCompressor {
 
   class SliceIndex {
    public:
-    void EmitTo(absl::string_view key, const Slice& value, Framer* framer);
+    void EmitTo(absl::string_view key, uint32_t static_key_index,
+                const Slice& value, Framer* framer);
 
    private:
     struct ValueIndex {
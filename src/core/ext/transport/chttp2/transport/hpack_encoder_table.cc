@@ -34,8 +34,10 @@ uint32_t HPackEncoderTable::AllocateIndex(size_t element_size) {
   // Reserve space for this element in the remote table: if this overflows
   // the current table, drop elements until it fits, matching the decompressor
   // algorithm.
+  insertions_++;
   while (table_size_ + element_size > max_table_size_) {
     EvictOne();
+    insertion_evictions_++;
   }
   GPR_ASSERT(table_elems_ < elem_size_.size());
   elem_size_[new_index % elem_size_.size()] =
@@ -42,6 +42,15 @@ class HPackEncoderTable {
   // Get the current table size
   uint32_t test_only_table_size() const { return table_size_; }
 
+  // Entries allocated, and entries evicted to make room for them, since the
+  // last ResetChurn(). Used to decide whether a larger table would help.
+  uint32_t insertions() const { return insertions_; }
+  uint32_t insertion_evictions() const { return insertion_evictions_; }
+  void ResetChurn() {
+    insertions_ = 0;
+    insertion_evictions_ = 0;
+  }
+
   // Convert an element index into a dynamic index
   uint32_t DynamicIndex(uint32_t index) const {
     return 1 + hpack_constants::kLastStaticEntry + tail_remote_index_ +
@@ -61,6 +70,9 @@ class HPackEncoderTable {
   uint32_t max_table_size_ = hpack_constants::kInitialTableSize;
   uint32_t table_elems_ = 0;
   uint32_t table_size_ = 0;
+  // Churn counters, see insertions().
+  uint32_t insertions_ = 0;
+  uint32_t insertion_evictions_ = 0;
   // The size of each element in the HPACK table.
   absl::InlinedVector<uint16_t, hpack_constants::kInitialTableEntries>
       elem_size_;
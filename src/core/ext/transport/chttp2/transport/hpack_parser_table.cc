@@ -129,9 +129,11 @@ grpc_error_handle HPackTable::Add(Memento md) {
   }
 
   // evict entries to ensure no overflow
+  ++insertions_;
   while (md.transport_size() >
          static_cast<size_t>(current_table_bytes_) - mem_used_) {
     EvictOne();
+    ++insertion_evictions_;
   }
 
   // copy the finalized entry in
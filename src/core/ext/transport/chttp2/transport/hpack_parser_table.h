@@ -65,6 +65,15 @@ class HPackTable {
   // Current entry count in the table.
   uint32_t num_entries() const { return num_entries_; }
 
+  // Entries added, and entries evicted to make room for them, since the last
+  // ResetChurn(). Used to decide whether to advertise a larger table.
+  uint32_t insertions() const { return insertions_; }
+  uint32_t insertion_evictions() const { return insertion_evictions_; }
+  void ResetChurn() {
+    insertions_ = 0;
+    insertion_evictions_ = 0;
+  }
+
  private:
   struct StaticMementos {
     StaticMementos();
@@ -104,6 +113,9 @@ class HPackTable {
   // Maximum number of entries we could possibly fit in the table, given defined
   // overheads.
   uint32_t max_entries_ = hpack_constants::kInitialTableEntries;
+  // Churn counters, see insertions().
+  uint32_t insertions_ = 0;
+  uint32_t insertion_evictions_ = 0;
   // HPack table entries
   EntriesVec entries_{hpack_constants::kInitialTableEntries};
   // Mementos for static data
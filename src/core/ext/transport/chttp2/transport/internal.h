@@ -24,6 +24,8 @@
 #include <assert.h>
 #include <stdbool.h>
 
+#include "absl/container/inlined_vector.h"
+
 #include "src/core/ext/transport/chttp2/transport/flow_control.h"
 #include "src/core/ext/transport/chttp2/transport/frame.h"
 #include "src/core/ext/transport/chttp2/transport/frame_data.h"
@@ -36,6 +38,7 @@
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
 #include "src/core/ext/transport/chttp2/transport/stream_map.h"
 #include "src/core/lib/channel/channelz.h"
+#include "src/core/lib/gpr/time_precise.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/iomgr/combiner.h"
 #include "src/core/lib/iomgr/endpoint.h"
@@ -114,6 +117,8 @@ const char* grpc_chttp2_initiate_write_reason_string(
 struct grpc_chttp2_ping_queue {
   grpc_closure_list lists[GRPC_CHTTP2_PCL_COUNT] = {};
   uint64_t inflight_id = 0;
+  /* when the inflight ping was put on the wire */
+  gpr_cycle_counter inflight_sent_at;
 };
 struct grpc_chttp2_repeated_ping_policy {
   int max_pings_without_data;
@@ -355,6 +360,19 @@ struct grpc_chttp2_transport {
    */
   uint32_t write_buffer_size = grpc_core::chttp2::kDefaultWindow;
 
+  /** should flow control windows be sized from the memory quota? */
+  bool memory_aware_flow_control = false;
+
+  /** how many bytes of DATA may a stream write per turn of the write
+      scheduler? zero places no limit on a turn */
+  uint32_t write_quantum = 0;
+
+  /** largest HPACK table either side may grow to when its table thrashes;
+      zero disables adaptive HPACK table sizing */
+  uint32_t max_adaptive_hpack_table_size = 0;
+  /** bytes reserved from memory_owner for growing the decoder's table */
+  size_t hpack_table_reserved_bytes = 0;
+
   /** Set to a grpc_error object if a goaway frame is received. By default, set
    * to GRPC_ERROR_NONE */
   grpc_error_handle goaway_error = GRPC_ERROR_NONE;
@@ -488,6 +506,10 @@ struct grpc_chttp2_transport {
   grpc_chttp2_keepalive_state keepalive_state;
   grpc_core::ContextList* cl = nullptr;
   grpc_core::RefCountedPtr<grpc_core::channelz::SocketNode> channelz_socket;
+  /** RTT measured from acked pings (smoothed as RFC 6298 does for TCP), the
+      smoothed time streams wait on the writable list, and the BDP estimate;
+      published to channelz_socket whenever a ping is acked */
+  grpc_core::channelz::SocketNode::TransportLatency latency;
   uint32_t num_messages_in_next_write = 0;
   /** The number of pending induced frames (SETTINGS_ACK, PINGS_ACK and
    * RST_STREAM) in the outgoing buffer (t->qbuf). If this number goes beyond
@@ -633,12 +655,18 @@ struct grpc_chttp2_stream {
       flow_control;
 
   grpc_slice_buffer flow_controlled_buffer;
+  /** Where each message in flow_controlled_buffer ends, counted in
+      flow_controlled_bytes_flowed terms */
+  absl::InlinedVector<int64_t, 1> flow_controlled_message_ends;
 
   grpc_chttp2_write_cb* on_flow_controlled_cbs = nullptr;
   grpc_chttp2_write_cb* on_write_finished_cbs = nullptr;
   grpc_chttp2_write_cb* finish_after_write = nullptr;
   size_t sending_bytes = 0;
 
+  /** When this stream was last added to the writable list */
+  gpr_cycle_counter writable_since;
+
   /** Whether the bytes needs to be traced using Fathom */
   bool traced = false;
   /** Byte counter for number of bytes written */
@@ -141,12 +141,22 @@ static bool stream_list_add(grpc_chttp2_transport* t, grpc_chttp2_stream* s,
 bool grpc_chttp2_list_add_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream* s) {
   GPR_ASSERT(s->id != 0);
-  return stream_list_add(t, s, GRPC_CHTTP2_LIST_WRITABLE);
+  if (!stream_list_add(t, s, GRPC_CHTTP2_LIST_WRITABLE)) return false;
+  s->writable_since = gpr_get_cycle_counter();
+  return true;
 }
 
 bool grpc_chttp2_list_pop_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream** s) {
-  return stream_list_pop(t, s, GRPC_CHTTP2_LIST_WRITABLE);
+  if (!stream_list_pop(t, s, GRPC_CHTTP2_LIST_WRITABLE)) return false;
+  const gpr_timespec delay =
+      gpr_cycle_counter_sub(gpr_get_cycle_counter(), (*s)->writable_since);
+  const int64_t delay_ns =
+      static_cast<int64_t>(delay.tv_sec) * GPR_NS_PER_SEC + delay.tv_nsec;
+  (*s)->stats.outgoing.queueing_delay_ns += delay_ns;
+  int64_t& smoothed_us = t->latency.queueing_delay_us;
+  smoothed_us += (delay_ns / GPR_NS_PER_US - smoothed_us) / 8;
+  return true;
 }
 
 bool grpc_chttp2_list_remove_writable_stream(grpc_chttp2_transport* t,
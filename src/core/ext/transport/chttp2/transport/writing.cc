@@ -120,6 +120,7 @@ static void maybe_initiate_ping(grpc_chttp2_transport* t) {
                          &pq->lists[GRPC_CHTTP2_PCL_INFLIGHT]);
   grpc_slice_buffer_add(&t->outbuf,
                         grpc_chttp2_ping_create(false, pq->inflight_id));
+  pq->inflight_sent_at = gpr_get_cycle_counter();
   GRPC_STATS_INC_HTTP2_PINGS_SENT();
   t->ping_state.last_ping_sent_time = now;
   if (GRPC_TRACE_FLAG_ENABLED(grpc_http_trace) ||
@@ -357,9 +358,11 @@ class DataSendContext {
 
   bool AnyOutgoing() const { return max_outgoing() > 0; }
 
-  void FlushBytes() {
+  // Frames up to max_bytes of the stream's data; returns the bytes framed.
+  uint32_t FlushBytes(uint32_t max_bytes) {
     uint32_t send_bytes = static_cast<uint32_t>(
-        std::min(size_t(max_outgoing()), s_->flow_controlled_buffer.length));
+        std::min(size_t(std::min(max_outgoing(), max_bytes)),
+                 s_->flow_controlled_buffer.length));
     is_last_frame_ = send_bytes == s_->flow_controlled_buffer.length &&
                      s_->fetching_send_message == nullptr &&
                      s_->send_trailing_metadata != nullptr &&
@@ -368,6 +371,7 @@ class DataSendContext {
                             is_last_frame_, &s_->stats.outgoing, &t_->outbuf);
     s_->flow_control->SentData(send_bytes);
     s_->sending_bytes += send_bytes;
+    return send_bytes;
   }
 
   bool is_last_frame() const { return is_last_frame_; }
@@ -476,9 +480,15 @@ class StreamWriteContext {
       return;  // early out: nothing to do
     }
 
+    // Streams take turns writing at most write_quantum bytes each: a stream
+    // with data left over goes to the back of the writable list below, so
+    // every other writable stream is served before its next turn. Data frames
+    // can be split anywhere, so no deficit needs carrying between turns.
+    uint32_t turn_bytes =
+        t_->write_quantum == 0 ? UINT32_MAX : t_->write_quantum;
     while (s_->flow_controlled_buffer.length > 0 &&
-           data_send_context.max_outgoing() > 0) {
-      data_send_context.FlushBytes();
+           data_send_context.max_outgoing() > 0 && turn_bytes > 0) {
+      turn_bytes -= data_send_context.FlushBytes(turn_bytes);
     }
     grpc_chttp2_reset_ping_clock(t_);
     if (data_send_context.is_last_frame()) {
@@ -490,7 +500,16 @@ class StreamWriteContext {
       GRPC_CHTTP2_STREAM_REF(s_, "chttp2_writing:fork");
       grpc_chttp2_list_add_writable_stream(t_, s_);
     }
-    write_context_->IncMessageWrites();
+    // Count the messages this turn finished framing: a message framed over
+    // several turns counts once.
+    auto& message_ends = s_->flow_controlled_message_ends;
+    auto framed = message_ends.begin();
+    while (framed != message_ends.end() &&
+           *framed <= s_->flow_controlled_bytes_flowed) {
+      write_context_->IncMessageWrites();
+      ++framed;
+    }
+    message_ends.erase(message_ends.begin(), framed);
   }
 
   void FlushTrailingMetadata() {
@@ -259,6 +259,23 @@ void MaybeLogDiscoveryRequest(
   }
 }
 
+// Populates the error_detail of a NACK.  Takes ownership of \a error.
+// \a error_string_storage must outlive the request.
+void PopulateErrorDetail(grpc_error_handle error,
+                         std::string* error_string_storage,
+                         google_rpc_Status* error_detail) {
+  // Hard-code INVALID_ARGUMENT as the status code.
+  // TODO(roth): If at some point we decide we care about this value,
+  // we could attach a status code to the individual errors where we
+  // generate them in the parsing code, and then use that here.
+  google_rpc_Status_set_code(error_detail, GRPC_STATUS_INVALID_ARGUMENT);
+  // Error description comes from the error that was passed in.
+  *error_string_storage = grpc_error_std_string(error);
+  upb_strview error_description = StdStringToUpbString(*error_string_storage);
+  google_rpc_Status_set_message(error_detail, error_description);
+  GRPC_ERROR_UNREF(error);
+}
+
 grpc_slice SerializeDiscoveryRequest(
     const XdsEncodingContext& context,
     envoy_service_discovery_v3_DiscoveryRequest* request) {
@@ -303,19 +320,10 @@ grpc_slice XdsApi::CreateAdsRequest(
   // Set error_detail if it's a NACK.
   std::string error_string_storage;
   if (error != GRPC_ERROR_NONE) {
-    google_rpc_Status* error_detail =
+    PopulateErrorDetail(
+        error, &error_string_storage,
         envoy_service_discovery_v3_DiscoveryRequest_mutable_error_detail(
-            request, arena.ptr());
-    // Hard-code INVALID_ARGUMENT as the status code.
-    // TODO(roth): If at some point we decide we care about this value,
-    // we could attach a status code to the individual errors where we
-    // generate them in the parsing code, and then use that here.
-    google_rpc_Status_set_code(error_detail, GRPC_STATUS_INVALID_ARGUMENT);
-    // Error description comes from the error that was passed in.
-    error_string_storage = grpc_error_std_string(error);
-    upb_strview error_description = StdStringToUpbString(error_string_storage);
-    google_rpc_Status_set_message(error_detail, error_description);
-    GRPC_ERROR_UNREF(error);
+            request, arena.ptr()));
   }
   // Populate node.
   if (populate_node) {
@@ -404,6 +412,174 @@ absl::Status XdsApi::ParseAdsResponse(const XdsBootstrap::XdsServer& server,
 
 namespace {
 
+void MaybeLogDeltaDiscoveryRequest(
+    const XdsEncodingContext& context,
+    const envoy_service_discovery_v3_DeltaDiscoveryRequest* request) {
+  if (GRPC_TRACE_FLAG_ENABLED(*context.tracer) &&
+      gpr_should_log(GPR_LOG_SEVERITY_DEBUG)) {
+    const upb_msgdef* msg_type =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_getmsgdef(
+            context.symtab);
+    char buf[10240];
+    upb_text_encode(request, msg_type, nullptr, 0, buf, sizeof(buf));
+    gpr_log(GPR_DEBUG, "[xds_client %p] constructed delta ADS request: %s",
+            context.client, buf);
+  }
+}
+
+void MaybeLogDeltaDiscoveryResponse(
+    const XdsEncodingContext& context,
+    const envoy_service_discovery_v3_DeltaDiscoveryResponse* response) {
+  if (GRPC_TRACE_FLAG_ENABLED(*context.tracer) &&
+      gpr_should_log(GPR_LOG_SEVERITY_DEBUG)) {
+    const upb_msgdef* msg_type =
+        envoy_service_discovery_v3_DeltaDiscoveryResponse_getmsgdef(
+            context.symtab);
+    char buf[10240];
+    upb_text_encode(response, msg_type, nullptr, 0, buf, sizeof(buf));
+    gpr_log(GPR_DEBUG, "[xds_client %p] received delta response: %s",
+            context.client, buf);
+  }
+}
+
+}  // namespace
+
+grpc_slice XdsApi::CreateDeltaAdsRequest(
+    const XdsBootstrap::XdsServer& server, absl::string_view type_url,
+    absl::string_view nonce,
+    const std::vector<std::string>& resource_names_subscribe,
+    const std::vector<std::string>& resource_names_unsubscribe,
+    const std::map<std::string, std::string>& initial_resource_versions,
+    grpc_error_handle error, bool populate_node) {
+  upb::Arena arena;
+  const XdsEncodingContext context = {client_,
+                                      server,
+                                      tracer_,
+                                      symtab_->ptr(),
+                                      arena.ptr(),
+                                      server.ShouldUseV3(),
+                                      certificate_provider_definition_map_};
+  // Create a request.
+  envoy_service_discovery_v3_DeltaDiscoveryRequest* request =
+      envoy_service_discovery_v3_DeltaDiscoveryRequest_new(arena.ptr());
+  // Set type_url.
+  std::string type_url_str = absl::StrCat("type.googleapis.com/", type_url);
+  envoy_service_discovery_v3_DeltaDiscoveryRequest_set_type_url(
+      request, StdStringToUpbString(type_url_str));
+  // Set nonce.
+  if (!nonce.empty()) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_set_response_nonce(
+        request, StdStringToUpbString(nonce));
+  }
+  // Set error_detail if it's a NACK.
+  std::string error_string_storage;
+  if (error != GRPC_ERROR_NONE) {
+    PopulateErrorDetail(
+        error, &error_string_storage,
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_mutable_error_detail(
+            request, arena.ptr()));
+  }
+  // Populate node.
+  if (populate_node) {
+    envoy_config_core_v3_Node* node_msg =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_mutable_node(
+            request, arena.ptr());
+    PopulateNode(context, node_, build_version_, user_agent_name_,
+                 user_agent_version_, node_msg);
+  }
+  // Add resource name changes.
+  for (const std::string& resource_name : resource_names_subscribe) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_add_resource_names_subscribe(
+        request, StdStringToUpbString(resource_name), arena.ptr());
+  }
+  for (const std::string& resource_name : resource_names_unsubscribe) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_add_resource_names_unsubscribe(
+        request, StdStringToUpbString(resource_name), arena.ptr());
+  }
+  // Add the versions of the resources we already have.
+  for (const auto& p : initial_resource_versions) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_initial_resource_versions_set(
+        request, StdStringToUpbString(p.first), StdStringToUpbString(p.second),
+        arena.ptr());
+  }
+  MaybeLogDeltaDiscoveryRequest(context, request);
+  size_t output_length;
+  char* output = envoy_service_discovery_v3_DeltaDiscoveryRequest_serialize(
+      request, arena.ptr(), &output_length);
+  return grpc_slice_from_copied_buffer(output, output_length);
+}
+
+absl::Status XdsApi::ParseDeltaAdsResponse(
+    const XdsBootstrap::XdsServer& server, const grpc_slice& encoded_response,
+    AdsResponseParserInterface* parser) {
+  upb::Arena arena;
+  const XdsEncodingContext context = {client_,
+                                      server,
+                                      tracer_,
+                                      symtab_->ptr(),
+                                      arena.ptr(),
+                                      server.ShouldUseV3(),
+                                      certificate_provider_definition_map_};
+  // Decode the response.
+  const envoy_service_discovery_v3_DeltaDiscoveryResponse* response =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_parse(
+          reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(encoded_response)),
+          GRPC_SLICE_LENGTH(encoded_response), arena.ptr());
+  // If decoding fails, report a fatal error and return.
+  if (response == nullptr) {
+    return absl::InvalidArgumentError("Can't decode DeltaDiscoveryResponse.");
+  }
+  MaybeLogDeltaDiscoveryResponse(context, response);
+  // Report the top-level fields and the removed resources to the parser.
+  AdsResponseParserInterface::AdsResponseFields fields;
+  fields.type_url = std::string(absl::StripPrefix(
+      UpbStringToAbsl(
+          envoy_service_discovery_v3_DeltaDiscoveryResponse_type_url(response)),
+      "type.googleapis.com/"));
+  fields.version = UpbStringToStdString(
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_system_version_info(
+          response));
+  fields.nonce = UpbStringToStdString(
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_nonce(response));
+  size_t num_resources;
+  const envoy_service_discovery_v3_Resource* const* resources =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_resources(
+          response, &num_resources);
+  fields.num_resources = num_resources;
+  size_t num_removed;
+  const upb_strview* removed =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_removed_resources(
+          response, &num_removed);
+  for (size_t i = 0; i < num_removed; ++i) {
+    fields.removed_resources.push_back(UpbStringToStdString(removed[i]));
+  }
+  absl::Status status = parser->ProcessAdsResponseFields(std::move(fields));
+  if (!status.ok()) return status;
+  // Process each resource.
+  for (size_t i = 0; i < num_resources; ++i) {
+    const google_protobuf_Any* resource =
+        envoy_service_discovery_v3_Resource_resource(resources[i]);
+    absl::string_view type_url;
+    absl::string_view serialized_resource;
+    if (resource != nullptr) {
+      type_url = absl::StripPrefix(
+          UpbStringToAbsl(google_protobuf_Any_type_url(resource)),
+          "type.googleapis.com/");
+      serialized_resource =
+          UpbStringToAbsl(google_protobuf_Any_value(resource));
+    }
+    parser->ParseDeltaResource(
+        context, i,
+        UpbStringToAbsl(envoy_service_discovery_v3_Resource_name(resources[i])),
+        UpbStringToAbsl(
+            envoy_service_discovery_v3_Resource_version(resources[i])),
+        type_url, serialized_resource);
+  }
+  return absl::OkStatus();
+}
+
+namespace {
+
 void MaybeLogLrsRequest(
     const XdsEncodingContext& context,
     const envoy_service_load_stats_v3_LoadStatsRequest* request) {
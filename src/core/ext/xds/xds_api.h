@@ -21,7 +21,10 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "envoy/admin/v3/config_dump.upb.h"
 #include "upb/def.hpp"
@@ -55,6 +58,8 @@ class XdsApi {
       std::string version;
       std::string nonce;
       size_t num_resources;
+      // Names of the resources the server removed (delta responses only).
+      std::vector<std::string> removed_resources;
     };
 
     virtual ~AdsResponseParserInterface() = default;
@@ -68,6 +73,14 @@ class XdsApi {
     virtual void ParseResource(const XdsEncodingContext& context, size_t idx,
                                absl::string_view type_url,
                                absl::string_view serialized_resource) = 0;
+
+    // Called instead of ParseResource() for each resource in a delta ADS
+    // response, along with the name and version the server sent for it.
+    virtual void ParseDeltaResource(const XdsEncodingContext& context,
+                                    size_t idx, absl::string_view name,
+                                    absl::string_view version,
+                                    absl::string_view type_url,
+                                    absl::string_view serialized_resource) = 0;
   };
 
   struct ClusterLoadReport {
@@ -156,6 +169,24 @@ class XdsApi {
                                 const grpc_slice& encoded_response,
                                 AdsResponseParserInterface* parser);
 
+  // Creates a delta ADS request, which only carries the changes to the
+  // subscribed resource names since the previous request of this type.
+  // \a initial_resource_versions is sent on the first request of a stream,
+  // so that the server can skip the resources the client already has.
+  // Takes ownership of \a error.
+  grpc_slice CreateDeltaAdsRequest(
+      const XdsBootstrap::XdsServer& server, absl::string_view type_url,
+      absl::string_view nonce,
+      const std::vector<std::string>& resource_names_subscribe,
+      const std::vector<std::string>& resource_names_unsubscribe,
+      const std::map<std::string, std::string>& initial_resource_versions,
+      grpc_error_handle error, bool populate_node);
+
+  // Like ParseAdsResponse(), for delta ADS responses.
+  absl::Status ParseDeltaAdsResponse(const XdsBootstrap::XdsServer& server,
+                                     const grpc_slice& encoded_response,
+                                     AdsResponseParserInterface* parser);
+
   // Creates an initial LRS request.
   grpc_slice CreateLrsInitialRequest(const XdsBootstrap::XdsServer& server);
 
@@ -78,6 +78,9 @@ class XdsBootstrap {
     Json::Object ToJson() const;
 
     bool ShouldUseV3() const;
+
+    // Whether to use the incremental (delta) variant of ADS.  Requires v3.
+    bool ShouldUseDelta() const;
   };
 
   struct Authority {
@@ -197,6 +197,8 @@ class XdsClient::ChannelState::AdsCallState
       std::map<std::string /*authority*/, std::set<XdsResourceKey>>
           resources_seen;
       bool have_valid_resources = false;
+      // Delta responses only.
+      std::vector<std::string> removed_resources;
     };
 
     explicit AdsResponseParser(AdsCallState* ads_call_state)
@@ -210,11 +212,25 @@ class XdsClient::ChannelState::AdsCallState
                        absl::string_view serialized_resource) override
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
 
+    void ParseDeltaResource(const XdsEncodingContext& context, size_t idx,
+                            absl::string_view name, absl::string_view version,
+                            absl::string_view type_url,
+                            absl::string_view serialized_resource) override
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
     Result TakeResult() { return std::move(result_); }
 
    private:
     XdsClient* xds_client() const { return ads_call_state_->xds_client(); }
 
+    // Decodes the resource, updates the cache and notifies the watchers.
+    // \a version is the version recorded for the resource.
+    void DecodeAndUpdateResource(const XdsEncodingContext& context, size_t idx,
+                                 absl::string_view type_url,
+                                 absl::string_view serialized_resource,
+                                 const std::string& version)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
     AdsCallState* ads_call_state_;
     const grpc_millis update_time_ = ExecCtx::Get()->Now();
     Result result_;
@@ -314,6 +330,12 @@ class XdsClient::ChannelState::AdsCallState
     std::map<std::string /*authority*/,
              std::map<XdsResourceKey, OrphanablePtr<ResourceTimer>>>
         subscribed_resources;
+
+    // Delta ADS only: resources subscribed to (true) or unsubscribed from
+    // (false) since the last request of this type was sent.
+    std::map<std::string /*authority*/, std::map<XdsResourceKey, bool>>
+        pending_subscription_changes;
+    bool sent_initial_request = false;
   };
 
   void SendMessageLocked(const XdsResourceType* type)
@@ -335,6 +357,30 @@ class XdsClient::ChannelState::AdsCallState
   // request.  Also starts the timer for each resource if needed.
   std::vector<std::string> ResourceNamesForRequest(const XdsResourceType* type);
 
+  // Delta ADS counterpart of ResourceNamesForRequest(): takes the pending
+  // subscription changes of a given type and starts the timer for each
+  // newly subscribed resource that is not cached yet.  On the first request
+  // of the stream, also returns the versions of the cached resources.
+  void DeltaResourceNamesForRequest(
+      const XdsResourceType* type, std::vector<std::string>* subscribe,
+      std::vector<std::string>* unsubscribe,
+      std::map<std::string, std::string>* initial_resource_versions)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
+  // Returns the cached state of a resource, or null if it is not watched.
+  ResourceState* FindResourceStateLocked(const XdsResourceType* type,
+                                         const XdsResourceName& name)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
+  void CancelResourceTimerLocked(const XdsResourceType* type,
+                                 const XdsResourceName& name)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
+  // Handles the resources removed by a delta ADS response.
+  void RemoveResourcesLocked(const XdsResourceType* type,
+                             const std::vector<std::string>& names)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
   // The owning RetryableCall<>.
   RefCountedPtr<RetryableCall<AdsCallState>> parent_;
 
@@ -782,6 +828,7 @@ absl::Status XdsClient::ChannelState::AdsCallState::AdsResponseParser::
   result_.type_url = std::move(fields.type_url);
   result_.version = std::move(fields.version);
   result_.nonce = std::move(fields.nonce);
+  result_.removed_resources = std::move(fields.removed_resources);
   return absl::OkStatus();
 }
 
@@ -815,6 +862,51 @@ void UpdateResourceMetadataNacked(const std::string& version,
 void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
     const XdsEncodingContext& context, size_t idx, absl::string_view type_url,
     absl::string_view serialized_resource) {
+  DecodeAndUpdateResource(context, idx, type_url, serialized_resource,
+                          result_.version);
+}
+
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    ParseDeltaResource(const XdsEncodingContext& context, size_t idx,
+                       absl::string_view name, absl::string_view version,
+                       absl::string_view type_url,
+                       absl::string_view serialized_resource) {
+  if (type_url.empty()) {
+    result_.errors.emplace_back(
+        absl::StrCat("resource index ", idx, ": ", name, ": missing resource"));
+    return;
+  }
+  // The server sends a resource again when its version changes, but also
+  // when the stream is re-established and the server did not act on the
+  // versions we reported.  Skip decoding resources we already have.
+  auto resource_name = XdsClient::ParseXdsResourceName(name, result_.type);
+  if (resource_name.ok() && !version.empty()) {
+    ResourceState* resource_state =
+        ads_call_state_->FindResourceStateLocked(result_.type, *resource_name);
+    if (resource_state != nullptr && resource_state->resource != nullptr &&
+        resource_state->meta.version == version &&
+        resource_state->meta.serialized_proto == serialized_resource) {
+      ads_call_state_->CancelResourceTimerLocked(result_.type, *resource_name);
+      result_.have_valid_resources = true;
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
+        gpr_log(GPR_INFO,
+                "[xds_client %p] %s resource %s version %s already cached, "
+                "ignoring.",
+                xds_client(), result_.type_url.c_str(),
+                std::string(name).c_str(), std::string(version).c_str());
+      }
+      return;
+    }
+  }
+  DecodeAndUpdateResource(context, idx, type_url, serialized_resource,
+                          std::string(version));
+}
+
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    DecodeAndUpdateResource(const XdsEncodingContext& context, size_t idx,
+                            absl::string_view type_url,
+                            absl::string_view serialized_resource,
+                            const std::string& version) {
   // Check the type_url of the resource.
   bool is_v2 = false;
   if (!result_.type->IsType(type_url, &is_v2)) {
@@ -841,36 +933,14 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
     return;
   }
   // Cancel resource-does-not-exist timer, if needed.
-  auto timer_it = ads_call_state_->state_map_.find(result_.type);
-  if (timer_it != ads_call_state_->state_map_.end()) {
-    auto it =
-        timer_it->second.subscribed_resources.find(resource_name->authority);
-    if (it != timer_it->second.subscribed_resources.end()) {
-      auto res_it = it->second.find(resource_name->key);
-      if (res_it != it->second.end()) {
-        res_it->second->MaybeCancelTimer();
-      }
-    }
-  }
-  // Lookup the authority in the cache.
-  auto authority_it =
-      xds_client()->authority_state_map_.find(resource_name->authority);
-  if (authority_it == xds_client()->authority_state_map_.end()) {
-    return;  // Skip resource -- we don't have a subscription for it.
-  }
-  // Found authority, so look up type.
-  AuthorityState& authority_state = authority_it->second;
-  auto type_it = authority_state.resource_map.find(result_.type);
-  if (type_it == authority_state.resource_map.end()) {
+  ads_call_state_->CancelResourceTimerLocked(result_.type, *resource_name);
+  // Lookup the resource in the cache.
+  ResourceState* resource_state_ptr =
+      ads_call_state_->FindResourceStateLocked(result_.type, *resource_name);
+  if (resource_state_ptr == nullptr) {
     return;  // Skip resource -- we don't have a subscription for it.
   }
-  auto& type_map = type_it->second;
-  // Found type, so look up resource key.
-  auto it = type_map.find(resource_name->key);
-  if (it == type_map.end()) {
-    return;  // Skip resource -- we don't have a subscription for it.
-  }
-  ResourceState& resource_state = it->second;
+  ResourceState& resource_state = *resource_state_ptr;
   // If needed, record that we've seen this resource.
   if (result_.type->AllResourcesRequiredInSotW()) {
     result_.resources_seen[resource_name->authority].insert(resource_name->key);
@@ -887,7 +957,7 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
                 "invalid resource: ", result->resource.status().ToString())),
             GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE),
         DEBUG_LOCATION);
-    UpdateResourceMetadataNacked(result_.version,
+    UpdateResourceMetadataNacked(version,
                                  result->resource.status().ToString(),
                                  update_time_, &resource_state.meta);
     return;
@@ -908,18 +978,18 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
   // Update the resource state.
   resource_state.resource = std::move(*result->resource);
   resource_state.meta = CreateResourceMetadataAcked(
-      std::string(serialized_resource), result_.version, update_time_);
-  // Notify watchers.
+      std::string(serialized_resource), version, update_time_);
+  // Notify watchers.  The resource is immutable from now on, so they all
+  // share it with the cache.
   auto& watchers_list = resource_state.watchers;
-  auto* value =
-      result_.type->CopyResource(resource_state.resource.get()).release();
+  std::shared_ptr<const XdsResourceType::ResourceData> value =
+      resource_state.resource;
   xds_client()->work_serializer_.Schedule(
       [watchers_list, value]()
           ABSL_EXCLUSIVE_LOCKS_REQUIRED(&xds_client()->work_serializer_) {
             for (const auto& p : watchers_list) {
-              p.first->OnGenericResourceChanged(value);
+              p.first->OnGenericResourceChanged(value.get());
             }
-            delete value;
           },
       DEBUG_LOCATION);
 }
@@ -946,6 +1016,11 @@ XdsClient::ChannelState::AdsCallState::AdsCallState(
             "StreamAggregatedResources"
           : "/envoy.service.discovery.v2.AggregatedDiscoveryService/"
             "StreamAggregatedResources";
+  if (chand()->server_.ShouldUseDelta()) {
+    method =
+        "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
+        "DeltaAggregatedResources";
+  }
   call_ = grpc_channel_create_pollset_set_call(
       chand()->channel_, nullptr, GRPC_PROPAGATE_DEFAULTS,
       xds_client()->interested_parties_,
@@ -1063,24 +1138,42 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
   }
   auto& state = state_map_[type];
   grpc_slice request_payload_slice;
-  request_payload_slice = xds_client()->api_.CreateAdsRequest(
-      chand()->server_,
-      chand()->server_.ShouldUseV3() ? type->type_url() : type->v2_type_url(),
-      chand()->resource_type_version_map_[type], state.nonce,
-      ResourceNamesForRequest(type), GRPC_ERROR_REF(state.error),
-      !sent_initial_message_);
+  // Delta requests carry per-resource versions instead of a version for the
+  // whole resource type.
+  std::string version;
+  if (chand()->server_.ShouldUseDelta()) {
+    std::vector<std::string> subscribe;
+    std::vector<std::string> unsubscribe;
+    std::map<std::string, std::string> initial_resource_versions;
+    DeltaResourceNamesForRequest(type, &subscribe, &unsubscribe,
+                                 &initial_resource_versions);
+    request_payload_slice = xds_client()->api_.CreateDeltaAdsRequest(
+        chand()->server_, type->type_url(), state.nonce, subscribe,
+        unsubscribe, initial_resource_versions, GRPC_ERROR_REF(state.error),
+        !sent_initial_message_);
+  } else {
+    version = chand()->resource_type_version_map_[type];
+    request_payload_slice = xds_client()->api_.CreateAdsRequest(
+        chand()->server_,
+        chand()->server_.ShouldUseV3() ? type->type_url()
+                                       : type->v2_type_url(),
+        version, state.nonce, ResourceNamesForRequest(type),
+        GRPC_ERROR_REF(state.error), !sent_initial_message_);
+  }
   sent_initial_message_ = true;
   if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
     gpr_log(GPR_INFO,
             "[xds_client %p] xds server %s: sending ADS request: type=%s "
             "version=%s nonce=%s error=%s",
             xds_client(), chand()->server_.server_uri.c_str(),
-            std::string(type->type_url()).c_str(),
-            chand()->resource_type_version_map_[type].c_str(),
+            std::string(type->type_url()).c_str(), version.c_str(),
             state.nonce.c_str(), grpc_error_std_string(state.error).c_str());
   }
   GRPC_ERROR_UNREF(state.error);
   state.error = GRPC_ERROR_NONE;
+  // Delta requests ACK or NACK a response only once; later requests of this
+  // type carry only subscription changes.
+  if (chand()->server_.ShouldUseDelta()) state.nonce.clear();
   // Create message payload.
   send_message_payload_ =
       grpc_raw_byte_buffer_create(&request_payload_slice, 1);
@@ -1107,9 +1200,13 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
 
 void XdsClient::ChannelState::AdsCallState::SubscribeLocked(
     const XdsResourceType* type, const XdsResourceName& name) {
-  auto& state = state_map_[type].subscribed_resources[name.authority][name.key];
+  auto& type_state = state_map_[type];
+  auto& state = type_state.subscribed_resources[name.authority][name.key];
   if (state == nullptr) {
     state = MakeOrphanable<ResourceTimer>(type, name);
+    if (chand()->server_.ShouldUseDelta()) {
+      type_state.pending_subscription_changes[name.authority][name.key] = true;
+    }
     SendMessageLocked(type);
   }
 }
@@ -1123,6 +1220,10 @@ void XdsClient::ChannelState::AdsCallState::UnsubscribeLocked(
   if (authority_map.empty()) {
     type_state_map.subscribed_resources.erase(name.authority);
   }
+  if (chand()->server_.ShouldUseDelta()) {
+    type_state_map.pending_subscription_changes[name.authority][name.key] =
+        false;
+  }
   if (!delay_unsubscription) SendMessageLocked(type);
 }
 
@@ -1193,8 +1294,12 @@ bool XdsClient::ChannelState::AdsCallState::OnResponseReceivedLocked() {
   recv_message_payload_ = nullptr;
   // Parse and validate the response.
   AdsResponseParser parser(this);
-  absl::Status status = xds_client()->api_.ParseAdsResponse(
-      chand()->server_, response_slice, &parser);
+  absl::Status status =
+      chand()->server_.ShouldUseDelta()
+          ? xds_client()->api_.ParseDeltaAdsResponse(chand()->server_,
+                                                     response_slice, &parser)
+          : xds_client()->api_.ParseAdsResponse(chand()->server_,
+                                                response_slice, &parser);
   grpc_slice_unref_internal(response_slice);
   if (!status.ok()) {
     // Ignore unparsable response.
@@ -1223,8 +1328,13 @@ bool XdsClient::ChannelState::AdsCallState::OnResponseReceivedLocked() {
                                        GRPC_ERROR_INT_GRPC_STATUS,
                                        GRPC_STATUS_UNAVAILABLE);
     }
-    // Delete resources not seen in update if needed.
-    if (result.type->AllResourcesRequiredInSotW()) {
+    // Delete resources the server removed.  Delta responses name them
+    // explicitly; state-of-the-world responses omit them, if the type
+    // requires all resources to be sent.
+    if (chand()->server_.ShouldUseDelta()) {
+      RemoveResourcesLocked(result.type, result.removed_resources);
+      if (!result.removed_resources.empty()) result.have_valid_resources = true;
+    } else if (result.type->AllResourcesRequiredInSotW()) {
       for (auto& a : xds_client()->authority_state_map_) {
         const std::string& authority = a.first;
         AuthorityState& authority_state = a.second;
@@ -1257,11 +1367,14 @@ bool XdsClient::ChannelState::AdsCallState::OnResponseReceivedLocked() {
         }
       }
     }
-    // If we had valid resources, update the version.
+    // If we had valid resources, update the version.  A delta response's
+    // system_version_info is for debugging only, and is not sent back.
     if (result.have_valid_resources) {
       seen_response_ = true;
-      chand()->resource_type_version_map_[result.type] =
-          std::move(result.version);
+      if (!chand()->server_.ShouldUseDelta()) {
+        chand()->resource_type_version_map_[result.type] =
+            std::move(result.version);
+      }
       // Start load reporting if needed.
       auto& lrs_call = chand()->lrs_calld_;
       if (lrs_call != nullptr) {
@@ -1350,6 +1463,95 @@ XdsClient::ChannelState::AdsCallState::ResourceNamesForRequest(
   return resource_names;
 }
 
+void XdsClient::ChannelState::AdsCallState::DeltaResourceNamesForRequest(
+    const XdsResourceType* type, std::vector<std::string>* subscribe,
+    std::vector<std::string>* unsubscribe,
+    std::map<std::string, std::string>* initial_resource_versions) {
+  auto it = state_map_.find(type);
+  if (it == state_map_.end()) return;
+  ResourceTypeState& state = it->second;
+  const bool initial_request = !state.sent_initial_request;
+  state.sent_initial_request = true;
+  for (auto& a : state.pending_subscription_changes) {
+    const std::string& authority = a.first;
+    auto subscribed_it = state.subscribed_resources.find(authority);
+    for (auto& p : a.second) {
+      const XdsResourceKey& resource_key = p.first;
+      std::string name = XdsClient::ConstructFullXdsResourceName(
+          authority, type->type_url(), resource_key);
+      if (!p.second) {
+        // Nothing to unsubscribe from on a new stream.
+        if (!initial_request) unsubscribe->emplace_back(std::move(name));
+        continue;
+      }
+      // Report the version of the resource if we already have it, in which
+      // case the server may not send it again, so don't wait for it.
+      ResourceState* resource_state =
+          FindResourceStateLocked(type, {authority, resource_key});
+      if (resource_state != nullptr && resource_state->resource != nullptr) {
+        if (initial_request && !resource_state->meta.version.empty()) {
+          (*initial_resource_versions)[name] = resource_state->meta.version;
+        }
+      } else if (subscribed_it != state.subscribed_resources.end()) {
+        auto timer_it = subscribed_it->second.find(resource_key);
+        if (timer_it != subscribed_it->second.end()) {
+          timer_it->second->MaybeStartTimer(
+              Ref(DEBUG_LOCATION, "ResourceTimer"));
+        }
+      }
+      subscribe->emplace_back(std::move(name));
+    }
+  }
+  state.pending_subscription_changes.clear();
+}
+
+XdsClient::ResourceState*
+XdsClient::ChannelState::AdsCallState::FindResourceStateLocked(
+    const XdsResourceType* type, const XdsResourceName& name) {
+  auto authority_it = xds_client()->authority_state_map_.find(name.authority);
+  if (authority_it == xds_client()->authority_state_map_.end()) {
+    return nullptr;
+  }
+  AuthorityState& authority_state = authority_it->second;
+  auto type_it = authority_state.resource_map.find(type);
+  if (type_it == authority_state.resource_map.end()) return nullptr;
+  auto it = type_it->second.find(name.key);
+  if (it == type_it->second.end()) return nullptr;
+  return &it->second;
+}
+
+void XdsClient::ChannelState::AdsCallState::CancelResourceTimerLocked(
+    const XdsResourceType* type, const XdsResourceName& name) {
+  auto type_it = state_map_.find(type);
+  if (type_it == state_map_.end()) return;
+  auto it = type_it->second.subscribed_resources.find(name.authority);
+  if (it == type_it->second.subscribed_resources.end()) return;
+  auto res_it = it->second.find(name.key);
+  if (res_it != it->second.end()) res_it->second->MaybeCancelTimer();
+}
+
+void XdsClient::ChannelState::AdsCallState::RemoveResourcesLocked(
+    const XdsResourceType* type, const std::vector<std::string>& names) {
+  for (const std::string& name : names) {
+    auto resource_name = XdsClient::ParseXdsResourceName(name, type);
+    if (!resource_name.ok()) continue;
+    CancelResourceTimerLocked(type, *resource_name);
+    ResourceState* resource_state =
+        FindResourceStateLocked(type, *resource_name);
+    if (resource_state == nullptr) continue;
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
+      gpr_log(GPR_INFO, "[xds_client %p] %s resource %s removed by server",
+              xds_client(), std::string(type->type_url()).c_str(),
+              name.c_str());
+    }
+    resource_state->resource.reset();
+    resource_state->meta.client_status =
+        XdsApi::ResourceMetadata::DOES_NOT_EXIST;
+    Notifier::ScheduleNotifyWatchersOnResourceDoesNotExistInWorkSerializer(
+        xds_client(), resource_state->watchers, DEBUG_LOCATION);
+  }
+}
+
 //
 // XdsClient::ChannelState::LrsCallState::Reporter
 //
@@ -1941,11 +2143,11 @@ void XdsClient::WatchResource(const XdsResourceType* type,
                 "[xds_client %p] returning cached listener data for %s", this,
                 std::string(name).c_str());
       }
-      auto* value = type->CopyResource(resource_state.resource.get()).release();
+      std::shared_ptr<const XdsResourceType::ResourceData> value =
+          resource_state.resource;
       work_serializer_.Schedule(
           [watcher, value]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(&work_serializer_) {
-            watcher->OnGenericResourceChanged(value);
-            delete value;
+            watcher->OnGenericResourceChanged(value.get());
           },
           DEBUG_LOCATION);
     }
@@ -19,6 +19,7 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -224,6 +225,7 @@ class XdsClient : public DualRefCounted<XdsClient> {
     OrphanablePtr<RetryableCall<LrsCallState>> lrs_calld_;
 
     // Stores the most recent accepted resource version for each resource type.
+    // Unused with delta ADS, which tracks versions per resource.
     std::map<const XdsResourceType*, std::string /*version*/>
         resource_type_version_map_;
   };
@@ -231,8 +233,9 @@ class XdsClient : public DualRefCounted<XdsClient> {
   struct ResourceState {
     std::map<ResourceWatcherInterface*, RefCountedPtr<ResourceWatcherInterface>>
         watchers;
-    // The latest data seen for the resource.
-    std::unique_ptr<XdsResourceType::ResourceData> resource;
+    // The latest data seen for the resource.  Immutable: watchers are
+    // handed the same instance rather than copies of it.
+    std::shared_ptr<const XdsResourceType::ResourceData> resource;
     XdsApi::ResourceMetadata meta;
   };
 
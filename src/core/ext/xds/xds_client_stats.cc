@@ -22,6 +22,8 @@
 
 #include <string.h>
 
+#include <tuple>
+
 #include <grpc/support/atm.h>
 #include <grpc/support/string_util.h>
 
@@ -35,8 +37,57 @@ uint64_t GetAndResetCounter(std::atomic<uint64_t>* from) {
   return from->exchange(0, std::memory_order_relaxed);
 }
 
+// Interned locality names.  Entries do not hold refs; they are removed when
+// the name is destroyed.
+struct InternedLocalityNames {
+  Mutex mu;
+  std::map<std::tuple<std::string, std::string, std::string>,
+           XdsLocalityName*>
+      names ABSL_GUARDED_BY(mu);
+};
+
+InternedLocalityNames* GetInternedLocalityNames() {
+  static InternedLocalityNames* interned = new InternedLocalityNames();
+  return interned;
+}
+
 }  // namespace
 
+//
+// XdsLocalityName
+//
+
+RefCountedPtr<XdsLocalityName> XdsLocalityName::Intern(std::string region,
+                                                       std::string zone,
+                                                       std::string sub_zone) {
+  InternedLocalityNames* interned = GetInternedLocalityNames();
+  MutexLock lock(&interned->mu);
+  XdsLocalityName*& name =
+      interned->names[std::make_tuple(region, zone, sub_zone)];
+  if (name != nullptr) {
+    // The last ref may have just gone away, in which case the name is being
+    // destroyed and is replaced below.
+    RefCountedPtr<XdsLocalityName> existing = name->RefIfNonZero();
+    if (existing != nullptr) return existing;
+  }
+  auto new_name = MakeRefCounted<XdsLocalityName>(
+      std::move(region), std::move(zone), std::move(sub_zone));
+  new_name->interned_ = true;
+  name = new_name.get();
+  return new_name;
+}
+
+XdsLocalityName::~XdsLocalityName() {
+  if (!interned_) return;
+  InternedLocalityNames* interned = GetInternedLocalityNames();
+  MutexLock lock(&interned->mu);
+  auto it =
+      interned->names.find(std::make_tuple(region_, zone_, sub_zone_));
+  if (it != interned->names.end() && it->second == this) {
+    interned->names.erase(it);
+  }
+}
+
 //
 // XdsClusterDropStats
 //
@@ -45,8 +45,10 @@ namespace grpc_core {
 
 std::string XdsEndpointResource::Priority::Locality::ToString() const {
   std::vector<std::string> endpoint_strings;
-  for (const ServerAddress& endpoint : endpoints) {
-    endpoint_strings.emplace_back(endpoint.ToString());
+  if (endpoints != nullptr) {
+    for (const ServerAddress& endpoint : *endpoints) {
+      endpoint_strings.emplace_back(endpoint.ToString());
+    }
   }
   return absl::StrCat("{name=", name->AsHumanReadableString(),
                       ", lb_weight=", lb_weight, ", endpoints=[",
@@ -205,18 +207,21 @@ grpc_error_handle LocalityParse(
       UpbStringToStdString(envoy_config_core_v3_Locality_region(locality));
   std::string sub_zone =
       UpbStringToStdString(envoy_config_core_v3_Locality_sub_zone(locality));
-  output_locality->name = MakeRefCounted<XdsLocalityName>(
+  output_locality->name = XdsLocalityName::Intern(
       std::move(region), std::move(zone), std::move(sub_zone));
   // Parse the addresses.
   size_t size;
   const envoy_config_endpoint_v3_LbEndpoint* const* lb_endpoints =
       envoy_config_endpoint_v3_LocalityLbEndpoints_lb_endpoints(
           locality_lb_endpoints, &size);
+  ServerAddressList endpoints;
   for (size_t i = 0; i < size; ++i) {
-    grpc_error_handle error = ServerAddressParseAndAppend(
-        lb_endpoints[i], &output_locality->endpoints);
+    grpc_error_handle error =
+        ServerAddressParseAndAppend(lb_endpoints[i], &endpoints);
     if (error != GRPC_ERROR_NONE) return error;
   }
+  output_locality->endpoints =
+      std::make_shared<const ServerAddressList>(std::move(endpoints));
   // Parse the priority.
   *priority = envoy_config_endpoint_v3_LocalityLbEndpoints_priority(
       locality_lb_endpoints);
@@ -20,6 +20,7 @@
 #include <grpc/support/port_platform.h>
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -39,11 +40,15 @@ struct XdsEndpointResource {
     struct Locality {
       RefCountedPtr<XdsLocalityName> name;
       uint32_t lb_weight;
-      ServerAddressList endpoints;
+      // Immutable, so that the copies of the resource handed to each
+      // watcher share the addresses instead of copying them.
+      std::shared_ptr<const ServerAddressList> endpoints;
 
       bool operator==(const Locality& other) const {
         return *name == *other.name && lb_weight == other.lb_weight &&
-               endpoints == other.endpoints;
+               (endpoints == other.endpoints ||
+                (endpoints != nullptr && other.endpoints != nullptr &&
+                 *endpoints == *other.endpoints));
       }
       bool operator!=(const Locality& other) const { return !(*this == other); }
       std::string ToString() const;
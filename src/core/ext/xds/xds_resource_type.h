@@ -69,12 +69,6 @@ class XdsResourceType {
   virtual bool ResourcesEqual(const ResourceData* r1,
                               const ResourceData* r2) const = 0;
 
-  // Returns a copy of resource.
-  // Must be invoked only on resources returned by this object's Decode()
-  // method.
-  virtual std::unique_ptr<ResourceData> CopyResource(
-      const ResourceData* resource) const = 0;
-
   // Indicates whether the resource type requires that all resources must
   // be present in every SotW response from the server.  If true, a
   // response that does not include a previously seen resource will be
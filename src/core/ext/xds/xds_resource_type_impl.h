@@ -72,14 +72,6 @@ class XdsResourceTypeImpl : public XdsResourceType {
     return static_cast<const ResourceDataSubclass*>(r1)->resource ==
            static_cast<const ResourceDataSubclass*>(r2)->resource;
   }
-
-  std::unique_ptr<ResourceData> CopyResource(
-      const ResourceData* resource) const override {
-    auto* resource_copy = new ResourceDataSubclass();
-    resource_copy->resource =
-        static_cast<const ResourceDataSubclass*>(resource)->resource;
-    return std::unique_ptr<ResourceData>(resource_copy);
-  }
 };
 
 }  // namespace grpc_core
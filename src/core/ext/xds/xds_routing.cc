@@ -20,8 +20,12 @@
 
 #include "src/core/ext/xds/xds_routing.h"
 
+#include <algorithm>
 #include <cctype>
 
+#include "absl/memory/memory.h"
+#include "absl/strings/ascii.h"
+
 namespace grpc_core {
 
 namespace {
@@ -33,41 +37,40 @@ enum MatchType {
   INVALID_MATCH,
 };
 
-// Returns true if match succeeds.
-bool DomainMatch(MatchType match_type, absl::string_view domain_pattern_in,
-                 absl::string_view expected_host_name_in) {
-  // Normalize the args to lower-case. Domain matching is case-insensitive.
-  std::string domain_pattern = std::string(domain_pattern_in);
-  std::string expected_host_name = std::string(expected_host_name_in);
-  std::transform(domain_pattern.begin(), domain_pattern.end(),
-                 domain_pattern.begin(),
-                 [](unsigned char c) { return std::tolower(c); });
-  std::transform(expected_host_name.begin(), expected_host_name.end(),
-                 expected_host_name.begin(),
-                 [](unsigned char c) { return std::tolower(c); });
+// Returns true if match succeeds.  Both args must be lower-case.
+bool LowerCaseDomainMatch(MatchType match_type,
+                          absl::string_view domain_pattern,
+                          absl::string_view expected_host_name) {
   if (match_type == EXACT_MATCH) {
     return domain_pattern == expected_host_name;
   } else if (match_type == SUFFIX_MATCH) {
     // Asterisk must match at least one char.
     if (expected_host_name.size() < domain_pattern.size()) return false;
-    absl::string_view pattern_suffix(domain_pattern.c_str() + 1);
-    absl::string_view host_suffix(expected_host_name.c_str() +
-                                  expected_host_name.size() -
-                                  pattern_suffix.size());
+    absl::string_view pattern_suffix = domain_pattern.substr(1);
+    absl::string_view host_suffix = expected_host_name.substr(
+        expected_host_name.size() - pattern_suffix.size());
     return pattern_suffix == host_suffix;
   } else if (match_type == PREFIX_MATCH) {
     // Asterisk must match at least one char.
     if (expected_host_name.size() < domain_pattern.size()) return false;
-    absl::string_view pattern_prefix(domain_pattern.c_str(),
-                                     domain_pattern.size() - 1);
-    absl::string_view host_prefix(expected_host_name.c_str(),
-                                  pattern_prefix.size());
+    absl::string_view pattern_prefix =
+        domain_pattern.substr(0, domain_pattern.size() - 1);
+    absl::string_view host_prefix =
+        expected_host_name.substr(0, pattern_prefix.size());
     return pattern_prefix == host_prefix;
   } else {
     return match_type == UNIVERSE_MATCH;
   }
 }
 
+// Returns true if match succeeds.
+bool DomainMatch(MatchType match_type, absl::string_view domain_pattern,
+                 absl::string_view expected_host_name) {
+  // Normalize the args to lower-case. Domain matching is case-insensitive.
+  return LowerCaseDomainMatch(match_type, absl::AsciiStrToLower(domain_pattern),
+                              absl::AsciiStrToLower(expected_host_name));
+}
+
 MatchType DomainPatternMatchType(absl::string_view domain_pattern) {
   if (domain_pattern.empty()) return INVALID_MATCH;
   if (!absl::StrContains(domain_pattern, '*')) return EXACT_MATCH;
@@ -79,6 +82,55 @@ MatchType DomainPatternMatchType(absl::string_view domain_pattern) {
 
 }  // namespace
 
+//
+// XdsRouting::CompiledVirtualHostList
+//
+
+XdsRouting::CompiledVirtualHostList::CompiledVirtualHostList(
+    const VirtualHostListIterator& vhost_iterator) {
+  for (size_t i = 0; i < vhost_iterator.Size(); ++i) {
+    for (const std::string& domain_pattern :
+         vhost_iterator.GetDomainsForVirtualHost(i)) {
+      const MatchType match_type = DomainPatternMatchType(domain_pattern);
+      // This should be caught by RouteConfigParse().
+      GPR_ASSERT(match_type != INVALID_MATCH);
+      std::string pattern = absl::AsciiStrToLower(domain_pattern);
+      if (match_type == EXACT_MATCH) {
+        // Does not replace the virtual host already listing the domain, if
+        // any.
+        exact_domains_.emplace(std::move(pattern), i);
+      } else {
+        wildcard_domains_.push_back({match_type, std::move(pattern), i});
+      }
+    }
+  }
+  // Same order as in FindVirtualHostForDomain(): by match type, then longest
+  // pattern first.  The sort is stable so that the first virtual host wins
+  // ties.
+  std::stable_sort(wildcard_domains_.begin(), wildcard_domains_.end(),
+                   [](const WildcardDomain& a, const WildcardDomain& b) {
+                     if (a.match_type != b.match_type) {
+                       return a.match_type < b.match_type;
+                     }
+                     return a.pattern.size() > b.pattern.size();
+                   });
+}
+
+absl::optional<size_t>
+XdsRouting::CompiledVirtualHostList::FindVirtualHostForDomain(
+    absl::string_view domain) const {
+  std::string host = absl::AsciiStrToLower(domain);
+  auto it = exact_domains_.find(host);
+  if (it != exact_domains_.end()) return it->second;
+  for (const WildcardDomain& wildcard : wildcard_domains_) {
+    if (LowerCaseDomainMatch(static_cast<MatchType>(wildcard.match_type),
+                             wildcard.pattern, host)) {
+      return wildcard.index;
+    }
+  }
+  return absl::nullopt;
+}
+
 absl::optional<size_t> XdsRouting::FindVirtualHostForDomain(
     const VirtualHostListIterator& vhost_iterator, absl::string_view domain) {
   // Find the best matched virtual host.
@@ -143,6 +195,156 @@ bool UnderFraction(const uint32_t fraction_per_million) {
 
 }  // namespace
 
+//
+// XdsRouting::CompiledRouteList
+//
+
+void XdsRouting::CompiledRouteList::PrefixTrie::Insert(
+    absl::string_view prefix, size_t index) {
+  size_t node = 0;
+  for (char c : prefix) {
+    auto& children = nodes_[node].children;
+    auto it = std::find_if(
+        children.begin(), children.end(),
+        [c](const std::pair<char, size_t>& child) { return child.first == c; });
+    if (it != children.end()) {
+      node = it->second;
+    } else {
+      children.emplace_back(c, nodes_.size());
+      node = nodes_.size();
+      nodes_.emplace_back();
+    }
+  }
+  nodes_[node].routes.push_back(index);
+}
+
+void XdsRouting::CompiledRouteList::PrefixTrie::FindPrefixes(
+    absl::string_view path, bool lower_case, Candidates* candidates) const {
+  size_t node = 0;
+  for (size_t i = 0;; ++i) {
+    const Node& current = nodes_[node];
+    candidates->insert(candidates->end(), current.routes.begin(),
+                       current.routes.end());
+    if (i == path.size()) return;
+    const char c = lower_case ? absl::ascii_tolower(path[i]) : path[i];
+    auto it = std::find_if(
+        current.children.begin(), current.children.end(),
+        [c](const std::pair<char, size_t>& child) { return child.first == c; });
+    if (it == current.children.end()) return;
+    node = it->second;
+  }
+}
+
+XdsRouting::CompiledRouteList::CompiledRouteList(
+    const RouteListIterator& route_list_iterator) {
+  auto regexes = absl::make_unique<RE2::Set>(RE2::Options(), RE2::ANCHOR_BOTH);
+  for (size_t i = 0; i < route_list_iterator.Size(); ++i) {
+    const StringMatcher& path_matcher =
+        route_list_iterator.GetMatchersForRoute(i).path_matcher;
+    const std::string& value = path_matcher.string_matcher();
+    if (path_matcher.type() == StringMatcher::Type::kExact) {
+      if (path_matcher.case_sensitive()) {
+        exact_paths_[value].push_back(i);
+      } else {
+        case_insensitive_paths_[absl::AsciiStrToLower(value)].push_back(i);
+      }
+    } else if (path_matcher.type() == StringMatcher::Type::kPrefix) {
+      if (path_matcher.case_sensitive()) {
+        prefixes_.Insert(value, i);
+      } else {
+        case_insensitive_prefixes_.Insert(absl::AsciiStrToLower(value), i);
+      }
+    } else if (path_matcher.type() == StringMatcher::Type::kSafeRegex &&
+               regexes->Add(path_matcher.regex_matcher()->pattern(),
+                            nullptr) >= 0) {
+      regex_routes_.push_back(i);
+    } else {
+      other_routes_.push_back(i);
+    }
+  }
+  if (!regex_routes_.empty()) {
+    if (regexes->Compile()) {
+      regexes_ = std::move(regexes);
+    } else {
+      // Too large for a single RE2::Set; match the regexes one by one.
+      other_routes_.insert(other_routes_.end(), regex_routes_.begin(),
+                           regex_routes_.end());
+      std::sort(other_routes_.begin(), other_routes_.end());
+      regex_routes_.clear();
+    }
+  }
+  if (!regex_routes_.empty()) first_deferred_route_ = regex_routes_.front();
+  if (!other_routes_.empty()) {
+    first_deferred_route_ =
+        std::min(first_deferred_route_, other_routes_.front());
+  }
+}
+
+absl::optional<size_t> XdsRouting::CompiledRouteList::GetRouteForRequest(
+    const RouteListIterator& route_list_iterator, absl::string_view path,
+    grpc_metadata_batch* initial_metadata) const {
+  // Collect the routes whose path matcher matches.
+  Candidates candidates;
+  auto it = exact_paths_.find(path);
+  if (it != exact_paths_.end()) {
+    candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+  }
+  if (!case_insensitive_paths_.empty()) {
+    it = case_insensitive_paths_.find(absl::AsciiStrToLower(path));
+    if (it != case_insensitive_paths_.end()) {
+      candidates.insert(candidates.end(), it->second.begin(),
+                        it->second.end());
+    }
+  }
+  prefixes_.FindPrefixes(path, /*lower_case=*/false, &candidates);
+  case_insensitive_prefixes_.FindPrefixes(path, /*lower_case=*/true,
+                                          &candidates);
+  // The first of them whose other matchers match wins.  Those ahead of all
+  // the routes matched one by one or with regexes are tried before matching
+  // those.
+  auto other_matchers_match = [&](size_t index) {
+    const XdsRouteConfigResource::Route::Matchers& matchers =
+        route_list_iterator.GetMatchersForRoute(index);
+    return HeadersMatch(matchers.header_matchers, initial_metadata) &&
+           (!matchers.fraction_per_million.has_value() ||
+            UnderFraction(*matchers.fraction_per_million));
+  };
+  std::sort(candidates.begin(), candidates.end());
+  auto deferred = candidates.begin();
+  for (; deferred != candidates.end() && *deferred < first_deferred_route_;
+       ++deferred) {
+    if (other_matchers_match(*deferred)) return *deferred;
+  }
+  candidates.erase(candidates.begin(), deferred);
+  if (regexes_ != nullptr) {
+    std::vector<int> matches;
+    RE2::Set::ErrorInfo error_info;
+    if (regexes_->Match(re2::StringPiece(path.data(), path.size()), &matches,
+                        &error_info)) {
+      for (int match : matches) candidates.push_back(regex_routes_[match]);
+    } else if (error_info.kind != RE2::Set::kNoError) {
+      // The DFA ran out of memory; fall back to matching one by one.
+      for (size_t index : regex_routes_) {
+        if (route_list_iterator.GetMatchersForRoute(index).path_matcher.Match(
+                path)) {
+          candidates.push_back(index);
+        }
+      }
+    }
+  }
+  for (size_t index : other_routes_) {
+    if (route_list_iterator.GetMatchersForRoute(index).path_matcher.Match(
+            path)) {
+      candidates.push_back(index);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  for (size_t index : candidates) {
+    if (other_matchers_match(index)) return index;
+  }
+  return absl::nullopt;
+}
+
 absl::optional<size_t> XdsRouting::GetRouteForRequest(
     const RouteListIterator& route_list_iterator, absl::string_view path,
     grpc_metadata_batch* initial_metadata) {
@@ -21,9 +21,16 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
+#include "re2/set.h"
 
 #include <grpc/support/log.h>
 
@@ -56,6 +63,84 @@ class XdsRouting {
         size_t index) const = 0;
   };
 
+  // A virtual host list prepared for finding the virtual hosts of many
+  // requests: exact domains are looked up in a hash table, and only the
+  // wildcard patterns are matched one by one.
+  class CompiledVirtualHostList {
+   public:
+    CompiledVirtualHostList() = default;
+    explicit CompiledVirtualHostList(
+        const VirtualHostListIterator& vhost_iterator);
+
+    // Same as the static FindVirtualHostForDomain() with the list this was
+    // compiled from.
+    absl::optional<size_t> FindVirtualHostForDomain(
+        absl::string_view domain) const;
+
+   private:
+    struct WildcardDomain {
+      int match_type;
+      std::string pattern;  // Lower-case.
+      size_t index;
+    };
+
+    // Lower-case domain to the first virtual host that lists it.
+    absl::flat_hash_map<std::string, size_t> exact_domains_;
+    // In the order they are to be tried in.
+    std::vector<WildcardDomain> wildcard_domains_;
+  };
+
+  // A route list prepared for matching many requests against it: exact path
+  // matchers are looked up in a hash table, prefix matchers in a trie and
+  // regex matchers are matched all at once with an RE2::Set.  Only the routes
+  // whose path matches have their header matchers checked.
+  class CompiledRouteList {
+   public:
+    CompiledRouteList() = default;
+    explicit CompiledRouteList(const RouteListIterator& route_list_iterator);
+
+    // Same as the static GetRouteForRequest().  \a route_list_iterator must
+    // return the same routes as the one this was compiled from.
+    absl::optional<size_t> GetRouteForRequest(
+        const RouteListIterator& route_list_iterator, absl::string_view path,
+        grpc_metadata_batch* initial_metadata) const;
+
+   private:
+    using RouteIndexes = std::vector<size_t>;
+    using Candidates = absl::InlinedVector<size_t, 8>;
+
+    class PrefixTrie {
+     public:
+      void Insert(absl::string_view prefix, size_t index);
+      // Appends the routes whose prefix \a path starts with to \a candidates.
+      // If \a lower_case is true, \a path is lower-cased as it is walked.
+      void FindPrefixes(absl::string_view path, bool lower_case,
+                        Candidates* candidates) const;
+
+     private:
+      struct Node {
+        std::vector<std::pair<char, size_t>> children;
+        RouteIndexes routes;
+      };
+
+      std::vector<Node> nodes_{1};
+    };
+
+    absl::flat_hash_map<std::string, RouteIndexes> exact_paths_;
+    // Keyed by the lower-case path.
+    absl::flat_hash_map<std::string, RouteIndexes> case_insensitive_paths_;
+    PrefixTrie prefixes_;
+    // Holds lower-case prefixes.
+    PrefixTrie case_insensitive_prefixes_;
+    std::unique_ptr<RE2::Set> regexes_;
+    // Route of each regex in regexes_.
+    RouteIndexes regex_routes_;
+    // Routes whose path matcher is matched on its own.
+    RouteIndexes other_routes_;
+    // The first route in regex_routes_ or other_routes_.
+    size_t first_deferred_route_ = std::numeric_limits<size_t>::max();
+  };
+
   // Returns the index of the selected virtual host in the list.
   static absl::optional<size_t> FindVirtualHostForDomain(
       const VirtualHostListIterator& vhost_iterator, absl::string_view domain);
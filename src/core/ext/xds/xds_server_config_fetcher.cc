@@ -287,6 +287,7 @@ class XdsServerConfigFetcher::ListenerWatcher::FilterChainMatchManager::
 
     std::vector<std::string> domains;
     std::vector<Route> routes;
+    XdsRouting::CompiledRouteList compiled_routes;
   };
 
   class VirtualHostListIterator : public XdsRouting::VirtualHostListIterator {
@@ -307,6 +308,7 @@ class XdsServerConfigFetcher::ListenerWatcher::FilterChainMatchManager::
   };
 
   std::vector<VirtualHost> virtual_hosts_;
+  XdsRouting::CompiledVirtualHostList compiled_virtual_hosts_;
 };
 
 // An XdsServerConfigSelectorProvider implementation for when the
@@ -1126,7 +1128,12 @@ XdsServerConfigFetcher::ListenerWatcher::FilterChainMatchManager::
       }
       grpc_channel_args_destroy(result.args);
     }
+    virtual_host.compiled_routes = XdsRouting::CompiledRouteList(
+        VirtualHost::RouteListIterator(&virtual_host.routes));
   }
+  config_selector->compiled_virtual_hosts_ =
+      XdsRouting::CompiledVirtualHostList(
+          VirtualHostListIterator(&config_selector->virtual_hosts_));
   return config_selector;
 }
 
@@ -1147,8 +1154,8 @@ ServerConfigSelector::CallConfig XdsServerConfigFetcher::ListenerWatcher::
   }
   absl::string_view authority =
       metadata->get_pointer(HttpAuthorityMetadata())->as_string_view();
-  auto vhost_index = XdsRouting::FindVirtualHostForDomain(
-      VirtualHostListIterator(&virtual_hosts_), authority);
+  auto vhost_index =
+      compiled_virtual_hosts_.FindVirtualHostForDomain(authority);
   if (!vhost_index.has_value()) {
     call_config.error =
         grpc_error_set_int(GRPC_ERROR_CREATE_FROM_CPP_STRING(absl::StrCat(
@@ -1158,7 +1165,7 @@ ServerConfigSelector::CallConfig XdsServerConfigFetcher::ListenerWatcher::
     return call_config;
   }
   auto& virtual_host = virtual_hosts_[vhost_index.value()];
-  auto route_index = XdsRouting::GetRouteForRequest(
+  auto route_index = virtual_host.compiled_routes.GetRouteForRequest(
       VirtualHost::RouteListIterator(&virtual_host.routes), path, metadata);
   if (route_index.has_value()) {
     auto& route = virtual_host.routes[route_index.value()];
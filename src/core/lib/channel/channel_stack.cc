@@ -244,7 +244,7 @@ void grpc_call_stack_destroy(grpc_call_stack* stack,
 
 void grpc_call_next_op(grpc_call_element* elem,
                        grpc_transport_stream_op_batch* op) {
-  grpc_call_element* next_elem = elem + 1;
+  grpc_call_element* next_elem = grpc_call_stack_skip_passthrough(elem + 1);
   GRPC_CALL_LOG_OP(GPR_INFO, next_elem, op);
   next_elem->filter->start_transport_stream_op_batch(next_elem, op);
 }
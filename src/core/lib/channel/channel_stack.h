@@ -298,6 +298,17 @@ void grpc_call_stack_ignore_set_pollset_or_pollset_set(
 /* Call the next operation in a call stack */
 void grpc_call_next_op(grpc_call_element* elem,
                        grpc_transport_stream_op_batch* op);
+/* Return the first element at or below \a elem that does more with a batch
+   than forward it, i.e. whose start_transport_stream_op_batch is not
+   grpc_call_next_op. Batches skip such pass-through filters entirely. The
+   bottom element of a stack is never pass-through. */
+inline grpc_call_element* grpc_call_stack_skip_passthrough(
+    grpc_call_element* elem) {
+  while (elem->filter->start_transport_stream_op_batch == grpc_call_next_op) {
+    ++elem;
+  }
+  return elem;
+}
 /* Call the next operation (depending on call directionality) in a channel
    stack */
 void grpc_channel_next_op(grpc_channel_element* elem, grpc_transport_op* op);
@@ -493,6 +493,16 @@ void SocketNode::RecordMessagesSent(uint32_t num_sent) {
                                  std::memory_order_relaxed);
 }
 
+void SocketNode::RecordTransportLatency(const TransportLatency& latency) {
+  MutexLock lock(&latency_mu_);
+  latency_ = latency;
+}
+
+absl::optional<SocketNode::TransportLatency> SocketNode::transport_latency() {
+  MutexLock lock(&latency_mu_);
+  return latency_;
+}
+
 void SocketNode::RecordMessageReceived() {
   messages_received_.fetch_add(1, std::memory_order_relaxed);
   last_message_received_cycle_.store(gpr_get_cycle_counter(),
@@ -555,6 +565,21 @@ Json SocketNode::RenderJson() {
   if (keepalives_sent != 0) {
     data["keepAlivesSent"] = std::to_string(keepalives_sent);
   }
+  // The proto has no fields for transport latency, so it is reported as
+  // socket options.
+  absl::optional<TransportLatency> latency = transport_latency();
+  if (latency.has_value()) {
+    auto option = [](const char* name, int64_t value) {
+      return Json::Object{{"name", name}, {"value", std::to_string(value)}};
+    };
+    data["option"] = Json::Array{
+        option("grpc.transport.min_rtt_us", latency->min_rtt_us),
+        option("grpc.transport.smoothed_rtt_us", latency->smoothed_rtt_us),
+        option("grpc.transport.rtt_variance_us", latency->rtt_variance_us),
+        option("grpc.transport.queueing_delay_us", latency->queueing_delay_us),
+        option("grpc.transport.bdp_bytes", latency->bdp_bytes),
+    };
+  }
   // Create and fill the parent object.
   Json::Object object = {
       {"ref",
@@ -301,6 +301,19 @@ class SocketNode : public BaseNode {
         const grpc_channel_args* args);
   };
 
+  // Latency of the connection as measured by the transport, e.g. from HTTP/2
+  // PING round trips. Times are in microseconds.
+  struct TransportLatency {
+    int64_t min_rtt_us = 0;
+    int64_t smoothed_rtt_us = 0;
+    int64_t rtt_variance_us = 0;
+    // How long outgoing data typically waits inside the transport before
+    // being written.
+    int64_t queueing_delay_us = 0;
+    // Bandwidth-delay product estimate, in bytes.
+    int64_t bdp_bytes = 0;
+  };
+
   SocketNode(std::string local, std::string remote, std::string name,
              RefCountedPtr<Security> security);
   ~SocketNode() override {}
@@ -320,6 +333,11 @@ class SocketNode : public BaseNode {
   void RecordKeepaliveSent() {
     keepalives_sent_.fetch_add(1, std::memory_order_relaxed);
   }
+  void RecordTransportLatency(const TransportLatency& latency);
+
+  // Returns the most recently recorded latency, or nullopt if the transport
+  // has not measured any yet.
+  absl::optional<TransportLatency> transport_latency();
 
   const std::string& remote() { return remote_; }
 
@@ -334,6 +352,8 @@ class SocketNode : public BaseNode {
   std::atomic<gpr_cycle_counter> last_remote_stream_created_cycle_{0};
   std::atomic<gpr_cycle_counter> last_message_sent_cycle_{0};
   std::atomic<gpr_cycle_counter> last_message_received_cycle_{0};
+  Mutex latency_mu_;
+  absl::optional<TransportLatency> latency_ ABSL_GUARDED_BY(latency_mu_);
   std::string local_;
   std::string remote_;
   RefCountedPtr<Security> const security_;
@@ -46,6 +46,10 @@ const char* CompressionAlgorithmAsString(grpc_compression_algorithm algorithm) {
       return "deflate";
     case GRPC_COMPRESS_GZIP:
       return "gzip";
+    case GRPC_COMPRESS_ZSTD:
+      return "zstd";
+    case GRPC_COMPRESS_LZ4:
+      return "lz4";
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
     default:
       return nullptr;
@@ -60,11 +64,39 @@ absl::optional<grpc_compression_algorithm> ParseCompressionAlgorithm(
     return GRPC_COMPRESS_DEFLATE;
   } else if (algorithm == "gzip") {
     return GRPC_COMPRESS_GZIP;
+  } else if (algorithm == "zstd") {
+    return GRPC_COMPRESS_ZSTD;
+  } else if (algorithm == "lz4") {
+    return GRPC_COMPRESS_LZ4;
   } else {
     return absl::nullopt;
   }
 }
 
+bool CompressionAlgorithmIsSupported(grpc_compression_algorithm algorithm) {
+  switch (algorithm) {
+    case GRPC_COMPRESS_NONE:
+    case GRPC_COMPRESS_DEFLATE:
+    case GRPC_COMPRESS_GZIP:
+      return true;
+    case GRPC_COMPRESS_ZSTD:
+#ifdef GRPC_HAVE_ZSTD
+      return true;
+#else
+      return false;
+#endif
+    case GRPC_COMPRESS_LZ4:
+#ifdef GRPC_HAVE_LZ4
+      return true;
+#else
+      return false;
+#endif
+    case GRPC_COMPRESS_ALGORITHMS_COUNT:
+    default:
+      return false;
+  }
+}
+
 grpc_compression_algorithm
 CompressionAlgorithmSet::CompressionAlgorithmForLevel(
     grpc_compression_level level) const {
@@ -85,12 +117,14 @@ CompressionAlgorithmSet::CompressionAlgorithmForLevel(
   /* Establish a "ranking" or compression algorithms in increasing order of
    * compression.
    * This is simplistic and we will probably want to introduce other dimensions
-   * in the future (cpu/memory cost, etc). */
+   * in the future (cpu/memory cost, etc). lz4 trades ratio for speed, zstd
+   * compresses hardest; algorithms this build cannot produce are skipped. */
   absl::InlinedVector<grpc_compression_algorithm,
                       GRPC_COMPRESS_ALGORITHMS_COUNT>
       algos;
-  for (auto algo : {GRPC_COMPRESS_GZIP, GRPC_COMPRESS_DEFLATE}) {
-    if (set_.is_set(algo)) {
+  for (auto algo : {GRPC_COMPRESS_LZ4, GRPC_COMPRESS_GZIP,
+                    GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_ZSTD}) {
+    if (set_.is_set(algo) && CompressionAlgorithmIsSupported(algo)) {
       algos.push_back(algo);
     }
   }
@@ -136,6 +170,13 @@ CompressionAlgorithmSet CompressionAlgorithmSet::FromChannelArgs(
   } else {
     set = CompressionAlgorithmSet::FromUint32(kEverything);
   }
+  // Never advertise (or accept) an algorithm this build cannot decode.
+  for (size_t i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    if (!CompressionAlgorithmIsSupported(
+            static_cast<grpc_compression_algorithm>(i))) {
+      set.set_.clear(i);
+    }
+  }
   return set;
 }
 
@@ -42,6 +42,9 @@ absl::optional<grpc_compression_algorithm> ParseCompressionAlgorithm(
 // Convert a compression algorithm to a string. Returns nullptr if a name is not
 // known.
 const char* CompressionAlgorithmAsString(grpc_compression_algorithm algorithm);
+// Return true if this build can compress and decompress with algorithm. zstd
+// and lz4 depend on optional libraries (GRPC_HAVE_ZSTD / GRPC_HAVE_LZ4).
+bool CompressionAlgorithmIsSupported(grpc_compression_algorithm algorithm);
 // Retrieve the default compression algorithm from channel args, return nullopt
 // if not found.
 absl::optional<grpc_compression_algorithm>
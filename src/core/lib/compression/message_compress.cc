@@ -22,18 +22,53 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <map>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
 #include <zlib.h>
 
+#ifdef GRPC_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef GRPC_HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/iomgr/load_file.h"
 #include "src/core/lib/slice/slice_internal.h"
 
 #define OUTPUT_BLOCK_SIZE 1024
+/* lz4 frames are produced by feeding the encoder at most this many bytes at a
+   time, bounding the size of each output slice. */
+#define LZ4_INPUT_CHUNK_SIZE (64 * 1024)
+
+/* Drop whatever was appended to output after (count_before, length_before). */
+static void truncate_output(grpc_slice_buffer* output, size_t count_before,
+                            size_t length_before) {
+  for (size_t i = count_before; i < output->count; i++) {
+    grpc_slice_unref_internal(output->slices[i]);
+  }
+  output->count = count_before;
+  output->length = length_before;
+}
 
+/* Runs all of input through flate, flushing with last_flush after the final
+   slice. Z_FINISH requires the stream to end with the input; otherwise
+   *stream_end (if given) reports whether it did. */
 static int zlib_body(z_stream* zs, grpc_slice_buffer* input,
                      grpc_slice_buffer* output,
-                     int (*flate)(z_stream* zs, int flush)) {
+                     int (*flate)(z_stream* zs, int flush), int last_flush,
+                     bool* stream_end = nullptr) {
   int r = Z_STREAM_END; /* Do not fail on an empty input. */
   int flush;
   size_t i;
@@ -45,7 +80,7 @@ static int zlib_body(z_stream* zs, grpc_slice_buffer* input,
   zs->next_out = GRPC_SLICE_START_PTR(outbuf);
   flush = Z_NO_FLUSH;
   for (i = 0; i < input->count; i++) {
-    if (i == input->count - 1) flush = Z_FINISH;
+    if (i == input->count - 1) flush = last_flush;
     GPR_ASSERT(GRPC_SLICE_LENGTH(input->slices[i]) <= uint_max);
     zs->avail_in = static_cast<uInt> GRPC_SLICE_LENGTH(input->slices[i]);
     zs->next_in = GRPC_SLICE_START_PTR(input->slices[i]);
@@ -68,10 +103,11 @@ static int zlib_body(z_stream* zs, grpc_slice_buffer* input,
       goto error;
     }
   }
-  if (r != Z_STREAM_END) {
+  if (r != Z_STREAM_END && last_flush == Z_FINISH) {
     gpr_log(GPR_INFO, "zlib: Data error");
     goto error;
   }
+  if (stream_end != nullptr) *stream_end = r == Z_STREAM_END;
 
   GPR_ASSERT(outbuf.refcount);
   outbuf.data.refcounted.length -= zs->avail_out;
@@ -95,7 +131,6 @@ static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
                          int gzip) {
   z_stream zs;
   int r;
-  size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
   memset(&zs, 0, sizeof(zs));
@@ -104,13 +139,10 @@ static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
   r = deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (gzip ? 16 : 0),
                    8, Z_DEFAULT_STRATEGY);
   GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, deflate) && output->length < input->length;
+  r = zlib_body(&zs, input, output, deflate, Z_FINISH) &&
+      output->length < input->length;
   if (!r) {
-    for (i = count_before; i < output->count; i++) {
-      grpc_slice_unref_internal(output->slices[i]);
-    }
-    output->count = count_before;
-    output->length = length_before;
+    truncate_output(output, count_before, length_before);
   }
   deflateEnd(&zs);
   return r;
@@ -120,7 +152,6 @@ static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
                            int gzip) {
   z_stream zs;
   int r;
-  size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
   memset(&zs, 0, sizeof(zs));
@@ -128,18 +159,234 @@ static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
   zs.zfree = zfree_gpr;
   r = inflateInit2(&zs, 15 | (gzip ? 16 : 0));
   GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, inflate);
+  r = zlib_body(&zs, input, output, inflate, Z_FINISH);
   if (!r) {
-    for (i = count_before; i < output->count; i++) {
-      grpc_slice_unref_internal(output->slices[i]);
-    }
-    output->count = count_before;
-    output->length = length_before;
+    truncate_output(output, count_before, length_before);
   }
   inflateEnd(&zs);
   return r;
 }
 
+#ifdef GRPC_HAVE_ZSTD
+/* Runs all of input through cctx, ending the input with last (ZSTD_e_end
+   finishes the frame, ZSTD_e_flush only flushes it). */
+static int zstd_compress_body(ZSTD_CCtx* cctx, grpc_slice_buffer* input,
+                              grpc_slice_buffer* output,
+                              ZSTD_EndDirective last) {
+  grpc_slice outbuf = GRPC_SLICE_MALLOC(OUTPUT_BLOCK_SIZE);
+  ZSTD_outBuffer out = {GRPC_SLICE_START_PTR(outbuf),
+                        GRPC_SLICE_LENGTH(outbuf), 0};
+  int r = 1;
+  for (size_t i = 0; r && i < input->count; i++) {
+    ZSTD_EndDirective mode = i == input->count - 1 ? last : ZSTD_e_continue;
+    ZSTD_inBuffer in = {GRPC_SLICE_START_PTR(input->slices[i]),
+                        GRPC_SLICE_LENGTH(input->slices[i]), 0};
+    size_t remaining;
+    do {
+      if (out.pos == out.size) {
+        grpc_slice_buffer_add_indexed(output, outbuf);
+        outbuf = GRPC_SLICE_MALLOC(OUTPUT_BLOCK_SIZE);
+        out = {GRPC_SLICE_START_PTR(outbuf), GRPC_SLICE_LENGTH(outbuf), 0};
+      }
+      remaining = ZSTD_compressStream2(cctx, &out, &in, mode);
+      if (ZSTD_isError(remaining)) {
+        gpr_log(GPR_INFO, "zstd error (%s)", ZSTD_getErrorName(remaining));
+        r = 0;
+        break;
+      }
+    } while (mode == ZSTD_e_continue ? in.pos < in.size : remaining != 0);
+  }
+  GRPC_SLICE_SET_LENGTH(outbuf, out.pos);
+  grpc_slice_buffer_add_indexed(output, outbuf);
+  return r;
+}
+
+/* Runs all of input through dctx. On return *pending is zero if the input
+   ended on a frame boundary. */
+static int zstd_decompress_body(ZSTD_DCtx* dctx, grpc_slice_buffer* input,
+                                grpc_slice_buffer* output, size_t* pending) {
+  grpc_slice outbuf = GRPC_SLICE_MALLOC(OUTPUT_BLOCK_SIZE);
+  ZSTD_outBuffer out = {GRPC_SLICE_START_PTR(outbuf),
+                        GRPC_SLICE_LENGTH(outbuf), 0};
+  /* An empty message is trivially complete. */
+  *pending = 0;
+  int r = 1;
+  for (size_t i = 0; r && i < input->count; i++) {
+    ZSTD_inBuffer in = {GRPC_SLICE_START_PTR(input->slices[i]),
+                        GRPC_SLICE_LENGTH(input->slices[i]), 0};
+    /* Keep going while input remains, or while a full output buffer may be
+       hiding more output from an unfinished frame. */
+    do {
+      if (out.pos == out.size) {
+        grpc_slice_buffer_add_indexed(output, outbuf);
+        outbuf = GRPC_SLICE_MALLOC(OUTPUT_BLOCK_SIZE);
+        out = {GRPC_SLICE_START_PTR(outbuf), GRPC_SLICE_LENGTH(outbuf), 0};
+      }
+      *pending = ZSTD_decompressStream(dctx, &out, &in);
+      if (ZSTD_isError(*pending)) {
+        gpr_log(GPR_INFO, "zstd error (%s)", ZSTD_getErrorName(*pending));
+        r = 0;
+        break;
+      }
+    } while (in.pos < in.size || (out.pos == out.size && *pending != 0));
+  }
+  GRPC_SLICE_SET_LENGTH(outbuf, out.pos);
+  grpc_slice_buffer_add_indexed(output, outbuf);
+  return r;
+}
+
+static int zstd_compress(grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  GPR_ASSERT(cctx != nullptr);
+  int r = zstd_compress_body(cctx, input, output, ZSTD_e_end) &&
+          output->length - length_before < input->length;
+  if (!r) {
+    truncate_output(output, count_before, length_before);
+  }
+  ZSTD_freeCCtx(cctx);
+  return r;
+}
+
+static int zstd_decompress(grpc_slice_buffer* input,
+                           grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  ZSTD_DCtx* dctx = ZSTD_createDCtx();
+  GPR_ASSERT(dctx != nullptr);
+  size_t pending;
+  int r = zstd_decompress_body(dctx, input, output, &pending);
+  if (r && pending != 0) {
+    gpr_log(GPR_INFO, "zstd: truncated frame");
+    r = 0;
+  }
+  if (!r) {
+    truncate_output(output, count_before, length_before);
+  }
+  ZSTD_freeDCtx(dctx);
+  return r;
+}
+#endif /* GRPC_HAVE_ZSTD */
+
+#ifdef GRPC_HAVE_LZ4
+/* Account for the n bytes an LZ4F call wrote into *buf: if any, append them to
+   output and start a fresh out_size slice. The encoder buffers input until it
+   has a full block, so most updates write nothing and *buf is reused. */
+static int lz4_take_output(size_t n, size_t out_size, grpc_slice* buf,
+                           grpc_slice_buffer* output) {
+  if (LZ4F_isError(n)) {
+    gpr_log(GPR_INFO, "lz4 error (%s)", LZ4F_getErrorName(n));
+    return 0;
+  }
+  if (n > 0) {
+    GRPC_SLICE_SET_LENGTH(*buf, n);
+    grpc_slice_buffer_add_indexed(output, *buf);
+    *buf = GRPC_SLICE_MALLOC(out_size);
+  }
+  return 1;
+}
+
+/* Appends input to output as one lz4 frame. */
+static int lz4_compress_frame(grpc_slice_buffer* input,
+                              grpc_slice_buffer* output) {
+  LZ4F_cctx* cctx;
+  GPR_ASSERT(
+      !LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION)));
+  LZ4F_preferences_t prefs;
+  memset(&prefs, 0, sizeof(prefs));
+  prefs.frameInfo.contentSize = input->length;
+  /* Large enough for the frame header, any single update and the trailer. */
+  const size_t out_size = LZ4F_compressBound(LZ4_INPUT_CHUNK_SIZE, &prefs);
+  grpc_slice buf = GRPC_SLICE_MALLOC(out_size);
+  int r = lz4_take_output(
+      LZ4F_compressBegin(cctx, GRPC_SLICE_START_PTR(buf), out_size, &prefs),
+      out_size, &buf, output);
+  for (size_t i = 0; r && i < input->count; i++) {
+    const uint8_t* src = GRPC_SLICE_START_PTR(input->slices[i]);
+    size_t remaining = GRPC_SLICE_LENGTH(input->slices[i]);
+    while (r && remaining > 0) {
+      size_t chunk = std::min<size_t>(remaining, LZ4_INPUT_CHUNK_SIZE);
+      r = lz4_take_output(
+          LZ4F_compressUpdate(cctx, GRPC_SLICE_START_PTR(buf), out_size, src,
+                              chunk, nullptr),
+          out_size, &buf, output);
+      src += chunk;
+      remaining -= chunk;
+    }
+  }
+  if (r) {
+    r = lz4_take_output(LZ4F_compressEnd(cctx, GRPC_SLICE_START_PTR(buf),
+                                         out_size, nullptr),
+                        out_size, &buf, output);
+  }
+  grpc_slice_unref_internal(buf);
+  LZ4F_freeCompressionContext(cctx);
+  return r;
+}
+
+static int lz4_compress(grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  int r = lz4_compress_frame(input, output) &&
+          output->length - length_before < input->length;
+  if (!r) {
+    truncate_output(output, count_before, length_before);
+  }
+  return r;
+}
+
+static int lz4_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  LZ4F_dctx* dctx;
+  GPR_ASSERT(!LZ4F_isError(
+      LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION)));
+  grpc_slice outbuf = GRPC_SLICE_MALLOC(OUTPUT_BLOCK_SIZE);
+  size_t out_pos = 0;
+  /* Non-zero while a frame is partially decoded; an empty message is
+     trivially complete. */
+  size_t pending = 0;
+  int r = 1;
+  for (size_t i = 0; r && i < input->count; i++) {
+    const uint8_t* src = GRPC_SLICE_START_PTR(input->slices[i]);
+    size_t remaining = GRPC_SLICE_LENGTH(input->slices[i]);
+    do {
+      if (out_pos == GRPC_SLICE_LENGTH(outbuf)) {
+        grpc_slice_buffer_add_indexed(output, outbuf);
+        outbuf = GRPC_SLICE_MALLOC(OUTPUT_BLOCK_SIZE);
+        out_pos = 0;
+      }
+      size_t dst_size = GRPC_SLICE_LENGTH(outbuf) - out_pos;
+      size_t src_size = remaining;
+      pending =
+          LZ4F_decompress(dctx, GRPC_SLICE_START_PTR(outbuf) + out_pos,
+                          &dst_size, src, &src_size, nullptr);
+      if (LZ4F_isError(pending)) {
+        gpr_log(GPR_INFO, "lz4 error (%s)", LZ4F_getErrorName(pending));
+        r = 0;
+        break;
+      }
+      src += src_size;
+      remaining -= src_size;
+      out_pos += dst_size;
+    } while (remaining > 0 ||
+             (out_pos == GRPC_SLICE_LENGTH(outbuf) && pending != 0));
+  }
+  if (r && pending != 0) {
+    gpr_log(GPR_INFO, "lz4: truncated frame");
+    r = 0;
+  }
+  GRPC_SLICE_SET_LENGTH(outbuf, out_pos);
+  grpc_slice_buffer_add_indexed(output, outbuf);
+  if (!r) {
+    truncate_output(output, count_before, length_before);
+  }
+  LZ4F_freeDecompressionContext(dctx);
+  return r;
+}
+#endif /* GRPC_HAVE_LZ4 */
+
 static int copy(grpc_slice_buffer* input, grpc_slice_buffer* output) {
   size_t i;
   for (i = 0; i < input->count; i++) {
@@ -159,6 +406,18 @@ static int compress_inner(grpc_compression_algorithm algorithm,
       return zlib_compress(input, output, 0);
     case GRPC_COMPRESS_GZIP:
       return zlib_compress(input, output, 1);
+    case GRPC_COMPRESS_ZSTD:
+#ifdef GRPC_HAVE_ZSTD
+      return zstd_compress(input, output);
+#else
+      return 0;
+#endif
+    case GRPC_COMPRESS_LZ4:
+#ifdef GRPC_HAVE_LZ4
+      return lz4_compress(input, output);
+#else
+      return 0;
+#endif
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       break;
   }
@@ -184,9 +443,672 @@ int grpc_msg_decompress(grpc_compression_algorithm algorithm,
       return zlib_decompress(input, output, 0);
     case GRPC_COMPRESS_GZIP:
       return zlib_decompress(input, output, 1);
+    case GRPC_COMPRESS_ZSTD:
+#ifdef GRPC_HAVE_ZSTD
+      return zstd_decompress(input, output);
+#else
+      gpr_log(GPR_ERROR, "zstd decompression not supported by this build");
+      return 0;
+#endif
+    case GRPC_COMPRESS_LZ4:
+#ifdef GRPC_HAVE_LZ4
+      return lz4_decompress(input, output);
+#else
+      gpr_log(GPR_ERROR, "lz4 decompression not supported by this build");
+      return 0;
+#endif
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       break;
   }
   gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
   return 0;
 }
+
+namespace grpc_core {
+namespace {
+
+int ZlibWindowBits(grpc_compression_algorithm algorithm) {
+  return 15 | (algorithm == GRPC_COMPRESS_GZIP ? 16 : 0);
+}
+
+// A message flushed with Z_SYNC_FLUSH ends with an empty stored block; a
+// message without it (and without the end of the stream) was truncated.
+bool EndsWithZlibSyncFlush(const grpc_slice_buffer* input) {
+  static const uint8_t kMarker[] = {0x00, 0x00, 0xff, 0xff};
+  size_t matched = 0;
+  for (size_t i = input->count; i > 0 && matched < sizeof(kMarker); i--) {
+    const grpc_slice& slice = input->slices[i - 1];
+    const uint8_t* p = GRPC_SLICE_END_PTR(slice);
+    for (size_t n = GRPC_SLICE_LENGTH(slice);
+         n > 0 && matched < sizeof(kMarker); n--) {
+      if (*--p != kMarker[sizeof(kMarker) - 1 - matched]) return false;
+      matched++;
+    }
+  }
+  return matched == sizeof(kMarker);
+}
+
+class ZlibMessageCompressor final : public MessageCompressor {
+ public:
+  explicit ZlibMessageCompressor(grpc_compression_algorithm algorithm)
+      : MessageCompressor(algorithm) {
+    memset(&zs_, 0, sizeof(zs_));
+    zs_.zalloc = zalloc_gpr;
+    zs_.zfree = zfree_gpr;
+    GPR_ASSERT(deflateInit2(&zs_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                            ZlibWindowBits(algorithm), 8,
+                            Z_DEFAULT_STRATEGY) == Z_OK);
+  }
+
+  ~ZlibMessageCompressor() override { deflateEnd(&zs_); }
+
+  bool Compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
+                bool keep_history) override {
+    size_t count_before = output->count;
+    size_t length_before = output->length;
+    bool ok = zlib_body(&zs_, input, output, deflate,
+                        keep_history ? Z_SYNC_FLUSH : Z_FINISH);
+    if (!keep_history) {
+      deflateReset(&zs_);
+      ok = ok && output->length - length_before < input->length;
+    }
+    if (!ok) {
+      truncate_output(output, count_before, length_before);
+    }
+    return ok;
+  }
+
+  void Reset() override { deflateReset(&zs_); }
+
+ private:
+  z_stream zs_;
+};
+
+class ZlibMessageDecompressor final : public MessageDecompressor {
+ public:
+  explicit ZlibMessageDecompressor(grpc_compression_algorithm algorithm)
+      : MessageDecompressor(algorithm) {
+    memset(&zs_, 0, sizeof(zs_));
+    zs_.zalloc = zalloc_gpr;
+    zs_.zfree = zfree_gpr;
+    GPR_ASSERT(inflateInit2(&zs_, ZlibWindowBits(algorithm)) == Z_OK);
+  }
+
+  ~ZlibMessageDecompressor() override { inflateEnd(&zs_); }
+
+  bool Decompress(grpc_slice_buffer* input,
+                  grpc_slice_buffer* output) override {
+    if (input->length == 0) return true;
+    size_t count_before = output->count;
+    size_t length_before = output->length;
+    bool stream_end = false;
+    bool ok = zlib_body(&zs_, input, output, inflate, Z_SYNC_FLUSH,
+                        &stream_end);
+    if (ok && !stream_end && !EndsWithZlibSyncFlush(input)) {
+      gpr_log(GPR_INFO, "zlib: truncated message");
+      ok = false;
+    }
+    // A message compressed on its own ends the zlib stream; the next one
+    // starts a new stream.
+    if (stream_end) inflateReset(&zs_);
+    if (!ok) {
+      truncate_output(output, count_before, length_before);
+    }
+    return ok;
+  }
+
+  void Reset() override { inflateReset(&zs_); }
+
+ private:
+  z_stream zs_;
+};
+
+#ifdef GRPC_HAVE_ZSTD
+// Size of a zstd block header (RFC 8878, section 3.1.1.2); zstd.h only
+// exports it to static linkers.
+constexpr size_t kZstdBlockHeaderSize = 3;
+
+// The most a zstd frame header takes (RFC 8878, section 3.1.1.1).
+constexpr size_t kZstdFrameHeaderMaxSize = 18;
+
+class ZstdMessageCompressor final : public MessageCompressor {
+ public:
+  explicit ZstdMessageCompressor(
+      RefCountedPtr<ZstdDictionary> dictionary = nullptr,
+      const ZSTD_CDict* cdict = nullptr)
+      : MessageCompressor(GRPC_COMPRESS_ZSTD),
+        cctx_(ZSTD_createCCtx()),
+        dictionary_(std::move(dictionary)) {
+    GPR_ASSERT(cctx_ != nullptr);
+    if (cdict != nullptr) ZSTD_CCtx_refCDict(cctx_, cdict);
+  }
+
+  ~ZstdMessageCompressor() override { ZSTD_freeCCtx(cctx_); }
+
+  bool Compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
+                bool keep_history) override {
+    // Messages compressed against a dictionary each end their frame, which
+    // names the dictionary.
+    if (dictionary_ != nullptr) keep_history = false;
+    size_t count_before = output->count;
+    size_t length_before = output->length;
+    if (!keep_history) ZSTD_CCtx_setPledgedSrcSize(cctx_, input->length);
+    bool ok = zstd_compress_body(cctx_, input, output,
+                                 keep_history ? ZSTD_e_flush : ZSTD_e_end);
+    if (!keep_history) {
+      ok = ok && output->length - length_before < input->length;
+    }
+    if (!ok) {
+      truncate_output(output, count_before, length_before);
+      Reset();
+    }
+    return ok;
+  }
+
+  // Keeps the dictionary, if any.
+  void Reset() override { ZSTD_CCtx_reset(cctx_, ZSTD_reset_session_only); }
+
+ private:
+  ZSTD_CCtx* const cctx_;
+  // Keeps the CDict the context refers to alive.
+  const RefCountedPtr<ZstdDictionary> dictionary_;
+};
+
+class ZstdMessageDecompressor final : public MessageDecompressor {
+ public:
+  explicit ZstdMessageDecompressor(
+      RefCountedPtr<ZstdDictionary> dictionary = nullptr,
+      const ZSTD_DDict* ddict = nullptr)
+      : MessageDecompressor(GRPC_COMPRESS_ZSTD),
+        dctx_(ZSTD_createDCtx()),
+        dictionary_(std::move(dictionary)) {
+    GPR_ASSERT(dctx_ != nullptr);
+    if (ddict != nullptr) ZSTD_DCtx_refDDict(dctx_, ddict);
+  }
+
+  ~ZstdMessageDecompressor() override { ZSTD_freeDCtx(dctx_); }
+
+  bool Decompress(grpc_slice_buffer* input,
+                  grpc_slice_buffer* output) override {
+    if (input->length == 0) return true;
+    size_t count_before = output->count;
+    size_t length_before = output->length;
+    // A message compressed on its own ends its frame; a flushed one leaves
+    // the frame open for the next message, between two blocks, where the
+    // decoder asks for no more than the next block's header. Anything else
+    // stopped part way through a header or block: the message was truncated.
+    // Messages compressed against a dictionary always end their frame.
+    size_t pending;
+    bool ok = zstd_decompress_body(dctx_, input, output, &pending);
+    if (ok && pending != 0 &&
+        (dictionary_ != nullptr || pending != kZstdBlockHeaderSize)) {
+      gpr_log(GPR_INFO, "zstd: truncated message");
+      ok = false;
+    }
+    if (!ok) {
+      truncate_output(output, count_before, length_before);
+    }
+    return ok;
+  }
+
+  // Keeps the dictionary, if any.
+  void Reset() override { ZSTD_DCtx_reset(dctx_, ZSTD_reset_session_only); }
+
+ private:
+  ZSTD_DCtx* const dctx_;
+  // Keeps the DDict the context refers to alive.
+  const RefCountedPtr<ZstdDictionary> dictionary_;
+};
+#endif /* GRPC_HAVE_ZSTD */
+
+}  // namespace
+
+std::unique_ptr<MessageCompressor> MessageCompressor::Create(
+    grpc_compression_algorithm algorithm) {
+  switch (algorithm) {
+    case GRPC_COMPRESS_DEFLATE:
+    case GRPC_COMPRESS_GZIP:
+      return absl::make_unique<ZlibMessageCompressor>(algorithm);
+#ifdef GRPC_HAVE_ZSTD
+    case GRPC_COMPRESS_ZSTD:
+      return absl::make_unique<ZstdMessageCompressor>();
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+std::unique_ptr<MessageDecompressor> MessageDecompressor::Create(
+    grpc_compression_algorithm algorithm) {
+  switch (algorithm) {
+    case GRPC_COMPRESS_DEFLATE:
+    case GRPC_COMPRESS_GZIP:
+      return absl::make_unique<ZlibMessageDecompressor>(algorithm);
+#ifdef GRPC_HAVE_ZSTD
+    case GRPC_COMPRESS_ZSTD:
+      return absl::make_unique<ZstdMessageDecompressor>();
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+bool ChunkedMessageCompressor::IsSupported(
+    grpc_compression_algorithm algorithm) {
+  switch (algorithm) {
+    case GRPC_COMPRESS_DEFLATE:
+    case GRPC_COMPRESS_GZIP:
+      return true;
+    case GRPC_COMPRESS_ZSTD:
+    case GRPC_COMPRESS_LZ4:
+      return CompressionAlgorithmIsSupported(algorithm);
+    default:
+      return false;
+  }
+}
+
+ChunkedMessageCompressor::Chunk::Chunk() {
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&output);
+}
+
+ChunkedMessageCompressor::Chunk::~Chunk() {
+  grpc_slice_buffer_destroy_internal(&input);
+  grpc_slice_buffer_destroy_internal(&output);
+}
+
+ChunkedMessageCompressor::ChunkedMessageCompressor(
+    grpc_compression_algorithm algorithm, const grpc_slice_buffer* input,
+    size_t chunk_size)
+    : algorithm_(algorithm),
+      input_(input),
+      num_chunks_(std::max<size_t>(
+          1, (input->length + chunk_size - 1) / chunk_size)),
+      chunks_(new Chunk[num_chunks_]) {
+  GPR_ASSERT(IsSupported(algorithm));
+  GPR_ASSERT(chunk_size > 0);
+  // Chunks refer to the message's slices rather than copying them.
+  size_t index = 0;
+  for (size_t i = 0; i < input->count; i++) {
+    const grpc_slice& slice = input->slices[i];
+    size_t offset = 0;
+    while (offset < GRPC_SLICE_LENGTH(slice)) {
+      if (chunks_[index].input.length == chunk_size) index++;
+      size_t n = std::min(GRPC_SLICE_LENGTH(slice) - offset,
+                          chunk_size - chunks_[index].input.length);
+      grpc_slice_buffer_add(&chunks_[index].input,
+                            grpc_slice_sub(slice, offset, offset + n));
+      offset += n;
+    }
+  }
+}
+
+void ChunkedMessageCompressor::CompressChunk(size_t index) {
+  Chunk& chunk = chunks_[index];
+  const bool last = index == num_chunks_ - 1;
+  switch (algorithm_) {
+    case GRPC_COMPRESS_DEFLATE:
+    case GRPC_COMPRESS_GZIP: {
+      // Raw deflate data, spliced into one stream by Finish(): only the last
+      // chunk ends the stream, the others end on a byte boundary.
+      z_stream zs;
+      memset(&zs, 0, sizeof(zs));
+      zs.zalloc = zalloc_gpr;
+      zs.zfree = zfree_gpr;
+      GPR_ASSERT(deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+                              Z_DEFAULT_STRATEGY) == Z_OK);
+      chunk.ok = zlib_body(&zs, &chunk.input, &chunk.output, deflate,
+                           last ? Z_FINISH : Z_SYNC_FLUSH);
+      deflateEnd(&zs);
+      const bool gzip = algorithm_ == GRPC_COMPRESS_GZIP;
+      uLong check = gzip ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0);
+      for (size_t i = 0; i < chunk.input.count; i++) {
+        const grpc_slice& slice = chunk.input.slices[i];
+        const uInt length = static_cast<uInt>(GRPC_SLICE_LENGTH(slice));
+        check = gzip ? crc32(check, GRPC_SLICE_START_PTR(slice), length)
+                     : adler32(check, GRPC_SLICE_START_PTR(slice), length);
+      }
+      chunk.check = static_cast<uint32_t>(check);
+      break;
+    }
+    case GRPC_COMPRESS_ZSTD: {
+#ifdef GRPC_HAVE_ZSTD
+      // Concatenated zstd frames decompress as one message.
+      ZSTD_CCtx* cctx = ZSTD_createCCtx();
+      GPR_ASSERT(cctx != nullptr);
+      ZSTD_CCtx_setPledgedSrcSize(cctx, chunk.input.length);
+      chunk.ok = zstd_compress_body(cctx, &chunk.input, &chunk.output,
+                                    ZSTD_e_end);
+      ZSTD_freeCCtx(cctx);
+#endif
+      break;
+    }
+    case GRPC_COMPRESS_LZ4:
+#ifdef GRPC_HAVE_LZ4
+      // So do concatenated lz4 frames.
+      chunk.ok = lz4_compress_frame(&chunk.input, &chunk.output);
+#endif
+      break;
+    default:
+      GPR_UNREACHABLE_CODE(break);
+  }
+}
+
+bool ChunkedMessageCompressor::Finish(grpc_slice_buffer* output) {
+  size_t compressed_length = 0;
+  bool ok = true;
+  for (size_t i = 0; i < num_chunks_; i++) {
+    ok = ok && chunks_[i].ok;
+    compressed_length += chunks_[i].output.length;
+  }
+  if (!ok || compressed_length >= input_->length) {
+    copy(const_cast<grpc_slice_buffer*>(input_), output);
+    return false;
+  }
+  if (algorithm_ == GRPC_COMPRESS_DEFLATE || algorithm_ == GRPC_COMPRESS_GZIP) {
+    // Wrap the deflate data the way deflate() would have: a zlib or gzip
+    // header, and a trailer with the check value of the whole message.
+    uLong check = chunks_[0].check;
+    for (size_t i = 1; i < num_chunks_; i++) {
+      const z_off_t length = static_cast<z_off_t>(chunks_[i].input.length);
+      check = algorithm_ == GRPC_COMPRESS_GZIP
+                  ? crc32_combine(check, chunks_[i].check, length)
+                  : adler32_combine(check, chunks_[i].check, length);
+    }
+    if (algorithm_ == GRPC_COMPRESS_GZIP) {
+      static const uint8_t kGzipHeader[] = {0x1f, 0x8b, 0x08, 0x00, 0x00,
+                                            0x00, 0x00, 0x00, 0x00, 0x03};
+      grpc_slice_buffer_add(
+          output, grpc_slice_from_copied_buffer(
+                      reinterpret_cast<const char*>(kGzipHeader),
+                      sizeof(kGzipHeader)));
+    } else {
+      static const uint8_t kZlibHeader[] = {0x78, 0x9c};
+      grpc_slice_buffer_add(
+          output, grpc_slice_from_copied_buffer(
+                      reinterpret_cast<const char*>(kZlibHeader),
+                      sizeof(kZlibHeader)));
+    }
+    for (size_t i = 0; i < num_chunks_; i++) {
+      grpc_slice_buffer_move_into(&chunks_[i].output, output);
+    }
+    uint8_t trailer[8];
+    size_t trailer_length;
+    if (algorithm_ == GRPC_COMPRESS_GZIP) {
+      // CRC-32 and the length modulo 2^32, little-endian.
+      const uint32_t length = static_cast<uint32_t>(input_->length);
+      for (size_t i = 0; i < 4; i++) {
+        trailer[i] = static_cast<uint8_t>(check >> (8 * i));
+        trailer[4 + i] = static_cast<uint8_t>(length >> (8 * i));
+      }
+      trailer_length = 8;
+    } else {
+      // Adler-32, big-endian.
+      for (size_t i = 0; i < 4; i++) {
+        trailer[i] = static_cast<uint8_t>(check >> (8 * (3 - i)));
+      }
+      trailer_length = 4;
+    }
+    grpc_slice_buffer_add(output, grpc_slice_from_copied_buffer(
+                                      reinterpret_cast<const char*>(trailer),
+                                      trailer_length));
+  } else {
+    for (size_t i = 0; i < num_chunks_; i++) {
+      grpc_slice_buffer_move_into(&chunks_[i].output, output);
+    }
+  }
+  return true;
+}
+
+bool MethodCompressibility::ShouldCompress(
+    grpc_compression_algorithm algorithm, const grpc_slice_buffer* message,
+    MessageCompressor* compressor, bool keep_history) {
+  const uint32_t ratio = ratio_.load(std::memory_order_relaxed);
+  if (ratio != kUnknownRatio && ratio > kMaxWorthwhileRatio &&
+      skipped_.fetch_add(1, std::memory_order_relaxed) % kProbeInterval !=
+          kProbeInterval - 1) {
+    return false;
+  }
+  if (message->length < kMinSampledMessageSize || keep_history) return true;
+  // The sample refers to the message's slices rather than copying them.
+  grpc_slice_buffer sample;
+  grpc_slice_buffer_init(&sample);
+  for (size_t i = 0; i < message->count && sample.length < kSampleSize; i++) {
+    const grpc_slice& slice = message->slices[i];
+    size_t n = std::min(GRPC_SLICE_LENGTH(slice), kSampleSize - sample.length);
+    grpc_slice_buffer_add(&sample, grpc_slice_sub(slice, 0, n));
+  }
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer_init(&compressed);
+  const bool shrank =
+      compressor != nullptr
+          ? compressor->Compress(&sample, &compressed, false)
+          : grpc_msg_compress(algorithm, &sample, &compressed) != 0;
+  const size_t sample_size = sample.length;
+  const size_t compressed_size = shrank ? compressed.length : sample_size;
+  grpc_slice_buffer_destroy_internal(&sample);
+  grpc_slice_buffer_destroy_internal(&compressed);
+  if (compressed_size * 1024 > sample_size * kMaxWorthwhileRatio) {
+    Record(sample_size, compressed_size);
+    return false;
+  }
+  return true;
+}
+
+void MethodCompressibility::Record(size_t input_size, size_t output_size) {
+  if (input_size == 0) return;
+  const uint32_t ratio = static_cast<uint32_t>(
+      std::min<size_t>(output_size * 1024 / input_size, 1024));
+  const uint32_t old_ratio = ratio_.load(std::memory_order_relaxed);
+  // The latest message weighs a quarter, so that a few messages are enough
+  // to notice that a method's payloads changed.
+  ratio_.store(old_ratio == kUnknownRatio ? ratio : (3 * old_ratio + ratio) / 4,
+               std::memory_order_relaxed);
+}
+
+RefCountedPtr<MethodCompressibility> CompressibilityByMethod::Get(
+    absl::string_view method) {
+  std::string key(method);
+  MutexLock lock(&mu_);
+  auto it = methods_.find(key);
+  if (it != methods_.end()) return it->second;
+  if (methods_.size() >= kMaxMethods) {
+    if (other_methods_ == nullptr) {
+      other_methods_ = MakeRefCounted<MethodCompressibility>();
+    }
+    return other_methods_;
+  }
+  auto compressibility = MakeRefCounted<MethodCompressibility>();
+  methods_.emplace(std::move(key), compressibility);
+  return compressibility;
+}
+
+#ifdef GRPC_HAVE_ZSTD
+namespace {
+
+// The dictionaries still in use, by path. Channels configured with the same
+// file share one copy of it, which is freed along with the last of them.
+struct LoadedZstdDictionaries {
+  Mutex mu;
+  std::map<std::string, ZstdDictionary*> by_path ABSL_GUARDED_BY(mu);
+};
+
+LoadedZstdDictionaries* loaded_zstd_dictionaries() {
+  static auto* loaded = new LoadedZstdDictionaries();
+  return loaded;
+}
+
+}  // namespace
+#endif /* GRPC_HAVE_ZSTD */
+
+absl::StatusOr<RefCountedPtr<ZstdDictionary>> ZstdDictionary::Load(
+    const std::string& path) {
+#ifdef GRPC_HAVE_ZSTD
+  LoadedZstdDictionaries* loaded = loaded_zstd_dictionaries();
+  MutexLock lock(&loaded->mu);
+  auto it = loaded->by_path.find(path);
+  // A dictionary whose last ref is going away is about to leave the map.
+  if (it != loaded->by_path.end()) {
+    RefCountedPtr<ZstdDictionary> dictionary = it->second->RefIfNonZero();
+    if (dictionary != nullptr) return dictionary;
+  }
+  grpc_slice contents;
+  grpc_error_handle error = grpc_load_file(path.c_str(), 0, &contents);
+  if (error != GRPC_ERROR_NONE) {
+    absl::Status status = absl::InvalidArgumentError(
+        absl::StrCat("failed to load zstd dictionary ", path, ": ",
+                     grpc_error_std_string(error)));
+    GRPC_ERROR_UNREF(error);
+    return status;
+  }
+  const void* data = GRPC_SLICE_START_PTR(contents);
+  const size_t size = GRPC_SLICE_LENGTH(contents);
+  // Raw content has no id to name it by on the wire.
+  const uint32_t id = ZSTD_getDictID_fromDict(data, size);
+  if (id == 0) {
+    grpc_slice_unref_internal(contents);
+    return absl::InvalidArgumentError(
+        absl::StrCat(path, " is not a zstd dictionary"));
+  }
+  ZSTD_CDict* cdict = ZSTD_createCDict(data, size, ZSTD_CLEVEL_DEFAULT);
+  ZSTD_DDict* ddict = ZSTD_createDDict(data, size);
+  grpc_slice_unref_internal(contents);
+  if (cdict == nullptr || ddict == nullptr) {
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+    return absl::InvalidArgumentError(
+        absl::StrCat(path, " is not a valid zstd dictionary"));
+  }
+  RefCountedPtr<ZstdDictionary> dictionary(
+      new ZstdDictionary(path, id, cdict, ddict));
+  loaded->by_path[path] = dictionary.get();
+  return dictionary;
+#else
+  return absl::UnimplementedError(absl::StrCat(
+      "cannot load zstd dictionary ", path, ": zstd not supported by this "
+      "build"));
+#endif
+}
+
+uint32_t ZstdDictionary::IdOfMessage(const grpc_slice_buffer* message) {
+#ifdef GRPC_HAVE_ZSTD
+  char header[kZstdFrameHeaderMaxSize];
+  size_t size = 0;
+  for (size_t i = 0; i < message->count && size < sizeof(header); i++) {
+    const size_t n = std::min(sizeof(header) - size,
+                              GRPC_SLICE_LENGTH(message->slices[i]));
+    memcpy(header + size, GRPC_SLICE_START_PTR(message->slices[i]), n);
+    size += n;
+  }
+  return ZSTD_getDictID_fromFrame(header, size);
+#else
+  return 0;
+#endif
+}
+
+ZstdDictionary::~ZstdDictionary() {
+#ifdef GRPC_HAVE_ZSTD
+  LoadedZstdDictionaries* loaded = loaded_zstd_dictionaries();
+  {
+    MutexLock lock(&loaded->mu);
+    // Load() may already have replaced us.
+    auto it = loaded->by_path.find(path_);
+    if (it != loaded->by_path.end() && it->second == this) {
+      loaded->by_path.erase(it);
+    }
+  }
+  ZSTD_freeCDict(cdict_);
+  ZSTD_freeDDict(ddict_);
+#endif
+}
+
+std::unique_ptr<MessageCompressor> ZstdDictionary::CreateCompressor() {
+#ifdef GRPC_HAVE_ZSTD
+  return absl::make_unique<ZstdMessageCompressor>(Ref(), cdict_);
+#else
+  return nullptr;
+#endif
+}
+
+std::unique_ptr<MessageDecompressor> ZstdDictionary::CreateDecompressor() {
+#ifdef GRPC_HAVE_ZSTD
+  return absl::make_unique<ZstdMessageDecompressor>(Ref(), ddict_);
+#else
+  return nullptr;
+#endif
+}
+
+namespace {
+
+// Not a grpc.internal. arg: preconditioning drops those after its stages.
+const char kZstdDictionarySetArg[] =
+    "grpc.experimental.compression_zstd_dictionary_set";
+
+void* zstd_dictionary_set_copy(void* p) {
+  return static_cast<ZstdDictionarySet*>(p)->Ref().release();
+}
+
+void zstd_dictionary_set_destroy(void* p) {
+  static_cast<ZstdDictionarySet*>(p)->Unref();
+}
+
+// Channels configured with the same files get the same dictionaries, so
+// compare those rather than the sets: the channels can share subchannels.
+int zstd_dictionary_set_cmp(void* p, void* q) {
+  const auto& a = static_cast<ZstdDictionarySet*>(p)->dictionaries();
+  const auto& b = static_cast<ZstdDictionarySet*>(q)->dictionaries();
+  if (a.size() != b.size()) return QsortCompare(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    int r = QsortCompare(a[i].get(), b[i].get());
+    if (r != 0) return r;
+  }
+  return 0;
+}
+
+const grpc_arg_pointer_vtable zstd_dictionary_set_vtable = {
+    zstd_dictionary_set_copy, zstd_dictionary_set_destroy,
+    zstd_dictionary_set_cmp};
+
+}  // namespace
+
+const grpc_channel_args* ZstdDictionarySet::LoadFromChannelArgs(
+    const grpc_channel_args* args) {
+  const char* paths = grpc_channel_args_find_string(
+      args, GRPC_COMPRESSION_CHANNEL_ZSTD_DICTIONARIES);
+  if (paths == nullptr ||
+      grpc_channel_args_find(args, kZstdDictionarySetArg) != nullptr) {
+    return grpc_channel_args_copy(args);
+  }
+  std::vector<RefCountedPtr<ZstdDictionary>> dictionaries;
+  for (absl::string_view path :
+       absl::StrSplit(paths, ',', absl::SkipWhitespace())) {
+    auto dictionary =
+        ZstdDictionary::Load(std::string(absl::StripAsciiWhitespace(path)));
+    if (!dictionary.ok()) {
+      gpr_log(GPR_ERROR, "%s", dictionary.status().ToString().c_str());
+      continue;
+    }
+    dictionaries.push_back(std::move(*dictionary));
+  }
+  if (dictionaries.empty()) return grpc_channel_args_copy(args);
+  auto set = MakeRefCounted<ZstdDictionarySet>(std::move(dictionaries));
+  grpc_arg arg = grpc_channel_arg_pointer_create(
+      const_cast<char*>(kZstdDictionarySetArg), set.get(),
+      &zstd_dictionary_set_vtable);
+  return grpc_channel_args_copy_and_add(args, &arg, 1);
+}
+
+ZstdDictionarySet* ZstdDictionarySet::GetFromChannelArgs(
+    const grpc_channel_args* args) {
+  return grpc_channel_args_find_pointer<ZstdDictionarySet>(
+      args, kZstdDictionarySetArg);
+}
+
+ZstdDictionary* ZstdDictionarySet::Find(uint32_t id) const {
+  for (const auto& dictionary : dictionaries_) {
+    if (dictionary->id() == id) return dictionary.get();
+  }
+  return nullptr;
+}
+
+}  // namespace grpc_core
@@ -21,9 +21,24 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
 #include <grpc/slice_buffer.h>
 
 #include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
 
 /* compress 'input' to 'output' using 'algorithm'.
    On success, appends compressed slices to output and returns 1.
@@ -37,4 +52,279 @@ int grpc_msg_compress(grpc_compression_algorithm algorithm,
 int grpc_msg_decompress(grpc_compression_algorithm algorithm,
                         grpc_slice_buffer* input, grpc_slice_buffer* output);
 
+namespace grpc_core {
+
+// Compresses the messages of one stream with a single zlib or zstd context
+// that is reset, rather than recreated, between messages.
+//
+// With keep_history, a message is flushed instead of finished: the context
+// keeps its window, so later messages on the stream can refer back to
+// earlier ones. The peer must then decompress every message of the stream
+// with one MessageDecompressor, and once a stream has used keep_history it
+// must keep using it until Reset().
+class MessageCompressor {
+ public:
+  // Returns nullptr if algorithm cannot keep a context in this build.
+  static std::unique_ptr<MessageCompressor> Create(
+      grpc_compression_algorithm algorithm);
+
+  virtual ~MessageCompressor() = default;
+
+  grpc_compression_algorithm algorithm() const { return algorithm_; }
+
+  // Appends the compressed message to output and returns true. Returns false
+  // and leaves output unchanged if the message should be sent uncompressed
+  // instead: without keep_history that is when compression does not shrink
+  // it; with keep_history it only happens on error, after which the stream
+  // cannot carry further compressed messages.
+  virtual bool Compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
+                        bool keep_history) = 0;
+  // Drops all history so the compressor can start a new stream.
+  virtual void Reset() = 0;
+
+ protected:
+  explicit MessageCompressor(grpc_compression_algorithm algorithm)
+      : algorithm_(algorithm) {}
+
+ private:
+  const grpc_compression_algorithm algorithm_;
+};
+
+// Decompresses the messages of one stream with a single context. Accepts
+// both messages compressed on their own (as by grpc_msg_compress) and
+// messages written by a MessageCompressor with keep_history.
+class MessageDecompressor {
+ public:
+  // Returns nullptr if algorithm cannot keep a context in this build.
+  static std::unique_ptr<MessageDecompressor> Create(
+      grpc_compression_algorithm algorithm);
+
+  virtual ~MessageDecompressor() = default;
+
+  grpc_compression_algorithm algorithm() const { return algorithm_; }
+
+  // On success, appends the message to output and returns true. On failure,
+  // output is unchanged and the stream cannot be decompressed any further.
+  virtual bool Decompress(grpc_slice_buffer* input,
+                          grpc_slice_buffer* output) = 0;
+  // Drops all history so the decompressor can start a new stream.
+  virtual void Reset() = 0;
+
+ protected:
+  explicit MessageDecompressor(grpc_compression_algorithm algorithm)
+      : algorithm_(algorithm) {}
+
+ private:
+  const grpc_compression_algorithm algorithm_;
+};
+
+// Idle MessageCompressors or MessageDecompressors, shared by the calls on a
+// channel so that a new stream reuses an existing context.
+template <typename Context>
+class MessageCompressionContextPool {
+ public:
+  // Returns nullptr if algorithm cannot keep a context in this build.
+  std::unique_ptr<Context> Get(grpc_compression_algorithm algorithm) {
+    if (algorithm >= GRPC_COMPRESS_ALGORITHMS_COUNT) return nullptr;
+    {
+      MutexLock lock(&mu_);
+      auto& idle = idle_[algorithm];
+      if (!idle.empty()) {
+        std::unique_ptr<Context> context = std::move(idle.back());
+        idle.pop_back();
+        return context;
+      }
+    }
+    return Context::Create(algorithm);
+  }
+
+  // Resets context and keeps it for a later Get().
+  void Return(std::unique_ptr<Context> context) {
+    if (context == nullptr) return;
+    context->Reset();
+    MutexLock lock(&mu_);
+    auto& idle = idle_[context->algorithm()];
+    if (idle.size() < kMaxIdlePerAlgorithm) idle.push_back(std::move(context));
+  }
+
+ private:
+  // zlib contexts hold a few hundred KB each; don't keep more than a burst's
+  // worth alive.
+  static constexpr size_t kMaxIdlePerAlgorithm = 8;
+
+  Mutex mu_;
+  std::vector<std::unique_ptr<Context>> idle_[GRPC_COMPRESS_ALGORITHMS_COUNT]
+      ABSL_GUARDED_BY(mu_);
+};
+
+// Compresses a large message as independent chunks, so that the chunks can
+// be compressed concurrently, and joins them into one message that the peer
+// decompresses as usual: deflate and gzip chunks become pieces of a single
+// deflate stream, zstd and lz4 chunks become frames of their own. Since
+// chunks cannot refer back to earlier ones, compresses slightly worse than
+// grpc_msg_compress.
+class ChunkedMessageCompressor {
+ public:
+  // Returns true if messages compressed with algorithm can be chunked.
+  static bool IsSupported(grpc_compression_algorithm algorithm);
+
+  // Splits input, which must outlive the compressor unchanged, into chunks of
+  // at most chunk_size bytes.
+  ChunkedMessageCompressor(grpc_compression_algorithm algorithm,
+                           const grpc_slice_buffer* input, size_t chunk_size);
+
+  size_t num_chunks() const { return num_chunks_; }
+
+  // Compresses one chunk. Distinct chunks may be compressed concurrently.
+  void CompressChunk(size_t index);
+  // Once every chunk has been compressed, joins them into output. Same
+  // contract as grpc_msg_compress.
+  bool Finish(grpc_slice_buffer* output);
+
+ private:
+  struct Chunk {
+    Chunk();
+    ~Chunk();
+    grpc_slice_buffer input;
+    grpc_slice_buffer output;
+    // Adler-32 (deflate) or CRC-32 (gzip) of input.
+    uint32_t check = 0;
+    bool ok = false;
+  };
+
+  const grpc_compression_algorithm algorithm_;
+  const grpc_slice_buffer* const input_;
+  const size_t num_chunks_;
+  // Not a vector: a grpc_slice_buffer must not move.
+  const std::unique_ptr<Chunk[]> chunks_;
+};
+
+// For adaptive compression: predicts whether the messages of one method are
+// worth compressing, from how well its recent messages compressed. Methods
+// whose messages stop shrinking are sent uncompressed, except for an
+// occasional probe that notices when they become compressible again. Large
+// messages are judged by a sample before paying for compressing all of them.
+// Shared by the calls of the method; updates from concurrent calls may be
+// lost, which only slows down learning.
+class MethodCompressibility : public RefCounted<MethodCompressibility> {
+ public:
+  // Bytes at the start of a large message that are compressed as a sample.
+  static constexpr size_t kSampleSize = 4 * 1024;
+  // Messages this large are sampled; smaller ones cost too little to bother.
+  static constexpr size_t kMinSampledMessageSize = 4 * kSampleSize;
+
+  // Returns false if message, about to be compressed with algorithm, is
+  // predicted not to shrink by enough to be worth the CPU. compressor, if not
+  // null, is what message is to be compressed with, keeping history if
+  // keep_history; else it is compressed on its own. A sample is compressed
+  // the same way, so that it gains from a dictionary, but it cannot be
+  // compressed against the stream's history without adding to it: with
+  // keep_history, only the ratios of earlier messages count. Records the
+  // sample if it decides against compressing; otherwise the caller is to
+  // Record() the whole message.
+  bool ShouldCompress(grpc_compression_algorithm algorithm,
+                      const grpc_slice_buffer* message,
+                      MessageCompressor* compressor, bool keep_history);
+  // Records that a message of input_size bytes compressed to output_size
+  // bytes: input_size if it was sent uncompressed after all.
+  void Record(size_t input_size, size_t output_size);
+
+ private:
+  // Ratios are compressed size over input size, in 1/1024ths.
+  static constexpr uint32_t kUnknownRatio = UINT32_MAX;
+  // Messages must shrink by at least 10% to be worth compressing.
+  static constexpr uint32_t kMaxWorthwhileRatio = 922;
+  // One in this many messages of a method that does not compress is
+  // compressed anyway.
+  static constexpr uint32_t kProbeInterval = 16;
+
+  // Moving average of the ratios of recent messages.
+  std::atomic<uint32_t> ratio_{kUnknownRatio};
+  // Messages skipped since the last probe.
+  std::atomic<uint32_t> skipped_{0};
+};
+
+// The MethodCompressibility of each method, for the calls on one channel.
+class CompressibilityByMethod {
+ public:
+  RefCountedPtr<MethodCompressibility> Get(absl::string_view method);
+
+ private:
+  // Methods beyond this many share one estimate, so that a server called
+  // with arbitrary paths does not grow the map without bound.
+  static constexpr size_t kMaxMethods = 1024;
+
+  Mutex mu_;
+  std::map<std::string, RefCountedPtr<MethodCompressibility>> methods_
+      ABSL_GUARDED_BY(mu_);
+  RefCountedPtr<MethodCompressibility> other_methods_ ABSL_GUARDED_BY(mu_);
+};
+
+// A pre-trained zstd dictionary, as written by `zstd --train`. Messages too
+// small to compress well on their own still compress against a dictionary
+// trained on similar messages. Both peers must have the dictionary: peers
+// advertise the ids of theirs in grpc-accept-encoding-dictionary, and each
+// frame compressed against one names it by id.
+class ZstdDictionary : public RefCounted<ZstdDictionary> {
+ public:
+  // Loads the dictionary at path, or returns the one already loaded from it
+  // if still in use. Fails if the file is not a zstd dictionary or zstd is
+  // not supported by this build.
+  static absl::StatusOr<RefCountedPtr<ZstdDictionary>> Load(
+      const std::string& path);
+
+  // Returns the id of the dictionary the zstd message was compressed
+  // against, or 0 if none.
+  static uint32_t IdOfMessage(const grpc_slice_buffer* message);
+
+  ~ZstdDictionary() override;
+
+  uint32_t id() const { return id_; }
+
+  // Compress every message on its own against the dictionary, reusing one
+  // context; the compressor ignores keep_history. Return nullptr if zstd is
+  // not supported by this build.
+  std::unique_ptr<MessageCompressor> CreateCompressor();
+  std::unique_ptr<MessageDecompressor> CreateDecompressor();
+
+ private:
+  ZstdDictionary(std::string path, uint32_t id, ZSTD_CDict_s* cdict,
+                 ZSTD_DDict_s* ddict)
+      : path_(std::move(path)), id_(id), cdict_(cdict), ddict_(ddict) {}
+
+  const std::string path_;
+  const uint32_t id_;
+  ZSTD_CDict_s* const cdict_;
+  ZSTD_DDict_s* const ddict_;
+};
+
+// The zstd dictionaries a channel compresses and decompresses with, in order
+// of preference. Loaded from GRPC_COMPRESSION_CHANNEL_ZSTD_DICTIONARIES when
+// the channel args are preconditioned, so that the filters do no file I/O.
+class ZstdDictionarySet : public RefCounted<ZstdDictionarySet> {
+ public:
+  // Channel args preconditioning stage: loads the dictionaries named by
+  // GRPC_COMPRESSION_CHANNEL_ZSTD_DICTIONARIES, logging and skipping any that
+  // fail to load, and passes them on in a pointer arg.
+  static const grpc_channel_args* LoadFromChannelArgs(
+      const grpc_channel_args* args);
+  // Returns the set added by LoadFromChannelArgs(), or nullptr if none.
+  static ZstdDictionarySet* GetFromChannelArgs(const grpc_channel_args* args);
+
+  explicit ZstdDictionarySet(
+      std::vector<RefCountedPtr<ZstdDictionary>> dictionaries)
+      : dictionaries_(std::move(dictionaries)) {}
+
+  const std::vector<RefCountedPtr<ZstdDictionary>>& dictionaries() const {
+    return dictionaries_;
+  }
+  // Returns the dictionary with this id, or nullptr if none.
+  ZstdDictionary* Find(uint32_t id) const;
+
+ private:
+  const std::vector<RefCountedPtr<ZstdDictionary>> dictionaries_;
+};
+
+}  // namespace grpc_core
+
 #endif /* GRPC_CORE_LIB_COMPRESSION_MESSAGE_COMPRESS_H */
@@ -48,6 +48,7 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "syscall_read",
     "tcp_backup_pollers_created",
     "tcp_backup_poller_polls",
+    "tcp_zerocopy_read_bytes",
     "http2_op_batches",
     "http2_op_cancel",
     "http2_op_send_initial_metadata",
@@ -125,6 +126,11 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "cq_ev_queue_trylock_failures",
     "cq_ev_queue_trylock_successes",
     "cq_ev_queue_transient_pop_failures",
+    "message_compress_messages",
+    "message_compress_skipped_messages",
+    "message_compress_input_bytes",
+    "message_compress_saved_bytes",
+    "message_compress_micros",
 };
 const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of client side calls created by this process",
@@ -157,6 +163,8 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of read syscalls (or equivalent - eg recvmsg) made by this process",
     "Number of times a backup poller has been created (this can be expensive)",
     "Number of polls performed on the backup poller",
+    "Number of bytes mapped out of socket receive queues with "
+    "TCP_ZEROCOPY_RECEIVE instead of copied",
     "Number of batches received by HTTP2 transport",
     "Number of cancelations received by HTTP2 transport",
     "Number of batches containing send initial metadata",
@@ -252,6 +260,14 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "queue.",
     "Number of times NULL was popped out of completion queue's event queue "
     "even though the event queue was not empty",
+    "Number of messages the compression filter ran a compressor on",
+    "Number of messages adaptive compression sent uncompressed, predicting "
+    "that they would not shrink",
+    "Number of bytes in the messages the compression filter ran a compressor "
+    "on",
+    "Number of bytes by which compression shrank the messages sent",
+    "Microseconds spent compressing messages, including samples and attempts "
+    "that did not shrink the message",
 };
 const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "call_initial_size",
@@ -49,6 +49,7 @@ typedef enum {
   GRPC_STATS_COUNTER_SYSCALL_READ,
   GRPC_STATS_COUNTER_TCP_BACKUP_POLLERS_CREATED,
   GRPC_STATS_COUNTER_TCP_BACKUP_POLLER_POLLS,
+  GRPC_STATS_COUNTER_TCP_ZEROCOPY_READ_BYTES,
   GRPC_STATS_COUNTER_HTTP2_OP_BATCHES,
   GRPC_STATS_COUNTER_HTTP2_OP_CANCEL,
   GRPC_STATS_COUNTER_HTTP2_OP_SEND_INITIAL_METADATA,
@@ -126,6 +127,11 @@ typedef enum {
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_FAILURES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESS_MESSAGES,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SKIPPED_MESSAGES,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESS_INPUT_BYTES,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SAVED_BYTES,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESS_MICROS,
   GRPC_STATS_COUNTER_COUNT
 } grpc_stats_counters;
 extern const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT];
@@ -220,6 +226,8 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_BACKUP_POLLERS_CREATED)
 #define GRPC_STATS_INC_TCP_BACKUP_POLLER_POLLS() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_BACKUP_POLLER_POLLS)
+#define GRPC_STATS_INC_TCP_ZEROCOPY_READ_BYTES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_ZEROCOPY_READ_BYTES)
 #define GRPC_STATS_INC_HTTP2_OP_BATCHES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_OP_BATCHES)
 #define GRPC_STATS_INC_HTTP2_OP_CANCEL() \
@@ -396,6 +404,16 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES)
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES)
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_MESSAGES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_MESSAGES)
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_SKIPPED_MESSAGES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SKIPPED_MESSAGES)
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_INPUT_BYTES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_INPUT_BYTES)
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_SAVED_BYTES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SAVED_BYTES)
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_MICROS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_MICROS)
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value) \
   grpc_stats_inc_call_initial_size((int)(value))
 void grpc_stats_inc_call_initial_size(int value);
@@ -457,6 +475,7 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_SYSCALL_READ()
 #define GRPC_STATS_INC_TCP_BACKUP_POLLERS_CREATED()
 #define GRPC_STATS_INC_TCP_BACKUP_POLLER_POLLS()
+#define GRPC_STATS_INC_TCP_ZEROCOPY_READ_BYTES()
 #define GRPC_STATS_INC_HTTP2_OP_BATCHES()
 #define GRPC_STATS_INC_HTTP2_OP_CANCEL()
 #define GRPC_STATS_INC_HTTP2_OP_SEND_INITIAL_METADATA()
@@ -534,6 +553,11 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_FAILURES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_SUCCESSES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES()
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_MESSAGES()
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_SKIPPED_MESSAGES()
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_INPUT_BYTES()
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_SAVED_BYTES()
+#define GRPC_STATS_INC_MESSAGE_COMPRESS_MICROS()
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value)
 #define GRPC_STATS_INC_POLL_EVENTS_RETURNED(value)
 #define GRPC_STATS_INC_TCP_WRITE_SIZE(value)
@@ -19,6 +19,7 @@ syscall_write_per_iteration:FLOAT,
 syscall_read_per_iteration:FLOAT,
 tcp_backup_pollers_created_per_iteration:FLOAT,
 tcp_backup_poller_polls_per_iteration:FLOAT,
+tcp_zerocopy_read_bytes_per_iteration:FLOAT,
 http2_op_batches_per_iteration:FLOAT,
 http2_op_cancel_per_iteration:FLOAT,
 http2_op_send_initial_metadata_per_iteration:FLOAT,
@@ -95,4 +96,9 @@ server_requested_calls_per_iteration:FLOAT,
 server_slowpath_requests_queued_per_iteration:FLOAT,
 cq_ev_queue_trylock_failures_per_iteration:FLOAT,
 cq_ev_queue_trylock_successes_per_iteration:FLOAT,
-cq_ev_queue_transient_pop_failures_per_iteration:FLOAT
+cq_ev_queue_transient_pop_failures_per_iteration:FLOAT,
+message_compress_messages_per_iteration:FLOAT,
+message_compress_skipped_messages_per_iteration:FLOAT,
+message_compress_input_bytes_per_iteration:FLOAT,
+message_compress_saved_bytes_per_iteration:FLOAT,
+message_compress_micros_per_iteration:FLOAT
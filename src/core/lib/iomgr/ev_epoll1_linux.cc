@@ -33,6 +33,7 @@
 #include <pthread.h>
 #include <string.h>
 #include <sys/epoll.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -54,6 +55,7 @@
 #include "src/core/lib/iomgr/block_annotate.h"
 #include "src/core/lib/iomgr/ev_epoll1_linux.h"
 #include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/iomgr.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
 #include "src/core/lib/iomgr/lockfree_event.h"
 #include "src/core/lib/iomgr/wakeup_fd_posix.h"
@@ -88,6 +90,10 @@ typedef struct epoll_set {
   /* Index of the first event in epoll_events that has to be processed. This
    * field is only valid if num_events > 0 */
   gpr_atm cursor;
+
+  /* The busy polling budget in microseconds when the set was created, or 0
+   * if busy polling is off. Sockets added to the set busy-poll for as long. */
+  int busy_poll_us;
 } epoll_set;
 
 /* The global singleton epoll set */
@@ -119,6 +125,21 @@ static bool epoll_set_init() {
   }
 
   gpr_log(GPR_INFO, "grpc epoll fd: %d", g_epoll_set.epfd);
+  g_epoll_set.busy_poll_us = grpc_iomgr_busy_poll_spin_us();
+#ifdef EPIOCSPARAMS
+  /* With busy polling on, also let the kernel poll the NIC queues of the
+     watched sockets from epoll_wait instead of waiting for interrupts. */
+  if (g_epoll_set.busy_poll_us > 0) {
+    struct epoll_params params;
+    memset(&params, 0, sizeof(params));
+    params.busy_poll_usecs = static_cast<uint32_t>(g_epoll_set.busy_poll_us);
+    params.busy_poll_budget = 8;
+    params.prefer_busy_poll = 1;
+    if (ioctl(g_epoll_set.epfd, EPIOCSPARAMS, &params) != 0) {
+      gpr_log(GPR_DEBUG, "epoll busy poll unavailable: %s", strerror(errno));
+    }
+  }
+#endif /* EPIOCSPARAMS */
   gpr_atm_no_barrier_store(&g_epoll_set.num_events, 0);
   gpr_atm_no_barrier_store(&g_epoll_set.cursor, 0);
   return true;
@@ -372,6 +393,17 @@ static grpc_fd* fd_create(int fd, const char* name, bool track_err) {
   if (epoll_ctl(g_epoll_set.epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
     gpr_log(GPR_ERROR, "epoll_ctl failed: %s", strerror(errno));
   }
+#ifdef SO_BUSY_POLL
+  /* Only in busy polling mode: otherwise the socket keeps the system's
+     net.core.busy_read setting. */
+  if (g_epoll_set.busy_poll_us > 0 &&
+      setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &g_epoll_set.busy_poll_us,
+                 sizeof(g_epoll_set.busy_poll_us)) != 0 &&
+      errno != ENOTSOCK) {
+    /* Values above net.core.busy_read need CAP_NET_ADMIN. */
+    gpr_log(GPR_DEBUG, "setsockopt(SO_BUSY_POLL) failed: %s", strerror(errno));
+  }
+#endif /* SO_BUSY_POLL */
 
   return new_fd;
 }
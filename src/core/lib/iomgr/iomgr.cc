@@ -24,7 +24,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/sync.h>
@@ -45,11 +48,18 @@ GPR_GLOBAL_CONFIG_DEFINE_BOOL(grpc_abort_on_leaks, false,
                               "A debugging aid to cause a call to abort() when "
                               "gRPC objects are leaked past grpc_shutdown()");
 
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_poll_busy_spin_us, 0,
+    "Microseconds a thread waiting for completions keeps polling without "
+    "blocking before it goes to sleep in the poller, trading CPU for latency. "
+    "Zero (the default) disables busy polling.");
+
 static gpr_mu g_mu;
 static gpr_cv g_rcv;
 static int g_shutdown;
 static grpc_iomgr_object g_root_object;
 static bool g_grpc_abort_on_leaks;
+static int g_grpc_poll_busy_spin_us;
 
 void grpc_iomgr_init() {
   grpc_core::ExecCtx exec_ctx;
@@ -57,6 +67,14 @@ void grpc_iomgr_init() {
     grpc_set_default_iomgr_platform();
   }
   g_shutdown = 0;
+  /* Read before the platform init: pollers configure themselves from it. */
+  g_grpc_poll_busy_spin_us =
+      std::max(0, GPR_GLOBAL_CONFIG_GET(grpc_poll_busy_spin_us));
+  if (g_grpc_poll_busy_spin_us > 0 && gpr_cpu_num_cores() < 2) {
+    /* Spinning would only starve the threads that produce completions. */
+    gpr_log(GPR_INFO, "Busy polling disabled: needs more than one cpu");
+    g_grpc_poll_busy_spin_us = 0;
+  }
   gpr_mu_init(&g_mu);
   gpr_cv_init(&g_rcv);
   grpc_core::Executor::InitAll();
@@ -194,3 +212,9 @@ void grpc_iomgr_unregister_object(grpc_iomgr_object* obj) {
 }
 
 bool grpc_iomgr_abort_on_leaks(void) { return g_grpc_abort_on_leaks; }
+
+int grpc_iomgr_busy_poll_spin_us(void) { return g_grpc_poll_busy_spin_us; }
+
+void grpc_iomgr_set_busy_poll_spin_us_for_testing(int spin_us) {
+  g_grpc_poll_busy_spin_us = spin_us;
+}
@@ -54,7 +54,16 @@ bool grpc_iomgr_is_any_background_poller_thread();
 bool grpc_iomgr_add_closure_to_background_poller(grpc_closure* closure,
                                                  grpc_error_handle error);
 
+/** Returns how long, in microseconds, a thread about to block waiting for
+ * completions busy-polls first (GRPC_POLL_BUSY_SPIN_US). Zero means busy
+ * polling is disabled. */
+int grpc_iomgr_busy_poll_spin_us();
+
 /* Exposed only for testing */
 size_t grpc_iomgr_count_objects_for_testing();
 
+/* Exposed only for testing: overrides the busy polling budget, even on a
+   single cpu. Pollers created earlier keep their setting. */
+void grpc_iomgr_set_busy_poll_spin_us_for_testing(int spin_us);
+
 #endif /* GRPC_CORE_LIB_IOMGR_IOMGR_H */
@@ -56,6 +56,12 @@
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 0, 0)
 #define GRPC_LINUX_ERRQUEUE 1
 #endif /* LINUX_VERSION_CODE >= KERNEL_VERSION(4, 0, 0) */
+/* TCP_ZEROCOPY_RECEIVE needs Linux 4.18. A binary built against newer headers
+   falls back to copying reads on older kernels, where mapping the socket
+   fails. */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 18, 0)
+#define GRPC_HAVE_TCP_ZEROCOPY_RECEIVE 1
+#endif /* LINUX_VERSION_CODE >= KERNEL_VERSION(4, 18, 0) */
 #endif /* LINUX_VERSION_CODE */
 #define GRPC_LINUX_MULTIPOLL_WITH_EPOLL 1
 #define GRPC_POSIX_FORK 1
@@ -32,15 +32,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <utility>
+
+#include "absl/types/optional.h"
 
 #include <grpc/slice.h>
 #include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/sync.h>
@@ -88,6 +95,14 @@
 #define MSG_ZEROCOPY 0x4000000
 #endif
 
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+// As with MSG_ZEROCOPY, fall back to the kernel's value if the library headers
+// predate TCP_ZEROCOPY_RECEIVE.
+#ifndef TCP_ZEROCOPY_RECEIVE
+#define TCP_ZEROCOPY_RECEIVE 35
+#endif
+#endif /* GRPC_HAVE_TCP_ZEROCOPY_RECEIVE */
+
 #ifdef GRPC_MSG_IOVLEN_TYPE
 typedef GRPC_MSG_IOVLEN_TYPE msg_iovlen_type;
 #else
@@ -356,6 +371,137 @@ using grpc_core::TcpZerocopySendCtx;
 using grpc_core::TcpZerocopySendRecord;
 
 namespace {
+
+/* Size of the fixed read buffers used when GRPC_ARG_TCP_READ_BUFFER_POOL is
+   set. Reads are issued into up to MAX_READ_IOVEC of these at a time. */
+constexpr size_t kReadSlabSize = 32 * 1024;
+/* Number of idle slabs each shard keeps before frees go back to malloc. */
+constexpr size_t kMaxIdleSlabsPerShard = 16;
+/* Reads into slabs of at most this many bytes are copied out to a slice of
+   their own, so that a small read cannot pin a whole slab for as long as the
+   reader holds on to it. Larger reads are handed out in place and pin at most
+   twice what they read. */
+constexpr size_t kMaxCopiedSlabRead = kReadSlabSize / 2;
+
+/* A fixed-size read buffer. Slices handed to the reader point into data and
+   hold refs on the slab; dropping the last ref returns it to ReadSlabPool. */
+struct ReadSlab : public grpc_slice_refcount {
+  ReadSlab() : grpc_slice_refcount(Release) {}
+  static void Release(grpc_slice_refcount* p);
+
+  /* Quota charged to the endpoint that currently owns the slab. */
+  absl::optional<grpc_core::MemoryAllocator::Reservation> reservation;
+  ReadSlab* next_idle = nullptr;
+  uint8_t data[kReadSlabSize];
+};
+
+/* Process wide cache of idle read slabs, sharded by cpu so that a slab freed
+   by the thread consuming a message is usually reused by the next read on the
+   same core while it is still warm. */
+class ReadSlabPool {
+ public:
+  static ReadSlabPool* Get() {
+    static ReadSlabPool* pool = new ReadSlabPool();
+    return pool;
+  }
+
+  grpc_slice TakeSlice(grpc_core::MemoryOwner* owner) {
+    ReadSlab* slab = nullptr;
+    {
+      Shard& shard = CurrentShard();
+      grpc_core::MutexLock lock(&shard.mu);
+      if (shard.idle != nullptr) {
+        slab = shard.idle;
+        shard.idle = slab->next_idle;
+        --shard.num_idle;
+      }
+    }
+    if (slab == nullptr) {
+      slab = new ReadSlab();
+    } else {
+      /* Idle slabs sit at a refcount of zero. */
+      slab->Ref();
+    }
+    slab->reservation.emplace(owner->MakeReservation(kReadSlabSize));
+    grpc_slice slice;
+    slice.refcount = slab;
+    slice.data.refcounted.bytes = slab->data;
+    slice.data.refcounted.length = kReadSlabSize;
+    return slice;
+  }
+
+  void Return(ReadSlab* slab) {
+    slab->reservation.reset();
+    {
+      Shard& shard = CurrentShard();
+      grpc_core::MutexLock lock(&shard.mu);
+      if (shard.num_idle < kMaxIdleSlabsPerShard) {
+        slab->next_idle = shard.idle;
+        shard.idle = slab;
+        ++shard.num_idle;
+        return;
+      }
+    }
+    delete slab;
+  }
+
+ private:
+  struct Shard {
+    grpc_core::Mutex mu;
+    ReadSlab* idle ABSL_GUARDED_BY(mu) = nullptr;
+    size_t num_idle ABSL_GUARDED_BY(mu) = 0;
+  };
+
+  ReadSlabPool()
+      : num_shards_(std::max(1u, gpr_cpu_num_cores())),
+        shards_(new Shard[num_shards_]) {}
+
+  Shard& CurrentShard() {
+    return shards_[gpr_cpu_current_cpu() % num_shards_];
+  }
+
+  const size_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+void ReadSlab::Release(grpc_slice_refcount* p) {
+  ReadSlabPool::Get()->Return(static_cast<ReadSlab*>(p));
+}
+
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+/* Leading fields of the kernel's struct tcp_zerocopy_receive, which older
+   library headers do not define. The kernel accepts this shorter layout. */
+struct TcpZerocopyReceiveArgs {
+  uint64_t address;
+  uint32_t length;
+  uint32_t recv_skip_hint;
+};
+
+/* The region of an endpoint's address space that TCP_ZEROCOPY_RECEIVE maps
+   payload pages into. The endpoint holds one ref, and each slice of mapped
+   payload another: the region is reused once the reader has released the
+   previous read's slices, and unmapped when the endpoint and the last slice
+   are gone. */
+struct ZerocopyRxMapping : public grpc_slice_refcount {
+  ZerocopyRxMapping(void* address, size_t length,
+                    grpc_core::MemoryAllocator::Reservation reservation)
+      : grpc_slice_refcount(Unmap),
+        address(address),
+        length(length),
+        reservation(std::move(reservation)) {}
+
+  static void Unmap(grpc_slice_refcount* p) {
+    ZerocopyRxMapping* mapping = static_cast<ZerocopyRxMapping*>(p);
+    munmap(mapping->address, mapping->length);
+    delete mapping;
+  }
+
+  void* address;
+  size_t length;
+  grpc_core::MemoryAllocator::Reservation reservation;
+};
+#endif /* GRPC_HAVE_TCP_ZEROCOPY_RECEIVE */
+
 struct grpc_tcp {
   grpc_tcp(int max_sends, size_t send_bytes_threshold)
       : tcp_zerocopy_send_ctx(max_sends, send_bytes_threshold) {}
@@ -372,6 +518,17 @@ struct grpc_tcp {
 
   int min_read_chunk_size;
   int max_read_chunk_size;
+  /* read into recycled ReadSlabs rather than freshly allocated slices */
+  bool use_read_buffer_pool;
+  /* map large reads with TCP_ZEROCOPY_RECEIVE; cleared if the kernel or the
+     socket type does not support it */
+  bool rx_zerocopy_enabled;
+  /* smallest expected read worth mapping */
+  size_t rx_zerocopy_threshold;
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+  /* where mapped reads land; created by the first mapped read */
+  ZerocopyRxMapping* rx_mapping;
+#endif /* GRPC_HAVE_TCP_ZEROCOPY_RECEIVE */
 
   /* garbage after the last read */
   grpc_slice_buffer last_read_buffer;
@@ -612,6 +769,9 @@ static void tcp_free(grpc_tcp* tcp) {
   grpc_fd_orphan(tcp->em_fd, tcp->release_fd_cb, tcp->release_fd,
                  "tcp_unref_orphan");
   grpc_slice_buffer_destroy_internal(&tcp->last_read_buffer);
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+  if (tcp->rx_mapping != nullptr) tcp->rx_mapping->Unref();
+#endif /* GRPC_HAVE_TCP_ZEROCOPY_RECEIVE */
   /* The lock is not really necessary here, since all refs have been released */
   gpr_mu_lock(&tcp->tb_mu);
   grpc_core::TracedBuffer::Shutdown(
@@ -827,11 +987,156 @@ static void tcp_do_read(grpc_tcp* tcp) {
                                tcp->incoming_buffer->length - total_read_bytes,
                                &tcp->last_read_buffer);
   }
+  if (tcp->use_read_buffer_pool && total_read_bytes <= kMaxCopiedSlabRead) {
+    /* The unread tail of the slab is in last_read_buffer and backs the next
+       read; the bytes read go out in a slice of their own. */
+    grpc_slice copy =
+        tcp->memory_owner.MakeSlice(grpc_core::MemoryRequest(total_read_bytes));
+    grpc_slice_buffer_move_first_into_buffer(
+        tcp->incoming_buffer, total_read_bytes, GRPC_SLICE_START_PTR(copy));
+    grpc_slice_buffer_add(tcp->incoming_buffer, copy);
+  }
+  call_read_cb(tcp, GRPC_ERROR_NONE);
+  TCP_UNREF(tcp, "read");
+}
+
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+/* Tries to satisfy a read by mapping whole pages of payload out of the socket
+   receive queue instead of copying them. Any bytes the kernel cannot map
+   (recv_skip_hint) are copied, but no more than that, so that the next read
+   can start mapping again. Returns false if the regular read should run
+   instead, e.g. because nothing is queued, the reader still holds the last
+   mapped read, or the socket cannot be mapped. */
+static bool tcp_do_zerocopy_read(grpc_tcp* tcp) {
+  GPR_TIMER_SCOPE("tcp_do_zerocopy_read", 0);
+  static const size_t kPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (tcp->rx_mapping == nullptr) {
+    size_t region_length = static_cast<size_t>(tcp->max_read_chunk_size);
+    region_length -= region_length % kPageSize;
+    void* address =
+        region_length == 0
+            ? MAP_FAILED
+            : mmap(nullptr, region_length, PROT_READ, MAP_SHARED, tcp->fd, 0);
+    if (address == MAP_FAILED) {
+      gpr_log(GPR_INFO, "TCP:%p disabling rx zerocopy, mmap failed: %s", tcp,
+              strerror(errno));
+      tcp->rx_zerocopy_enabled = false;
+      return false;
+    }
+    tcp->rx_mapping =
+        new ZerocopyRxMapping(address, region_length,
+                              tcp->memory_owner.MakeReservation(region_length));
+  } else if (!tcp->rx_mapping->IsUnique()) {
+    return false;
+  }
+  /* Pairs with the release of the reader's last ref: its reads of the pages
+     happen before the kernel replaces them. */
+  std::atomic_thread_fence(std::memory_order_acquire);
+  ZerocopyRxMapping* mapping = tcp->rx_mapping;
+  size_t map_length = std::min(static_cast<size_t>(tcp->target_length),
+                               mapping->length);
+  map_length -= map_length % kPageSize;
+  if (map_length == 0) return false;
+  TcpZerocopyReceiveArgs zc;
+  memset(&zc, 0, sizeof(zc));
+  zc.address = reinterpret_cast<uintptr_t>(mapping->address);
+  zc.length = static_cast<uint32_t>(map_length);
+  socklen_t zc_len = sizeof(zc);
+  int err;
+  do {
+    GRPC_STATS_INC_SYSCALL_READ();
+    err = getsockopt(tcp->fd, IPPROTO_TCP, TCP_ZEROCOPY_RECEIVE, &zc, &zc_len);
+  } while (err < 0 && errno == EINTR);
+  if (err < 0 || (zc.length == 0 && zc.recv_skip_hint == 0)) {
+    /* Leave EAGAIN, end of stream and socket errors to recvmsg. */
+    if (err < 0 && errno != EAGAIN) {
+      gpr_log(GPR_INFO,
+              "TCP:%p disabling rx zerocopy, TCP_ZEROCOPY_RECEIVE failed: %s",
+              tcp, strerror(errno));
+      tcp->rx_zerocopy_enabled = false;
+    }
+    return false;
+  }
+
+  grpc_slice_buffer data;
+  grpc_slice_buffer_init(&data);
+  size_t mapped = zc.length;
+  GPR_DEBUG_ASSERT(mapped % kPageSize == 0);
+  if (mapped > 0) {
+    mapping->Ref();
+    grpc_slice slice;
+    slice.refcount = mapping;
+    slice.data.refcounted.bytes = static_cast<uint8_t*>(mapping->address);
+    slice.data.refcounted.length = mapped;
+    grpc_slice_buffer_add_indexed(&data, slice);
+    GRPC_STATS_ADD_COUNTER(GRPC_STATS_COUNTER_TCP_ZEROCOPY_READ_BYTES, mapped);
+  }
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  if (zc.recv_skip_hint > 0) {
+    /* The hint can cover the whole receive queue; read no more than we were
+       prepared to map. */
+    size_t copy_length = std::min<size_t>(zc.recv_skip_hint, map_length);
+    grpc_slice copy =
+        tcp->memory_owner.MakeSlice(grpc_core::MemoryRequest(copy_length));
+    ssize_t read_bytes;
+    do {
+      GRPC_STATS_INC_SYSCALL_READ();
+      read_bytes = recv(tcp->fd, GRPC_SLICE_START_PTR(copy), copy_length, 0);
+    } while (read_bytes < 0 && errno == EINTR);
+    if (read_bytes > 0) {
+      copy.data.refcounted.length = static_cast<size_t>(read_bytes);
+      grpc_slice_buffer_add_indexed(&data, copy);
+    } else {
+      grpc_slice_unref_internal(copy);
+      /* Deliver whatever was mapped first; the next read sees the error
+         again. */
+      if (mapped == 0 && read_bytes == 0) {
+        error = tcp_annotate_error(
+            GRPC_ERROR_CREATE_FROM_STATIC_STRING("Socket closed"), tcp);
+      } else if (mapped == 0 && errno != EAGAIN) {
+        error = tcp_annotate_error(GRPC_OS_ERROR(errno, "recv"), tcp);
+      }
+    }
+  }
+  if (error != GRPC_ERROR_NONE) {
+    grpc_slice_buffer_destroy_internal(&data);
+    grpc_slice_buffer_reset_and_unref_internal(tcp->incoming_buffer);
+    call_read_cb(tcp, error);
+    TCP_UNREF(tcp, "read");
+    return true;
+  }
+  if (data.length == 0) {
+    grpc_slice_buffer_destroy_internal(&data);
+    return false;
+  }
+
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
+    gpr_log(GPR_INFO,
+            "TCP:%p zerocopy read: mapped=%" PRIuPTR " copied=%" PRIuPTR, tcp,
+            mapped, data.length - mapped);
+  }
+  GRPC_STATS_INC_TCP_READ_SIZE(data.length);
+  add_to_estimate(tcp, data.length);
+  /* Keep any buffers already allocated for this read for the next one. */
+  grpc_slice_buffer_move_into(tcp->incoming_buffer, &tcp->last_read_buffer);
+  grpc_slice_buffer_swap(tcp->incoming_buffer, &data);
+  grpc_slice_buffer_destroy_internal(&data);
+  tcp->inq = 1;
   call_read_cb(tcp, GRPC_ERROR_NONE);
   TCP_UNREF(tcp, "read");
+  return true;
 }
+#endif /* GRPC_HAVE_TCP_ZEROCOPY_RECEIVE */
 
 static void tcp_continue_read(grpc_tcp* tcp) {
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+  /* Only large expected reads are worth a page-table update. */
+  if (tcp->rx_zerocopy_enabled &&
+      tcp->target_length >= static_cast<double>(tcp->rx_zerocopy_threshold) &&
+      tcp_do_zerocopy_read(tcp)) {
+    return;
+  }
+#endif /* GRPC_HAVE_TCP_ZEROCOPY_RECEIVE */
   if (tcp->incoming_buffer->length == 0 &&
       tcp->incoming_buffer->count < MAX_READ_IOVEC) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
@@ -844,12 +1149,28 @@ static void tcp_continue_read(grpc_tcp* tcp) {
     int target_length = static_cast<int>(tcp->target_length);
     int extra_wanted =
         target_length - static_cast<int>(tcp->incoming_buffer->length);
-    grpc_slice_buffer_add_indexed(
-        tcp->incoming_buffer,
-        tcp->memory_owner.MakeSlice(grpc_core::MemoryRequest(
-            tcp->min_read_chunk_size,
-            grpc_core::Clamp(extra_wanted, tcp->min_read_chunk_size,
-                             tcp->max_read_chunk_size))));
+    if (tcp->use_read_buffer_pool) {
+      /* Cover the estimate with whole slabs. Whatever the read leaves unused
+         is trimmed off into last_read_buffer and backs the next read; a slab
+         only goes back to the pool once no slice refers to it. */
+      size_t wanted = static_cast<size_t>(grpc_core::Clamp(
+          extra_wanted, tcp->min_read_chunk_size, tcp->max_read_chunk_size));
+      size_t num_slabs = grpc_core::Clamp<size_t>(
+          (wanted + kReadSlabSize - 1) / kReadSlabSize, 1,
+          MAX_READ_IOVEC - tcp->incoming_buffer->count);
+      for (size_t i = 0; i < num_slabs; i++) {
+        grpc_slice_buffer_add_indexed(
+            tcp->incoming_buffer,
+            ReadSlabPool::Get()->TakeSlice(&tcp->memory_owner));
+      }
+    } else {
+      grpc_slice_buffer_add_indexed(
+          tcp->incoming_buffer,
+          tcp->memory_owner.MakeSlice(grpc_core::MemoryRequest(
+              tcp->min_read_chunk_size,
+              grpc_core::Clamp(extra_wanted, tcp->min_read_chunk_size,
+                               tcp->max_read_chunk_size))));
+    }
   }
   if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
     gpr_log(GPR_INFO, "TCP:%p do_read", tcp);
@@ -1667,6 +1988,9 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
   int tcp_read_chunk_size = GRPC_TCP_DEFAULT_READ_SLICE_SIZE;
   int tcp_max_read_chunk_size = 4 * 1024 * 1024;
   int tcp_min_read_chunk_size = 256;
+  bool tcp_read_buffer_pool = false;
+  bool tcp_rx_zerocopy_enabled = false;
+  int tcp_rx_zerocopy_threshold = 64 * 1024;
   bool tcp_tx_zerocopy_enabled = kZerocpTxEnabledDefault;
   int tcp_tx_zerocopy_send_bytes_thresh =
       grpc_core::TcpZerocopySendCtx::kDefaultSendBytesThreshold;
@@ -1689,6 +2013,20 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
         grpc_integer_options options = {tcp_read_chunk_size, 1, MAX_CHUNK_SIZE};
         tcp_max_read_chunk_size =
             grpc_channel_arg_get_integer(&channel_args->args[i], options);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_READ_BUFFER_POOL)) {
+        tcp_read_buffer_pool =
+            grpc_channel_arg_get_bool(&channel_args->args[i], false);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_RX_ZEROCOPY_ENABLED)) {
+        tcp_rx_zerocopy_enabled =
+            grpc_channel_arg_get_bool(&channel_args->args[i], false);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_RX_ZEROCOPY_RECV_BYTES_THRESHOLD)) {
+        grpc_integer_options options = {tcp_rx_zerocopy_threshold, 0,
+                                        MAX_CHUNK_SIZE};
+        tcp_rx_zerocopy_threshold =
+            grpc_channel_arg_get_integer(&channel_args->args[i], options);
       } else if (0 == strcmp(channel_args->args[i].key,
                              GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED)) {
         tcp_tx_zerocopy_enabled = grpc_channel_arg_get_bool(
@@ -1744,6 +2082,12 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
   tcp->target_length = static_cast<double>(tcp_read_chunk_size);
   tcp->min_read_chunk_size = tcp_min_read_chunk_size;
   tcp->max_read_chunk_size = tcp_max_read_chunk_size;
+  tcp->use_read_buffer_pool = tcp_read_buffer_pool;
+  tcp->rx_zerocopy_enabled = tcp_rx_zerocopy_enabled;
+  tcp->rx_zerocopy_threshold = static_cast<size_t>(tcp_rx_zerocopy_threshold);
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+  tcp->rx_mapping = nullptr;
+#endif /* GRPC_HAVE_TCP_ZEROCOPY_RECEIVE */
   tcp->bytes_read_this_round = 0;
   /* Will be set to false by the very first endpoint read function */
   tcp->is_first_read = true;
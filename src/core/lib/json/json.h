@@ -28,11 +28,14 @@
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 #include "src/core/lib/iomgr/error.h"
 
 namespace grpc_core {
 
+class Arena;
+
 // A JSON value, which can be any one of object, array, string,
 // number, true, false, or null.
 class Json {
@@ -245,6 +248,67 @@ class Json {
   Array array_value_;
 };
 
+// A read-only JSON value allocated in an Arena, for reading a document
+// without building a Json for it.  Strings that contain no escapes refer to
+// the parsed input, so the input must outlive the value as well as the arena.
+class JsonView {
+ public:
+  using Type = Json::Type;
+
+  struct Member;
+
+  // Parses JSON string from json_str into arena.  On error, sets *error and
+  // returns nullptr.  Accepts the same input as Json::Parse().
+  static const JsonView* Parse(absl::string_view json_str, Arena* arena,
+                               grpc_error_handle* error);
+
+  Type type() const { return type_; }
+  // For NUMBER and STRING values.
+  absl::string_view string_value() const {
+    return absl::string_view(string_, size_);
+  }
+  // For OBJECT values.  Sorted by key.
+  absl::Span<const Member> object_value() const;
+  // For ARRAY values.
+  absl::Span<const JsonView> array_value() const {
+    return absl::Span<const JsonView>(elements_, size_);
+  }
+
+  // Returns the value of the member of an OBJECT value with the given key,
+  // or nullptr if there is none.
+  const JsonView* Find(absl::string_view key) const;
+
+  Json ToJson() const;
+
+ private:
+  class Parser;
+
+  explicit JsonView(Type type) : type_(type), size_(0), string_(nullptr) {}
+  JsonView(Type type, const char* string, size_t size)
+      : type_(type), size_(size), string_(string) {}
+  JsonView(const JsonView* elements, size_t size)
+      : type_(Type::ARRAY), size_(size), elements_(elements) {}
+  JsonView(const Member* members, size_t size)
+      : type_(Type::OBJECT), size_(size), members_(members) {}
+
+  Type type_;
+  size_t size_;
+  union {
+    const char* string_;
+    const JsonView* elements_;
+    const Member* members_;
+  };
+};
+
+struct JsonView::Member {
+  absl::string_view key;
+  JsonView value;
+};
+
+inline absl::Span<const JsonView::Member> JsonView::object_value() const {
+  return absl::Span<const Member>(members_, size_);
+}
+
 }  // namespace grpc_core
 
 #endif /* GRPC_CORE_LIB_JSON_JSON_H */
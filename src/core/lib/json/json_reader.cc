@@ -20,14 +20,24 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 
 #include <grpc/support/log.h>
 
+#include "src/core/lib/gpr/alloc.h"
 #include "src/core/lib/json/json.h"
+#include "src/core/lib/resource_quota/arena.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
 
 #define GRPC_JSON_MAX_DEPTH 255
 #define GRPC_JSON_MAX_ERRORS 16
@@ -36,99 +46,188 @@ namespace grpc_core {
 
 namespace {
 
-class JsonReader {
- public:
-  static grpc_error_handle Parse(absl::string_view input, Json* output);
+// Objects with more members than this look keys up in a hash set, rather
+// than comparing them with each member, to detect duplicates.
+constexpr size_t kMaxLinearKeySearch = 16;
 
- private:
-  enum class Status {
-    GRPC_JSON_DONE,          /* The parser finished successfully. */
-    GRPC_JSON_PARSE_ERROR,   /* The parser found an error in the json stream. */
-    GRPC_JSON_INTERNAL_ERROR /* The parser got an internal error. */
-  };
+// Bounds on the size of the blocks values are allocated from.
+constexpr size_t kMinBlockSize = 1024;
+constexpr size_t kMaxBlockSize = 1024 * 1024;
 
-  enum class State {
-    GRPC_JSON_STATE_OBJECT_KEY_BEGIN,
-    GRPC_JSON_STATE_OBJECT_KEY_STRING,
-    GRPC_JSON_STATE_OBJECT_KEY_END,
-    GRPC_JSON_STATE_VALUE_BEGIN,
-    GRPC_JSON_STATE_VALUE_STRING,
-    GRPC_JSON_STATE_STRING_ESCAPE,
-    GRPC_JSON_STATE_STRING_ESCAPE_U1,
-    GRPC_JSON_STATE_STRING_ESCAPE_U2,
-    GRPC_JSON_STATE_STRING_ESCAPE_U3,
-    GRPC_JSON_STATE_STRING_ESCAPE_U4,
-    GRPC_JSON_STATE_VALUE_NUMBER,
-    GRPC_JSON_STATE_VALUE_NUMBER_WITH_DECIMAL,
-    GRPC_JSON_STATE_VALUE_NUMBER_ZERO,
-    GRPC_JSON_STATE_VALUE_NUMBER_DOT,
-    GRPC_JSON_STATE_VALUE_NUMBER_E,
-    GRPC_JSON_STATE_VALUE_NUMBER_EPM,
-    GRPC_JSON_STATE_VALUE_TRUE_R,
-    GRPC_JSON_STATE_VALUE_TRUE_U,
-    GRPC_JSON_STATE_VALUE_TRUE_E,
-    GRPC_JSON_STATE_VALUE_FALSE_A,
-    GRPC_JSON_STATE_VALUE_FALSE_L,
-    GRPC_JSON_STATE_VALUE_FALSE_S,
-    GRPC_JSON_STATE_VALUE_FALSE_E,
-    GRPC_JSON_STATE_VALUE_NULL_U,
-    GRPC_JSON_STATE_VALUE_NULL_L1,
-    GRPC_JSON_STATE_VALUE_NULL_L2,
-    GRPC_JSON_STATE_VALUE_END,
-    GRPC_JSON_STATE_END
-  };
+constexpr uint64_t kOnes = ~uint64_t{0} / 255;
+constexpr uint64_t kHighBits = kOnes * 0x80;
+
+// Returns non-zero if any byte of word is zero.
+inline uint64_t HasZeroByte(uint64_t word) {
+  return (word - kOnes) & ~word & kHighBits;
+}
+
+// Returns non-zero if any byte of word may need more than copying as part of
+// a string: a quote, a backslash, a control character or a non-ASCII byte.
+inline uint64_t HasSpecialStringByte(uint64_t word) {
+  return HasZeroByte(word ^ (kOnes * '"')) |
+         HasZeroByte(word ^ (kOnes * '\\')) |
+         ((word - kOnes * 0x20) & ~word & kHighBits) | (word & kHighBits);
+}
+
+inline bool IsSpecialStringByte(uint8_t c) {
+  return c == '"' || c == '\\' || c < 0x20 || c >= 0x80;
+}
+
+inline bool IsWhitespace(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool IsDigit(uint8_t c) { return c >= '0' && c <= '9'; }
+
+// Builds each value in place in its parent container, rather than moving it
+// there.
+void ConvertTo(const JsonView& view, Json* json) {
+  switch (view.type()) {
+    case Json::Type::JSON_TRUE:
+      *json = true;
+      break;
+    case Json::Type::JSON_FALSE:
+      *json = false;
+      break;
+    case Json::Type::NUMBER:
+      *json = Json(std::string(view.string_value()), /*is_number=*/true);
+      break;
+    case Json::Type::STRING:
+      *json = std::string(view.string_value());
+      break;
+    case Json::Type::OBJECT: {
+      *json = Json::Object();
+      Json::Object* object = json->mutable_object();
+      // Members are sorted, so each one goes at the end of the map.
+      for (const JsonView::Member& member : view.object_value()) {
+        auto it = object->emplace_hint(
+            object->end(), std::piecewise_construct,
+            std::forward_as_tuple(member.key.data(), member.key.size()),
+            std::forward_as_tuple());
+        ConvertTo(member.value, &it->second);
+      }
+      break;
+    }
+    case Json::Type::ARRAY: {
+      *json = Json::Array(view.array_value().size());
+      Json::Array* array = json->mutable_array();
+      for (size_t i = 0; i < array->size(); ++i) {
+        ConvertTo(view.array_value()[i], &(*array)[i]);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
 
-  /* The first non-unicode value is 0x110000. But let's pick
-   * a value high enough to start our error codes from. These
-   * values are safe to return from the read_char function.
-   */
-  static constexpr uint32_t GRPC_JSON_READ_CHAR_EOF = 0x7ffffff0;
+}  // namespace
+
+// A single pass, recursive descent implementation of ECMA-404.  Values are
+// collected on scratch stacks and copied into the arena in one piece when
+// their container ends.
+class JsonView::Parser {
+ public:
+  Parser(absl::string_view input, Arena* arena)
+      : input_(reinterpret_cast<const uint8_t*>(input.data())),
+        arena_(arena) {
+    // As far as the parser is concerned, the input ends at the first NUL.
+    const void* nul = memchr(input.data(), 0, input.size());
+    if (nul != nullptr) {
+      size_ = static_cast<const uint8_t*>(nul) - input_;
+      eof_index_ = size_;
+    } else {
+      size_ = input.size();
+      eof_index_ = size_ - 1;
+    }
+  }
 
-  explicit JsonReader(absl::string_view input)
-      : original_input_(reinterpret_cast<const uint8_t*>(input.data())),
-        input_(original_input_),
-        remaining_input_(input.size()) {}
+  const JsonView* Parse(grpc_error_handle* error);
 
-  Status Run();
-  uint32_t ReadChar();
-  bool IsComplete();
+ private:
+  // The object whose member value is being parsed.
+  struct ParentObject {
+    size_t first_member;
+    absl::string_view key;
+    std::unique_ptr<absl::flat_hash_set<absl::string_view>> keys;
+  };
 
-  size_t CurrentIndex() const { return input_ - original_input_ - 1; }
+  // All of the methods returning bool return false on a parse error, having
+  // set error_index_, which ends parsing.
+
+  // Pushes the value starting at pos_ onto values_.
+  bool ParseValue(ParentObject* parent);
+  bool ParseObject(ParentObject* parent);
+  bool ParseArray(ParentObject* parent);
+  // Parses the string whose opening quote is at pos_ - 1.  Leaves pos_ after
+  // the closing quote.
+  bool ParseString(absl::string_view* value);
+  bool ParseEscapedString(size_t start, absl::string_view* value);
+  bool ParseNumber(ParentObject* parent);
+  bool ParseLiteral(absl::string_view literal, Type type,
+                    ParentObject* parent);
+
+  // Called where a value is added to \a parent, with \a index being the
+  // index that errors refer to.
+  void CheckForDuplicateKey(ParentObject* parent, size_t index);
+  bool EnterContainer();
 
   GRPC_MUST_USE_RESULT bool StringAddChar(uint32_t c);
   GRPC_MUST_USE_RESULT bool StringAddUtf32(uint32_t c);
 
-  Json* CreateAndLinkValue();
-  bool StartContainer(Json::Type type);
-  void EndContainer();
-  void SetKey();
-  void SetString();
-  bool SetNumber();
-  void SetTrue();
-  void SetFalse();
-  void SetNull();
-
-  const uint8_t* original_input_;
-  const uint8_t* input_;
-  size_t remaining_input_;
-
-  State state_ = State::GRPC_JSON_STATE_VALUE_BEGIN;
-  bool escaped_string_was_key_ = false;
-  bool container_just_begun_ = false;
-  uint16_t unicode_char_ = 0;
-  uint16_t unicode_high_surrogate_ = 0;
+  void SkipWhitespace() {
+    while (pos_ < size_ && IsWhitespace(input_[pos_])) ++pos_;
+  }
+  // Returns the index of the first byte from pos that IsSpecialStringByte(),
+  // or size_.
+  size_t FindSpecialStringByte(size_t pos) const;
+  // Index of the current character, or of the end of the input.
+  size_t CurrentIndex() const { return pos_ < size_ ? pos_ : eof_index_; }
+  bool Fail(size_t index) {
+    error_index_ = index;
+    return false;
+  }
+  void AddError(std::string error) {
+    if (errors_.size() == GRPC_JSON_MAX_ERRORS) {
+      truncated_errors_ = true;
+    } else {
+      errors_.push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(std::move(error)));
+    }
+  }
+  // Allocates from blocks of the arena, so that large documents need few
+  // arena zones.
+  void* Alloc(size_t size);
+  template <typename T>
+  const T* CopyToArena(const T* values, size_t count) {
+    if (count == 0) return nullptr;
+    T* copy = static_cast<T*>(Alloc(sizeof(T) * count));
+    std::uninitialized_copy(values, values + count, copy);
+    return copy;
+  }
+
+  const uint8_t* const input_;
+  size_t size_;
+  // Index reported for errors at the end of the input.
+  size_t eof_index_;
+  Arena* const arena_;
+  char* block_ = nullptr;
+  size_t block_remaining_ = 0;
+  size_t next_block_size_ = kMinBlockSize;
+  size_t pos_ = 0;
+  size_t depth_ = 0;
+  size_t error_index_ = 0;
   std::vector<grpc_error_handle> errors_;
   bool truncated_errors_ = false;
-  uint8_t utf8_bytes_remaining_ = 0;
-
-  Json root_value_;
-  std::vector<Json*> stack_;
 
-  std::string key_;
+  std::vector<JsonView> values_;
+  std::vector<Member> members_;
+  // Unescaped string being parsed.
   std::string string_;
+  uint8_t utf8_bytes_remaining_ = 0;
 };
 
-bool JsonReader::StringAddChar(uint32_t c) {
+bool JsonView::Parser::StringAddChar(uint32_t c) {
   switch (utf8_bytes_remaining_) {
     case 0:
       if ((c & 0x80) == 0) {
@@ -156,7 +255,7 @@ bool JsonReader::StringAddChar(uint32_t c) {
   return true;
 }
 
-bool JsonReader::StringAddUtf32(uint32_t c) {
+bool JsonView::Parser::StringAddUtf32(uint32_t c) {
   if (c <= 0x7f) {
     return StringAddChar(c);
   } else if (c <= 0x7ff) {
@@ -180,718 +279,386 @@ bool JsonReader::StringAddUtf32(uint32_t c) {
   }
 }
 
-uint32_t JsonReader::ReadChar() {
-  if (remaining_input_ == 0) return GRPC_JSON_READ_CHAR_EOF;
-  const uint32_t r = *input_++;
-  --remaining_input_;
-  if (r == 0) {
-    remaining_input_ = 0;
-    return GRPC_JSON_READ_CHAR_EOF;
+void* JsonView::Parser::Alloc(size_t size) {
+  size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(size);
+  if (size > block_remaining_) {
+    if (size > next_block_size_ / 2) return arena_->Alloc(size);
+    block_ = static_cast<char*>(arena_->Alloc(next_block_size_));
+    block_remaining_ = next_block_size_;
+    next_block_size_ = std::min(2 * next_block_size_, kMaxBlockSize);
   }
-  return r;
+  void* p = block_;
+  block_ += size;
+  block_remaining_ -= size;
+  return p;
 }
 
-Json* JsonReader::CreateAndLinkValue() {
-  Json* value;
-  if (stack_.empty()) {
-    value = &root_value_;
-  } else {
-    Json* parent = stack_.back();
-    if (parent->type() == Json::Type::OBJECT) {
-      if (parent->object_value().find(key_) != parent->object_value().end()) {
-        if (errors_.size() == GRPC_JSON_MAX_ERRORS) {
-          truncated_errors_ = true;
-        } else {
-          errors_.push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(
-              absl::StrFormat("duplicate key \"%s\" at index %" PRIuPTR, key_,
-                              CurrentIndex())));
-        }
-      }
-      value = &(*parent->mutable_object())[std::move(key_)];
-    } else {
-      GPR_ASSERT(parent->type() == Json::Type::ARRAY);
-      parent->mutable_array()->emplace_back();
-      value = &parent->mutable_array()->back();
-    }
+size_t JsonView::Parser::FindSpecialStringByte(size_t pos) const {
+  // Skip over eight bytes at a time while none of them is special.
+  while (pos + sizeof(uint64_t) <= size_) {
+    uint64_t word;
+    memcpy(&word, input_ + pos, sizeof(word));
+    if (HasSpecialStringByte(word) != 0) break;
+    pos += sizeof(word);
   }
-  return value;
+  while (pos < size_ && !IsSpecialStringByte(input_[pos])) ++pos;
+  return pos;
 }
 
-bool JsonReader::StartContainer(Json::Type type) {
-  if (stack_.size() == GRPC_JSON_MAX_DEPTH) {
-    if (errors_.size() == GRPC_JSON_MAX_ERRORS) {
-      truncated_errors_ = true;
-    } else {
-      errors_.push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(
-          absl::StrFormat("exceeded max stack depth (%d) at index %" PRIuPTR,
-                          GRPC_JSON_MAX_DEPTH, CurrentIndex())));
+void JsonView::Parser::CheckForDuplicateKey(ParentObject* parent,
+                                            size_t index) {
+  if (parent == nullptr) return;
+  bool duplicate;
+  if (parent->keys == nullptr &&
+      members_.size() - parent->first_member >= kMaxLinearKeySearch) {
+    parent->keys = absl::make_unique<absl::flat_hash_set<absl::string_view>>();
+    for (size_t i = parent->first_member; i < members_.size(); ++i) {
+      parent->keys->insert(members_[i].key);
     }
-    return false;
   }
-  Json* value = CreateAndLinkValue();
-  if (type == Json::Type::OBJECT) {
-    *value = Json::Object();
+  if (parent->keys != nullptr) {
+    duplicate = !parent->keys->insert(parent->key).second;
   } else {
-    GPR_ASSERT(type == Json::Type::ARRAY);
-    *value = Json::Array();
+    duplicate = std::any_of(
+        members_.begin() + parent->first_member, members_.end(),
+        [parent](const Member& member) { return member.key == parent->key; });
+  }
+  if (duplicate) {
+    AddError(absl::StrFormat("duplicate key \"%s\" at index %" PRIuPTR,
+                             parent->key, index));
   }
-  stack_.push_back(value);
-  return true;
-}
-
-void JsonReader::EndContainer() {
-  GPR_ASSERT(!stack_.empty());
-  stack_.pop_back();
 }
 
-void JsonReader::SetKey() {
-  key_ = std::move(string_);
-  string_.clear();
+bool JsonView::Parser::EnterContainer() {
+  if (depth_ == GRPC_JSON_MAX_DEPTH) {
+    AddError(
+        absl::StrFormat("exceeded max stack depth (%d) at index %" PRIuPTR,
+                        GRPC_JSON_MAX_DEPTH, pos_));
+    return Fail(pos_);
+  }
+  ++depth_;
+  return true;
 }
 
-void JsonReader::SetString() {
-  Json* value = CreateAndLinkValue();
-  *value = std::move(string_);
-  string_.clear();
+bool JsonView::Parser::ParseValue(ParentObject* parent) {
+  SkipWhitespace();
+  if (pos_ == size_) return Fail(eof_index_);
+  switch (input_[pos_]) {
+    case '{':
+      return ParseObject(parent);
+    case '[':
+      return ParseArray(parent);
+    case '"': {
+      ++pos_;
+      absl::string_view value;
+      if (!ParseString(&value)) return false;
+      CheckForDuplicateKey(parent, pos_ - 1);
+      values_.push_back(JsonView(Type::STRING, value.data(), value.size()));
+      return true;
+    }
+    case 't':
+      return ParseLiteral("true", Type::JSON_TRUE, parent);
+    case 'f':
+      return ParseLiteral("false", Type::JSON_FALSE, parent);
+    case 'n':
+      return ParseLiteral("null", Type::JSON_NULL, parent);
+    default:
+      if (input_[pos_] == '-' || IsDigit(input_[pos_])) {
+        return ParseNumber(parent);
+      }
+      return Fail(pos_);
+  }
 }
 
-bool JsonReader::SetNumber() {
-  Json* value = CreateAndLinkValue();
-  *value = Json(string_, /*is_number=*/true);
-  string_.clear();
+bool JsonView::Parser::ParseObject(ParentObject* parent) {
+  if (!EnterContainer()) return false;
+  CheckForDuplicateKey(parent, pos_);
+  ++pos_;
+  ParentObject object;
+  object.first_member = members_.size();
+  SkipWhitespace();
+  if (pos_ < size_ && input_[pos_] == '}') {
+    ++pos_;
+  } else {
+    while (true) {
+      SkipWhitespace();
+      if (pos_ == size_ || input_[pos_] != '"') return Fail(CurrentIndex());
+      ++pos_;
+      if (!ParseString(&object.key)) return false;
+      SkipWhitespace();
+      if (pos_ == size_ || input_[pos_] != ':') return Fail(CurrentIndex());
+      ++pos_;
+      if (!ParseValue(&object)) return false;
+      members_.push_back({object.key, values_.back()});
+      values_.pop_back();
+      SkipWhitespace();
+      if (pos_ == size_) return Fail(eof_index_);
+      if (input_[pos_] == ',') {
+        ++pos_;
+      } else if (input_[pos_] == '}') {
+        ++pos_;
+        break;
+      } else {
+        return Fail(pos_);
+      }
+    }
+  }
+  auto first = members_.begin() + object.first_member;
+  std::sort(first, members_.end(), [](const Member& a, const Member& b) {
+    return a.key < b.key;
+  });
+  const size_t count = members_.size() - object.first_member;
+  values_.push_back(JsonView(CopyToArena(&*first, count), count));
+  members_.erase(first, members_.end());
+  --depth_;
   return true;
 }
 
-void JsonReader::SetTrue() {
-  Json* value = CreateAndLinkValue();
-  *value = true;
-  string_.clear();
-}
-
-void JsonReader::SetFalse() {
-  Json* value = CreateAndLinkValue();
-  *value = false;
-  string_.clear();
+bool JsonView::Parser::ParseArray(ParentObject* parent) {
+  if (!EnterContainer()) return false;
+  CheckForDuplicateKey(parent, pos_);
+  ++pos_;
+  const size_t first_element = values_.size();
+  SkipWhitespace();
+  if (pos_ < size_ && input_[pos_] == ']') {
+    ++pos_;
+  } else {
+    while (true) {
+      if (!ParseValue(nullptr)) return false;
+      SkipWhitespace();
+      if (pos_ == size_) return Fail(eof_index_);
+      if (input_[pos_] == ',') {
+        ++pos_;
+      } else if (input_[pos_] == ']') {
+        ++pos_;
+        break;
+      } else {
+        return Fail(pos_);
+      }
+    }
+  }
+  const size_t count = values_.size() - first_element;
+  const JsonView* elements = CopyToArena(&values_[first_element], count);
+  values_.erase(values_.begin() + first_element, values_.end());
+  values_.push_back(JsonView(elements, count));
+  --depth_;
+  return true;
 }
 
-void JsonReader::SetNull() { CreateAndLinkValue(); }
-
-bool JsonReader::IsComplete() {
-  return (stack_.empty() && (state_ == State::GRPC_JSON_STATE_END ||
-                             state_ == State::GRPC_JSON_STATE_VALUE_END));
+bool JsonView::Parser::ParseString(absl::string_view* value) {
+  const size_t start = pos_;
+  pos_ = FindSpecialStringByte(pos_);
+  if (pos_ < size_ && input_[pos_] == '"') {
+    // No escapes: refer to the input.
+    *value = absl::string_view(reinterpret_cast<const char*>(input_) + start,
+                               pos_ - start);
+    ++pos_;
+    return true;
+  }
+  return ParseEscapedString(start, value);
 }
 
-/* Call this function to start parsing the input. It will return the following:
- *    . GRPC_JSON_DONE if the input got eof, and the parsing finished
- *      successfully.
- *    . GRPC_JSON_PARSE_ERROR if the input was somehow invalid.
- *    . GRPC_JSON_INTERNAL_ERROR if the parser somehow ended into an invalid
- *      internal state.
- */
-JsonReader::Status JsonReader::Run() {
-  uint32_t c;
-
-  /* This state-machine is a strict implementation of ECMA-404 */
+bool JsonView::Parser::ParseEscapedString(size_t start,
+                                          absl::string_view* value) {
+  string_.assign(reinterpret_cast<const char*>(input_) + start, pos_ - start);
+  utf8_bytes_remaining_ = 0;
+  uint16_t unicode_high_surrogate = 0;
   while (true) {
-    c = ReadChar();
+    if (pos_ == size_) return Fail(eof_index_);
+    uint8_t c = input_[pos_];
+    if (unicode_high_surrogate != 0 && c != '\\') return Fail(pos_);
+    if (c == '"') {
+      // Once the string is parsed, there should no un-matched utf8 encoded
+      // bytes.
+      if (utf8_bytes_remaining_ != 0) return Fail(pos_);
+      char* copy = static_cast<char*>(Alloc(string_.size()));
+      memcpy(copy, string_.data(), string_.size());
+      *value = absl::string_view(copy, string_.size());
+      ++pos_;
+      return true;
+    }
+    if (c != '\\') {
+      if (c < 32 || !StringAddChar(c)) return Fail(pos_);
+      ++pos_;
+      continue;
+    }
+    if (++pos_ == size_) return Fail(eof_index_);
+    c = input_[pos_];
+    if (unicode_high_surrogate != 0 && c != 'u') return Fail(pos_);
+    bool ok = true;
     switch (c) {
-      /* Let's process the error case first. */
-      case GRPC_JSON_READ_CHAR_EOF:
-        switch (state_) {
-          case State::GRPC_JSON_STATE_VALUE_NUMBER:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_WITH_DECIMAL:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_ZERO:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_EPM:
-            if (!SetNumber()) return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_END;
-            break;
-
-          default:
-            break;
-        }
-        if (IsComplete()) {
-          return Status::GRPC_JSON_DONE;
-        }
-        return Status::GRPC_JSON_PARSE_ERROR;
-
-      /* Processing whitespaces. */
-      case ' ':
-      case '\t':
-      case '\n':
-      case '\r':
-        switch (state_) {
-          case State::GRPC_JSON_STATE_OBJECT_KEY_BEGIN:
-          case State::GRPC_JSON_STATE_OBJECT_KEY_END:
-          case State::GRPC_JSON_STATE_VALUE_BEGIN:
-          case State::GRPC_JSON_STATE_VALUE_END:
-          case State::GRPC_JSON_STATE_END:
-            break;
-
-          case State::GRPC_JSON_STATE_OBJECT_KEY_STRING:
-          case State::GRPC_JSON_STATE_VALUE_STRING:
-            if (c != ' ') return Status::GRPC_JSON_PARSE_ERROR;
-            if (unicode_high_surrogate_ != 0) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_WITH_DECIMAL:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_ZERO:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_EPM:
-            if (!SetNumber()) return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_END;
-            break;
-
-          default:
-            return Status::GRPC_JSON_PARSE_ERROR;
-        }
+      case '"':
+      case '/':
+      case '\\':
+        ok = StringAddChar(c);
         break;
-
-      /* Value, object or array terminations. */
-      case ',':
-      case '}':
-      case ']':
-        switch (state_) {
-          case State::GRPC_JSON_STATE_OBJECT_KEY_STRING:
-          case State::GRPC_JSON_STATE_VALUE_STRING:
-            if (unicode_high_surrogate_ != 0) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_WITH_DECIMAL:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_ZERO:
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_EPM:
-            if (stack_.empty()) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            } else if (c == '}' &&
-                       stack_.back()->type() != Json::Type::OBJECT) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            } else if (c == ']' && stack_.back()->type() != Json::Type::ARRAY) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            if (!SetNumber()) return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_END;
-            ABSL_FALLTHROUGH_INTENDED;
-
-          case State::GRPC_JSON_STATE_VALUE_END:
-          case State::GRPC_JSON_STATE_OBJECT_KEY_BEGIN:
-          case State::GRPC_JSON_STATE_VALUE_BEGIN:
-            if (c == ',') {
-              if (state_ != State::GRPC_JSON_STATE_VALUE_END) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              if (!stack_.empty() &&
-                  stack_.back()->type() == Json::Type::OBJECT) {
-                state_ = State::GRPC_JSON_STATE_OBJECT_KEY_BEGIN;
-              } else if (!stack_.empty() &&
-                         stack_.back()->type() == Json::Type::ARRAY) {
-                state_ = State::GRPC_JSON_STATE_VALUE_BEGIN;
-              } else {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-            } else {
-              if (stack_.empty()) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              if (c == '}' && stack_.back()->type() != Json::Type::OBJECT) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              if (c == '}' &&
-                  state_ == State::GRPC_JSON_STATE_OBJECT_KEY_BEGIN &&
-                  !container_just_begun_) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              if (c == ']' && stack_.back()->type() != Json::Type::ARRAY) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              if (c == ']' && state_ == State::GRPC_JSON_STATE_VALUE_BEGIN &&
-                  !container_just_begun_) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              state_ = State::GRPC_JSON_STATE_VALUE_END;
-              EndContainer();
-              if (stack_.empty()) {
-                state_ = State::GRPC_JSON_STATE_END;
-              }
-            }
-            break;
-
-          default:
-            return Status::GRPC_JSON_PARSE_ERROR;
-        }
+      case 'b':
+        ok = StringAddChar('\b');
         break;
-
-      /* In-string escaping. */
-      case '\\':
-        switch (state_) {
-          case State::GRPC_JSON_STATE_OBJECT_KEY_STRING:
-            escaped_string_was_key_ = true;
-            state_ = State::GRPC_JSON_STATE_STRING_ESCAPE;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_STRING:
-            escaped_string_was_key_ = false;
-            state_ = State::GRPC_JSON_STATE_STRING_ESCAPE;
-            break;
-
-          /* This is the \\ case. */
-          case State::GRPC_JSON_STATE_STRING_ESCAPE:
-            if (unicode_high_surrogate_ != 0) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            if (!StringAddChar('\\')) return Status::GRPC_JSON_PARSE_ERROR;
-            if (escaped_string_was_key_) {
-              state_ = State::GRPC_JSON_STATE_OBJECT_KEY_STRING;
-            } else {
-              state_ = State::GRPC_JSON_STATE_VALUE_STRING;
-            }
-            break;
-
-          default:
-            return Status::GRPC_JSON_PARSE_ERROR;
+      case 'f':
+        ok = StringAddChar('\f');
+        break;
+      case 'n':
+        ok = StringAddChar('\n');
+        break;
+      case 'r':
+        ok = StringAddChar('\r');
+        break;
+      case 't':
+        ok = StringAddChar('\t');
+        break;
+      case 'u': {
+        uint16_t unicode_char = 0;
+        for (int i = 0; i < 4; ++i) {
+          if (++pos_ == size_) return Fail(eof_index_);
+          c = input_[pos_];
+          if ((c >= '0') && (c <= '9')) {
+            c -= '0';
+          } else if ((c >= 'A') && (c <= 'F')) {
+            c -= 'A' - 10;
+          } else if ((c >= 'a') && (c <= 'f')) {
+            c -= 'a' - 10;
+          } else {
+            return Fail(pos_);
+          }
+          unicode_char = static_cast<uint16_t>((unicode_char << 4) | c);
+        }
+        /* See grpc_json_writer_escape_string to have a description
+         * of what's going on here.
+         */
+        if ((unicode_char & 0xfc00) == 0xd800) {
+          /* high surrogate utf-16 */
+          if (unicode_high_surrogate != 0) return Fail(pos_);
+          unicode_high_surrogate = unicode_char;
+        } else if ((unicode_char & 0xfc00) == 0xdc00) {
+          /* low surrogate utf-16 */
+          if (unicode_high_surrogate == 0) return Fail(pos_);
+          uint32_t utf32 = 0x10000;
+          utf32 += static_cast<uint32_t>((unicode_high_surrogate - 0xd800) *
+                                         0x400);
+          utf32 += static_cast<uint32_t>(unicode_char - 0xdc00);
+          ok = StringAddUtf32(utf32);
+          unicode_high_surrogate = 0;
+        } else {
+          /* anything else */
+          if (unicode_high_surrogate != 0) return Fail(pos_);
+          ok = StringAddUtf32(unicode_char);
         }
         break;
-
+      }
       default:
-        container_just_begun_ = false;
-        switch (state_) {
-          case State::GRPC_JSON_STATE_OBJECT_KEY_BEGIN:
-            if (c != '"') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_OBJECT_KEY_STRING;
-            break;
-
-          case State::GRPC_JSON_STATE_OBJECT_KEY_STRING:
-            if (unicode_high_surrogate_ != 0) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            if (c == '"') {
-              state_ = State::GRPC_JSON_STATE_OBJECT_KEY_END;
-              // Once the key is parsed, there should no un-matched utf8
-              // encoded bytes.
-              if (utf8_bytes_remaining_ != 0) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              SetKey();
-            } else {
-              if (c < 32) return Status::GRPC_JSON_PARSE_ERROR;
-              if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_STRING:
-            if (unicode_high_surrogate_ != 0) {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            if (c == '"') {
-              state_ = State::GRPC_JSON_STATE_VALUE_END;
-              // Once the value is parsed, there should no un-matched utf8
-              // encoded bytes.
-              if (utf8_bytes_remaining_ != 0) {
-                return Status::GRPC_JSON_PARSE_ERROR;
-              }
-              SetString();
-            } else {
-              if (c < 32) return Status::GRPC_JSON_PARSE_ERROR;
-              if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_OBJECT_KEY_END:
-            if (c != ':') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_BEGIN;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_BEGIN:
-            switch (c) {
-              case 't':
-                state_ = State::GRPC_JSON_STATE_VALUE_TRUE_R;
-                break;
-
-              case 'f':
-                state_ = State::GRPC_JSON_STATE_VALUE_FALSE_A;
-                break;
-
-              case 'n':
-                state_ = State::GRPC_JSON_STATE_VALUE_NULL_U;
-                break;
-
-              case '"':
-                state_ = State::GRPC_JSON_STATE_VALUE_STRING;
-                break;
-
-              case '0':
-                if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-                state_ = State::GRPC_JSON_STATE_VALUE_NUMBER_ZERO;
-                break;
-
-              case '1':
-              case '2':
-              case '3':
-              case '4':
-              case '5':
-              case '6':
-              case '7':
-              case '8':
-              case '9':
-              case '-':
-                if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-                state_ = State::GRPC_JSON_STATE_VALUE_NUMBER;
-                break;
-
-              case '{':
-                container_just_begun_ = true;
-                if (!StartContainer(Json::Type::OBJECT)) {
-                  return Status::GRPC_JSON_PARSE_ERROR;
-                }
-                state_ = State::GRPC_JSON_STATE_OBJECT_KEY_BEGIN;
-                break;
-
-              case '[':
-                container_just_begun_ = true;
-                if (!StartContainer(Json::Type::ARRAY)) {
-                  return Status::GRPC_JSON_PARSE_ERROR;
-                }
-                break;
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_STRING_ESCAPE:
-            if (escaped_string_was_key_) {
-              state_ = State::GRPC_JSON_STATE_OBJECT_KEY_STRING;
-            } else {
-              state_ = State::GRPC_JSON_STATE_VALUE_STRING;
-            }
-            if (unicode_high_surrogate_ && c != 'u') {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            switch (c) {
-              case '"':
-              case '/':
-                if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-                break;
-              case 'b':
-                if (!StringAddChar('\b')) return Status::GRPC_JSON_PARSE_ERROR;
-                break;
-              case 'f':
-                if (!StringAddChar('\f')) return Status::GRPC_JSON_PARSE_ERROR;
-                break;
-              case 'n':
-                if (!StringAddChar('\n')) return Status::GRPC_JSON_PARSE_ERROR;
-                break;
-              case 'r':
-                if (!StringAddChar('\r')) return Status::GRPC_JSON_PARSE_ERROR;
-                break;
-              case 't':
-                if (!StringAddChar('\t')) return Status::GRPC_JSON_PARSE_ERROR;
-                break;
-              case 'u':
-                state_ = State::GRPC_JSON_STATE_STRING_ESCAPE_U1;
-                unicode_char_ = 0;
-                break;
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_STRING_ESCAPE_U1:
-          case State::GRPC_JSON_STATE_STRING_ESCAPE_U2:
-          case State::GRPC_JSON_STATE_STRING_ESCAPE_U3:
-          case State::GRPC_JSON_STATE_STRING_ESCAPE_U4:
-            if ((c >= '0') && (c <= '9')) {
-              c -= '0';
-            } else if ((c >= 'A') && (c <= 'F')) {
-              c -= 'A' - 10;
-            } else if ((c >= 'a') && (c <= 'f')) {
-              c -= 'a' - 10;
-            } else {
-              return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            unicode_char_ = static_cast<uint16_t>(unicode_char_ << 4);
-            unicode_char_ = static_cast<uint16_t>(unicode_char_ | c);
-
-            switch (state_) {
-              case State::GRPC_JSON_STATE_STRING_ESCAPE_U1:
-                state_ = State::GRPC_JSON_STATE_STRING_ESCAPE_U2;
-                break;
-              case State::GRPC_JSON_STATE_STRING_ESCAPE_U2:
-                state_ = State::GRPC_JSON_STATE_STRING_ESCAPE_U3;
-                break;
-              case State::GRPC_JSON_STATE_STRING_ESCAPE_U3:
-                state_ = State::GRPC_JSON_STATE_STRING_ESCAPE_U4;
-                break;
-              case State::GRPC_JSON_STATE_STRING_ESCAPE_U4:
-                /* See grpc_json_writer_escape_string to have a description
-                 * of what's going on here.
-                 */
-                if ((unicode_char_ & 0xfc00) == 0xd800) {
-                  /* high surrogate utf-16 */
-                  if (unicode_high_surrogate_ != 0) {
-                    return Status::GRPC_JSON_PARSE_ERROR;
-                  }
-                  unicode_high_surrogate_ = unicode_char_;
-                } else if ((unicode_char_ & 0xfc00) == 0xdc00) {
-                  /* low surrogate utf-16 */
-                  uint32_t utf32;
-                  if (unicode_high_surrogate_ == 0) {
-                    return Status::GRPC_JSON_PARSE_ERROR;
-                  }
-                  utf32 = 0x10000;
-                  utf32 += static_cast<uint32_t>(
-                      (unicode_high_surrogate_ - 0xd800) * 0x400);
-                  utf32 += static_cast<uint32_t>(unicode_char_ - 0xdc00);
-                  if (!StringAddUtf32(utf32)) {
-                    return Status::GRPC_JSON_PARSE_ERROR;
-                  }
-                  unicode_high_surrogate_ = 0;
-                } else {
-                  /* anything else */
-                  if (unicode_high_surrogate_ != 0) {
-                    return Status::GRPC_JSON_PARSE_ERROR;
-                  }
-                  if (!StringAddUtf32(unicode_char_)) {
-                    return Status::GRPC_JSON_PARSE_ERROR;
-                  }
-                }
-                if (escaped_string_was_key_) {
-                  state_ = State::GRPC_JSON_STATE_OBJECT_KEY_STRING;
-                } else {
-                  state_ = State::GRPC_JSON_STATE_VALUE_STRING;
-                }
-                break;
-              default:
-                GPR_UNREACHABLE_CODE(return Status::GRPC_JSON_INTERNAL_ERROR);
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER:
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            switch (c) {
-              case '0':
-              case '1':
-              case '2':
-              case '3':
-              case '4':
-              case '5':
-              case '6':
-              case '7':
-              case '8':
-              case '9':
-                break;
-              case 'e':
-              case 'E':
-                state_ = State::GRPC_JSON_STATE_VALUE_NUMBER_E;
-                break;
-              case '.':
-                state_ = State::GRPC_JSON_STATE_VALUE_NUMBER_DOT;
-                break;
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_WITH_DECIMAL:
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            switch (c) {
-              case '0':
-              case '1':
-              case '2':
-              case '3':
-              case '4':
-              case '5':
-              case '6':
-              case '7':
-              case '8':
-              case '9':
-                break;
-              case 'e':
-              case 'E':
-                state_ = State::GRPC_JSON_STATE_VALUE_NUMBER_E;
-                break;
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_ZERO:
-            if (c != '.') return Status::GRPC_JSON_PARSE_ERROR;
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_NUMBER_DOT;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_DOT:
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            switch (c) {
-              case '0':
-              case '1':
-              case '2':
-              case '3':
-              case '4':
-              case '5':
-              case '6':
-              case '7':
-              case '8':
-              case '9':
-                state_ = State::GRPC_JSON_STATE_VALUE_NUMBER_WITH_DECIMAL;
-                break;
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_E:
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            switch (c) {
-              case '0':
-              case '1':
-              case '2':
-              case '3':
-              case '4':
-              case '5':
-              case '6':
-              case '7':
-              case '8':
-              case '9':
-              case '+':
-              case '-':
-                state_ = State::GRPC_JSON_STATE_VALUE_NUMBER_EPM;
-                break;
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NUMBER_EPM:
-            if (!StringAddChar(c)) return Status::GRPC_JSON_PARSE_ERROR;
-            switch (c) {
-              case '0':
-              case '1':
-              case '2':
-              case '3':
-              case '4':
-              case '5':
-              case '6':
-              case '7':
-              case '8':
-              case '9':
-                break;
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_TRUE_R:
-            if (c != 'r') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_TRUE_U;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_TRUE_U:
-            if (c != 'u') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_TRUE_E;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_TRUE_E:
-            if (c != 'e') return Status::GRPC_JSON_PARSE_ERROR;
-            SetTrue();
-            state_ = State::GRPC_JSON_STATE_VALUE_END;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_FALSE_A:
-            if (c != 'a') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_FALSE_L;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_FALSE_L:
-            if (c != 'l') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_FALSE_S;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_FALSE_S:
-            if (c != 's') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_FALSE_E;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_FALSE_E:
-            if (c != 'e') return Status::GRPC_JSON_PARSE_ERROR;
-            SetFalse();
-            state_ = State::GRPC_JSON_STATE_VALUE_END;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NULL_U:
-            if (c != 'u') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_NULL_L1;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NULL_L1:
-            if (c != 'l') return Status::GRPC_JSON_PARSE_ERROR;
-            state_ = State::GRPC_JSON_STATE_VALUE_NULL_L2;
-            break;
-
-          case State::GRPC_JSON_STATE_VALUE_NULL_L2:
-            if (c != 'l') return Status::GRPC_JSON_PARSE_ERROR;
-            SetNull();
-            state_ = State::GRPC_JSON_STATE_VALUE_END;
-            break;
-
-          /* All of the VALUE_END cases are handled in the specialized case
-           * above. */
-          case State::GRPC_JSON_STATE_VALUE_END:
-            switch (c) {
-              case ',':
-              case '}':
-              case ']':
-                GPR_UNREACHABLE_CODE(return Status::GRPC_JSON_INTERNAL_ERROR);
-                break;
-
-              default:
-                return Status::GRPC_JSON_PARSE_ERROR;
-            }
-            break;
-
-          case State::GRPC_JSON_STATE_END:
-            return Status::GRPC_JSON_PARSE_ERROR;
-        }
+        ok = false;
     }
+    if (!ok) return Fail(pos_);
+    ++pos_;
   }
+}
 
-  GPR_UNREACHABLE_CODE(return Status::GRPC_JSON_INTERNAL_ERROR);
+bool JsonView::Parser::ParseNumber(ParentObject* parent) {
+  const size_t start = pos_;
+  if (input_[pos_] == '-') ++pos_;
+  if (pos_ == size_) return Fail(eof_index_);
+  if (input_[pos_] == '0') {
+    ++pos_;
+  } else if (IsDigit(input_[pos_])) {
+    while (pos_ < size_ && IsDigit(input_[pos_])) ++pos_;
+  } else {
+    return Fail(pos_);
+  }
+  if (pos_ < size_ && input_[pos_] == '.') {
+    ++pos_;
+    if (pos_ == size_ || !IsDigit(input_[pos_])) return Fail(CurrentIndex());
+    while (pos_ < size_ && IsDigit(input_[pos_])) ++pos_;
+  }
+  if (pos_ < size_ && (input_[pos_] == 'e' || input_[pos_] == 'E')) {
+    ++pos_;
+    if (pos_ < size_ && (input_[pos_] == '+' || input_[pos_] == '-')) ++pos_;
+    if (pos_ == size_ || !IsDigit(input_[pos_])) return Fail(CurrentIndex());
+    while (pos_ < size_ && IsDigit(input_[pos_])) ++pos_;
+  }
+  if (pos_ < size_ && !IsWhitespace(input_[pos_]) && input_[pos_] != ',' &&
+      input_[pos_] != '}' && input_[pos_] != ']') {
+    return Fail(pos_);
+  }
+  CheckForDuplicateKey(parent, CurrentIndex());
+  values_.push_back(JsonView(Type::NUMBER,
+                             reinterpret_cast<const char*>(input_) + start,
+                             pos_ - start));
+  return true;
+}
+
+bool JsonView::Parser::ParseLiteral(absl::string_view literal, Type type,
+                                    ParentObject* parent) {
+  for (size_t i = 1; i < literal.size(); ++i) {
+    if (pos_ + i == size_) return Fail(eof_index_);
+    if (input_[pos_ + i] != literal[i]) return Fail(pos_ + i);
+  }
+  pos_ += literal.size();
+  CheckForDuplicateKey(parent, pos_ - 1);
+  values_.push_back(JsonView(type));
+  return true;
 }
 
-grpc_error_handle JsonReader::Parse(absl::string_view input, Json* output) {
-  JsonReader reader(input);
-  Status status = reader.Run();
-  if (reader.truncated_errors_) {
-    reader.errors_.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+const JsonView* JsonView::Parser::Parse(grpc_error_handle* error) {
+  bool ok = ParseValue(nullptr);
+  if (ok) {
+    SkipWhitespace();
+    if (pos_ < size_) ok = Fail(pos_);
+  }
+  if (truncated_errors_) {
+    errors_.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
         "too many errors encountered during JSON parsing -- fix reported "
         "errors and try again to see additional errors"));
   }
-  if (status == Status::GRPC_JSON_INTERNAL_ERROR) {
-    reader.errors_.push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(absl::StrCat(
-        "internal error in JSON parser at index ", reader.CurrentIndex())));
-  } else if (status == Status::GRPC_JSON_PARSE_ERROR) {
-    reader.errors_.push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(
-        absl::StrCat("JSON parse error at index ", reader.CurrentIndex())));
+  if (!ok) {
+    errors_.push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(
+        absl::StrCat("JSON parse error at index ", error_index_)));
   }
-  if (!reader.errors_.empty()) {
-    return GRPC_ERROR_CREATE_FROM_VECTOR("JSON parsing failed",
-                                         &reader.errors_);
+  if (!errors_.empty()) {
+    *error = GRPC_ERROR_CREATE_FROM_VECTOR("JSON parsing failed", &errors_);
+    return nullptr;
   }
-  *output = std::move(reader.root_value_);
-  return GRPC_ERROR_NONE;
+  *error = GRPC_ERROR_NONE;
+  return arena_->New<JsonView>(values_.back());
 }
 
-}  // namespace
+//
+// JsonView
+//
+
+const JsonView* JsonView::Parse(absl::string_view json_str, Arena* arena,
+                                grpc_error_handle* error) {
+  return Parser(json_str, arena).Parse(error);
+}
+
+const JsonView* JsonView::Find(absl::string_view key) const {
+  auto it = std::lower_bound(
+      members_, members_ + size_, key,
+      [](const Member& member, absl::string_view key) {
+        return member.key < key;
+      });
+  if (it == members_ + size_ || it->key != key) return nullptr;
+  return &it->value;
+}
+
+Json JsonView::ToJson() const {
+  Json json;
+  ConvertTo(*this, &json);
+  return json;
+}
+
+//
+// Json
+//
 
 Json Json::Parse(absl::string_view json_str, grpc_error_handle* error) {
-  Json value;
-  *error = JsonReader::Parse(json_str, &value);
-  return value;
+  static MemoryAllocator* memory_allocator = new MemoryAllocator(
+      ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator(
+          "json_parser"));
+  ScopedArenaPtr arena = MakeScopedArena(1024, memory_allocator);
+  const JsonView* value = JsonView::Parse(json_str, arena.get(), error);
+  if (value == nullptr) return Json();
+  return value->ToJson();
 }
 
 }  // namespace grpc_core
@@ -34,11 +34,14 @@
 
 namespace {
 
-void* ArenaStorage(size_t initial_size) {
+size_t ArenaStorageSize(size_t initial_size) {
   static constexpr size_t base_size =
       GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(grpc_core::Arena));
-  initial_size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
-  size_t alloc_size = base_size + initial_size;
+  return base_size + GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
+}
+
+void* ArenaStorage(size_t initial_size) {
+  size_t alloc_size = ArenaStorageSize(initial_size);
   static constexpr size_t alignment =
       (GPR_CACHELINE_SIZE > GPR_MAX_ALIGNMENT &&
        GPR_CACHELINE_SIZE % GPR_MAX_ALIGNMENT == 0)
@@ -76,10 +79,15 @@ std::pair<Arena*, void*> Arena::CreateWithAlloc(
   return std::make_pair(new_arena, first_alloc);
 }
 
-size_t Arena::Destroy() {
+size_t Arena::DestroyInPlace() {
   size_t size = total_used_.load(std::memory_order_relaxed);
   memory_allocator_->Release(total_allocated_.load(std::memory_order_relaxed));
   this->~Arena();
+  return size;
+}
+
+size_t Arena::Destroy() {
+  size_t size = DestroyInPlace();
   gpr_free_aligned(this);
   return size;
 }
@@ -104,4 +112,60 @@ void* Arena::AllocZone(size_t size) {
   return reinterpret_cast<char*>(z) + zone_base_size;
 }
 
+ArenaPool::~ArenaPool() {
+  MutexLock lock(&mu_);
+  for (const PooledArena& pooled : free_list_) {
+    memory_allocator_->Release(ArenaStorageSize(pooled.initial_zone_size));
+    gpr_free_aligned(pooled.storage);
+  }
+}
+
+std::pair<Arena*, void*> ArenaPool::CreateWithAlloc(size_t initial_size,
+                                                    size_t alloc_size) {
+  if (max_pooled_arenas_ == 0) {
+    return Arena::CreateWithAlloc(initial_size, alloc_size, memory_allocator_);
+  }
+  PooledArena pooled{nullptr, 0};
+  {
+    MutexLock lock(&mu_);
+    if (!free_list_.empty()) {
+      pooled = free_list_.back();
+      free_list_.pop_back();
+      memory_allocator_->Release(ArenaStorageSize(pooled.initial_zone_size));
+    }
+  }
+  if (pooled.storage == nullptr) {
+    return Arena::CreateWithAlloc(initial_size, alloc_size, memory_allocator_);
+  }
+  // The call size estimate has grown past what this arena can hold: drop it
+  // rather than overflowing into extra zones for the whole call.
+  if (pooled.initial_zone_size < initial_size) {
+    gpr_free_aligned(pooled.storage);
+    return Arena::CreateWithAlloc(initial_size, alloc_size, memory_allocator_);
+  }
+  static constexpr size_t base_size =
+      GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena));
+  auto* arena = new (pooled.storage)
+      Arena(pooled.initial_zone_size, alloc_size, memory_allocator_);
+  void* first_alloc = reinterpret_cast<char*>(arena) + base_size;
+  return std::make_pair(arena, first_alloc);
+}
+
+size_t ArenaPool::Recycle(Arena* arena) {
+  GPR_DEBUG_ASSERT(arena->memory_allocator_ == memory_allocator_);
+  if (max_pooled_arenas_ == 0) return arena->Destroy();
+  const size_t initial_zone_size = arena->initial_zone_size_;
+  size_t size = arena->DestroyInPlace();
+  {
+    MutexLock lock(&mu_);
+    if (free_list_.size() < max_pooled_arenas_) {
+      memory_allocator_->Reserve(ArenaStorageSize(initial_zone_size));
+      free_list_.push_back(PooledArena{arena, initial_zone_size});
+      return size;
+    }
+  }
+  gpr_free_aligned(arena);
+  return size;
+}
+
 }  // namespace grpc_core
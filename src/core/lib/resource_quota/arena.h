@@ -33,11 +33,13 @@
 #include <memory>
 #include <new>
 #include <utility>
+#include <vector>
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/sync.h>
 
 #include "src/core/lib/gpr/alloc.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/promise/context.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
 
@@ -82,6 +84,8 @@ class Arena {
   }
 
  private:
+  friend class ArenaPool;
+
   struct Zone {
     Zone* prev;
   };
@@ -106,6 +110,11 @@ class Arena {
 
   ~Arena();
 
+  // Release all additional zones back to the memory allocator and run the
+  // destructor, leaving the storage (and initial zone) intact.
+  // Returns the total number of bytes used by the arena.
+  size_t DestroyInPlace();
+
   void* AllocZone(size_t size);
 
   // Keep track of the total used size. We use this in our call sizing
@@ -123,6 +132,43 @@ class Arena {
   MemoryAllocator* const memory_allocator_;
 };
 
+// A bounded free list of arena storage, used to recycle call arenas (and the
+// grpc_call objects placed at their head) across calls on the same channel.
+// Recycled arenas keep their initial zone: subsequent calls reuse it as long as
+// it is at least as large as the requested initial size.
+// While sitting in the pool, the storage is reserved against the memory
+// allocator so that idle cached memory stays visible to the resource quota.
+class ArenaPool {
+ public:
+  ArenaPool(size_t max_pooled_arenas, MemoryAllocator* memory_allocator)
+      : max_pooled_arenas_(max_pooled_arenas),
+        memory_allocator_(memory_allocator) {}
+  ~ArenaPool();
+
+  ArenaPool(const ArenaPool&) = delete;
+  ArenaPool& operator=(const ArenaPool&) = delete;
+
+  // As Arena::CreateWithAlloc, but reuses pooled storage when possible.
+  std::pair<Arena*, void*> CreateWithAlloc(size_t initial_size,
+                                           size_t alloc_size);
+
+  // As Arena::Destroy, but returns the arena storage to the pool if there is
+  // room for it. \a arena must have been created with this pool's memory
+  // allocator.
+  size_t Recycle(Arena* arena);
+
+ private:
+  struct PooledArena {
+    void* storage;
+    size_t initial_zone_size;
+  };
+
+  const size_t max_pooled_arenas_;
+  MemoryAllocator* const memory_allocator_;
+  Mutex mu_;
+  std::vector<PooledArena> free_list_ ABSL_GUARDED_BY(mu_);
+};
+
 // Smart pointer for arenas when the final size is not required.
 struct ScopedArenaDeleter {
   void operator()(Arena* arena) { arena->Destroy(); }
@@ -169,6 +169,10 @@ void GrpcMemoryAllocatorImpl::Shutdown() {
     GPR_ASSERT(!shutdown_);
     shutdown_ = true;
     memory_quota = memory_quota_;
+    if (pressure_watcher_ != nullptr) {
+      memory_quota_->RemovePressureWatcher(
+          absl::exchange(pressure_watcher_, nullptr));
+    }
     for (size_t i = 0; i < kNumReclamationPasses; i++) {
       reclamation_handles[i] = absl::exchange(reclamation_handles_[i], nullptr);
     }
@@ -300,6 +304,11 @@ void GrpcMemoryAllocatorImpl::Rebind(
       reclamation_handles_[i]->Requeue(memory_quota->reclaimer_queue(i));
     }
   }
+  // Move the pressure watcher, if any.
+  if (pressure_watcher_ != nullptr) {
+    memory_quota_->RemovePressureWatcher(pressure_watcher_);
+    memory_quota->AddPressureWatcher(pressure_watcher_);
+  }
   // Switch to the new memory quota, leaving the old one in memory_quota so that
   // when we unref it, we are outside of lock.
   memory_quota_.swap(memory_quota);
@@ -310,6 +319,20 @@ void GrpcMemoryAllocatorImpl::Rebind(
   memory_quota_->Take(taken_bytes_);
 }
 
+void GrpcMemoryAllocatorImpl::SetPressureWatcher(
+    BasicMemoryQuota::PressureWatcher* watcher) {
+  MutexLock lock(&memory_quota_mu_);
+  GPR_ASSERT(!shutdown_);
+  if (pressure_watcher_ == watcher) return;
+  if (pressure_watcher_ != nullptr) {
+    memory_quota_->RemovePressureWatcher(pressure_watcher_);
+  }
+  pressure_watcher_ = watcher;
+  if (pressure_watcher_ != nullptr) {
+    memory_quota_->AddPressureWatcher(pressure_watcher_);
+  }
+}
+
 //
 // MemoryOwner
 //
@@ -427,6 +450,9 @@ void BasicMemoryQuota::Take(size_t amount) {
   if (prior >= 0 && prior < static_cast<intptr_t>(amount)) {
     if (reclaimer_activity_ != nullptr) reclaimer_activity_->ForceWakeup();
   }
+  if (num_pressure_watchers_.load(std::memory_order_relaxed) != 0) {
+    MaybeNotifyPressureWatchers();
+  }
 }
 
 void BasicMemoryQuota::FinishReclamation(uint64_t token, Waker waker) {
@@ -444,6 +470,53 @@ void BasicMemoryQuota::FinishReclamation(uint64_t token, Waker waker) {
 
 void BasicMemoryQuota::Return(size_t amount) {
   free_bytes_.fetch_add(amount, std::memory_order_relaxed);
+  if (num_pressure_watchers_.load(std::memory_order_relaxed) != 0) {
+    MaybeNotifyPressureWatchers();
+  }
+}
+
+void BasicMemoryQuota::AddPressureWatcher(PressureWatcher* watcher) {
+  MutexLock lock(&pressure_watchers_mu_);
+  pressure_watchers_.push_back(watcher);
+  num_pressure_watchers_.store(pressure_watchers_.size(),
+                               std::memory_order_relaxed);
+  NotifyPressureWatchersLocked();
+}
+
+void BasicMemoryQuota::RemovePressureWatcher(PressureWatcher* watcher) {
+  MutexLock lock(&pressure_watchers_mu_);
+  auto it = std::find(pressure_watchers_.begin(), pressure_watchers_.end(),
+                      watcher);
+  GPR_ASSERT(it != pressure_watchers_.end());
+  pressure_watchers_.erase(it);
+  num_pressure_watchers_.store(pressure_watchers_.size(),
+                               std::memory_order_relaxed);
+  NotifyPressureWatchersLocked();
+}
+
+void BasicMemoryQuota::MaybeNotifyPressureWatchers() {
+  const int band = static_cast<int>(
+      InstantaneousPressureAndMaxRecommendedAllocationSize().first *
+      kPressureBands);
+  if (pressure_band_.load(std::memory_order_relaxed) == band) return;
+  MutexLock lock(&pressure_watchers_mu_);
+  NotifyPressureWatchersLocked();
+}
+
+void BasicMemoryQuota::NotifyPressureWatchersLocked() {
+  if (pressure_watchers_.empty()) return;
+  // Sampled under the lock, so that the last notification reflects the
+  // latest pressure even when several threads race to notify.
+  const auto pressure_and_max_recommended_allocation_size =
+      InstantaneousPressureAndMaxRecommendedAllocationSize();
+  const double pressure = pressure_and_max_recommended_allocation_size.first;
+  pressure_band_.store(static_cast<int>(pressure * kPressureBands),
+                       std::memory_order_relaxed);
+  const size_t share = pressure_and_max_recommended_allocation_size.second /
+                       pressure_watchers_.size();
+  for (PressureWatcher* watcher : pressure_watchers_) {
+    watcher->OnPressureChanged(pressure, share);
+  }
 }
 
 std::pair<double, size_t>
@@ -215,6 +215,18 @@ class ReclaimerQueue {
 class BasicMemoryQuota final
     : public std::enable_shared_from_this<BasicMemoryQuota> {
  public:
+  // Told about changes in a quota's memory pressure.
+  class PressureWatcher {
+   public:
+    virtual ~PressureWatcher() = default;
+    // Called with the quota's pressure and this watcher's equal share of the
+    // quota's max recommended allocation size, whenever the pressure moves to
+    // a different band or a watcher is added or removed. Runs on whichever
+    // thread changed the quota, under the watcher list lock: it must be cheap
+    // and must not call back into the quota.
+    virtual void OnPressureChanged(double pressure, size_t share) = 0;
+  };
+
   explicit BasicMemoryQuota(std::string name) : name_(std::move(name)) {}
 
   // Start the reclamation activity.
@@ -239,6 +251,10 @@ class BasicMemoryQuota final
   InstantaneousPressureAndMaxRecommendedAllocationSize() const;
   // Get a reclamation queue
   ReclaimerQueue* reclaimer_queue(size_t i) { return &reclaimers_[i]; }
+  // Add or remove a pressure watcher. Every watcher, including a new one, is
+  // notified of its new share.
+  void AddPressureWatcher(PressureWatcher* watcher);
+  void RemovePressureWatcher(PressureWatcher* watcher);
 
   // The name of this quota
   absl::string_view name() const { return name_; }
@@ -248,6 +264,14 @@ class BasicMemoryQuota final
   class WaitForSweepPromise;
 
   static constexpr intptr_t kInitialSize = std::numeric_limits<intptr_t>::max();
+  // Pressure watchers are notified when the pressure crosses a multiple of
+  // 1/kPressureBands.
+  static constexpr int kPressureBands = 20;
+
+  // Notify pressure watchers if the pressure has moved to a different band.
+  void MaybeNotifyPressureWatchers();
+  void NotifyPressureWatchersLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(pressure_watchers_mu_);
 
   // The amount of memory that's free in this quota.
   // We use intptr_t as a reasonable proxy for ssize_t that's portable.
@@ -268,6 +292,14 @@ class BasicMemoryQuota final
   // We also increment this counter on completion of a sweep, as an indicator
   // that the wait has ended.
   std::atomic<uint64_t> reclamation_counter_{0};
+  // Pressure watchers, and the pressure band they were last notified of.
+  // num_pressure_watchers_ lets Take() and Return() skip the band check when
+  // nobody is watching.
+  Mutex pressure_watchers_mu_;
+  std::vector<PressureWatcher*> pressure_watchers_
+      ABSL_GUARDED_BY(pressure_watchers_mu_);
+  std::atomic<size_t> num_pressure_watchers_{0};
+  std::atomic<int> pressure_band_{0};
   // The name of this quota - used for debugging/tracing/etc..
   std::string name_;
 };
@@ -312,11 +344,23 @@ class GrpcMemoryAllocatorImpl final : public EventEngineMemoryAllocatorImpl {
 
   // Read the instantaneous memory pressure
   double InstantaneousPressure() const {
+    return InstantaneousPressureAndMaxRecommendedAllocationSize().first;
+  }
+
+  // Read the instantaneous memory pressure along with the largest single
+  // allocation the quota currently recommends.
+  std::pair<double, size_t>
+  InstantaneousPressureAndMaxRecommendedAllocationSize() const {
     MutexLock lock(&memory_quota_mu_);
-    return memory_quota_->InstantaneousPressureAndMaxRecommendedAllocationSize()
-        .first;
+    return memory_quota_->InstantaneousPressureAndMaxRecommendedAllocationSize();
   }
 
+  // Register \a watcher with the backing quota, replacing any previously set
+  // watcher; nullptr removes it. The watcher follows the allocator across
+  // Rebind and is removed on Shutdown.
+  void SetPressureWatcher(BasicMemoryQuota::PressureWatcher* watcher)
+      ABSL_LOCKS_EXCLUDED(memory_quota_mu_);
+
   // Name of this allocator
   absl::string_view name() const { return name_; }
 
@@ -353,6 +397,9 @@ class GrpcMemoryAllocatorImpl final : public EventEngineMemoryAllocatorImpl {
       sizeof(GrpcMemoryAllocatorImpl);
   bool shutdown_ ABSL_GUARDED_BY(memory_quota_mu_) = false;
   bool registered_reclaimer_ ABSL_GUARDED_BY(memory_quota_mu_) = false;
+  // Watcher registered with memory_quota_, if any.
+  BasicMemoryQuota::PressureWatcher* pressure_watcher_
+      ABSL_GUARDED_BY(memory_quota_mu_) = nullptr;
   // Indices into the various reclaimer queues, used so that we can cancel
   // reclamation should we shutdown or get rebound.
   OrphanablePtr<ReclaimerQueue::Handle>
@@ -391,6 +438,19 @@ class MemoryOwner final : public MemoryAllocator {
     return impl()->InstantaneousPressure();
   }
 
+  // Instantaneous memory pressure in the underlying quota, and the largest
+  // allocation it currently recommends.
+  std::pair<double, size_t>
+  InstantaneousPressureAndMaxRecommendedAllocationSize() const {
+    return impl()->InstantaneousPressureAndMaxRecommendedAllocationSize();
+  }
+
+  // Have \a watcher told about pressure changes in the underlying quota until
+  // it is replaced, or this owner is reset.
+  void SetPressureWatcher(BasicMemoryQuota::PressureWatcher* watcher) {
+    impl()->SetPressureWatcher(watcher);
+  }
+
   template <typename T, typename... Args>
   OrphanablePtr<T> MakeOrphanable(Args&&... args) {
     return OrphanablePtr<T>(New<T>(std::forward<Args>(args)...));
@@ -18,8 +18,11 @@
 
 #include "src/core/lib/service_config/service_config.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 
 #include <grpc/support/log.h>
@@ -30,18 +33,50 @@
 
 namespace grpc_core {
 
+namespace {
+
+// Returns true if the two service config objects have the same fields other
+// than methodConfig, which are what the global params are parsed from.
+bool GlobalParamsEqual(const Json::Object& a, const Json::Object& b) {
+  auto a_it = a.begin();
+  auto b_it = b.begin();
+  while (true) {
+    if (a_it != a.end() && a_it->first == "methodConfig") ++a_it;
+    if (b_it != b.end() && b_it->first == "methodConfig") ++b_it;
+    if (a_it == a.end() || b_it == b.end()) {
+      return a_it == a.end() && b_it == b.end();
+    }
+    if (*a_it != *b_it) return false;
+    ++a_it;
+    ++b_it;
+  }
+}
+
+}  // namespace
+
 RefCountedPtr<ServiceConfig> ServiceConfig::Create(
     const grpc_channel_args* args, absl::string_view json_string,
     grpc_error_handle* error) {
+  return Create(args, json_string, /*previous=*/nullptr, error);
+}
+
+RefCountedPtr<ServiceConfig> ServiceConfig::Create(
+    const grpc_channel_args* args, absl::string_view json_string,
+    ServiceConfig* previous, grpc_error_handle* error) {
   GPR_DEBUG_ASSERT(error != nullptr);
+  if (previous != nullptr && previous->json_string_ == json_string) {
+    *error = GRPC_ERROR_NONE;
+    return previous->Ref();
+  }
   Json json = Json::Parse(json_string, error);
   if (*error != GRPC_ERROR_NONE) return nullptr;
   return MakeRefCounted<ServiceConfig>(args, std::string(json_string),
-                                       std::move(json), error);
+                                       std::move(json), previous, error);
 }
 
 ServiceConfig::ServiceConfig(const grpc_channel_args* args,
                              std::string json_string, Json json,
+                             const ServiceConfig* previous,
                              grpc_error_handle* error)
     : json_string_(std::move(json_string)), json_(std::move(json)) {
   GPR_DEBUG_ASSERT(error != nullptr);
@@ -51,11 +86,18 @@ ServiceConfig::ServiceConfig(const grpc_channel_args* args,
     return;
   }
   std::vector<grpc_error_handle> error_list;
-  grpc_error_handle global_error = GRPC_ERROR_NONE;
-  parsed_global_configs_ =
-      ServiceConfigParser::ParseGlobalParameters(args, json_, &global_error);
-  if (global_error != GRPC_ERROR_NONE) error_list.push_back(global_error);
-  grpc_error_handle local_error = ParsePerMethodParams(args);
+  if (previous != nullptr &&
+      GlobalParamsEqual(json_.object_value(), previous->json_.object_value())) {
+    parsed_global_configs_ = previous->parsed_global_configs_;
+  } else {
+    grpc_error_handle global_error = GRPC_ERROR_NONE;
+    parsed_global_configs_ =
+        std::make_shared<ServiceConfigParser::ParsedConfigVector>(
+            ServiceConfigParser::ParseGlobalParameters(args, json_,
+                                                       &global_error));
+    if (global_error != GRPC_ERROR_NONE) error_list.push_back(global_error);
+  }
+  grpc_error_handle local_error = ParsePerMethodParams(args, previous);
   if (local_error != GRPC_ERROR_NONE) error_list.push_back(local_error);
   if (!error_list.empty()) {
     *error = GRPC_ERROR_CREATE_FROM_VECTOR("Service config parsing error",
@@ -70,22 +112,47 @@ ServiceConfig::~ServiceConfig() {
 }
 
 grpc_error_handle ServiceConfig::ParseJsonMethodConfig(
-    const grpc_channel_args* args, const Json& json) {
+    const grpc_channel_args* args, const Json& json,
+    const ServiceConfig* previous) {
   std::vector<grpc_error_handle> error_list;
-  // Parse method config with each registered parser.
-  auto parsed_configs =
-      absl::make_unique<ServiceConfigParser::ParsedConfigVector>();
-  grpc_error_handle parser_error = GRPC_ERROR_NONE;
-  *parsed_configs =
-      ServiceConfigParser::ParsePerMethodParameters(args, json, &parser_error);
-  if (parser_error != GRPC_ERROR_NONE) {
-    error_list.push_back(parser_error);
-  }
-  parsed_method_config_vectors_storage_.push_back(std::move(parsed_configs));
-  const auto* vector_ptr = parsed_method_config_vectors_storage_.back().get();
+  auto method_config = absl::make_unique<MethodConfig>();
+  method_config->json = &json;
+  // If the previous config had the same method config for the first name,
+  // share what was parsed from it.
+  auto it = json.object_value().find("name");
+  if (previous != nullptr && it != json.object_value().end() &&
+      it->second.type() == Json::Type::ARRAY) {
+    for (const Json& name : it->second.array_value()) {
+      grpc_error_handle parse_error = GRPC_ERROR_NONE;
+      std::string path = ParseJsonMethodName(name, &parse_error);
+      if (parse_error != GRPC_ERROR_NONE) {
+        GRPC_ERROR_UNREF(parse_error);
+        continue;
+      }
+      const MethodConfig* previous_method_config =
+          previous->FindMethodConfig(path);
+      if (previous_method_config != nullptr &&
+          *previous_method_config->json == json) {
+        method_config->parsed_configs = previous_method_config->parsed_configs;
+      }
+      break;
+    }
+  }
+  // Otherwise, parse method config with each registered parser.
+  if (method_config->parsed_configs == nullptr) {
+    grpc_error_handle parser_error = GRPC_ERROR_NONE;
+    method_config->parsed_configs =
+        std::make_shared<ServiceConfigParser::ParsedConfigVector>(
+            ServiceConfigParser::ParsePerMethodParameters(args, json,
+                                                          &parser_error));
+    if (parser_error != GRPC_ERROR_NONE) {
+      error_list.push_back(parser_error);
+    }
+  }
+  method_configs_storage_.push_back(std::move(method_config));
+  const auto* method_config_ptr = method_configs_storage_.back().get();
   // Add an entry for each path.
   bool found_name = false;
-  auto it = json.object_value().find("name");
   if (it != json.object_value().end()) {
     if (it->second.type() != Json::Type::ARRAY) {
       error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
@@ -101,11 +168,11 @@ grpc_error_handle ServiceConfig::ParseJsonMethodConfig(
       } else {
         found_name = true;
         if (path.empty()) {
-          if (default_method_config_vector_ != nullptr) {
+          if (default_method_config_ != nullptr) {
             error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
                 "field:name error:multiple default method configs"));
           }
-          default_method_config_vector_ = vector_ptr;
+          default_method_config_ = method_config_ptr;
         } else {
           grpc_slice key = grpc_slice_from_copied_string(path.c_str());
           // If the key is not already present in the map, this will
@@ -118,20 +185,20 @@ grpc_error_handle ServiceConfig::ParseJsonMethodConfig(
             // key we just created.
             grpc_slice_unref_internal(key);
           } else {
-            value = vector_ptr;
+            value = method_config_ptr;
           }
         }
       }
     }
   }
   if (!found_name) {
-    parsed_method_config_vectors_storage_.pop_back();
+    method_configs_storage_.pop_back();
   }
   return GRPC_ERROR_CREATE_FROM_VECTOR("methodConfig", &error_list);
 }
 
 grpc_error_handle ServiceConfig::ParsePerMethodParams(
-    const grpc_channel_args* args) {
+    const grpc_channel_args* args, const ServiceConfig* previous) {
   std::vector<grpc_error_handle> error_list;
   auto it = json_.object_value().find("methodConfig");
   if (it != json_.object_value().end()) {
@@ -145,7 +212,8 @@ grpc_error_handle ServiceConfig::ParsePerMethodParams(
             "field:methodConfig error:not of type Object"));
         continue;
       }
-      grpc_error_handle error = ParseJsonMethodConfig(args, method_config);
+      grpc_error_handle error =
+          ParseJsonMethodConfig(args, method_config, previous);
       if (error != GRPC_ERROR_NONE) {
         error_list.push_back(error);
       }
@@ -203,25 +271,38 @@ std::string ServiceConfig::ParseJsonMethodName(const Json& json,
                       method_name == nullptr ? "" : *method_name);
 }
 
+const ServiceConfig::MethodConfig* ServiceConfig::FindMethodConfig(
+    absl::string_view path) const {
+  if (path.empty()) return default_method_config_;
+  auto it = parsed_method_configs_map_.find(
+      grpc_slice_from_static_buffer(path.data(), path.size()));
+  if (it == parsed_method_configs_map_.end()) return nullptr;
+  return it->second;
+}
+
 const ServiceConfigParser::ParsedConfigVector*
 ServiceConfig::GetMethodParsedConfigVector(const grpc_slice& path) const {
-  if (parsed_method_configs_map_.empty()) {
-    return default_method_config_vector_;
-  }
-  // Try looking up the full path in the map.
-  auto it = parsed_method_configs_map_.find(path);
-  if (it != parsed_method_configs_map_.end()) return it->second;
-  // If we didn't find a match for the path, try looking for a wildcard
-  // entry (i.e., change "/service/method" to "/service/").
-  UniquePtr<char> path_str(grpc_slice_to_c_string(path));
-  char* sep = strrchr(path_str.get(), '/');
-  if (sep == nullptr) return nullptr;  // Shouldn't ever happen.
-  sep[1] = '\0';
-  grpc_slice wildcard_path = grpc_slice_from_static_string(path_str.get());
-  it = parsed_method_configs_map_.find(wildcard_path);
-  if (it != parsed_method_configs_map_.end()) return it->second;
-  // Try default method config, if set.
-  return default_method_config_vector_;
+  const MethodConfig* method_config = default_method_config_;
+  if (!parsed_method_configs_map_.empty()) {
+    // Try looking up the full path in the map.
+    auto it = parsed_method_configs_map_.find(path);
+    if (it != parsed_method_configs_map_.end()) {
+      method_config = it->second;
+    } else {
+      // If we didn't find a match for the path, try looking for a wildcard
+      // entry (i.e., change "/service/method" to "/service/").
+      UniquePtr<char> path_str(grpc_slice_to_c_string(path));
+      char* sep = strrchr(path_str.get(), '/');
+      if (sep == nullptr) return nullptr;  // Shouldn't ever happen.
+      sep[1] = '\0';
+      grpc_slice wildcard_path = grpc_slice_from_static_string(path_str.get());
+      it = parsed_method_configs_map_.find(wildcard_path);
+      // Otherwise, use the default method config, if set.
+      if (it != parsed_method_configs_map_.end()) method_config = it->second;
+    }
+  }
+  if (method_config == nullptr) return nullptr;
+  return method_config->parsed_configs.get();
 }
 
 }  // namespace grpc_core
@@ -19,6 +19,8 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "absl/container/inlined_vector.h"
@@ -68,19 +70,38 @@ class ServiceConfig : public RefCounted<ServiceConfig> {
   static RefCountedPtr<ServiceConfig> Create(const grpc_channel_args* args,
                                              absl::string_view json_string,
                                              grpc_error_handle* error);
+  /// As above, but shares the parsed configs of \a previous, a valid config
+  /// created with the same \a args, for the parts of the JSON that have not
+  /// changed.  If nothing has changed, returns \a previous.
+  static RefCountedPtr<ServiceConfig> Create(const grpc_channel_args* args,
+                                             absl::string_view json_string,
+                                             ServiceConfig* previous,
+                                             grpc_error_handle* error);
 
   ServiceConfig(const grpc_channel_args* args, std::string json_string,
-                Json json, grpc_error_handle* error);
+                Json json, grpc_error_handle* error)
+      : ServiceConfig(args, std::move(json_string), std::move(json),
+                      /*previous=*/nullptr, error) {}
+  ServiceConfig(const grpc_channel_args* args, std::string json_string,
+                Json json, const ServiceConfig* previous,
+                grpc_error_handle* error);
   ~ServiceConfig() override;
 
   const std::string& json_string() const { return json_string_; }
 
+  /// Returns true if the global parsed configs are the same objects as
+  /// those of \a other, as happens when \a other was passed as the previous
+  /// config to Create() and only the method configs changed.
+  bool SharesGlobalParsedConfigsWith(const ServiceConfig& other) const {
+    return parsed_global_configs_ == other.parsed_global_configs_;
+  }
+
   /// Retrieves the global parsed config at index \a index. The
   /// lifetime of the returned object is tied to the lifetime of the
   /// ServiceConfig object.
   ServiceConfigParser::ParsedConfig* GetGlobalParsedConfig(size_t index) {
-    GPR_DEBUG_ASSERT(index < parsed_global_configs_.size());
-    return parsed_global_configs_[index].get();
+    GPR_DEBUG_ASSERT(index < parsed_global_configs_->size());
+    return (*parsed_global_configs_)[index].get();
   }
 
   /// Retrieves the vector of parsed configs for the method identified
@@ -90,36 +111,47 @@ class ServiceConfig : public RefCounted<ServiceConfig> {
       const grpc_slice& path) const;
 
  private:
+  // A method config and the configs parsed from it, which may be shared
+  // with other ServiceConfigs.
+  struct MethodConfig {
+    // Points into json_.
+    const Json* json;
+    std::shared_ptr<const ServiceConfigParser::ParsedConfigVector>
+        parsed_configs;
+  };
+
   // Helper functions for parsing the method configs.
-  grpc_error_handle ParsePerMethodParams(const grpc_channel_args* args);
+  grpc_error_handle ParsePerMethodParams(const grpc_channel_args* args,
+                                         const ServiceConfig* previous);
   grpc_error_handle ParseJsonMethodConfig(const grpc_channel_args* args,
-                                          const Json& json);
+                                          const Json& json,
+                                          const ServiceConfig* previous);
 
   // Returns a path string for the JSON name object specified by json.
   // Sets *error on error.
   static std::string ParseJsonMethodName(const Json& json,
                                          grpc_error_handle* error);
 
+  // Returns the method config for exactly \a path, or the default method
+  // config if \a path is empty.
+  const MethodConfig* FindMethodConfig(absl::string_view path) const;
+
   std::string json_string_;
   Json json_;
 
-  absl::InlinedVector<std::unique_ptr<ServiceConfigParser::ParsedConfig>,
-                      ServiceConfigParser::kNumPreallocatedParsers>
+  std::shared_ptr<ServiceConfigParser::ParsedConfigVector>
       parsed_global_configs_;
-  // A map from the method name to the parsed config vector. Note that we are
+  // A map from the method name to the method config. Note that we are
   // using a raw pointer and not a unique pointer so that we can use the same
-  // vector for multiple names.
-  std::unordered_map<grpc_slice, const ServiceConfigParser::ParsedConfigVector*,
-                     SliceHash>
+  // config for multiple names.
+  std::unordered_map<grpc_slice, const MethodConfig*, SliceHash>
       parsed_method_configs_map_;
   // Default method config.
-  const ServiceConfigParser::ParsedConfigVector* default_method_config_vector_ =
-      nullptr;
-  // Storage for all the vectors that are being used in
-  // parsed_method_configs_table_.
-  absl::InlinedVector<std::unique_ptr<ServiceConfigParser::ParsedConfigVector>,
-                      32>
-      parsed_method_config_vectors_storage_;
+  const MethodConfig* default_method_config_ = nullptr;
+  // Storage for all the method configs that are being used in
+  // parsed_method_configs_map_.
+  absl::InlinedVector<std::unique_ptr<MethodConfig>, 32>
+      method_configs_storage_;
 };
 
 }  // namespace grpc_core
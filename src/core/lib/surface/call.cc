@@ -347,8 +347,8 @@ grpc_error_handle grpc_call_create(grpc_call_create_args* args,
       call_and_stack_size + (args->parent ? sizeof(child_call) : 0);
 
   std::pair<grpc_core::Arena*, void*> arena_with_call =
-      grpc_core::Arena::CreateWithAlloc(initial_size, call_alloc_size,
-                                        &*args->channel->allocator);
+      args->channel->arena_pool->CreateWithAlloc(initial_size,
+                                                 call_alloc_size);
   arena = arena_with_call.first;
   call = new (arena_with_call.second) grpc_call(arena, *args);
   *out_call = call;
@@ -515,7 +515,8 @@ static void release_call(void* call, grpc_error_handle /*error*/) {
   grpc_channel* channel = c->channel;
   grpc_core::Arena* arena = c->arena;
   c->~grpc_call();
-  grpc_channel_update_call_size_estimate(channel, arena->Destroy());
+  grpc_channel_update_call_size_estimate(channel,
+                                         channel->arena_pool->Recycle(arena));
   GRPC_CHANNEL_INTERNAL_UNREF(channel, "call");
 }
 
@@ -606,7 +607,8 @@ static void execute_batch_in_call_combiner(void* arg,
   grpc_transport_stream_op_batch* batch =
       static_cast<grpc_transport_stream_op_batch*>(arg);
   grpc_call* call = static_cast<grpc_call*>(batch->handler_private.extra_arg);
-  grpc_call_element* elem = CALL_ELEM_FROM_CALL(call, 0);
+  grpc_call_element* elem =
+      grpc_call_stack_skip_passthrough(CALL_ELEM_FROM_CALL(call, 0));
   GRPC_CALL_LOG_OP(GPR_INFO, elem, batch);
   elem->filter->start_transport_stream_op_batch(elem, batch);
 }
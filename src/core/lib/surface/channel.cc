@@ -90,6 +90,10 @@ grpc_channel* grpc_channel_create_with_builder(
   channel->allocator.Init(grpc_core::ResourceQuotaFromChannelArgs(args)
                               ->memory_quota()
                               ->CreateMemoryOwner(name));
+  channel->arena_pool.Init(
+      static_cast<size_t>(grpc_channel_args_find_integer(
+          args, GRPC_ARG_CALL_ARENA_POOL_SIZE, {0, 0, INT_MAX})),
+      &*channel->allocator);
 
   gpr_atm_no_barrier_store(
       &channel->call_size_estimate,
@@ -478,6 +482,7 @@ static void destroy_channel(void* arg, grpc_error_handle /*error*/) {
   }
   grpc_channel_stack_destroy(CHANNEL_STACK_FROM_CHANNEL(channel));
   channel->registration_table.Destroy();
+  channel->arena_pool.Destroy();
   channel->allocator.Destroy();
   channel->target.Destroy();
   gpr_free(channel);
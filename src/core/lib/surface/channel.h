@@ -27,6 +27,7 @@
 #include "src/core/lib/channel/channel_stack_builder.h"
 #include "src/core/lib/channel/channelz.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/resource_quota/arena.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
 #include "src/core/lib/surface/channel_stack_type.h"
 
@@ -109,6 +110,8 @@ struct grpc_channel {
       registration_table;
   grpc_core::RefCountedPtr<grpc_core::channelz::ChannelNode> channelz_node;
   grpc_core::ManualConstructor<grpc_core::MemoryAllocator> allocator;
+  // Free list of call arenas; must be destroyed before the allocator.
+  grpc_core::ManualConstructor<grpc_core::ArenaPool> arena_pool;
 
   grpc_core::ManualConstructor<std::string> target;
 };
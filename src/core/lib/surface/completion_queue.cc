@@ -40,6 +40,7 @@
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/tls.h"
 #include "src/core/lib/iomgr/executor.h"
+#include "src/core/lib/iomgr/iomgr.h"
 #include "src/core/lib/iomgr/pollset.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
@@ -936,6 +937,34 @@ class ExecCtxNext : public grpc_core::ExecCtx {
   void* check_ready_to_finish_arg_;
 };
 
+/* Busy polling (GRPC_POLL_BUSY_SPIN_US): a thread that would block waiting for
+   completions first keeps polling with a zero timeout for the spin budget,
+   so that completions arriving within it are picked up without a trip
+   through the scheduler. */
+class BusyPollBudget {
+ public:
+  BusyPollBudget() {
+    int spin_us = grpc_iomgr_busy_poll_spin_us();
+    if (spin_us > 0) {
+      spinning_ = true;
+      spin_end_ = gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                               gpr_time_from_micros(spin_us, GPR_TIMESPAN));
+    }
+  }
+
+  /* Returns the deadline to poll with for this iteration. */
+  grpc_millis PollDeadline(grpc_millis deadline) {
+    if (!spinning_ || deadline == 0) return deadline;
+    if (gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), spin_end_) < 0) return 0;
+    spinning_ = false;
+    return deadline;
+  }
+
+ private:
+  bool spinning_ = false;
+  gpr_timespec spin_end_;
+};
+
 #ifndef NDEBUG
 static void dump_pending_tags(grpc_completion_queue* cq) {
   if (!GRPC_TRACE_FLAG_ENABLED(grpc_trace_pending_tags)) return;
@@ -983,6 +1012,7 @@ static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
       nullptr,
       true};
   ExecCtxNext exec_ctx(&is_finished_arg);
+  BusyPollBudget busy_poll;
   for (;;) {
     grpc_millis iteration_deadline = deadline_millis;
 
@@ -1045,7 +1075,8 @@ static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
     gpr_mu_lock(cq->mu);
     cq->num_polls++;
     grpc_error_handle err = cq->poller_vtable->work(
-        POLLSET_FROM_CQ(cq), nullptr, iteration_deadline);
+        POLLSET_FROM_CQ(cq), nullptr,
+        busy_poll.PollDeadline(iteration_deadline));
     gpr_mu_unlock(cq->mu);
 
     if (err != GRPC_ERROR_NONE) {
@@ -1232,6 +1263,7 @@ static grpc_event cq_pluck(grpc_completion_queue* cq, void* tag,
       tag,
       true};
   ExecCtxPluck exec_ctx(&is_finished_arg);
+  BusyPollBudget busy_poll;
   for (;;) {
     if (is_finished_arg.stolen_completion != nullptr) {
       gpr_mu_unlock(cq->mu);
@@ -1290,8 +1322,8 @@ static grpc_event cq_pluck(grpc_completion_queue* cq, void* tag,
       break;
     }
     cq->num_polls++;
-    grpc_error_handle err =
-        cq->poller_vtable->work(POLLSET_FROM_CQ(cq), &worker, deadline_millis);
+    grpc_error_handle err = cq->poller_vtable->work(
+        POLLSET_FROM_CQ(cq), &worker, busy_poll.PollDeadline(deadline_millis));
     if (err != GRPC_ERROR_NONE) {
       del_plucker(cq, tag, &worker);
       gpr_mu_unlock(cq->mu);
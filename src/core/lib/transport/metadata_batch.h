@@ -325,6 +325,13 @@ struct GrpcAcceptEncodingMetadata {
   static std::string DisplayValue(MementoType x) { return x.ToString(); }
 };
 
+// grpc-accept-stream-encoding metadata trait: the algorithms for which the
+// sender decompresses all messages of a stream with one context, so that its
+// peer may compress them with history (see MessageCompressor).
+struct GrpcAcceptStreamEncodingMetadata : public GrpcAcceptEncodingMetadata {
+  static absl::string_view key() { return "grpc-accept-stream-encoding"; }
+};
+
 struct SimpleSliceBasedMetadata {
   using ValueType = Slice;
   using MementoType = Slice;
@@ -424,6 +431,13 @@ struct GrpcStatusMetadata
   static absl::string_view key() { return "grpc-status"; }
 };
 
+// grpc-accept-encoding-dictionary metadata trait: comma-separated ids of the
+// zstd dictionaries the sender decompresses with.
+struct GrpcAcceptEncodingDictionaryMetadata : public SimpleSliceBasedMetadata {
+  static constexpr bool kRepeatable = false;
+  static absl::string_view key() { return "grpc-accept-encoding-dictionary"; }
+};
+
 // grpc-previous-rpc-attempts metadata trait.
 struct GrpcPreviousRpcAttemptsMetadata
     : public SimpleIntBasedMetadata<uint32_t, 0> {
@@ -1340,7 +1354,10 @@ using grpc_metadata_batch_base = grpc_core::MetadataMap<
     // Non-colon prefixed headers begin here
     grpc_core::ContentTypeMetadata, grpc_core::TeMetadata,
     grpc_core::GrpcEncodingMetadata, grpc_core::GrpcInternalEncodingRequest,
-    grpc_core::GrpcAcceptEncodingMetadata, grpc_core::GrpcStatusMetadata,
+    grpc_core::GrpcAcceptEncodingMetadata,
+    grpc_core::GrpcAcceptStreamEncodingMetadata,
+    grpc_core::GrpcAcceptEncodingDictionaryMetadata,
+    grpc_core::GrpcStatusMetadata,
     grpc_core::GrpcTimeoutMetadata, grpc_core::GrpcPreviousRpcAttemptsMetadata,
     grpc_core::GrpcRetryPushbackMsMetadata, grpc_core::UserAgentMetadata,
     grpc_core::GrpcMessageMetadata, grpc_core::HostMetadata,
@@ -87,6 +87,7 @@ void grpc_transport_move_one_way_stats(grpc_transport_one_way_stats* from,
   move64bits(&from->framing_bytes, &to->framing_bytes);
   move64bits(&from->data_bytes, &to->data_bytes);
   move64bits(&from->header_bytes, &to->header_bytes);
+  move64bits(&from->queueing_delay_ns, &to->queueing_delay_ns);
 }
 
 void grpc_transport_move_stats(grpc_transport_stream_stats* from,
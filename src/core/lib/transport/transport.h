@@ -189,6 +189,9 @@ struct grpc_transport_one_way_stats {
   uint64_t framing_bytes = 0;
   uint64_t data_bytes = 0;
   uint64_t header_bytes = 0;
+  // Time spent queued inside the transport waiting for a write (only tracked
+  // for outgoing data).
+  uint64_t queueing_delay_ns = 0;
 };
 
 struct grpc_transport_stream_stats {
@@ -21,6 +21,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <map>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <grpc/grpc_security.h>
@@ -555,6 +558,37 @@ TEST_F(ChannelzRegistryBasedTest, ManyServersTest) {
   ValidateGetServers(10);
 }
 
+TEST(ChannelzSocketTest, TransportLatencyRenderedAsOptions) {
+  ExecCtx exec_ctx;
+  auto socket = MakeRefCounted<SocketNode>(
+      "ipv4:127.0.0.1:1234", "ipv4:127.0.0.1:5678", "test_socket", nullptr);
+  EXPECT_FALSE(socket->transport_latency().has_value());
+  Json json = socket->RenderJson();
+  EXPECT_EQ(json.object_value().at("data").object_value().count("option"), 0);
+  SocketNode::TransportLatency latency;
+  latency.min_rtt_us = 100;
+  latency.smoothed_rtt_us = 150;
+  latency.rtt_variance_us = 25;
+  latency.queueing_delay_us = 7;
+  latency.bdp_bytes = 65536;
+  socket->RecordTransportLatency(latency);
+  ASSERT_TRUE(socket->transport_latency().has_value());
+  EXPECT_EQ(socket->transport_latency()->smoothed_rtt_us, 150);
+  json = socket->RenderJson();
+  const Json::Array& options =
+      json.object_value().at("data").object_value().at("option").array_value();
+  std::map<std::string, std::string> values;
+  for (const Json& option : options) {
+    values[option.object_value().at("name").string_value()] =
+        option.object_value().at("value").string_value();
+  }
+  EXPECT_EQ(values["grpc.transport.min_rtt_us"], "100");
+  EXPECT_EQ(values["grpc.transport.smoothed_rtt_us"], "150");
+  EXPECT_EQ(values["grpc.transport.rtt_variance_us"], "25");
+  EXPECT_EQ(values["grpc.transport.queueing_delay_us"], "7");
+  EXPECT_EQ(values["grpc.transport.bdp_bytes"], "65536");
+}
+
 INSTANTIATE_TEST_SUITE_P(ChannelzChannelTestSweep, ChannelzChannelTest,
                          ::testing::Values(0, 8, 64, 1024, 1024 * 1024));
 
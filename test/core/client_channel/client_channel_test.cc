@@ -0,0 +1,158 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/filters/client_channel/client_channel.h"
+
+#include <gtest/gtest.h>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/grpc.h>
+#include <grpc/grpc_security.h>
+
+#include "src/core/ext/filters/client_channel/resolver/fake/fake_resolver.h"
+#include "src/core/lib/service_config/service_config.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+// A service config with the given global retry throttling and per-method
+// timeout.
+std::string ServiceConfigJson(int max_tokens, const char* timeout) {
+  return absl::StrCat(
+      "{\n"
+      "  \"retryThrottling\": {\n"
+      "    \"maxTokens\": ",
+      max_tokens,
+      ",\n"
+      "    \"tokenRatio\": 1.0\n"
+      "  },\n"
+      "  \"methodConfig\": [ {\n"
+      "    \"name\": [ { \"service\": \"TestServ\" } ],\n"
+      "    \"timeout\": \"",
+      timeout,
+      "\"\n"
+      "  } ]\n"
+      "}");
+}
+
+// Feeds service configs to a client channel through the fake resolver and
+// checks which updates rebuild its dynamic filter stack.
+class ClientChannelServiceConfigUpdateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    response_generator_ = MakeRefCounted<FakeResolverResponseGenerator>();
+    grpc_arg arg = FakeResolverResponseGenerator::MakeChannelArg(
+        response_generator_.get());
+    grpc_channel_args args = {1, &arg};
+    grpc_channel_credentials* creds = grpc_insecure_credentials_create();
+    channel_ = grpc_channel_create("fake:target", creds, &args);
+    grpc_channel_credentials_release(creds);
+    client_channel_ = ClientChannel::GetFromChannel(channel_);
+    ASSERT_NE(client_channel_, nullptr);
+    // Have the channel start its resolver.
+    ExecCtx exec_ctx;
+    client_channel_->CheckConnectivityState(/*try_to_connect=*/true);
+  }
+
+  void TearDown() override { grpc_channel_destroy(channel_); }
+
+  // Creates a service config from \a json, sharing what it can with
+  // \a previous.
+  static RefCountedPtr<ServiceConfig> CreateServiceConfig(
+      const std::string& json, ServiceConfig* previous) {
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    auto service_config =
+        ServiceConfig::Create(nullptr, json, previous, &error);
+    EXPECT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+    GRPC_ERROR_UNREF(error);
+    return service_config;
+  }
+
+  // Has the resolver return \a service_config and waits for the channel to
+  // use it for new calls.
+  void ApplyServiceConfig(RefCountedPtr<ServiceConfig> service_config) {
+    ServiceConfig* expected = service_config.get();
+    {
+      ExecCtx exec_ctx;
+      Resolver::Result result;
+      result.addresses = ServerAddressList();
+      result.service_config = std::move(service_config);
+      response_generator_->SetResponse(std::move(result));
+    }
+    const gpr_timespec deadline = grpc_timeout_seconds_to_deadline(5);
+    while (client_channel_->TestOnlyServiceConfig().get() != expected) {
+      ASSERT_LT(gpr_time_cmp(gpr_now(deadline.clock_type), deadline), 0)
+          << "timed out waiting for service config";
+      gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(10));
+    }
+  }
+
+  RefCountedPtr<FakeResolverResponseGenerator> response_generator_;
+  grpc_channel* channel_ = nullptr;
+  ClientChannel* client_channel_ = nullptr;
+};
+
+TEST_F(ClientChannelServiceConfigUpdateTest, MethodOnlyUpdateKeepsFilters) {
+  // Covers the release of the filters held by the test.
+  ExecCtx exec_ctx;
+  auto service_config =
+      CreateServiceConfig(ServiceConfigJson(10, "1s"), nullptr);
+  ApplyServiceConfig(service_config);
+  RefCountedPtr<DynamicFilters> filters =
+      client_channel_->TestOnlyDynamicFilters();
+  ASSERT_NE(filters, nullptr);
+  auto updated_config =
+      CreateServiceConfig(ServiceConfigJson(10, "2s"), service_config.get());
+  ASSERT_NE(updated_config, service_config);
+  ASSERT_TRUE(updated_config->SharesGlobalParsedConfigsWith(*service_config));
+  ApplyServiceConfig(updated_config);
+  EXPECT_EQ(client_channel_->TestOnlyDynamicFilters(), filters);
+}
+
+TEST_F(ClientChannelServiceConfigUpdateTest, GlobalUpdateRebuildsFilters) {
+  // Covers the release of the filters held by the test.
+  ExecCtx exec_ctx;
+  auto service_config =
+      CreateServiceConfig(ServiceConfigJson(10, "1s"), nullptr);
+  ApplyServiceConfig(service_config);
+  RefCountedPtr<DynamicFilters> filters =
+      client_channel_->TestOnlyDynamicFilters();
+  ASSERT_NE(filters, nullptr);
+  auto updated_config =
+      CreateServiceConfig(ServiceConfigJson(20, "1s"), service_config.get());
+  ASSERT_FALSE(updated_config->SharesGlobalParsedConfigsWith(*service_config));
+  ApplyServiceConfig(updated_config);
+  RefCountedPtr<DynamicFilters> updated_filters =
+      client_channel_->TestOnlyDynamicFilters();
+  ASSERT_NE(updated_filters, nullptr);
+  EXPECT_NE(updated_filters, filters);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
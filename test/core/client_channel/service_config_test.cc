@@ -426,6 +426,82 @@ TEST_F(ServiceConfigTest, Parser2ErrorInvalidValue) {
   GRPC_ERROR_UNREF(error);
 }
 
+TEST_F(ServiceConfigTest, UnchangedConfigReturnsPrevious) {
+  const char* test_json =
+      "{\"global_param\":5, \"methodConfig\": [{\"name\":[{\"service\":"
+      "\"TestServ\"}], \"method_param\":5}]}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfig::Create(nullptr, test_json, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  auto svc_cfg2 =
+      ServiceConfig::Create(nullptr, test_json, svc_cfg.get(), &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  EXPECT_EQ(svc_cfg2, svc_cfg);
+}
+
+TEST_F(ServiceConfigTest, SharesUnchangedParsedConfigsWithPrevious) {
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfig::Create(
+      nullptr,
+      "{\"global_param\":5, \"methodConfig\": ["
+      "{\"name\":[{\"service\":\"Serv1\"}], \"method_param\":1}, "
+      "{\"name\":[{\"service\":\"Serv2\"}], \"method_param\":2}]}",
+      &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  // Change one method config and reorder the other.
+  auto svc_cfg2 = ServiceConfig::Create(
+      nullptr,
+      "{\"methodConfig\": ["
+      "{\"name\":[{\"service\":\"Serv2\"}], \"method_param\":2}, "
+      "{\"name\":[{\"service\":\"Serv1\"}], \"method_param\":10}], "
+      "\"global_param\":5}",
+      svc_cfg.get(), &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  EXPECT_TRUE(svc_cfg2->SharesGlobalParsedConfigsWith(*svc_cfg));
+  EXPECT_EQ(svc_cfg2->GetGlobalParsedConfig(0),
+            svc_cfg->GetGlobalParsedConfig(0));
+  grpc_slice serv1 = grpc_slice_from_static_string("/Serv1/Method");
+  grpc_slice serv2 = grpc_slice_from_static_string("/Serv2/Method");
+  EXPECT_EQ(svc_cfg2->GetMethodParsedConfigVector(serv2),
+            svc_cfg->GetMethodParsedConfigVector(serv2));
+  const auto* vector_ptr = svc_cfg2->GetMethodParsedConfigVector(serv1);
+  ASSERT_NE(vector_ptr, nullptr);
+  EXPECT_NE(vector_ptr, svc_cfg->GetMethodParsedConfigVector(serv1));
+  EXPECT_EQ(static_cast<TestParsedConfig1*>((*vector_ptr)[1].get())->value(),
+            10);
+  // Changing a global param reparses the global params.
+  auto svc_cfg3 = ServiceConfig::Create(
+      nullptr,
+      "{\"global_param\":6, \"methodConfig\": ["
+      "{\"name\":[{\"service\":\"Serv2\"}], \"method_param\":2}]}",
+      svc_cfg2.get(), &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  EXPECT_FALSE(svc_cfg3->SharesGlobalParsedConfigsWith(*svc_cfg2));
+  EXPECT_EQ(static_cast<TestParsedConfig1*>(svc_cfg3->GetGlobalParsedConfig(0))
+                ->value(),
+            6);
+  EXPECT_EQ(svc_cfg3->GetMethodParsedConfigVector(serv2),
+            svc_cfg->GetMethodParsedConfigVector(serv2));
+}
+
+TEST_F(ServiceConfigTest, ErrorsReportedWhenSharingWithPrevious) {
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto svc_cfg = ServiceConfig::Create(
+      nullptr,
+      "{\"methodConfig\": [{\"name\":[{\"service\":\"TestServ\"}], "
+      "\"method_param\":5}]}",
+      &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  svc_cfg = ServiceConfig::Create(
+      nullptr,
+      "{\"methodConfig\": [{\"name\":[{\"service\":\"TestServ\"}], "
+      "\"method_param\":-5}]}",
+      svc_cfg.get(), &error);
+  EXPECT_THAT(grpc_error_std_string(error),
+              ::testing::HasSubstr(TestParser2::InvalidValueErrorMessage()));
+  GRPC_ERROR_UNREF(error);
+}
+
 // Test parsing with ErrorParsers which always add errors
 class ErroredParsersScopingTest : public ::testing::Test {
  protected:
@@ -32,13 +32,12 @@
 
 static void test_compression_algorithm_parse(void) {
   size_t i;
-  const char* valid_names[] = {"identity", "gzip", "deflate"};
+  const char* valid_names[] = {"identity", "gzip", "deflate", "zstd", "lz4"};
   const grpc_compression_algorithm valid_algorithms[] = {
-      GRPC_COMPRESS_NONE,
-      GRPC_COMPRESS_GZIP,
-      GRPC_COMPRESS_DEFLATE,
+      GRPC_COMPRESS_NONE, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_DEFLATE,
+      GRPC_COMPRESS_ZSTD, GRPC_COMPRESS_LZ4,
   };
-  const char* invalid_names[] = {"gzip2", "foo", "", "2gzip"};
+  const char* invalid_names[] = {"gzip2", "foo", "", "2gzip", "zstd1"};
 
   gpr_log(GPR_DEBUG, "test_compression_algorithm_parse");
 
@@ -66,11 +65,10 @@ static void test_compression_algorithm_name(void) {
   int success;
   const char* name;
   size_t i;
-  const char* valid_names[] = {"identity", "gzip", "deflate"};
+  const char* valid_names[] = {"identity", "gzip", "deflate", "zstd", "lz4"};
   const grpc_compression_algorithm valid_algorithms[] = {
-      GRPC_COMPRESS_NONE,
-      GRPC_COMPRESS_GZIP,
-      GRPC_COMPRESS_DEFLATE,
+      GRPC_COMPRESS_NONE, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_DEFLATE,
+      GRPC_COMPRESS_ZSTD, GRPC_COMPRESS_LZ4,
   };
 
   gpr_log(GPR_DEBUG, "test_compression_algorithm_name");
@@ -205,6 +203,42 @@ static void test_compression_algorithm_for_level(void) {
                grpc_compression_algorithm_for_level(GRPC_COMPRESS_LEVEL_HIGH,
                                                     accepted_encodings));
   }
+
+  if (grpc_core::CompressionAlgorithmIsSupported(GRPC_COMPRESS_ZSTD) &&
+      grpc_core::CompressionAlgorithmIsSupported(GRPC_COMPRESS_LZ4)) {
+    /* accept every algorithm, including the optional ones */
+    uint32_t accepted_encodings = 0;
+    grpc_core::SetBit(&accepted_encodings, GRPC_COMPRESS_NONE); /* always */
+    grpc_core::SetBit(&accepted_encodings, GRPC_COMPRESS_GZIP);
+    grpc_core::SetBit(&accepted_encodings, GRPC_COMPRESS_DEFLATE);
+    grpc_core::SetBit(&accepted_encodings, GRPC_COMPRESS_ZSTD);
+    grpc_core::SetBit(&accepted_encodings, GRPC_COMPRESS_LZ4);
+
+    GPR_ASSERT(GRPC_COMPRESS_LZ4 ==
+               grpc_compression_algorithm_for_level(GRPC_COMPRESS_LEVEL_LOW,
+                                                    accepted_encodings));
+
+    GPR_ASSERT(GRPC_COMPRESS_DEFLATE ==
+               grpc_compression_algorithm_for_level(GRPC_COMPRESS_LEVEL_MED,
+                                                    accepted_encodings));
+
+    GPR_ASSERT(GRPC_COMPRESS_ZSTD ==
+               grpc_compression_algorithm_for_level(GRPC_COMPRESS_LEVEL_HIGH,
+                                                    accepted_encodings));
+  }
+
+  {
+    /* algorithms this build cannot produce are never chosen */
+    uint32_t accepted_encodings = 0;
+    grpc_core::SetBit(&accepted_encodings, GRPC_COMPRESS_NONE); /* always */
+    grpc_core::SetBit(&accepted_encodings, GRPC_COMPRESS_ZSTD);
+
+    GPR_ASSERT((grpc_core::CompressionAlgorithmIsSupported(GRPC_COMPRESS_ZSTD)
+                    ? GRPC_COMPRESS_ZSTD
+                    : GRPC_COMPRESS_NONE) ==
+               grpc_compression_algorithm_for_level(GRPC_COMPRESS_LEVEL_HIGH,
+                                                    accepted_encodings));
+  }
 }
 
 static void test_compression_enable_disable_algorithm(void) {
@@ -262,11 +296,13 @@ static void test_channel_args_compression_algorithm_states(void) {
 
   const grpc_channel_args* ch_args =
       grpc_channel_args_copy_and_add(nullptr, nullptr, 0);
-  /* by default, all enabled */
+  /* by default, all algorithms supported by this build are enabled */
   states = grpc_core::CompressionAlgorithmSet::FromChannelArgs(ch_args);
 
   for (size_t i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
-    GPR_ASSERT(states.IsSet(static_cast<grpc_compression_algorithm>(i)));
+    auto algorithm = static_cast<grpc_compression_algorithm>(i);
+    GPR_ASSERT(states.IsSet(algorithm) ==
+               grpc_core::CompressionAlgorithmIsSupported(algorithm));
   }
 
   /* disable gzip and deflate and stream/gzip */
@@ -282,10 +318,12 @@ static void test_channel_args_compression_algorithm_states(void) {
   states = grpc_core::CompressionAlgorithmSet::FromChannelArgs(
       ch_args_wo_gzip_deflate);
   for (size_t i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    auto algorithm = static_cast<grpc_compression_algorithm>(i);
     if (i == GRPC_COMPRESS_GZIP || i == GRPC_COMPRESS_DEFLATE) {
-      GPR_ASSERT(!states.IsSet(static_cast<grpc_compression_algorithm>(i)));
+      GPR_ASSERT(!states.IsSet(algorithm));
     } else {
-      GPR_ASSERT(states.IsSet(static_cast<grpc_compression_algorithm>(i)));
+      GPR_ASSERT(states.IsSet(algorithm) ==
+                 grpc_core::CompressionAlgorithmIsSupported(algorithm));
     }
   }
 
@@ -296,10 +334,12 @@ static void test_channel_args_compression_algorithm_states(void) {
 
   states = grpc_core::CompressionAlgorithmSet::FromChannelArgs(ch_args_wo_gzip);
   for (size_t i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    auto algorithm = static_cast<grpc_compression_algorithm>(i);
     if (i == GRPC_COMPRESS_DEFLATE) {
-      GPR_ASSERT(!states.IsSet(static_cast<grpc_compression_algorithm>(i)));
+      GPR_ASSERT(!states.IsSet(algorithm));
     } else {
-      GPR_ASSERT(states.IsSet(static_cast<grpc_compression_algorithm>(i)));
+      GPR_ASSERT(states.IsSet(algorithm) ==
+                 grpc_core::CompressionAlgorithmIsSupported(algorithm));
     }
   }
 
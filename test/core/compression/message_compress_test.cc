@@ -18,13 +18,26 @@
 
 #include "src/core/lib/compression/message_compress.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+
+#ifdef GRPC_HAVE_ZSTD
+#include <zdict.h>
+#endif
+
 #include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/gpr/murmur_hash.h"
+#include "src/core/lib/gpr/tmpfile.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "test/core/util/slice_splitter.h"
@@ -113,7 +126,10 @@ static grpc_slice repeated(char c, size_t length) {
 
 static compressability get_compressability(
     test_value id, grpc_compression_algorithm algorithm) {
-  if (algorithm == GRPC_COMPRESS_NONE) return SHOULD_NOT_COMPRESS;
+  if (algorithm == GRPC_COMPRESS_NONE ||
+      !grpc_core::CompressionAlgorithmIsSupported(algorithm)) {
+    return SHOULD_NOT_COMPRESS;
+  }
   switch (id) {
     case ONE_A:
       return SHOULD_NOT_COMPRESS;
@@ -218,6 +234,37 @@ static void test_bad_decompression_data_missing_trailer(void) {
   grpc_slice_buffer_destroy(&output);
 }
 
+static void test_bad_decompression_data_truncated_frame(void) {
+  for (auto algorithm : {GRPC_COMPRESS_ZSTD, GRPC_COMPRESS_LZ4}) {
+    if (!grpc_core::CompressionAlgorithmIsSupported(algorithm)) continue;
+    grpc_slice_buffer input;
+    grpc_slice_buffer compressed;
+    grpc_slice_buffer garbage;
+    grpc_slice_buffer output;
+
+    grpc_slice_buffer_init(&input);
+    grpc_slice_buffer_init(&compressed);
+    grpc_slice_buffer_init(&garbage);
+    grpc_slice_buffer_init(&output);
+    grpc_slice_buffer_add(&input, create_test_value(ONE_MB_A));
+
+    grpc_core::ExecCtx exec_ctx;
+    /* compress it */
+    GPR_ASSERT(1 == grpc_msg_compress(algorithm, &input, &compressed));
+    GPR_ASSERT(compressed.length > 4);
+    /* Remove the end of the frame */
+    grpc_slice_buffer_trim_end(&compressed, 4, &garbage);
+    /* try (and fail) to decompress the truncated frame */
+    GPR_ASSERT(0 == grpc_msg_decompress(algorithm, &compressed, &output));
+    GPR_ASSERT(0 == output.length);
+
+    grpc_slice_buffer_destroy(&input);
+    grpc_slice_buffer_destroy(&compressed);
+    grpc_slice_buffer_destroy(&garbage);
+    grpc_slice_buffer_destroy(&output);
+  }
+}
+
 static void test_bad_decompression_data_trailing_garbage(void) {
   grpc_slice_buffer input;
   grpc_slice_buffer output;
@@ -303,6 +350,391 @@ static void test_bad_decompression_algorithm(void) {
   grpc_slice_buffer_destroy(&output);
 }
 
+static grpc_slice json_like_message(int i) {
+  return grpc_slice_from_cpp_string(absl::StrFormat(
+      "{\"id\": %d, \"name\": \"user-%d\", \"region\": \"us-east-1\", "
+      "\"status\": \"ACTIVE\", \"tags\": [\"alpha\", \"beta\"]}",
+      i, i * 7));
+}
+
+static void test_stream_context_roundtrip(void) {
+  for (auto algorithm :
+       {GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_ZSTD}) {
+    auto compressor = grpc_core::MessageCompressor::Create(algorithm);
+    auto decompressor = grpc_core::MessageDecompressor::Create(algorithm);
+    GPR_ASSERT((compressor == nullptr) == (decompressor == nullptr));
+    if (compressor == nullptr) {
+      GPR_ASSERT(!grpc_core::CompressionAlgorithmIsSupported(algorithm));
+      continue;
+    }
+    grpc_core::ExecCtx exec_ctx;
+    size_t standalone_bytes = 0;
+    size_t stream_bytes = 0;
+    for (int i = 0; i < 100; i++) {
+      grpc_slice value = json_like_message(i);
+      grpc_slice_buffer input;
+      grpc_slice_buffer standalone;
+      grpc_slice_buffer compressed;
+      grpc_slice_buffer output;
+      grpc_slice_buffer_init(&input);
+      grpc_slice_buffer_init(&standalone);
+      grpc_slice_buffer_init(&compressed);
+      grpc_slice_buffer_init(&output);
+      grpc_split_slices_to_buffer(GRPC_SLICE_SPLIT_ONE_BYTE, &value, 1, &input);
+
+      grpc_msg_compress(algorithm, &input, &standalone);
+      standalone_bytes += standalone.length;
+      /* Messages of a stream refer back to earlier ones, so after the first
+         they compress far better than on their own. */
+      GPR_ASSERT(compressor->Compress(&input, &compressed, true));
+      stream_bytes += compressed.length;
+      if (i > 0) GPR_ASSERT(compressed.length < input.length / 2);
+      GPR_ASSERT(decompressor->Decompress(&compressed, &output));
+      grpc_slice final = grpc_slice_merge(output.slices, output.count);
+      GPR_ASSERT(grpc_slice_eq(value, final));
+
+      grpc_slice_unref(final);
+      grpc_slice_unref(value);
+      grpc_slice_buffer_destroy(&input);
+      grpc_slice_buffer_destroy(&standalone);
+      grpc_slice_buffer_destroy(&compressed);
+      grpc_slice_buffer_destroy(&output);
+    }
+    gpr_log(GPR_INFO, "stream context %d: %" PRIuPTR " vs. %" PRIuPTR " bytes",
+            algorithm, stream_bytes, standalone_bytes);
+    GPR_ASSERT(stream_bytes < standalone_bytes / 2);
+  }
+}
+
+static void test_stream_context_accepts_standalone_messages(void) {
+  for (auto algorithm :
+       {GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_ZSTD}) {
+    auto compressor = grpc_core::MessageCompressor::Create(algorithm);
+    auto decompressor = grpc_core::MessageDecompressor::Create(algorithm);
+    if (compressor == nullptr) continue;
+    grpc_core::ExecCtx exec_ctx;
+    /* A peer without stream context compresses every message on its own,
+       with or without reusing its compressor. */
+    for (int i = 0; i < 4; i++) {
+      grpc_slice_buffer input;
+      grpc_slice_buffer compressed;
+      grpc_slice_buffer output;
+      grpc_slice_buffer_init(&input);
+      grpc_slice_buffer_init(&compressed);
+      grpc_slice_buffer_init(&output);
+      grpc_slice_buffer_add(&input, create_test_value(ONE_KB_A));
+      if (i % 2 == 0) {
+        GPR_ASSERT(grpc_msg_compress(algorithm, &input, &compressed));
+      } else {
+        GPR_ASSERT(compressor->Compress(&input, &compressed, false));
+      }
+      GPR_ASSERT(decompressor->Decompress(&compressed, &output));
+      GPR_ASSERT(output.length == input.length);
+      grpc_slice_buffer_destroy(&input);
+      grpc_slice_buffer_destroy(&compressed);
+      grpc_slice_buffer_destroy(&output);
+    }
+  }
+}
+
+static void test_stream_context_truncated_message(void) {
+  for (auto algorithm :
+       {GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_ZSTD}) {
+    auto compressor = grpc_core::MessageCompressor::Create(algorithm);
+    auto decompressor = grpc_core::MessageDecompressor::Create(algorithm);
+    if (compressor == nullptr) continue;
+    grpc_core::ExecCtx exec_ctx;
+    grpc_slice_buffer input;
+    grpc_slice_buffer compressed;
+    grpc_slice_buffer garbage;
+    grpc_slice_buffer output;
+    grpc_slice_buffer_init(&input);
+    grpc_slice_buffer_init(&compressed);
+    grpc_slice_buffer_init(&garbage);
+    grpc_slice_buffer_init(&output);
+    grpc_slice_buffer_add(&input, create_test_value(ONE_MB_A));
+    GPR_ASSERT(compressor->Compress(&input, &compressed, true));
+    /* Remove the flush marker, or the end of zstd's last block */
+    grpc_slice_buffer_trim_end(&compressed, 2, &garbage);
+    GPR_ASSERT(!decompressor->Decompress(&compressed, &output));
+    GPR_ASSERT(output.length == 0);
+    grpc_slice_buffer_destroy(&input);
+    grpc_slice_buffer_destroy(&compressed);
+    grpc_slice_buffer_destroy(&garbage);
+    grpc_slice_buffer_destroy(&output);
+  }
+}
+
+static void test_stream_context_pool(void) {
+  grpc_core::MessageCompressionContextPool<grpc_core::MessageCompressor> pool;
+  GPR_ASSERT(pool.Get(GRPC_COMPRESS_NONE) == nullptr);
+  GPR_ASSERT(pool.Get(GRPC_COMPRESS_ALGORITHMS_COUNT) == nullptr);
+  auto compressor = pool.Get(GRPC_COMPRESS_GZIP);
+  GPR_ASSERT(compressor != nullptr);
+  grpc_core::MessageCompressor* raw = compressor.get();
+  pool.Return(std::move(compressor));
+  /* The idle compressor is handed out again, for the same algorithm only. */
+  auto deflate = pool.Get(GRPC_COMPRESS_DEFLATE);
+  GPR_ASSERT(deflate.get() != raw);
+  GPR_ASSERT(pool.Get(GRPC_COMPRESS_GZIP).get() == raw);
+}
+
+/* Writes contents to a new temporary file and returns its name. */
+static std::string write_tmpfile(const void* contents, size_t size) {
+  char* name;
+  FILE* file = gpr_tmpfile("message_compress_test", &name);
+  GPR_ASSERT(file != nullptr);
+  GPR_ASSERT(fwrite(contents, 1, size, file) == size);
+  fclose(file);
+  std::string result = name;
+  gpr_free(name);
+  return result;
+}
+
+/* Text-like data: compressible, but not trivially so. */
+static grpc_slice pseudo_text(size_t length, uint32_t seed) {
+  static const char* kWords[] = {"alpha ", "beta ",  "gamma ", "delta ",
+                                 "omega ", "sigma ", "\n",     "kappa "};
+  std::string text;
+  while (text.size() < length) {
+    seed = seed * 1103515245 + 12345;
+    text += kWords[(seed >> 16) % GPR_ARRAY_SIZE(kWords)];
+    if ((seed >> 8) % 5 == 0) text += std::to_string(seed % 1000);
+  }
+  text.resize(length);
+  return grpc_slice_from_cpp_string(std::move(text));
+}
+
+static void test_chunked_compression(void) {
+  const size_t kChunkSize = 64 * 1024;
+  for (auto algorithm : {GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_GZIP,
+                         GRPC_COMPRESS_ZSTD, GRPC_COMPRESS_LZ4}) {
+    if (!grpc_core::ChunkedMessageCompressor::IsSupported(algorithm)) {
+      GPR_ASSERT(!grpc_core::CompressionAlgorithmIsSupported(algorithm));
+      continue;
+    }
+    for (auto mode : {GRPC_SLICE_SPLIT_IDENTITY, GRPC_SLICE_SPLIT_ONE_BYTE}) {
+      grpc_core::ExecCtx exec_ctx;
+      grpc_slice value = pseudo_text(3 * kChunkSize + 1234, algorithm);
+      grpc_slice_buffer input;
+      grpc_slice_buffer compressed;
+      grpc_slice_buffer output;
+      grpc_slice_buffer_init(&input);
+      grpc_slice_buffer_init(&compressed);
+      grpc_slice_buffer_init(&output);
+      grpc_split_slices_to_buffer(mode, &value, 1, &input);
+
+      grpc_core::ChunkedMessageCompressor compressor(algorithm, &input,
+                                                     kChunkSize);
+      GPR_ASSERT(compressor.num_chunks() == 4);
+      /* Chunks do not depend on each other. */
+      for (size_t i = compressor.num_chunks(); i > 0; i--) {
+        compressor.CompressChunk(i - 1);
+      }
+      GPR_ASSERT(compressor.Finish(&compressed));
+      GPR_ASSERT(compressed.length < input.length);
+      /* The peer decompresses the chunks as one message. */
+      GPR_ASSERT(grpc_msg_decompress(algorithm, &compressed, &output));
+      grpc_slice final = grpc_slice_merge(output.slices, output.count);
+      GPR_ASSERT(grpc_slice_eq(value, final));
+
+      grpc_slice_unref(final);
+      grpc_slice_unref(value);
+      grpc_slice_buffer_destroy(&input);
+      grpc_slice_buffer_destroy(&compressed);
+      grpc_slice_buffer_destroy(&output);
+    }
+  }
+}
+
+static void test_chunked_compression_incompressible(void) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_slice_buffer input;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&output);
+  /* Random bytes do not compress. */
+  grpc_slice value = GRPC_SLICE_MALLOC(256 * 1024);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < GRPC_SLICE_LENGTH(value); i++) {
+    seed = seed * 1103515245 + 12345;
+    GRPC_SLICE_START_PTR(value)[i] = static_cast<uint8_t>(seed >> 16);
+  }
+  grpc_slice_buffer_add(&input, value);
+  grpc_core::ChunkedMessageCompressor compressor(GRPC_COMPRESS_GZIP, &input,
+                                                 64 * 1024);
+  for (size_t i = 0; i < compressor.num_chunks(); i++) {
+    compressor.CompressChunk(i);
+  }
+  GPR_ASSERT(!compressor.Finish(&output));
+  GPR_ASSERT(output.length == input.length);
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&output);
+}
+
+static grpc_slice random_bytes(size_t length, uint32_t seed) {
+  grpc_slice value = GRPC_SLICE_MALLOC(length);
+  for (size_t i = 0; i < length; i++) {
+    seed = seed * 1103515245 + 12345;
+    GRPC_SLICE_START_PTR(value)[i] = static_cast<uint8_t>(seed >> 16);
+  }
+  return value;
+}
+
+static void test_method_compressibility(void) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_slice_buffer message;
+  grpc_slice_buffer_init(&message);
+  /* Large messages are judged by a sample. */
+  auto text = grpc_core::MakeRefCounted<grpc_core::MethodCompressibility>();
+  grpc_slice_buffer_add(&message, pseudo_text(64 * 1024, 1));
+  GPR_ASSERT(text->ShouldCompress(GRPC_COMPRESS_GZIP, &message, nullptr,
+                                  false));
+  /* ... with the compressor that is to compress them. */
+  auto compressor = grpc_core::MessageCompressor::Create(GRPC_COMPRESS_GZIP);
+  GPR_ASSERT(text->ShouldCompress(GRPC_COMPRESS_GZIP, &message,
+                                  compressor.get(), false));
+  grpc_slice_buffer_reset_and_unref(&message);
+  /* A sample that passes is not recorded, the message being recorded once
+     compressed: one message that did not shrink outweighs it. */
+  text->Record(64 * 1024, 64 * 1024);
+  grpc_slice_buffer_add(&message, pseudo_text(1024, 2));
+  GPR_ASSERT(!text->ShouldCompress(GRPC_COMPRESS_GZIP, &message, nullptr,
+                                   false));
+  grpc_slice_buffer_reset_and_unref(&message);
+  auto random = grpc_core::MakeRefCounted<grpc_core::MethodCompressibility>();
+  grpc_slice_buffer_add(&message, random_bytes(64 * 1024, 1));
+  /* A sample compressed without the stream's history says nothing about how
+     the message compresses with it. */
+  GPR_ASSERT(random->ShouldCompress(GRPC_COMPRESS_GZIP, &message,
+                                    compressor.get(), true));
+  GPR_ASSERT(!random->ShouldCompress(GRPC_COMPRESS_GZIP, &message, nullptr,
+                                     false));
+  grpc_slice_buffer_reset_and_unref(&message);
+  /* Once a method's messages stop shrinking, only the occasional probe is
+     compressed, even among messages too small to sample. */
+  grpc_slice_buffer_add(&message, random_bytes(1024, 2));
+  int compressed = 0;
+  for (int i = 0; i < 32; i++) {
+    if (random->ShouldCompress(GRPC_COMPRESS_GZIP, &message, nullptr,
+                               false)) {
+      compressed++;
+    }
+  }
+  GPR_ASSERT(compressed == 2);
+  /* A probe that shrinks brings the method back. */
+  random->Record(1024, 300);
+  GPR_ASSERT(random->ShouldCompress(GRPC_COMPRESS_GZIP, &message, nullptr,
+                                    false));
+  grpc_slice_buffer_destroy(&message);
+  /* Calls to one method share its estimate. */
+  grpc_core::CompressibilityByMethod by_method;
+  auto foo = by_method.Get("/svc/Foo");
+  GPR_ASSERT(foo == by_method.Get("/svc/Foo"));
+  GPR_ASSERT(foo != by_method.Get("/svc/Bar"));
+}
+
+static void test_zstd_dictionary_load_errors(void) {
+  GPR_ASSERT(!grpc_core::ZstdDictionary::Load("/nonexistent/dictionary").ok());
+  /* Raw content has no dictionary id. */
+  std::string path = write_tmpfile("not a dictionary", 16);
+  GPR_ASSERT(!grpc_core::ZstdDictionary::Load(path).ok());
+  remove(path.c_str());
+}
+
+#ifdef GRPC_HAVE_ZSTD
+static void test_zstd_dictionary(void) {
+  /* Train a dictionary on messages like the ones it will compress. */
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (int i = 0; i < 2000; i++) {
+    grpc_slice sample = json_like_message(i);
+    samples.append(reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(sample)),
+                   GRPC_SLICE_LENGTH(sample));
+    sample_sizes.push_back(GRPC_SLICE_LENGTH(sample));
+    grpc_slice_unref(sample);
+  }
+  std::vector<char> trained(4096);
+  size_t trained_size = ZDICT_trainFromBuffer(
+      trained.data(), trained.size(), samples.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  GPR_ASSERT(!ZDICT_isError(trained_size));
+  std::string path = write_tmpfile(trained.data(), trained_size);
+  auto dictionary = grpc_core::ZstdDictionary::Load(path);
+  GPR_ASSERT(dictionary.ok());
+  GPR_ASSERT((*dictionary)->id() == ZDICT_getDictID(trained.data(),
+                                                    trained_size));
+  /* Later loads share the first one while it is in use. */
+  GPR_ASSERT(grpc_core::ZstdDictionary::Load(path)->get() ==
+             dictionary->get());
+  /* So do channels, which load it when their args are preconditioned. */
+  grpc_arg arg = grpc_channel_arg_string_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_ZSTD_DICTIONARIES),
+      const_cast<char*>(path.c_str()));
+  grpc_channel_args args = {1, &arg};
+  const grpc_channel_args* preconditioned =
+      grpc_core::ZstdDictionarySet::LoadFromChannelArgs(&args);
+  grpc_core::ZstdDictionarySet* set =
+      grpc_core::ZstdDictionarySet::GetFromChannelArgs(preconditioned);
+  GPR_ASSERT(set != nullptr);
+  GPR_ASSERT(set->Find((*dictionary)->id()) == dictionary->get());
+  GPR_ASSERT(set->Find((*dictionary)->id() + 1) == nullptr);
+  grpc_channel_args_destroy(preconditioned);
+
+  grpc_core::ExecCtx exec_ctx;
+  grpc_slice value = json_like_message(123456);
+  grpc_slice_buffer input;
+  grpc_slice_buffer plain;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&plain);
+  grpc_slice_buffer_init(&compressed);
+  grpc_slice_buffer_init(&output);
+  grpc_split_slices_to_buffer(GRPC_SLICE_SPLIT_ONE_BYTE, &value, 1, &input);
+  /* A small message hardly compresses on its own, but does against the
+     dictionary. */
+  grpc_msg_compress(GRPC_COMPRESS_ZSTD, &input, &plain);
+  GPR_ASSERT(grpc_core::ZstdDictionary::IdOfMessage(&plain) == 0);
+  auto compressor = (*dictionary)->CreateCompressor();
+  auto decompressor = (*dictionary)->CreateDecompressor();
+  /* One context serves every message of a call, and each message ends its
+     frame even if asked to keep history. */
+  for (int i = 0; i < 2; i++) {
+    grpc_slice_buffer_reset_and_unref(&compressed);
+    grpc_slice_buffer_reset_and_unref(&output);
+    GPR_ASSERT(compressor->Compress(&input, &compressed, true));
+    gpr_log(GPR_INFO, "zstd dictionary: %" PRIuPTR " vs. %" PRIuPTR " bytes",
+            compressed.length, plain.length);
+    GPR_ASSERT(compressed.length < input.length / 2);
+    GPR_ASSERT(compressed.length < plain.length);
+    /* The frames name the dictionary they need to decompress. */
+    GPR_ASSERT(grpc_core::ZstdDictionary::IdOfMessage(&compressed) ==
+               (*dictionary)->id());
+    GPR_ASSERT(!grpc_msg_decompress(GRPC_COMPRESS_ZSTD, &compressed, &output));
+    GPR_ASSERT(decompressor->Decompress(&compressed, &output));
+    grpc_slice final = grpc_slice_merge(output.slices, output.count);
+    GPR_ASSERT(grpc_slice_eq(value, final));
+    grpc_slice_unref(final);
+  }
+
+  /* The file is only read again once the last user of the dictionary is
+     gone and it has been freed. */
+  remove(path.c_str());
+  GPR_ASSERT(grpc_core::ZstdDictionary::Load(path).ok());
+  compressor.reset();
+  decompressor.reset();
+  dictionary->reset();
+  GPR_ASSERT(!grpc_core::ZstdDictionary::Load(path).ok());
+
+  grpc_slice_unref(value);
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&plain);
+  grpc_slice_buffer_destroy(&compressed);
+  grpc_slice_buffer_destroy(&output);
+}
+#endif /* GRPC_HAVE_ZSTD */
+
 int main(int argc, char** argv) {
   unsigned i, j, k, m;
   grpc_slice_split_mode uncompressed_split_modes[] = {
@@ -336,8 +768,20 @@ int main(int argc, char** argv) {
   test_bad_decompression_data_missing_trailer();
   test_bad_decompression_data_stream();
   test_bad_decompression_data_trailing_garbage();
+  test_bad_decompression_data_truncated_frame();
   test_bad_compression_algorithm();
   test_bad_decompression_algorithm();
+  test_stream_context_roundtrip();
+  test_stream_context_accepts_standalone_messages();
+  test_stream_context_truncated_message();
+  test_stream_context_pool();
+  test_chunked_compression();
+  test_chunked_compression_incompressible();
+  test_method_compressibility();
+  test_zstd_dictionary_load_errors();
+#ifdef GRPC_HAVE_ZSTD
+  test_zstd_dictionary();
+#endif
   grpc_shutdown();
 
   return 0;
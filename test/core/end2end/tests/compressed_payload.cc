@@ -20,9 +20,14 @@
 #include <string.h>
 
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_format.h"
 
+#ifdef GRPC_HAVE_ZSTD
+#include <zdict.h>
+#endif
+
 #include <grpc/byte_buffer.h>
 #include <grpc/byte_buffer_reader.h>
 #include <grpc/compression.h>
@@ -31,6 +36,9 @@
 #include <grpc/support/time.h>
 
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/gpr/tmpfile.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/surface/call_test_only.h"
 #include "test/core/compression/args_utils.h"
@@ -397,9 +405,17 @@ static void request_with_payload_template_inner(
   CQ_EXPECT_COMPLETION(cqv, tag(100), true);
   cq_verify(cqv);
 
+  /* zstd and lz4 are only accepted by builds that support them. */
+  size_t supported_algorithms = 0;
+  for (size_t i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    if (grpc_core::CompressionAlgorithmIsSupported(
+            static_cast<grpc_compression_algorithm>(i))) {
+      supported_algorithms++;
+    }
+  }
   GPR_ASSERT(grpc_core::BitCount(
                  grpc_call_test_only_get_encodings_accepted_by_peer(s)) ==
-             GRPC_COMPRESS_ALGORITHMS_COUNT);
+             supported_algorithms);
   GPR_ASSERT(
       grpc_core::GetBit(grpc_call_test_only_get_encodings_accepted_by_peer(s),
                         GRPC_COMPRESS_NONE) != 0);
@@ -688,6 +704,639 @@ static void test_invoke_request_with_disabled_algorithm(
                                  GRPC_STATUS_UNIMPLEMENTED, nullptr, true);
 }
 
+/* Sends large messages both ways on channels with extra_args and algorithm
+   as the default on both sides. Unless compressible, the messages are random
+   (non-zero) bytes, which no algorithm shrinks. */
+static void request_with_large_payload(grpc_end2end_test_config config,
+                                       const char* test_name,
+                                       grpc_compression_algorithm algorithm,
+                                       grpc_arg* extra_args,
+                                       size_t num_extra_args,
+                                       bool compressible) {
+  grpc_call* c;
+  grpc_call* s;
+  grpc_op ops[6];
+  grpc_op* op;
+  grpc_metadata_array initial_metadata_recv;
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_metadata_array request_metadata_recv;
+  grpc_call_details call_details;
+  grpc_status_code status;
+  grpc_call_error error;
+  grpc_slice details;
+  int was_cancelled = 2;
+
+  /* If compressible, not so much that it shrinks to nothing. */
+  std::string payload_str(300 * 1024, 'a');
+  uint32_t seed = 1;
+  for (size_t i = 0; i < payload_str.size(); i += compressible ? 4 : 1) {
+    seed = seed * 1103515245 + 12345;
+    payload_str[i] = compressible ? static_cast<char>('a' + (seed >> 16) % 26)
+                                  : static_cast<char>(1 + (seed >> 16) % 255);
+  }
+  grpc_slice payload_slice = grpc_slice_from_cpp_string(payload_str);
+
+  const grpc_channel_args* base_args =
+      grpc_channel_args_set_channel_default_compression_algorithm(nullptr,
+                                                                  algorithm);
+  const grpc_channel_args* args =
+      grpc_channel_args_copy_and_add(base_args, extra_args, num_extra_args);
+  grpc_channel_args_destroy(base_args);
+  grpc_end2end_test_fixture f = begin_test(config, test_name, args, args, true);
+  cq_verifier* cqv = cq_verifier_create(f.cq);
+
+  gpr_timespec deadline = five_seconds_from_now();
+  c = grpc_channel_create_call(f.client, nullptr, GRPC_PROPAGATE_DEFAULTS, f.cq,
+                               grpc_slice_from_static_string("/foo"), nullptr,
+                               deadline, nullptr);
+  GPR_ASSERT(c);
+
+  grpc_metadata_array_init(&initial_metadata_recv);
+  grpc_metadata_array_init(&trailing_metadata_recv);
+  grpc_metadata_array_init(&request_metadata_recv);
+  grpc_call_details_init(&call_details);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_RECV_INITIAL_METADATA;
+  op->data.recv_initial_metadata.recv_initial_metadata = &initial_metadata_recv;
+  op++;
+  op->op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  op->data.recv_status_on_client.trailing_metadata = &trailing_metadata_recv;
+  op->data.recv_status_on_client.status = &status;
+  op->data.recv_status_on_client.status_details = &details;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(1),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  error =
+      grpc_server_request_call(f.server, &s, &call_details,
+                               &request_metadata_recv, f.cq, f.cq, tag(100));
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  CQ_EXPECT_COMPLETION(cqv, tag(100), true);
+  cq_verify(cqv);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  op->data.recv_close_on_server.cancelled = &was_cancelled;
+  op++;
+  error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops), tag(101),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  for (int i = 0; i < 2; i++) {
+    grpc_byte_buffer* request_payload =
+        grpc_raw_byte_buffer_create(&payload_slice, 1);
+    grpc_byte_buffer* response_payload =
+        grpc_raw_byte_buffer_create(&payload_slice, 1);
+    grpc_byte_buffer* request_payload_recv = nullptr;
+    grpc_byte_buffer* response_payload_recv = nullptr;
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_MESSAGE;
+    op->data.send_message.send_message = request_payload;
+    op++;
+    error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(2),
+                                  nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_RECV_MESSAGE;
+    op->data.recv_message.recv_message = &request_payload_recv;
+    op++;
+    error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops),
+                                  tag(102), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    CQ_EXPECT_COMPLETION(cqv, tag(2), 1);
+    CQ_EXPECT_COMPLETION(cqv, tag(102), 1);
+    cq_verify(cqv);
+    GPR_ASSERT(byte_buffer_eq_string(request_payload_recv,
+                                     payload_str.c_str()));
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_MESSAGE;
+    op->data.send_message.send_message = response_payload;
+    op++;
+    error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops),
+                                  tag(103), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_RECV_MESSAGE;
+    op->data.recv_message.recv_message = &response_payload_recv;
+    op++;
+    error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(3),
+                                  nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    CQ_EXPECT_COMPLETION(cqv, tag(103), 1);
+    CQ_EXPECT_COMPLETION(cqv, tag(3), 1);
+    cq_verify(cqv);
+    GPR_ASSERT(byte_buffer_eq_string(response_payload_recv,
+                                     payload_str.c_str()));
+
+    grpc_byte_buffer_destroy(request_payload);
+    grpc_byte_buffer_destroy(response_payload);
+    grpc_byte_buffer_destroy(request_payload_recv);
+    grpc_byte_buffer_destroy(response_payload_recv);
+  }
+  grpc_slice_unref(payload_slice);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(4),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  op->data.send_status_from_server.trailing_metadata_count = 0;
+  op->data.send_status_from_server.status = GRPC_STATUS_OK;
+  grpc_slice status_details = grpc_slice_from_static_string("xyz");
+  op->data.send_status_from_server.status_details = &status_details;
+  op++;
+  error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops), tag(104),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  CQ_EXPECT_COMPLETION(cqv, tag(1), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(4), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(101), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(104), 1);
+  cq_verify(cqv);
+
+  GPR_ASSERT(status == GRPC_STATUS_OK);
+  GPR_ASSERT(was_cancelled == 0);
+
+  grpc_slice_unref(details);
+  grpc_metadata_array_destroy(&initial_metadata_recv);
+  grpc_metadata_array_destroy(&trailing_metadata_recv);
+  grpc_metadata_array_destroy(&request_metadata_recv);
+  grpc_call_details_destroy(&call_details);
+
+  grpc_call_unref(c);
+  grpc_call_unref(s);
+
+  cq_verifier_destroy(cqv);
+  grpc_channel_args_destroy(args);
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+static void test_invoke_request_with_offloaded_compression(
+    grpc_end2end_test_config config) {
+  grpc_arg args[2];
+  args[0] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_OFFLOAD_THRESHOLD), 1);
+  /* Whole messages */
+  args[1] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_CHUNK_SIZE), 0);
+  request_with_large_payload(
+      config, "test_invoke_request_with_offloaded_compression",
+      GRPC_COMPRESS_GZIP, args, GPR_ARRAY_SIZE(args), true);
+  /* Chunked messages */
+  args[1] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_CHUNK_SIZE), 64 * 1024);
+  for (auto algorithm : {GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_GZIP}) {
+    request_with_large_payload(
+        config, "test_invoke_request_with_chunked_compression", algorithm,
+        args, GPR_ARRAY_SIZE(args), true);
+  }
+}
+
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+static int64_t stats_counter(grpc_stats_counters counter) {
+  grpc_stats_data stats;
+  grpc_stats_collect(&stats);
+  return stats.counters[counter];
+}
+#endif
+
+static void test_invoke_request_with_adaptive_compression(
+    grpc_end2end_test_config config) {
+  grpc_arg args[2];
+  args[0] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_ADAPTIVE), 1);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  int64_t skipped =
+      stats_counter(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SKIPPED_MESSAGES);
+#endif
+  request_with_large_payload(config,
+                             "test_invoke_request_with_adaptive_compression",
+                             GRPC_COMPRESS_GZIP, args, 1, true);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  GPR_ASSERT(stats_counter(
+                 GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SKIPPED_MESSAGES) ==
+             skipped);
+#endif
+  /* Each side samples its first random message, and skips both its
+     messages: the first for its sample, the second for the method's ratio. */
+  request_with_large_payload(
+      config, "test_invoke_request_with_adaptive_compression_random",
+      GRPC_COMPRESS_GZIP, args, 1, false);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  GPR_ASSERT(stats_counter(
+                 GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SKIPPED_MESSAGES) ==
+             skipped + 4);
+#endif
+  /* Offloaded messages are sampled before going to the executor. */
+  args[1] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_OFFLOAD_THRESHOLD), 1);
+  request_with_large_payload(
+      config, "test_invoke_request_with_adaptive_offloaded_compression",
+      GRPC_COMPRESS_DEFLATE, args, GPR_ARRAY_SIZE(args), true);
+}
+
+/* The i-th of a series of small, similar messages. */
+static std::string similar_message(int i) {
+  return absl::StrFormat(
+      "[{\"id\": %d, \"name\": \"user-%d\", \"region\": \"us-east-1\", "
+      "\"status\": \"ACTIVE\", \"tags\": [\"alpha\", \"beta\"]}, "
+      "{\"id\": %d, \"name\": \"user-%d\", \"region\": \"us-west-2\", "
+      "\"status\": \"ACTIVE\", \"tags\": [\"alpha\", \"gamma\"]}]",
+      i, i * 7, i + 1, i * 11);
+}
+
+/* Exchanges similar small messages on one call, the client only sending once
+   the server's initial metadata has arrived. The server's application adds
+   server_metadata, if any, to its initial metadata. Returns the bytes
+   compression saved, both ways. */
+static int64_t exchange_similar_messages(grpc_end2end_test_config config,
+                                         const char* test_name,
+                                         const grpc_channel_args* client_args,
+                                         const grpc_channel_args* server_args,
+                                         grpc_metadata* server_metadata,
+                                         grpc_status_code expected_status) {
+  grpc_call* c;
+  grpc_call* s;
+  grpc_op ops[6];
+  grpc_op* op;
+  grpc_metadata_array initial_metadata_recv;
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_metadata_array request_metadata_recv;
+  grpc_call_details call_details;
+  grpc_status_code status;
+  grpc_call_error error;
+  grpc_slice details;
+  int was_cancelled = 2;
+  const int kNumMessages = 20;
+
+  grpc_end2end_test_fixture f =
+      begin_test(config, test_name, client_args, server_args, true);
+  cq_verifier* cqv = cq_verifier_create(f.cq);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  const int64_t saved_bytes_before =
+      stats_counter(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SAVED_BYTES);
+#endif
+
+  gpr_timespec deadline = five_seconds_from_now();
+  c = grpc_channel_create_call(f.client, nullptr, GRPC_PROPAGATE_DEFAULTS, f.cq,
+                               grpc_slice_from_static_string("/foo"), nullptr,
+                               deadline, nullptr);
+  GPR_ASSERT(c);
+
+  grpc_metadata_array_init(&initial_metadata_recv);
+  grpc_metadata_array_init(&trailing_metadata_recv);
+  grpc_metadata_array_init(&request_metadata_recv);
+  grpc_call_details_init(&call_details);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  op->data.recv_status_on_client.trailing_metadata = &trailing_metadata_recv;
+  op->data.recv_status_on_client.status = &status;
+  op->data.recv_status_on_client.status_details = &details;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(1),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  error =
+      grpc_server_request_call(f.server, &s, &call_details,
+                               &request_metadata_recv, f.cq, f.cq, tag(100));
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  CQ_EXPECT_COMPLETION(cqv, tag(100), true);
+  cq_verify(cqv);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = server_metadata != nullptr ? 1 : 0;
+  op->data.send_initial_metadata.metadata = server_metadata;
+  op++;
+  op->op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  op->data.recv_close_on_server.cancelled = &was_cancelled;
+  op++;
+  error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops), tag(101),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  /* Have the server's initial metadata before sending anything, so that the
+     client compresses every message alike. */
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_RECV_INITIAL_METADATA;
+  op->data.recv_initial_metadata.recv_initial_metadata = &initial_metadata_recv;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(5),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  CQ_EXPECT_COMPLETION(cqv, tag(5), true);
+  cq_verify(cqv);
+
+  for (int i = 0; i < kNumMessages; i++) {
+    std::string message = similar_message(i);
+    grpc_slice message_slice = grpc_slice_from_cpp_string(message);
+    grpc_byte_buffer* request_payload =
+        grpc_raw_byte_buffer_create(&message_slice, 1);
+    grpc_byte_buffer* response_payload =
+        grpc_raw_byte_buffer_create(&message_slice, 1);
+    grpc_slice_unref(message_slice);
+    grpc_byte_buffer* request_payload_recv = nullptr;
+    grpc_byte_buffer* response_payload_recv = nullptr;
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_MESSAGE;
+    op->data.send_message.send_message = request_payload;
+    op++;
+    error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(2),
+                                  nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_RECV_MESSAGE;
+    op->data.recv_message.recv_message = &request_payload_recv;
+    op++;
+    error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops),
+                                  tag(102), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    const bool ok = expected_status == GRPC_STATUS_OK;
+    CQ_EXPECT_COMPLETION(cqv, tag(2), 1);
+    CQ_EXPECT_COMPLETION(cqv, tag(102), ok);
+    cq_verify(cqv);
+    grpc_byte_buffer_destroy(request_payload);
+    if (!ok) {
+      /* The server cannot decompress the message, and fails the call. */
+      GPR_ASSERT(request_payload_recv == nullptr);
+      grpc_byte_buffer_destroy(response_payload);
+      break;
+    }
+    GPR_ASSERT(byte_buffer_eq_string(request_payload_recv, message.c_str()));
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_MESSAGE;
+    op->data.send_message.send_message = response_payload;
+    op++;
+    error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops),
+                                  tag(103), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_RECV_MESSAGE;
+    op->data.recv_message.recv_message = &response_payload_recv;
+    op++;
+    error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(3),
+                                  nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    CQ_EXPECT_COMPLETION(cqv, tag(103), 1);
+    CQ_EXPECT_COMPLETION(cqv, tag(3), 1);
+    cq_verify(cqv);
+    GPR_ASSERT(byte_buffer_eq_string(response_payload_recv, message.c_str()));
+
+    grpc_byte_buffer_destroy(response_payload);
+    grpc_byte_buffer_destroy(request_payload_recv);
+    grpc_byte_buffer_destroy(response_payload_recv);
+  }
+
+  if (expected_status == GRPC_STATUS_OK) {
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+    op++;
+    error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops),
+                                  tag(4), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+    op->data.send_status_from_server.trailing_metadata_count = 0;
+    op->data.send_status_from_server.status = GRPC_STATUS_OK;
+    grpc_slice status_details = grpc_slice_from_static_string("xyz");
+    op->data.send_status_from_server.status_details = &status_details;
+    op++;
+    error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops),
+                                  tag(104), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    CQ_EXPECT_COMPLETION(cqv, tag(4), 1);
+    CQ_EXPECT_COMPLETION(cqv, tag(104), 1);
+  }
+  CQ_EXPECT_COMPLETION(cqv, tag(1), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(101), 1);
+  cq_verify(cqv);
+
+  GPR_ASSERT(status == expected_status);
+  GPR_ASSERT(was_cancelled == (expected_status == GRPC_STATUS_OK ? 0 : 1));
+
+  int64_t saved_bytes = 0;
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  saved_bytes = stats_counter(GRPC_STATS_COUNTER_MESSAGE_COMPRESS_SAVED_BYTES) -
+                saved_bytes_before;
+#endif
+
+  grpc_slice_unref(details);
+  grpc_metadata_array_destroy(&initial_metadata_recv);
+  grpc_metadata_array_destroy(&trailing_metadata_recv);
+  grpc_metadata_array_destroy(&request_metadata_recv);
+  grpc_call_details_destroy(&call_details);
+
+  grpc_call_unref(c);
+  grpc_call_unref(s);
+
+  cq_verifier_destroy(cqv);
+  end_test(&f);
+  config.tear_down_data(&f);
+  return saved_bytes;
+}
+
+/* Exchanges similar small messages with gzip, the client keeping a context
+   per stream if client_stream_context and the server if
+   server_stream_context. If server_claims_stream_context, the server's
+   application advertises grpc-accept-stream-encoding itself, whatever the
+   server channel does. */
+static int64_t request_with_stream_context(grpc_end2end_test_config config,
+                                           const char* test_name,
+                                           bool client_stream_context,
+                                           bool server_stream_context,
+                                           bool server_claims_stream_context,
+                                           grpc_status_code expected_status) {
+  grpc_arg stream_context_arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_STREAM_CONTEXT), 1);
+  const grpc_channel_args* base_args =
+      grpc_channel_args_set_channel_default_compression_algorithm(
+          nullptr, GRPC_COMPRESS_GZIP);
+  const grpc_channel_args* client_args = grpc_channel_args_copy_and_add(
+      base_args, &stream_context_arg, client_stream_context ? 1 : 0);
+  const grpc_channel_args* server_args = grpc_channel_args_copy_and_add(
+      base_args, &stream_context_arg, server_stream_context ? 1 : 0);
+  grpc_channel_args_destroy(base_args);
+  grpc_metadata claim;
+  claim.key = grpc_slice_from_static_string("grpc-accept-stream-encoding");
+  claim.value = grpc_slice_from_static_string("gzip");
+  const int64_t saved_bytes = exchange_similar_messages(
+      config, test_name, client_args, server_args,
+      server_claims_stream_context ? &claim : nullptr, expected_status);
+  grpc_channel_args_destroy(client_args);
+  grpc_channel_args_destroy(server_args);
+  return saved_bytes;
+}
+
+static void test_invoke_request_with_stream_context(
+    grpc_end2end_test_config config) {
+  const int64_t standalone = request_with_stream_context(
+      config, "test_invoke_request_without_stream_context", false, false,
+      false, GRPC_STATUS_OK);
+  /* Messages only refer back to earlier ones when the receiving side keeps
+     a context too: until then they are compressed exactly as without. */
+  const int64_t client_only = request_with_stream_context(
+      config, "test_invoke_request_with_client_stream_context", true, false,
+      false, GRPC_STATUS_OK);
+  const int64_t server_only = request_with_stream_context(
+      config, "test_invoke_request_with_server_stream_context", false, true,
+      false, GRPC_STATUS_OK);
+  const int64_t both = request_with_stream_context(
+      config, "test_invoke_request_with_stream_context", true, true, false,
+      GRPC_STATUS_OK);
+  gpr_log(GPR_INFO,
+          "saved bytes: %" PRId64 " standalone, %" PRId64
+          " client only, %" PRId64 " server only, %" PRId64 " both",
+          standalone, client_only, server_only, both);
+  GPR_ASSERT(client_only == standalone);
+  GPR_ASSERT(server_only == standalone);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  GPR_ASSERT(both > standalone);
+#endif
+}
+
+/* A server that advertises stream context without decompressing with one
+   cannot read the client's messages: the call fails instead of delivering
+   garbage. */
+static void test_invoke_request_with_unsupported_stream_context(
+    grpc_end2end_test_config config) {
+  request_with_stream_context(
+      config, "test_invoke_request_with_unsupported_stream_context", true,
+      false, true, GRPC_STATUS_INTERNAL);
+}
+
+#ifdef GRPC_HAVE_ZSTD
+/* Writes a zstd dictionary trained on messages like similar_message()'s to a
+   temporary file, and returns its path. */
+static std::string write_zstd_dictionary() {
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (int i = 0; i < 2000; i++) {
+    std::string sample = similar_message(1000 + i);
+    samples += sample;
+    sample_sizes.push_back(sample.size());
+  }
+  std::vector<char> dictionary(4096);
+  size_t size = ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), samples.data(),
+      sample_sizes.data(), static_cast<unsigned>(sample_sizes.size()));
+  GPR_ASSERT(!ZDICT_isError(size));
+  char* name;
+  FILE* file = gpr_tmpfile("compressed_payload", &name);
+  GPR_ASSERT(file != nullptr);
+  GPR_ASSERT(fwrite(dictionary.data(), 1, size, file) == size);
+  fclose(file);
+  std::string path = name;
+  gpr_free(name);
+  return path;
+}
+
+/* Exchanges similar small messages with zstd, each side configured with the
+   dictionary at the given path, if any. */
+static int64_t request_with_zstd_dictionaries(
+    grpc_end2end_test_config config, const char* test_name,
+    const char* client_dictionary, const char* server_dictionary) {
+  const grpc_channel_args* base_args =
+      grpc_channel_args_set_channel_default_compression_algorithm(
+          nullptr, GRPC_COMPRESS_ZSTD);
+  grpc_arg client_arg = grpc_channel_arg_string_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_ZSTD_DICTIONARIES),
+      const_cast<char*>(client_dictionary));
+  grpc_arg server_arg = grpc_channel_arg_string_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_ZSTD_DICTIONARIES),
+      const_cast<char*>(server_dictionary));
+  const grpc_channel_args* client_args = grpc_channel_args_copy_and_add(
+      base_args, &client_arg, client_dictionary != nullptr ? 1 : 0);
+  const grpc_channel_args* server_args = grpc_channel_args_copy_and_add(
+      base_args, &server_arg, server_dictionary != nullptr ? 1 : 0);
+  grpc_channel_args_destroy(base_args);
+  const int64_t saved_bytes =
+      exchange_similar_messages(config, test_name, client_args, server_args,
+                                nullptr, GRPC_STATUS_OK);
+  grpc_channel_args_destroy(client_args);
+  grpc_channel_args_destroy(server_args);
+  return saved_bytes;
+}
+
+static void test_invoke_request_with_zstd_dictionary(
+    grpc_end2end_test_config config) {
+  const std::string path = write_zstd_dictionary();
+  const int64_t standalone = request_with_zstd_dictionaries(
+      config, "test_invoke_request_without_zstd_dictionary", nullptr,
+      nullptr);
+  /* Neither side compresses against a dictionary the other has not
+     announced. */
+  const int64_t client_only = request_with_zstd_dictionaries(
+      config, "test_invoke_request_with_client_zstd_dictionary", path.c_str(),
+      nullptr);
+  const int64_t server_only = request_with_zstd_dictionaries(
+      config, "test_invoke_request_with_server_zstd_dictionary", nullptr,
+      path.c_str());
+  const int64_t both = request_with_zstd_dictionaries(
+      config, "test_invoke_request_with_zstd_dictionary", path.c_str(),
+      path.c_str());
+  gpr_log(GPR_INFO,
+          "saved bytes: %" PRId64 " standalone, %" PRId64
+          " client only, %" PRId64 " server only, %" PRId64 " both",
+          standalone, client_only, server_only, both);
+  GPR_ASSERT(client_only == standalone);
+  GPR_ASSERT(server_only == standalone);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  GPR_ASSERT(both > standalone);
+#endif
+  remove(path.c_str());
+}
+#endif /* GRPC_HAVE_ZSTD */
+
 void compressed_payload(grpc_end2end_test_config config) {
   test_invoke_request_with_exceptionally_uncompressed_payload(config);
   test_invoke_request_with_uncompressed_payload(config);
@@ -696,6 +1345,13 @@ void compressed_payload(grpc_end2end_test_config config) {
   test_invoke_request_with_server_level(config);
   test_invoke_request_with_compressed_payload_md_override(config);
   test_invoke_request_with_disabled_algorithm(config);
+  test_invoke_request_with_offloaded_compression(config);
+  test_invoke_request_with_adaptive_compression(config);
+  test_invoke_request_with_stream_context(config);
+  test_invoke_request_with_unsupported_stream_context(config);
+#ifdef GRPC_HAVE_ZSTD
+  test_invoke_request_with_zstd_dictionary(config);
+#endif
 }
 
 void compressed_payload_pre_init(void) {}
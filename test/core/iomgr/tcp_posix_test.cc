@@ -33,15 +33,22 @@
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
 
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/iomgr/buffer_list.h"
 #include "src/core/lib/iomgr/ev_posix.h"
 #include "src/core/lib/iomgr/sockaddr_posix.h"
+#include "src/core/lib/iomgr/socket_utils_posix.h"
 #include "src/core/lib/iomgr/tcp_posix.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "test/core/iomgr/endpoint_tests.h"
 #include "test/core/util/test_config.h"
 
+/* As in tcp_posix.cc, in case the library headers predate MSG_ZEROCOPY. */
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
 static gpr_mu* g_mu;
 static grpc_pollset* g_pollset;
 
@@ -147,6 +154,37 @@ static size_t fill_socket_partial(int fd, size_t bytes) {
   return total_bytes;
 }
 
+/* Like fill_socket_partial, but sends from page-aligned memory with
+   MSG_ZEROCOPY where the socket allows it: on loopback that hands the pages
+   themselves to the receiver, which can then map them. Returns the buffer,
+   which must outlive the reads, through *buf; *zerocopy says whether
+   MSG_ZEROCOPY was used. */
+static size_t fill_socket_partial_zerocopy(int fd, size_t bytes,
+                                           unsigned char** buf,
+                                           bool* zerocopy) {
+  ssize_t write_bytes;
+  size_t total_bytes = 0;
+  *buf = static_cast<unsigned char*>(gpr_malloc_aligned(bytes, 4096));
+  for (size_t i = 0; i < bytes; ++i) {
+    (*buf)[i] = static_cast<uint8_t>(i % 256);
+  }
+  grpc_error_handle error = grpc_set_socket_zerocopy(fd);
+  *zerocopy = error == GRPC_ERROR_NONE;
+  GRPC_ERROR_UNREF(error);
+  do {
+    write_bytes = send(fd, *buf + total_bytes, bytes - total_bytes,
+                       *zerocopy ? MSG_ZEROCOPY : 0);
+    if (write_bytes > 0) {
+      total_bytes += static_cast<size_t>(write_bytes);
+    } else if (write_bytes < 0 && errno == ENOBUFS) {
+      /* Out of optmem for zerocopy notifications; copy the rest. */
+      *zerocopy = false;
+    }
+  } while ((write_bytes >= 0 || errno == EINTR || errno == ENOBUFS) &&
+           bytes > total_bytes);
+  return total_bytes;
+}
+
 struct read_socket_state {
   grpc_endpoint* ep;
   size_t read_bytes;
@@ -198,7 +236,8 @@ static void read_cb(void* user_data, grpc_error_handle error) {
 }
 
 /* Write to a socket, then read from it using the grpc_tcp API. */
-static void read_test(size_t num_bytes, size_t slice_size) {
+static void read_test(size_t num_bytes, size_t slice_size,
+                      bool use_read_buffer_pool = false) {
   int sv[2];
   grpc_endpoint* ep;
   struct read_socket_state state;
@@ -207,12 +246,14 @@ static void read_test(size_t num_bytes, size_t slice_size) {
       grpc_timespec_to_millis_round_up(grpc_timeout_seconds_to_deadline(20));
   grpc_core::ExecCtx exec_ctx;
 
-  gpr_log(GPR_INFO, "Read test of size %" PRIuPTR ", slice size %" PRIuPTR,
-          num_bytes, slice_size);
+  gpr_log(GPR_INFO,
+          "Read test of size %" PRIuPTR ", slice size %" PRIuPTR
+          ", read buffer pool %d",
+          num_bytes, slice_size, use_read_buffer_pool);
 
   create_sockets(sv);
 
-  grpc_arg a[2];
+  grpc_arg a[3];
   a[0].key = const_cast<char*>(GRPC_ARG_TCP_READ_CHUNK_SIZE);
   a[0].type = GRPC_ARG_INTEGER,
   a[0].value.integer = static_cast<int>(slice_size);
@@ -220,13 +261,20 @@ static void read_test(size_t num_bytes, size_t slice_size) {
   a[1].type = GRPC_ARG_POINTER;
   a[1].value.pointer.p = grpc_resource_quota_create("test");
   a[1].value.pointer.vtable = grpc_resource_quota_arg_vtable();
+  a[2].key = const_cast<char*>(GRPC_ARG_TCP_READ_BUFFER_POOL);
+  a[2].type = GRPC_ARG_INTEGER;
+  a[2].value.integer = use_read_buffer_pool;
   grpc_channel_args args = {GPR_ARRAY_SIZE(a), a};
   ep =
       grpc_tcp_create(grpc_fd_create(sv[1], "read_test", false), &args, "test");
   grpc_endpoint_add_to_pollset(ep, g_pollset);
 
-  written_bytes = fill_socket_partial(sv[0], num_bytes);
-  gpr_log(GPR_INFO, "Wrote %" PRIuPTR " bytes", written_bytes);
+  unsigned char* written;
+  bool zerocopy_sent;
+  written_bytes = fill_socket_partial_zerocopy(sv[0], num_bytes, &written,
+                                               &zerocopy_sent);
+  gpr_log(GPR_INFO, "Wrote %" PRIuPTR " bytes%s", written_bytes,
+          zerocopy_sent ? " with MSG_ZEROCOPY" : "");
 
   state.ep = ep;
   state.read_bytes = 0;
@@ -254,6 +302,100 @@ static void read_test(size_t num_bytes, size_t slice_size) {
       static_cast<grpc_resource_quota*>(a[1].value.pointer.p));
 }
 
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+static int64_t zerocopy_read_bytes() {
+  grpc_stats_data stats;
+  grpc_stats_collect(&stats);
+  return stats.counters[GRPC_STATS_COUNTER_TCP_ZEROCOPY_READ_BYTES];
+}
+#endif
+
+/* Write num_bytes over a TCP connection and read them with receive zerocopy
+   enabled; every byte must arrive in order. If expect_mapped, and the kernel
+   supports zerocopy on both ends, some of them must also have been mapped
+   rather than copied. */
+static void rx_zerocopy_read_test(size_t num_bytes, bool expect_mapped) {
+  int sv[2];
+  grpc_endpoint* ep;
+  struct read_socket_state state;
+  size_t written_bytes;
+  grpc_millis deadline =
+      grpc_timespec_to_millis_round_up(grpc_timeout_seconds_to_deadline(20));
+  grpc_core::ExecCtx exec_ctx;
+
+  gpr_log(GPR_INFO, "Rx zerocopy read test of size %" PRIuPTR, num_bytes);
+
+  create_inet_sockets(sv);
+
+  grpc_arg a[4];
+  a[0].key = const_cast<char*>(GRPC_ARG_TCP_READ_CHUNK_SIZE);
+  a[0].type = GRPC_ARG_INTEGER;
+  a[0].value.integer = 256 * 1024;
+  a[1].key = const_cast<char*>(GRPC_ARG_RESOURCE_QUOTA);
+  a[1].type = GRPC_ARG_POINTER;
+  a[1].value.pointer.p = grpc_resource_quota_create("test");
+  a[1].value.pointer.vtable = grpc_resource_quota_arg_vtable();
+  a[2].key = const_cast<char*>(GRPC_ARG_TCP_RX_ZEROCOPY_ENABLED);
+  a[2].type = GRPC_ARG_INTEGER;
+  a[2].value.integer = 1;
+  a[3].key = const_cast<char*>(GRPC_ARG_TCP_RX_ZEROCOPY_RECV_BYTES_THRESHOLD);
+  a[3].type = GRPC_ARG_INTEGER;
+  a[3].value.integer = 4096;
+  grpc_channel_args args = {GPR_ARRAY_SIZE(a), a};
+  ep = grpc_tcp_create(grpc_fd_create(sv[1], "rx_zerocopy_read_test", false),
+                       &args, "test");
+  grpc_endpoint_add_to_pollset(ep, g_pollset);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  const int64_t zerocopy_read_bytes_before = zerocopy_read_bytes();
+#endif
+
+  unsigned char* written;
+  bool zerocopy_sent;
+  written_bytes = fill_socket_partial_zerocopy(sv[0], num_bytes, &written,
+                                               &zerocopy_sent);
+  gpr_log(GPR_INFO, "Wrote %" PRIuPTR " bytes%s", written_bytes,
+          zerocopy_sent ? " with MSG_ZEROCOPY" : "");
+
+  state.ep = ep;
+  state.read_bytes = 0;
+  state.target_read_bytes = written_bytes;
+  grpc_slice_buffer_init(&state.incoming);
+  GRPC_CLOSURE_INIT(&state.read_cb, read_cb, &state, grpc_schedule_on_exec_ctx);
+
+  grpc_endpoint_read(ep, &state.incoming, &state.read_cb, /*urgent=*/false);
+
+  gpr_mu_lock(g_mu);
+  while (state.read_bytes < state.target_read_bytes) {
+    grpc_pollset_worker* worker = nullptr;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work", grpc_pollset_work(g_pollset, &worker, deadline)));
+    gpr_mu_unlock(g_mu);
+
+    gpr_mu_lock(g_mu);
+  }
+  GPR_ASSERT(state.read_bytes == state.target_read_bytes);
+  gpr_mu_unlock(g_mu);
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  const int64_t mapped = zerocopy_read_bytes() - zerocopy_read_bytes_before;
+  gpr_log(GPR_INFO, "Mapped %" PRId64 " bytes", mapped);
+  if (!expect_mapped) {
+    GPR_ASSERT(mapped == 0);
+  }
+#ifdef GRPC_HAVE_TCP_ZEROCOPY_RECEIVE
+  if (expect_mapped && zerocopy_sent) {
+    GPR_ASSERT(mapped > 0);
+  }
+#endif
+#endif
+
+  grpc_slice_buffer_destroy_internal(&state.incoming);
+  grpc_endpoint_destroy(ep);
+  close(sv[0]);
+  gpr_free_aligned(written);
+  grpc_resource_quota_unref(
+      static_cast<grpc_resource_quota*>(a[1].value.pointer.p));
+}
+
 /* Write to a socket until it fills up, then read from it using the grpc_tcp
    API. */
 static void large_read_test(size_t slice_size) {
@@ -533,8 +675,12 @@ static void release_fd_test(size_t num_bytes, size_t slice_size) {
   GPR_ASSERT(grpc_tcp_fd(ep) == sv[1] && sv[1] >= 0);
   grpc_endpoint_add_to_pollset(ep, g_pollset);
 
-  written_bytes = fill_socket_partial(sv[0], num_bytes);
-  gpr_log(GPR_INFO, "Wrote %" PRIuPTR " bytes", written_bytes);
+  unsigned char* written;
+  bool zerocopy_sent;
+  written_bytes = fill_socket_partial_zerocopy(sv[0], num_bytes, &written,
+                                               &zerocopy_sent);
+  gpr_log(GPR_INFO, "Wrote %" PRIuPTR " bytes%s", written_bytes,
+          zerocopy_sent ? " with MSG_ZEROCOPY" : "");
 
   state.ep = ep;
   state.read_bytes = 0;
@@ -588,6 +734,11 @@ void run_tests(void) {
   read_test(10000, 8192);
   read_test(10000, 137);
   read_test(10000, 1);
+  read_test(100, 8192, /*use_read_buffer_pool=*/true);
+  read_test(100000, 8192, /*use_read_buffer_pool=*/true);
+  read_test(100000, 1, /*use_read_buffer_pool=*/true);
+  rx_zerocopy_read_test(1000, /*expect_mapped=*/false);
+  rx_zerocopy_read_test(1024 * 1024, /*expect_mapped=*/true);
   large_read_test(8192);
   large_read_test(1);
 
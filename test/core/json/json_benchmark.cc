@@ -0,0 +1,162 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Parses large synthetic service configs, once into a JsonView and once
+// into a Json, and reports the throughput of each.
+
+#include <stdio.h>
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/resource_quota/arena.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "test/core/util/cmdline.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+// A service config with a method config, with a retry policy, per method.
+std::string MakeServiceConfig(int num_methods) {
+  Json::Array method_configs;
+  for (int i = 0; i < num_methods; ++i) {
+    method_configs.push_back(Json::Object{
+        {"name",
+         Json::Array{Json::Object{
+             {"service", absl::StrCat("pkg.Service", i / 10)},
+             {"method", absl::StrCat("Method", i % 10)},
+         }}},
+        {"timeout", "1.5s"},
+        {"waitForReady", true},
+        {"maxRequestMessageBytes", 4194304},
+        {"retryPolicy",
+         Json::Object{
+             {"maxAttempts", 3},
+             {"initialBackoff", "0.1s"},
+             {"maxBackoff", "10s"},
+             {"backoffMultiplier", 2},
+             {"retryableStatusCodes", Json::Array{"UNAVAILABLE", "ABORTED"}},
+         }},
+    });
+  }
+  return Json(Json::Object{
+                  {"loadBalancingConfig",
+                   Json::Array{Json::Object{{"round_robin", Json::Object{}}}}},
+                  {"methodConfig", std::move(method_configs)},
+              })
+      .Dump(/*indent=*/2);
+}
+
+// An RLS LB policy config with a key builder per service.
+std::string MakeRlsConfig(int num_services) {
+  Json::Array key_builders;
+  for (int i = 0; i < num_services; ++i) {
+    key_builders.push_back(Json::Object{
+        {"names", Json::Array{Json::Object{
+                      {"service", absl::StrCat("pkg.Service", i)},
+                  }}},
+        {"headers", Json::Array{Json::Object{
+                        {"key", "user"},
+                        {"names", Json::Array{"x-user-id", "x-user"}},
+                    }}},
+        {"extraKeys", Json::Object{{"host", "host-key"}}},
+        {"constantKeys", Json::Object{{"region", "us-east1"}}},
+    });
+  }
+  return Json(
+             Json::Object{
+                 {"loadBalancingConfig",
+                  Json::Array{Json::Object{
+                      {"rls",
+                       Json::Object{
+                           {"routeLookupConfig",
+                            Json::Object{
+                                {"lookupService", "rls.example.com:443"},
+                                {"cacheSizeBytes", 1048576},
+                                {"grpcKeybuilders", std::move(key_builders)},
+                            }},
+                           {"childPolicy",
+                            Json::Array{Json::Object{
+                                {"grpclb", Json::Object{}}}}},
+                           {"childPolicyConfigTargetFieldName", "target"},
+                       }}}}},
+             })
+      .Dump(/*indent=*/2);
+}
+
+// Runs \a fn \a iterations times; returns the average time per call in
+// microseconds.
+template <typename F>
+double TimePerCall(int iterations, F fn) {
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  for (int i = 0; i < iterations; ++i) fn();
+  gpr_timespec elapsed = gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start);
+  return gpr_timespec_to_micros(elapsed) / iterations;
+}
+
+void RunBenchmark(const char* name, const std::string& input,
+                  int iterations) {
+  MemoryAllocator memory_allocator(
+      ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator(
+          "json_benchmark"));
+  double view_us = TimePerCall(iterations, [&]() {
+    ScopedArenaPtr arena = MakeScopedArena(1024, &memory_allocator);
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    GPR_ASSERT(JsonView::Parse(input, arena.get(), &error) != nullptr);
+  });
+  double json_us = TimePerCall(iterations, [&]() {
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    Json json = Json::Parse(input, &error);
+    GPR_ASSERT(error == GRPC_ERROR_NONE);
+  });
+  const double mb = input.size() / 1e6;
+  printf("%s (%.2fMB): JsonView %.0fus (%.0fMB/s), Json %.0fus (%.0fMB/s)\n",
+         name, mb, view_us, mb / view_us * 1e6, json_us, mb / json_us * 1e6);
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  int num_methods = 10000;
+  int num_services = 10000;
+  int iterations = 10;
+  gpr_cmdline* cl = gpr_cmdline_create("json benchmark");
+  gpr_cmdline_add_int(cl, "methods", "Method configs in the service config",
+                      &num_methods);
+  gpr_cmdline_add_int(cl, "services", "Key builders in the RLS config",
+                      &num_services);
+  gpr_cmdline_add_int(cl, "iterations", "Parses of each config",
+                      &iterations);
+  gpr_cmdline_parse(cl, argc, argv);
+  gpr_cmdline_destroy(cl);
+  grpc_init();
+  grpc_core::RunBenchmark("service config",
+                          grpc_core::MakeServiceConfig(num_methods),
+                          iterations);
+  grpc_core::RunBenchmark("RLS config", grpc_core::MakeRlsConfig(num_services),
+                          iterations);
+  grpc_shutdown();
+  return 0;
+}
@@ -23,12 +23,16 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "absl/strings/str_cat.h"
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/resource_quota/arena.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
 #include "test/core/util/test_config.h"
 
 namespace grpc_core {
@@ -206,6 +210,9 @@ TEST(Json, ImbalancedSurrogatePairs) {
   RunParseFailureTest("{\"\\ud834 \"\":0}");
   RunParseFailureTest("\"\\ud834\\\\\"");
   RunParseFailureTest("{\"\\ud834\\\\\"\":0}");
+  RunParseFailureTest("\"\\ud834\\ud834\\udd1e\"");
+  RunParseFailureTest("\"\\ud834\\u0041\"");
+  RunParseFailureTest("\"\\ud834\\u0041\\udd1e\"");
 }
 
 TEST(Json, EmbeddedInvalidWhitechars) {
@@ -254,8 +261,101 @@ TEST(Json, InvalidNumbers) {
   RunParseFailureTest("1e12x");
   RunParseFailureTest(".12x");
   RunParseFailureTest("000");
+  RunParseFailureTest("-");
+  RunParseFailureTest("-01");
+  RunParseFailureTest("1e+");
 };
 
+TEST(Json, ErrorIndex) {
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  Json::Parse("{\"a\": 1, \"a\": tru}", &error);
+  std::string message = grpc_error_std_string(error);
+  EXPECT_THAT(message, ::testing::HasSubstr("JSON parse error at index 17"));
+  GRPC_ERROR_UNREF(error);
+  Json::Parse("{\"a\": 1, \"a\": true}", &error);
+  message = grpc_error_std_string(error);
+  EXPECT_THAT(message, ::testing::HasSubstr("duplicate key \"a\" at index 17"));
+  GRPC_ERROR_UNREF(error);
+}
+
+class JsonViewTest : public ::testing::Test {
+ protected:
+  JsonViewTest()
+      : memory_allocator_(
+            ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator(
+                "test")),
+        arena_(MakeScopedArena(1024, &memory_allocator_)) {}
+
+  const JsonView* Parse(absl::string_view input) {
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    const JsonView* view = JsonView::Parse(input, arena_.get(), &error);
+    EXPECT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+    GRPC_ERROR_UNREF(error);
+    return view;
+  }
+
+  MemoryAllocator memory_allocator_;
+  ScopedArenaPtr arena_;
+};
+
+TEST_F(JsonViewTest, UnescapedStringsReferToInput) {
+  std::string input =
+      "{\"b\": [\"plain\", \"esc\\\\aped\", -1.5e3], \"a\": null}";
+  const JsonView* view = Parse(input);
+  ASSERT_NE(view, nullptr);
+  ASSERT_EQ(view->type(), Json::Type::OBJECT);
+  ASSERT_EQ(view->object_value().size(), 2);
+  // Members are sorted by key.
+  EXPECT_EQ(view->object_value()[0].key, "a");
+  EXPECT_EQ(view->object_value()[0].value.type(), Json::Type::JSON_NULL);
+  const JsonView* array = view->Find("b");
+  ASSERT_NE(array, nullptr);
+  ASSERT_EQ(array->array_value().size(), 3);
+  absl::string_view plain = array->array_value()[0].string_value();
+  EXPECT_EQ(plain, "plain");
+  EXPECT_EQ(plain.data(), input.data() + input.find("plain"));
+  absl::string_view escaped = array->array_value()[1].string_value();
+  EXPECT_EQ(escaped, "esc\\aped");
+  EXPECT_NE(escaped.data(), input.data() + input.find("esc"));
+  EXPECT_EQ(array->array_value()[2].type(), Json::Type::NUMBER);
+  EXPECT_EQ(array->array_value()[2].string_value(), "-1.5e3");
+  EXPECT_EQ(view->Find("c"), nullptr);
+}
+
+TEST_F(JsonViewTest, ToJsonMatchesJsonParse) {
+  const char* input =
+      "{\"methodConfig\": [{\"name\": [{\"service\": \"foo.Bar\"}], "
+      "\"timeout\": \"1.5s\", \"waitForReady\": true}], "
+      "\"loadBalancingConfig\": [{\"round_robin\": {}}], "
+      "\"text\": \"\\u00e9\\ud834\\udd1e\", \"empty\": [], \"x\": false}";
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  Json json = Json::Parse(input, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  const JsonView* view = Parse(input);
+  ASSERT_NE(view, nullptr);
+  EXPECT_EQ(view->ToJson(), json);
+  EXPECT_EQ(view->ToJson().Dump(), json.Dump());
+}
+
+TEST_F(JsonViewTest, LargeObjectDuplicateKey) {
+  std::string input = "{";
+  for (int i = 0; i < 100; ++i) {
+    absl::StrAppend(&input, "\"key", i, "\": ", i, ", ");
+  }
+  const JsonView* view = Parse(absl::StrCat(input, "\"last\": 0}"));
+  ASSERT_NE(view, nullptr);
+  EXPECT_EQ(view->object_value().size(), 101);
+  ASSERT_NE(view->Find("key42"), nullptr);
+  EXPECT_EQ(view->Find("key42")->string_value(), "42");
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  EXPECT_EQ(JsonView::Parse(absl::StrCat(input, "\"key7\": 0}"), arena_.get(),
+                            &error),
+            nullptr);
+  EXPECT_THAT(grpc_error_std_string(error),
+              ::testing::HasSubstr("duplicate key"));
+  GRPC_ERROR_UNREF(error);
+}
+
 TEST(Json, Equality) {
   // Null.
   EXPECT_EQ(Json(), Json());
@@ -199,6 +199,53 @@ TEST(MemoryQuotaTest, NoBunchingIfIdle) {
   EXPECT_GE(count_reclaimers_called.load(std::memory_order_relaxed), 8000);
 }
 
+class RecordingPressureWatcher : public BasicMemoryQuota::PressureWatcher {
+ public:
+  void OnPressureChanged(double pressure, size_t share) override {
+    pressure_ = pressure;
+    share_ = share;
+    ++notifications_;
+  }
+
+  double pressure() const { return pressure_; }
+  size_t share() const { return share_; }
+  int notifications() const { return notifications_; }
+
+ private:
+  double pressure_ = 0;
+  size_t share_ = 0;
+  int notifications_ = 0;
+};
+
+TEST(MemoryQuotaTest, PressureWatchersShareTheQuota) {
+  ExecCtx exec_ctx;
+  MemoryQuota memory_quota("foo");
+  memory_quota.SetSize(16 * 1024 * 1024);
+  // Declared before the owners: owners drop their watchers on shutdown.
+  RecordingPressureWatcher watcher1;
+  RecordingPressureWatcher watcher2;
+  auto memory_owner1 = memory_quota.CreateMemoryOwner("bar1");
+  auto memory_owner2 = memory_quota.CreateMemoryOwner("bar2");
+  // Each watcher gets an equal share of the recommended allocation size, a
+  // sixteenth of the quota.
+  memory_owner1.SetPressureWatcher(&watcher1);
+  EXPECT_EQ(watcher1.share(), 1024 * 1024);
+  memory_owner2.SetPressureWatcher(&watcher2);
+  EXPECT_EQ(watcher1.share(), 512 * 1024);
+  EXPECT_EQ(watcher2.share(), 512 * 1024);
+  EXPECT_LT(watcher1.pressure(), 0.1);
+  // Using up most of the quota is reported to every watcher.
+  const int notifications = watcher2.notifications();
+  const size_t reserved = memory_owner1.Reserve(12 * 1024 * 1024);
+  EXPECT_GT(watcher2.notifications(), notifications);
+  EXPECT_GE(watcher1.pressure(), 0.75);
+  EXPECT_GE(watcher2.pressure(), 0.75);
+  // Removing a watcher hands its share back to the others.
+  memory_owner2.SetPressureWatcher(nullptr);
+  EXPECT_EQ(watcher1.share(), 1024 * 1024);
+  memory_owner1.Release(reserved);
+}
+
 }  // namespace testing
 }  // namespace grpc_core
 
@@ -18,6 +18,8 @@
 
 #include "src/core/lib/surface/completion_queue.h"
 
+#include <time.h>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
@@ -130,6 +132,59 @@ static void test_wait_empty(void) {
   }
 }
 
+/* Waits on an empty queue of the given type until \a deadline with a busy
+   polling budget of \a spin_us. Returns how often the queue polled, and
+   stores the cpu time the wait took in *cpu_ms. */
+static int wait_empty_with_busy_poll(grpc_cq_completion_type type,
+                                     int spin_us, gpr_timespec deadline,
+                                     double* cpu_ms) {
+  grpc_completion_queue_attributes attr;
+  attr.version = 1;
+  attr.cq_completion_type = type;
+  attr.cq_polling_type = GRPC_CQ_DEFAULT_POLLING;
+  grpc_completion_queue* cc = grpc_completion_queue_create(
+      grpc_completion_queue_factory_lookup(&attr), &attr, nullptr);
+  grpc_iomgr_set_busy_poll_spin_us_for_testing(spin_us);
+  clock_t start = clock();
+  grpc_event event =
+      type == GRPC_CQ_NEXT
+          ? grpc_completion_queue_next(cc, deadline, nullptr)
+          : grpc_completion_queue_pluck(cc, create_test_tag(), deadline,
+                                        nullptr);
+  *cpu_ms = 1000.0 * static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+  grpc_iomgr_set_busy_poll_spin_us_for_testing(0);
+  GPR_ASSERT(event.type == GRPC_QUEUE_TIMEOUT);
+  int polls = grpc_get_cq_poll_num(cc);
+  shutdown_and_destroy(cc);
+  return polls;
+}
+
+static void test_busy_poll_spin_budget(void) {
+  grpc_cq_completion_type completion_types[] = {GRPC_CQ_NEXT, GRPC_CQ_PLUCK};
+  LOG_TEST("test_busy_poll_spin_budget");
+
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(completion_types); i++) {
+    double cpu_ms;
+    /* Without a budget, a wait blocks in the poller. */
+    int blocking_polls = wait_empty_with_busy_poll(
+        completion_types[i], 0, grpc_timeout_milliseconds_to_deadline(200),
+        &cpu_ms);
+    /* With a 50ms budget it polls without blocking for 50ms, then blocks for
+       the rest of the wait. */
+    int spinning_polls = wait_empty_with_busy_poll(
+        completion_types[i], 50000, grpc_timeout_milliseconds_to_deadline(200),
+        &cpu_ms);
+    gpr_log(GPR_INFO, "%d polls blocking, %d spinning for %.1fms of cpu",
+            blocking_polls, spinning_polls, cpu_ms);
+    GPR_ASSERT(spinning_polls > blocking_polls);
+    GPR_ASSERT(cpu_ms < 150);
+    /* A wait that has already expired polls once, budget or not. */
+    GPR_ASSERT(wait_empty_with_busy_poll(completion_types[i], 50000,
+                                         gpr_inf_past(GPR_CLOCK_REALTIME),
+                                         &cpu_ms) == 1);
+  }
+}
+
 static void do_nothing_end_completion(void* /*arg*/,
                                       grpc_cq_completion* /*c*/) {}
 
@@ -492,6 +547,7 @@ int main(int argc, char** argv) {
   test_no_op();
   test_pollset_conversion();
   test_wait_empty();
+  test_busy_poll_spin_budget();
   test_shutdown_then_next_polling();
   test_shutdown_then_next_with_timeout();
   test_cq_end_op();
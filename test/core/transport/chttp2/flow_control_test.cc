@@ -23,9 +23,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <functional>
 #include <set>
 #include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 
@@ -55,10 +57,11 @@ class TransportTargetWindowSizeMocker
   static constexpr uint32_t kSmallInitialWindowSize = 0;
 
   double ComputeNextTargetInitialWindowSizeFromPeriodicUpdate(
-      double /* current_target */) override {
+      double current_target) override {
     // Protecting access to variable window_size_ shared between client and
     // server.
     absl::MutexLock lock(&mu_);
+    max_current_target_ = std::max(max_current_target_, current_target);
     if (alternating_initial_window_sizes_) {
       window_size_ = (window_size_ == kLargeInitialWindowSize)
                          ? kSmallInitialWindowSize
@@ -80,12 +83,20 @@ class TransportTargetWindowSizeMocker
     absl::MutexLock lock(&mu_);
     alternating_initial_window_sizes_ = false;
     window_size_ = kLargeInitialWindowSize;
+    max_current_target_ = 0;
+  }
+
+  // The largest initial window target any transport has applied since Reset.
+  double max_current_target() {
+    absl::MutexLock lock(&mu_);
+    return max_current_target_;
   }
 
  private:
   absl::Mutex mu_;
   bool alternating_initial_window_sizes_ ABSL_GUARDED_BY(mu_) = false;
   double window_size_ ABSL_GUARDED_BY(mu_) = kLargeInitialWindowSize;
+  double max_current_target_ ABSL_GUARDED_BY(mu_) = 0;
 };
 
 TransportTargetWindowSizeMocker* g_target_initial_window_size_mocker;
@@ -290,15 +301,17 @@ class FlowControlTest : public ::testing::Test {
     // create the server
     std::string server_address =
         grpc_core::JoinHostPort("localhost", grpc_pick_unused_port_or_die());
-    grpc_arg server_args[] = {
+    std::vector<grpc_arg> server_args = {
         grpc_channel_arg_integer_create(
             const_cast<char*>(GRPC_ARG_HTTP2_MAX_PING_STRIKES), 0),
         grpc_channel_arg_integer_create(
             const_cast<char*>(GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH), -1),
         grpc_channel_arg_integer_create(
             const_cast<char*>(GRPC_ARG_MAX_SEND_MESSAGE_LENGTH), -1)};
-    grpc_channel_args server_channel_args = {GPR_ARRAY_SIZE(server_args),
-                                             server_args};
+    server_args.insert(server_args.end(), extra_args_.begin(),
+                       extra_args_.end());
+    grpc_channel_args server_channel_args = {server_args.size(),
+                                             server_args.data()};
     server_ = grpc_server_create(&server_channel_args, nullptr);
     grpc_server_register_completion_queue(server_, cq_, nullptr);
     grpc_server_credentials* server_creds =
@@ -308,7 +321,7 @@ class FlowControlTest : public ::testing::Test {
     grpc_server_credentials_release(server_creds);
     grpc_server_start(server_);
     // create the channel (bdp pings are enabled by default)
-    grpc_arg client_args[] = {
+    std::vector<grpc_arg> client_args = {
         grpc_channel_arg_integer_create(
             const_cast<char*>(GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA), 0),
         grpc_channel_arg_integer_create(
@@ -317,8 +330,10 @@ class FlowControlTest : public ::testing::Test {
             const_cast<char*>(GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH), -1),
         grpc_channel_arg_integer_create(
             const_cast<char*>(GRPC_ARG_MAX_SEND_MESSAGE_LENGTH), -1)};
-    grpc_channel_args client_channel_args = {GPR_ARRAY_SIZE(client_args),
-                                             client_args};
+    client_args.insert(client_args.end(), extra_args_.begin(),
+                       extra_args_.end());
+    grpc_channel_args client_channel_args = {client_args.size(),
+                                             client_args.data()};
     grpc_channel_credentials* creds = grpc_insecure_credentials_create();
     channel_ = grpc_channel_create(server_address.c_str(), creds,
                                    &client_channel_args);
@@ -339,11 +354,40 @@ class FlowControlTest : public ::testing::Test {
     grpc_completion_queue_destroy(cq_);
   }
 
+  // Added to both the client and the server args.
+  std::vector<grpc_arg> extra_args_;
   grpc_server* server_ = nullptr;
   grpc_channel* channel_ = nullptr;
   grpc_completion_queue* cq_ = nullptr;
 };
 
+// Runs the client and server with memory aware flow control, sharing a quota
+// small enough that their windows are bounded by the quota rather than by the
+// BDP estimate.
+class MemoryAwareFlowControlTest : public FlowControlTest {
+ protected:
+  static constexpr size_t kQuotaSize = 64 * 1024 * 1024;
+
+  void SetUp() override {
+    resource_quota_ = grpc_resource_quota_create("memory_aware_flow_control");
+    grpc_resource_quota_resize(resource_quota_, kQuotaSize);
+    extra_args_ = {
+        grpc_channel_arg_pointer_create(
+            const_cast<char*>(GRPC_ARG_RESOURCE_QUOTA), resource_quota_,
+            grpc_resource_quota_arg_vtable()),
+        grpc_channel_arg_integer_create(
+            const_cast<char*>(GRPC_ARG_HTTP2_MEMORY_AWARE_FLOW_CONTROL), 1)};
+    FlowControlTest::SetUp();
+  }
+
+  void TearDown() override {
+    FlowControlTest::TearDown();
+    grpc_resource_quota_unref(resource_quota_);
+  }
+
+  grpc_resource_quota* resource_quota_ = nullptr;
+};
+
 TEST_F(FlowControlTest,
        TestLargeWindowSizeUpdatesDoNotCauseIllegalFlowControlWindows) {
   for (int i = 0; i < 10; ++i) {
@@ -360,6 +404,21 @@ TEST_F(FlowControlTest, TestWindowSizeUpdatesDoNotCauseStalledStreams) {
   }
 }
 
+TEST_F(MemoryAwareFlowControlTest, LargePayloadsCompleteUnderQuota) {
+  for (int i = 0; i < 10; ++i) {
+    PerformCallWithLargePayload(channel_, server_, cq_);
+    VerifyChannelConnected(channel_, cq_);
+  }
+  // The mocker asks for a 2GiB window. Without the quota that would be
+  // clamped to kMaxInitialWindowSize (1GiB); here no transport ever gets more
+  // than its share of the quota's recommended allocation size, a sixteenth of
+  // the quota.
+  const double max_target =
+      g_target_initial_window_size_mocker->max_current_target();
+  EXPECT_GT(max_target, 0);
+  EXPECT_LE(max_target, kQuotaSize / 16);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
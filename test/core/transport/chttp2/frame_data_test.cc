@@ -0,0 +1,199 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/ext/transport/chttp2/transport/frame_data.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
+#include "src/core/ext/transport/chttp2/transport/internal.h"
+#include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "test/core/util/mock_endpoint.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+void discard_write(grpc_slice /*slice*/) {}
+
+// Deframes messages out of buffers whose slice boundaries fall at chosen
+// places, on a real stream of a client transport.
+class DeframeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    GRPC_STREAM_REF_INIT(&ref_, 1, nullptr, nullptr, "phony ref");
+    const grpc_channel_args* args = CoreConfiguration::Get()
+                                        .channel_args_preconditioning()
+                                        .PreconditionChannelArgs(nullptr);
+    t_ = grpc_create_chttp2_transport(
+        args, grpc_mock_endpoint_create(discard_write), true);
+    grpc_channel_args_destroy(args);
+    s_ = static_cast<grpc_chttp2_stream*>(
+        gpr_malloc(grpc_transport_stream_size(t_)));
+    grpc_transport_init_stream(t_, reinterpret_cast<grpc_stream*>(s_), &ref_,
+                               nullptr, nullptr);
+    grpc_slice_buffer_init(&buffer_);
+  }
+
+  void TearDown() override {
+    grpc_slice_buffer_destroy_internal(&buffer_);
+    grpc_transport_destroy_stream(t_, reinterpret_cast<grpc_stream*>(s_),
+                                  nullptr);
+    exec_ctx_.Flush();
+    gpr_free(s_);
+    grpc_transport_destroy(t_);
+    exec_ctx_.Flush();
+  }
+
+  // Appends \a bytes to the buffer as slices of the given lengths, which
+  // must add up to bytes.size().
+  void AddSlices(const std::string& bytes, const std::vector<size_t>& lengths) {
+    size_t offset = 0;
+    for (size_t length : lengths) {
+      grpc_slice_buffer_add(
+          &buffer_, grpc_slice_from_copied_buffer(bytes.data() + offset,
+                                                  length));
+      offset += length;
+    }
+    ASSERT_EQ(offset, bytes.size());
+  }
+
+  // Deframes one message and returns its payload.
+  std::string Deframe(uint32_t* flags = nullptr) {
+    OrphanablePtr<ByteStream> stream;
+    grpc_error_handle error = grpc_deframe_unprocessed_incoming_frames(
+        &s_->data_parser, s_, &buffer_, nullptr, &stream);
+    EXPECT_EQ(error, GRPC_ERROR_NONE);
+    GRPC_ERROR_UNREF(error);
+    if (stream == nullptr) return "<no message>";
+    // Only the whole-message path may hand a stream out without a pending
+    // byte stream on the transport.
+    EXPECT_FALSE(s_->pending_byte_stream);
+    EXPECT_EQ(s_->data_parser.state, GRPC_CHTTP2_DATA_FH_0);
+    if (flags != nullptr) *flags = stream->flags();
+    std::string payload;
+    while (payload.size() < stream->length()) {
+      EXPECT_TRUE(stream->Next(stream->length() - payload.size(), nullptr));
+      grpc_slice slice;
+      error = stream->Pull(&slice);
+      EXPECT_EQ(error, GRPC_ERROR_NONE);
+      GRPC_ERROR_UNREF(error);
+      payload.append(std::string(StringViewFromSlice(slice)));
+      grpc_slice_unref_internal(slice);
+    }
+    return payload;
+  }
+
+  // Remaining buffered bytes, flattened.
+  std::string Remaining() {
+    std::string remaining;
+    for (size_t i = 0; i < buffer_.count; ++i) {
+      const grpc_slice& slice = buffer_.slices[i];
+      remaining.append(std::string(StringViewFromSlice(slice)));
+    }
+    return remaining;
+  }
+
+  ExecCtx exec_ctx_;
+  grpc_stream_refcount ref_;
+  grpc_transport* t_ = nullptr;
+  grpc_chttp2_stream* s_ = nullptr;
+  grpc_slice_buffer buffer_;
+};
+
+// A gRPC message: the 5-byte header followed by \a payload.
+std::string Message(const std::string& payload, bool compressed = false) {
+  std::string message(5, '\0');
+  message[0] = compressed ? 1 : 0;
+  message[1] = static_cast<char>(payload.size() >> 24);
+  message[2] = static_cast<char>(payload.size() >> 16);
+  message[3] = static_cast<char>(payload.size() >> 8);
+  message[4] = static_cast<char>(payload.size());
+  return message + payload;
+}
+
+TEST_F(DeframeTest, SingleSlice) {
+  AddSlices(Message("hello world"), {16});
+  EXPECT_EQ(Deframe(), "hello world");
+  EXPECT_EQ(buffer_.length, 0);
+  EXPECT_EQ(s_->stats.incoming.framing_bytes, 5);
+  EXPECT_EQ(s_->stats.incoming.data_bytes, 11);
+}
+
+TEST_F(DeframeTest, HeaderInItsOwnSlice) {
+  AddSlices(Message("hello world"), {5, 6, 5});
+  EXPECT_EQ(Deframe(), "hello world");
+  EXPECT_EQ(buffer_.length, 0);
+}
+
+TEST_F(DeframeTest, PayloadSpansSlices) {
+  AddSlices(Message("hello world"), {7, 3, 1, 5});
+  EXPECT_EQ(Deframe(), "hello world");
+  EXPECT_EQ(buffer_.length, 0);
+}
+
+TEST_F(DeframeTest, OneByteSlices) {
+  AddSlices(Message("hello world"), {5, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1});
+  EXPECT_EQ(Deframe(), "hello world");
+  EXPECT_EQ(buffer_.length, 0);
+}
+
+TEST_F(DeframeTest, EmptyMessage) {
+  AddSlices(Message(""), {5});
+  EXPECT_EQ(Deframe(), "");
+  EXPECT_EQ(buffer_.length, 0);
+}
+
+TEST_F(DeframeTest, CompressedFlag) {
+  AddSlices(Message("abc", /*compressed=*/true), {4, 4});
+  uint32_t flags = 0;
+  EXPECT_EQ(Deframe(&flags), "abc");
+  EXPECT_EQ(flags & GRPC_WRITE_INTERNAL_COMPRESS, GRPC_WRITE_INTERNAL_COMPRESS);
+}
+
+// The next message starts in the middle of the slice that ends this one; the
+// bytes that follow must stay buffered, and be deframed in turn.
+TEST_F(DeframeTest, BackToBackMessagesShareSlices) {
+  const std::string first = Message("first");
+  const std::string second = Message("second message");
+  AddSlices(first + second, {8, first.size() - 8 + 7, second.size() - 7});
+  EXPECT_EQ(Deframe(), "first");
+  EXPECT_EQ(Remaining(), second);
+  EXPECT_EQ(Deframe(), "second message");
+  EXPECT_EQ(buffer_.length, 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
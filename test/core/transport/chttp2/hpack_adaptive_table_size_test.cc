@@ -0,0 +1,181 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
+#include "src/core/ext/transport/chttp2/transport/internal.h"
+#include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "test/core/util/mock_endpoint.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+void discard_write(grpc_slice /*slice*/) {}
+
+// Checks how far a client transport's HPACK encoder table grows when it
+// thrashes, given the table size the server advertises in its SETTINGS.
+class HPackAdaptiveTableSizeTest : public ::testing::Test {
+ protected:
+  void StartTransport(int max_adaptive_table_size) {
+    grpc_arg arg = grpc_channel_arg_integer_create(
+        const_cast<char*>(GRPC_ARG_HTTP2_MAX_ADAPTIVE_HPACK_TABLE_SIZE),
+        max_adaptive_table_size);
+    grpc_channel_args client_args = {1, &arg};
+    const grpc_channel_args* args =
+        CoreConfiguration::Get()
+            .channel_args_preconditioning()
+            .PreconditionChannelArgs(&client_args);
+    endpoint_ = grpc_mock_endpoint_create(discard_write);
+    transport_ = grpc_create_chttp2_transport(args, endpoint_, true);
+    grpc_channel_args_destroy(args);
+    grpc_chttp2_transport_start_reading(transport_, nullptr, nullptr, nullptr);
+    exec_ctx_.Flush();
+  }
+
+  void TearDown() override {
+    grpc_transport_destroy(transport_);
+    exec_ctx_.Flush();
+  }
+
+  grpc_chttp2_transport* t() {
+    return reinterpret_cast<grpc_chttp2_transport*>(transport_);
+  }
+
+  // Delivers \a frame to the transport as if read from the server.
+  void Read(const std::string& frame) {
+    grpc_mock_endpoint_put_read(
+        endpoint_, grpc_slice_from_copied_buffer(frame.data(), frame.size()));
+    exec_ctx_.Flush();
+  }
+
+  // A SETTINGS frame, optionally advertising SETTINGS_HEADER_TABLE_SIZE.
+  static std::string SettingsFrame(uint32_t header_table_size = 0) {
+    if (header_table_size == 0) {
+      return std::string("\x00\x00\x00\x04\x00\x00\x00\x00\x00", 9);
+    }
+    std::string frame("\x00\x00\x06\x04\x00\x00\x00\x00\x00\x00\x01", 11);
+    frame.push_back(static_cast<char>(header_table_size >> 24));
+    frame.push_back(static_cast<char>(header_table_size >> 16));
+    frame.push_back(static_cast<char>(header_table_size >> 8));
+    frame.push_back(static_cast<char>(header_table_size));
+    return frame;
+  }
+
+  // Encodes \a count header blocks, each with a never-seen-before :path, as
+  // the transport would for new streams. Each path takes a new table entry
+  // and, once the table is full, evicts older ones. (Unknown metadata keys are
+  // never indexed, so they would not churn the table.)
+  void EncodeUniquePaths(int count) {
+    for (int i = 0; i < count; ++i) {
+      auto arena = MakeScopedArena(1024, &memory_allocator_);
+      grpc_metadata_batch headers(arena.get());
+      headers.Set(HttpPathMetadata(),
+                  Slice::FromCopiedString(absl::StrCat(
+                      "/pkg.Service/", std::string(64, 'x'), next_path_++)));
+      grpc_transport_one_way_stats stats = {};
+      HPackCompressor::EncodeHeaderOptions options{
+          1,     /* stream_id */
+          false, /* is_eof */
+          false, /* use_true_binary_metadata */
+          16384, /* max_frame_size */
+          &stats /* stats */};
+      grpc_slice_buffer output;
+      grpc_slice_buffer_init(&output);
+      t()->hpack_compressor.EncodeHeaders(options, headers, &output);
+      grpc_slice_buffer_destroy_internal(&output);
+    }
+  }
+
+  // Thrashes the encoder table, then has the transport read a frame, which is
+  // when it reconsiders the table sizes. Returns the encoder's table size.
+  uint32_t ThrashAndRead() {
+    EncodeUniquePaths(2 * hpack_constants::kChurnSampleInsertions);
+    Read(SettingsFrame());
+    return t()->hpack_compressor.test_only_table_max_size();
+  }
+
+  ExecCtx exec_ctx_;
+  MemoryAllocator memory_allocator_ =
+      ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator("test");
+  grpc_endpoint* endpoint_ = nullptr;
+  grpc_transport* transport_ = nullptr;
+  int next_path_ = 0;
+};
+
+// The server allows a larger table than the 4096 byte default: the encoder
+// table grows until it reaches the server's limit, and no further, even though
+// the adaptive limit is higher still.
+TEST_F(HPackAdaptiveTableSizeTest, GrowsUpToPeerAdvertisedSize) {
+  StartTransport(65536);
+  Read(SettingsFrame(16384));
+  EXPECT_EQ(t()->settings[GRPC_PEER_SETTINGS]
+                         [GRPC_CHTTP2_SETTINGS_HEADER_TABLE_SIZE],
+            16384);
+  EXPECT_EQ(t()->hpack_compressor.test_only_table_max_size(), 4096);
+  EXPECT_EQ(ThrashAndRead(), 8192);
+  EXPECT_EQ(ThrashAndRead(), 16384);
+  EXPECT_EQ(ThrashAndRead(), 16384);
+  EXPECT_EQ(ThrashAndRead(), 16384);
+}
+
+// The server never advertises a table size, so the 4096 byte default applies.
+TEST_F(HPackAdaptiveTableSizeTest, PeerDefaultCapsGrowth) {
+  StartTransport(65536);
+  Read(SettingsFrame());
+  EXPECT_EQ(ThrashAndRead(), 4096);
+  EXPECT_EQ(ThrashAndRead(), 4096);
+}
+
+// The adaptive limit is below what the server allows.
+TEST_F(HPackAdaptiveTableSizeTest, AdaptiveLimitCapsGrowth) {
+  StartTransport(8192);
+  Read(SettingsFrame(65536));
+  EXPECT_EQ(ThrashAndRead(), 8192);
+  EXPECT_EQ(ThrashAndRead(), 8192);
+}
+
+// Without the adaptive limit the table keeps its size.
+TEST_F(HPackAdaptiveTableSizeTest, DisabledByDefault) {
+  StartTransport(0);
+  Read(SettingsFrame(65536));
+  EXPECT_EQ(ThrashAndRead(), 4096);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -214,6 +214,21 @@ static void test_basic_headers() {
          "b", "c");
 }
 
+static void test_static_table_names() {
+  verify_params params = {
+      false,
+      false,
+  };
+  // Keys found in the static table are referenced by index, and other well
+  // known keys are emitted as literals.
+  verify(params,
+         "000019 0104 deadbeef 44 04 2f666f6f 40 0b 677270632d737461747573 "
+         "01 30 0f17 01 68",
+         3, ":path", "/foo", "grpc-status", "0", "host", "h");
+  verify(params, "000005 0104 deadbeef bf 0f17 01 68", 2, ":path", "/foo",
+         "host", "h");
+}
+
 static void verify_continuation_headers(const char* key, const char* value,
                                         bool is_eof) {
   auto arena = grpc_core::MakeScopedArena(1024, g_memory_allocator);
@@ -260,6 +275,7 @@ int main(int argc, char** argv) {
   grpc::testing::TestEnvironment env(argc, argv);
   grpc_init();
   TEST(test_basic_headers);
+  TEST(test_static_table_names);
   TEST(test_continuation_headers);
   grpc_shutdown();
   return g_failure;
@@ -139,6 +139,55 @@ TEST(HpackParserTableTest, ManyAdditions) {
   }
 }
 
+TEST(HpackParserTableTest, ChurnSuggestsLargerTable) {
+  HPackTable tbl;
+  ExecCtx exec_ctx;
+
+  // ~2KB of distinct headers per "call" does not fit a 4KB table twice, so
+  // every insertion past the first call evicts an older entry.
+  for (int call = 0; call < 4; call++) {
+    for (int i = 0; i < 32; i++) {
+      auto memento = HPackTable::Memento(
+          Slice::FromCopiedString(absl::StrCat("x-header-", i)),
+          Slice::FromCopiedString(
+              absl::StrCat(std::string(24, 'v'), call, ".", i)));
+      ASSERT_EQ(tbl.Add(std::move(memento)), GRPC_ERROR_NONE);
+    }
+  }
+  EXPECT_EQ(tbl.insertions(), 128);
+  EXPECT_GE(tbl.insertion_evictions() * 2, tbl.insertions());
+  EXPECT_EQ(hpack_constants::TableSizeForChurn(
+                hpack_constants::kInitialTableSize, 65536, tbl.insertions(),
+                tbl.insertion_evictions()),
+            2 * hpack_constants::kInitialTableSize);
+  // Never beyond the configured cap.
+  EXPECT_EQ(hpack_constants::TableSizeForChurn(
+                hpack_constants::kInitialTableSize, 6000, tbl.insertions(),
+                tbl.insertion_evictions()),
+            6000);
+  tbl.ResetChurn();
+  EXPECT_EQ(tbl.insertions(), 0);
+  EXPECT_EQ(tbl.insertion_evictions(), 0);
+
+  // Once the table is big enough the same headers stop evicting.
+  ASSERT_EQ(tbl.SetCurrentTableSize(hpack_constants::kInitialTableSize),
+            GRPC_ERROR_NONE);
+  tbl.SetMaxBytes(8 * hpack_constants::kInitialTableSize);
+  ASSERT_EQ(tbl.SetCurrentTableSize(8 * hpack_constants::kInitialTableSize),
+            GRPC_ERROR_NONE);
+  for (int i = 0; i < 64; i++) {
+    auto memento = HPackTable::Memento(
+        Slice::FromCopiedString(absl::StrCat("x-header-", i)),
+        Slice::FromCopiedString(std::string(24, 'v')));
+    ASSERT_EQ(tbl.Add(std::move(memento)), GRPC_ERROR_NONE);
+  }
+  EXPECT_EQ(tbl.insertion_evictions(), 0);
+  EXPECT_EQ(hpack_constants::TableSizeForChurn(
+                8 * hpack_constants::kInitialTableSize, 65536,
+                tbl.insertions(), tbl.insertion_evictions()),
+            8 * hpack_constants::kInitialTableSize);
+}
+
 }  // namespace grpc_core
 
 int main(int argc, char** argv) {
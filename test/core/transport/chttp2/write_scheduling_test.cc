@@ -0,0 +1,257 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
+#include "src/core/ext/transport/chttp2/transport/internal.h"
+#include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/transport/byte_stream.h"
+#include "test/core/util/mock_endpoint.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+constexpr size_t kMessageSize = 64 * 1024;
+constexpr uint32_t kWriteQuantum = 16 * 1024;
+
+// Everything the client transport wrote.
+std::string* g_written;
+
+void record_write(grpc_slice slice) {
+  g_written->append(std::string(StringViewFromSlice(slice)));
+}
+
+// A client stream sending one large message.
+class SendingStream {
+ public:
+  SendingStream(grpc_transport* transport, MemoryAllocator* memory_allocator)
+      : transport_(transport),
+        arena_(MakeScopedArena(1024, memory_allocator)),
+        initial_metadata_(arena_.get()),
+        payload_(nullptr) {
+    GRPC_STREAM_REF_INIT(&refcount_, 1, &SendingStream::Destroy, this,
+                         "test_stream");
+    stream_ = static_cast<grpc_chttp2_stream*>(
+        gpr_malloc(grpc_transport_stream_size(transport_)));
+    grpc_transport_init_stream(transport_,
+                               reinterpret_cast<grpc_stream*>(stream_),
+                               &refcount_, nullptr, arena_.get());
+    stream_->flow_control->TestOnlyForceHugeWindow();
+    GRPC_CLOSURE_INIT(&on_complete_, OnComplete, this, nullptr);
+    GRPC_CLOSURE_INIT(&on_destroyed_, OnDestroyed, this, nullptr);
+  }
+
+  ~SendingStream() { gpr_free(stream_); }
+
+  void SendInitialMetadataAndMessage() {
+    initial_metadata_.Set(HttpPathMetadata(),
+                          Slice::FromStaticString("/foo/bar"));
+    initial_metadata_.Set(HttpAuthorityMetadata(),
+                          Slice::FromStaticString("foo.test"));
+    initial_metadata_.Set(HttpMethodMetadata(), HttpMethodMetadata::kPost);
+    initial_metadata_.Set(HttpSchemeMetadata(), HttpSchemeMetadata::kHttp);
+    grpc_slice_buffer message;
+    grpc_slice_buffer_init(&message);
+    grpc_slice slice = grpc_slice_malloc(kMessageSize);
+    memset(GRPC_SLICE_START_PTR(slice), 'a', kMessageSize);
+    grpc_slice_buffer_add(&message, slice);
+    send_stream_.Init(&message, 0);
+    grpc_slice_buffer_destroy_internal(&message);
+    op_ = {};
+    op_.payload = &payload_;
+    op_.send_initial_metadata = true;
+    payload_.send_initial_metadata.send_initial_metadata = &initial_metadata_;
+    op_.send_message = true;
+    payload_.send_message.send_message.reset(send_stream_.get());
+    op_.on_complete = &on_complete_;
+    grpc_transport_perform_stream_op(
+        transport_, reinterpret_cast<grpc_stream*>(stream_), &op_);
+  }
+
+  void CancelAndDestroy() {
+    op_ = {};
+    op_.payload = &payload_;
+    op_.cancel_stream = true;
+    payload_.cancel_stream.cancel_error = GRPC_ERROR_CANCELLED;
+    grpc_transport_perform_stream_op(
+        transport_, reinterpret_cast<grpc_stream*>(stream_), &op_);
+    grpc_stream_unref(&refcount_, "test_stream");
+  }
+
+  grpc_chttp2_stream* stream() { return stream_; }
+  bool completed() const { return completed_; }
+  bool destroyed() const { return destroyed_; }
+
+ private:
+  static void OnComplete(void* arg, grpc_error_handle error) {
+    EXPECT_EQ(error, GRPC_ERROR_NONE);
+    static_cast<SendingStream*>(arg)->completed_ = true;
+  }
+
+  static void Destroy(void* arg, grpc_error_handle /*error*/) {
+    auto* self = static_cast<SendingStream*>(arg);
+    grpc_transport_destroy_stream(self->transport_,
+                                  reinterpret_cast<grpc_stream*>(self->stream_),
+                                  &self->on_destroyed_);
+  }
+
+  static void OnDestroyed(void* arg, grpc_error_handle /*error*/) {
+    static_cast<SendingStream*>(arg)->destroyed_ = true;
+  }
+
+  grpc_transport* const transport_;
+  ScopedArenaPtr arena_;
+  grpc_metadata_batch initial_metadata_;
+  grpc_stream_refcount refcount_;
+  grpc_chttp2_stream* stream_;
+  ManualConstructor<SliceBufferByteStream> send_stream_;
+  grpc_transport_stream_op_batch op_;
+  grpc_transport_stream_op_batch_payload payload_;
+  grpc_closure on_complete_;
+  grpc_closure on_destroyed_;
+  bool completed_ = false;
+  bool destroyed_ = false;
+};
+
+// Two client streams become writable together, each with a large message:
+// checks the order their DATA frames reach the wire in.
+class WriteSchedulingTest : public ::testing::Test {
+ protected:
+  void SetUp() override { g_written = &written_; }
+
+  void TearDown() override {
+    for (auto& stream : streams_) stream->CancelAndDestroy();
+    exec_ctx_.Flush();
+    for (auto& stream : streams_) EXPECT_TRUE(stream->destroyed());
+    streams_.clear();
+    grpc_transport_destroy(transport_);
+    exec_ctx_.Flush();
+    g_written = nullptr;
+  }
+
+  void StartTransport(int write_quantum) {
+    grpc_arg arg = grpc_channel_arg_integer_create(
+        const_cast<char*>(GRPC_ARG_HTTP2_WRITE_QUANTUM_BYTES), write_quantum);
+    grpc_channel_args client_args = {1, &arg};
+    const grpc_channel_args* args =
+        CoreConfiguration::Get()
+            .channel_args_preconditioning()
+            .PreconditionChannelArgs(&client_args);
+    transport_ = grpc_create_chttp2_transport(
+        args, grpc_mock_endpoint_create(record_write), true);
+    grpc_channel_args_destroy(args);
+    grpc_chttp2_transport_start_reading(transport_, nullptr, nullptr, nullptr);
+    reinterpret_cast<grpc_chttp2_transport*>(transport_)
+        ->flow_control->TestOnlyForceHugeWindow();
+    exec_ctx_.Flush();
+  }
+
+  // Starts both streams in the same combiner run, so that both are on the
+  // writable list when the write begins, then lets the writes drain.
+  void SendOnTwoStreams() {
+    for (int i = 0; i < 2; ++i) {
+      streams_.emplace_back(new SendingStream(transport_, &memory_allocator_));
+    }
+    for (auto& stream : streams_) stream->SendInitialMetadataAndMessage();
+    exec_ctx_.Flush();
+    for (auto& stream : streams_) EXPECT_TRUE(stream->completed());
+  }
+
+  // Stream ids of the DATA frames written, in order.
+  std::vector<uint32_t> DataFrameStreamIds() {
+    // Skip the connection preface.
+    size_t offset = strlen(GRPC_CHTTP2_CLIENT_CONNECT_STRING);
+    std::vector<uint32_t> ids;
+    while (offset + 9 <= written_.size()) {
+      const uint8_t* header =
+          reinterpret_cast<const uint8_t*>(written_.data() + offset);
+      const uint32_t length = (header[0] << 16) | (header[1] << 8) | header[2];
+      const uint32_t id = ((header[5] & 0x7f) << 24) | (header[6] << 16) |
+                          (header[7] << 8) | header[8];
+      if (header[3] == GRPC_CHTTP2_FRAME_DATA) ids.push_back(id);
+      offset += 9 + length;
+    }
+    EXPECT_EQ(offset, written_.size());
+    return ids;
+  }
+
+  ExecCtx exec_ctx_;
+  MemoryAllocator memory_allocator_ =
+      ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator("test");
+  std::string written_;
+  grpc_transport* transport_ = nullptr;
+  std::vector<std::unique_ptr<SendingStream>> streams_;
+};
+
+// With a quantum each stream writes at most kWriteQuantum bytes per turn, so
+// the two messages go out interleaved, one quantum (one frame here) at a time.
+TEST_F(WriteSchedulingTest, StreamsTakeTurnsByQuantum) {
+  StartTransport(kWriteQuantum);
+  SendOnTwoStreams();
+  const uint32_t first = streams_[0]->stream()->id;
+  const uint32_t second = streams_[1]->stream()->id;
+  const std::vector<uint32_t> ids = DataFrameStreamIds();
+  // Four full quanta and the 5 byte message header's spill-over each.
+  ASSERT_EQ(ids.size(), 10);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(ids[i], i % 2 == 0 ? first : second) << "frame " << i;
+  }
+  // Each stream waited on the writable list while the other took its turns.
+  for (auto& stream : streams_) {
+    EXPECT_GT(stream->stream()->stats.outgoing.queueing_delay_ns, 0);
+  }
+}
+
+// Without a quantum, the first stream writes its whole message before the
+// second gets a turn.
+TEST_F(WriteSchedulingTest, NoQuantumDrainsEachStreamInTurn) {
+  StartTransport(0);
+  SendOnTwoStreams();
+  const uint32_t first = streams_[0]->stream()->id;
+  const uint32_t second = streams_[1]->stream()->id;
+  const std::vector<uint32_t> ids = DataFrameStreamIds();
+  ASSERT_EQ(ids.size(), 10);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(ids[i], i < 5 ? first : second) << "frame " << i;
+  }
+  EXPECT_GT(streams_[1]->stream()->stats.outgoing.queueing_delay_ns, 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -0,0 +1,85 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/xds/xds_client_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+TEST(XdsLocalityNameTest, InternReturnsSameInstanceForEqualNames) {
+  auto name1 = XdsLocalityName::Intern("region", "zone", "sub_zone");
+  auto name2 = XdsLocalityName::Intern("region", "zone", "sub_zone");
+  EXPECT_EQ(name1.get(), name2.get());
+  EXPECT_EQ(name1->AsHumanReadableString(),
+            "{region=\"region\", zone=\"zone\", sub_zone=\"sub_zone\"}");
+}
+
+TEST(XdsLocalityNameTest, InternReturnsDifferentInstancesForDifferentNames) {
+  auto name = XdsLocalityName::Intern("region", "zone", "sub_zone");
+  for (auto other : {XdsLocalityName::Intern("region2", "zone", "sub_zone"),
+                     XdsLocalityName::Intern("region", "zone2", "sub_zone"),
+                     XdsLocalityName::Intern("region", "zone", "sub_zone2")}) {
+    EXPECT_NE(name.get(), other.get());
+    EXPECT_NE(*name, *other);
+  }
+}
+
+TEST(XdsLocalityNameTest, DirectlyConstructedNameIsNotInterned) {
+  auto interned = XdsLocalityName::Intern("region", "zone", "sub_zone");
+  auto constructed =
+      MakeRefCounted<XdsLocalityName>("region", "zone", "sub_zone");
+  EXPECT_NE(interned.get(), constructed.get());
+  EXPECT_EQ(*interned, *constructed);
+  // Destroying the constructed name leaves the interned one in place.
+  constructed.reset();
+  EXPECT_EQ(XdsLocalityName::Intern("region", "zone", "sub_zone").get(),
+            interned.get());
+}
+
+TEST(XdsLocalityNameTest, InternCreatesNewInstanceAfterLastRefIsDropped) {
+  auto name = XdsLocalityName::Intern("region", "zone", "sub_zone");
+  name.reset();
+  // The freed name must not be handed out again; a new one is created, and
+  // is itself shared.  (The new instance may reuse the old one's address, so
+  // the addresses are not compared.)
+  name = XdsLocalityName::Intern("region", "zone", "sub_zone");
+  ASSERT_NE(name, nullptr);
+  EXPECT_EQ(name->region(), "region");
+  EXPECT_EQ(name->zone(), "zone");
+  EXPECT_EQ(name->sub_zone(), "sub_zone");
+  EXPECT_EQ(XdsLocalityName::Intern("region", "zone", "sub_zone").get(),
+            name.get());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -0,0 +1,261 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/xds/xds_routing.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+auto* g_memory_allocator = new MemoryAllocator(
+    ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator("test"));
+
+class VirtualHostList : public XdsRouting::VirtualHostListIterator {
+ public:
+  explicit VirtualHostList(std::vector<std::vector<std::string>> domains)
+      : domains_(std::move(domains)) {}
+
+  size_t Size() const override { return domains_.size(); }
+
+  const std::vector<std::string>& GetDomainsForVirtualHost(
+      size_t index) const override {
+    return domains_[index];
+  }
+
+ private:
+  std::vector<std::vector<std::string>> domains_;
+};
+
+class RouteList : public XdsRouting::RouteListIterator {
+ public:
+  void Add(StringMatcher::Type type, absl::string_view path,
+           bool case_sensitive = true,
+           std::vector<HeaderMatcher> header_matchers = {}) {
+    auto path_matcher = StringMatcher::Create(type, path, case_sensitive);
+    GPR_ASSERT(path_matcher.ok());
+    routes_.emplace_back();
+    routes_.back().path_matcher = std::move(*path_matcher);
+    routes_.back().header_matchers = std::move(header_matchers);
+  }
+
+  size_t Size() const override { return routes_.size(); }
+
+  const XdsRouteConfigResource::Route::Matchers& GetMatchersForRoute(
+      size_t index) const override {
+    return routes_[index];
+  }
+
+ private:
+  std::vector<XdsRouteConfigResource::Route::Matchers> routes_;
+};
+
+class XdsRoutingTest : public ::testing::Test {
+ protected:
+  XdsRoutingTest()
+      : arena_(MakeScopedArena(1024, g_memory_allocator)),
+        metadata_(arena_.get()) {}
+
+  // Checks that the compiled list picks the same route as the linear search.
+  absl::optional<size_t> GetRoute(const RouteList& routes,
+                                  absl::string_view path) {
+    XdsRouting::CompiledRouteList compiled(routes);
+    auto index = compiled.GetRouteForRequest(routes, path, &metadata_);
+    EXPECT_EQ(index, XdsRouting::GetRouteForRequest(routes, path, &metadata_))
+        << path;
+    return index;
+  }
+
+  ScopedArenaPtr arena_;
+  grpc_metadata_batch metadata_;
+};
+
+TEST(CompiledVirtualHostListTest, MatchTypeOrder) {
+  VirtualHostList vhosts({{"*"},
+                          {"foo.*"},
+                          {"*.example.com"},
+                          {"bar.example.com", "baz.example.com"}});
+  XdsRouting::CompiledVirtualHostList compiled(vhosts);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("baz.example.com"), 3);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("foo.example.com"), 2);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("foo.example.org"), 1);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("example.org"), 0);
+}
+
+TEST(CompiledVirtualHostListTest, LongestMatchThenFirstVirtualHostWins) {
+  VirtualHostList vhosts({{"*.com"},
+                          {"*.example.com"},
+                          {"*.other.com", "*.example.com"},
+                          {"exact.com"},
+                          {"EXACT.com"}});
+  XdsRouting::CompiledVirtualHostList compiled(vhosts);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("a.example.com"), 1);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("a.other.com"), 2);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("b.com"), 0);
+  EXPECT_EQ(compiled.FindVirtualHostForDomain("Exact.COM"), 3);
+  // The asterisk must match at least one character.
+  EXPECT_EQ(compiled.FindVirtualHostForDomain(".com"), absl::nullopt);
+}
+
+TEST(CompiledVirtualHostListTest, SameAsLinearSearch) {
+  VirtualHostList vhosts({{"a.example.com", "*.example.com"},
+                          {"api.*", "*.test"},
+                          {"A.EXAMPLE.COM", "api.test"},
+                          {"*"}});
+  XdsRouting::CompiledVirtualHostList compiled(vhosts);
+  for (const char* domain :
+       {"a.example.com", "b.example.com", "API.test", "api.example.com",
+        "x.test", "example.com", ""}) {
+    EXPECT_EQ(compiled.FindVirtualHostForDomain(domain),
+              XdsRouting::FindVirtualHostForDomain(vhosts, domain))
+        << domain;
+  }
+}
+
+// A large list in the shape of the one bm_xds_routing uses: one exact domain
+// per virtual host, a wildcard virtual host for every hundred, and a
+// catch-all.
+TEST(CompiledVirtualHostListTest, LargeListSameAsLinearSearch) {
+  std::vector<std::vector<std::string>> domains_per_vhost;
+  std::vector<std::string> domains;
+  for (int i = 0; i < 1000; ++i) {
+    std::string domain = absl::StrCat("host", i, ".example.com");
+    domains_per_vhost.push_back({domain});
+    if (i % 100 == 0) {
+      domains_per_vhost.push_back({absl::StrCat("*.zone", i, ".example.com")});
+      domains.push_back(absl::StrCat("host.zone", i, ".example.com"));
+    }
+    domains.push_back(std::move(domain));
+  }
+  domains_per_vhost.push_back({"*"});
+  domains.push_back("unknown.example.org");
+  VirtualHostList vhosts(std::move(domains_per_vhost));
+  XdsRouting::CompiledVirtualHostList compiled(vhosts);
+  for (const std::string& domain : domains) {
+    EXPECT_EQ(compiled.FindVirtualHostForDomain(domain),
+              XdsRouting::FindVirtualHostForDomain(vhosts, domain))
+        << domain;
+  }
+}
+
+TEST_F(XdsRoutingTest, FirstMatchingRouteWins) {
+  RouteList routes;
+  routes.Add(StringMatcher::Type::kPrefix, "/pkg.Service/");
+  routes.Add(StringMatcher::Type::kExact, "/pkg.Service/Method");
+  routes.Add(StringMatcher::Type::kExact, "/pkg.Other/Method");
+  routes.Add(StringMatcher::Type::kSafeRegex, "/pkg\\..*/Method");
+  routes.Add(StringMatcher::Type::kPrefix, "");
+  EXPECT_EQ(GetRoute(routes, "/pkg.Service/Method"), 0);
+  EXPECT_EQ(GetRoute(routes, "/pkg.Other/Method"), 2);
+  EXPECT_EQ(GetRoute(routes, "/pkg.Third/Method"), 3);
+  EXPECT_EQ(GetRoute(routes, "/pkg.Third/Other"), 4);
+}
+
+TEST_F(XdsRoutingTest, CaseInsensitive) {
+  RouteList routes;
+  routes.Add(StringMatcher::Type::kExact, "/pkg.Service/Method",
+             /*case_sensitive=*/false);
+  routes.Add(StringMatcher::Type::kPrefix, "/PKG.OTHER/",
+             /*case_sensitive=*/false);
+  routes.Add(StringMatcher::Type::kPrefix, "/pkg.");
+  EXPECT_EQ(GetRoute(routes, "/PKG.service/method"), 0);
+  EXPECT_EQ(GetRoute(routes, "/pkg.other/Method"), 1);
+  EXPECT_EQ(GetRoute(routes, "/pkg.Third/Method"), 2);
+  EXPECT_EQ(GetRoute(routes, "/Pkg.Third/Method"), absl::nullopt);
+}
+
+TEST_F(XdsRoutingTest, RegexesMustMatchWholePath) {
+  RouteList routes;
+  routes.Add(StringMatcher::Type::kSafeRegex, "/pkg.Service/.*");
+  routes.Add(StringMatcher::Type::kSafeRegex, "Method");
+  routes.Add(StringMatcher::Type::kSuffix, "Method");
+  EXPECT_EQ(GetRoute(routes, "/pkg.Service/Method"), 0);
+  EXPECT_EQ(GetRoute(routes, "Method"), 1);
+  EXPECT_EQ(GetRoute(routes, "/pkg.Other/Method"), 2);
+  EXPECT_EQ(GetRoute(routes, "/pkg.Other/Other"), absl::nullopt);
+}
+
+TEST_F(XdsRoutingTest, HeaderMatchersChecked) {
+  auto header_matcher = HeaderMatcher::Create(
+      "x-route", HeaderMatcher::Type::kExact, "first");
+  ASSERT_TRUE(header_matcher.ok());
+  RouteList routes;
+  routes.Add(StringMatcher::Type::kExact, "/pkg.Service/Method",
+             /*case_sensitive=*/true, {*header_matcher});
+  routes.Add(StringMatcher::Type::kPrefix, "/pkg.Service/");
+  EXPECT_EQ(GetRoute(routes, "/pkg.Service/Method"), 1);
+  metadata_.Append("x-route", Slice::FromStaticString("first"),
+                   [](absl::string_view, const Slice&) { abort(); });
+  EXPECT_EQ(GetRoute(routes, "/pkg.Service/Method"), 0);
+}
+
+// A large table in the shape of the one bm_xds_routing uses: a route per
+// method, then a prefix route, for each service, a regex route for every tenth
+// service, and a catch-all.
+TEST_F(XdsRoutingTest, LargeRouteTableSameAsLinearSearch) {
+  RouteList routes;
+  std::vector<std::string> paths;
+  const int kMethodsPerService = 8;
+  for (int service = 0; routes.Size() < 1000; ++service) {
+    std::string service_prefix = absl::StrCat("/pkg.Service", service, "/");
+    for (int method = 0; method < kMethodsPerService; ++method) {
+      routes.Add(StringMatcher::Type::kExact,
+                 absl::StrCat(service_prefix, "Method", method));
+    }
+    routes.Add(StringMatcher::Type::kPrefix, service_prefix);
+    if (service % 10 == 0) {
+      routes.Add(StringMatcher::Type::kSafeRegex,
+                 absl::StrCat("/pkg\\.Regex", service, "/Method[0-9]+"));
+    }
+    paths.push_back(absl::StrCat(service_prefix, "Method",
+                                 service % kMethodsPerService));
+    paths.push_back(absl::StrCat(service_prefix, "Unlisted"));
+    paths.push_back(absl::StrCat("/pkg.Regex", service - service % 10,
+                                 "/Method", service));
+  }
+  routes.Add(StringMatcher::Type::kPrefix, "");
+  XdsRouting::CompiledRouteList compiled(routes);
+  for (const std::string& path : paths) {
+    EXPECT_EQ(compiled.GetRouteForRequest(routes, path, &metadata_),
+              XdsRouting::GetRouteForRequest(routes, path, &metadata_))
+        << path;
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -16,6 +16,7 @@
  *
  */
 
+#include <google/protobuf/wrappers.pb.h>
 #include <gtest/gtest.h>
 
 #include <grpc/impl/codegen/byte_buffer.h>
@@ -89,6 +90,29 @@ TEST_F(ProtoUtilsTest, TinyBackupThenNext) {
   EXPECT_EQ(block_size, size);
 }
 
+// Large messages are serialized into one exactly-sized slice rather than a
+// chain of kProtoBufferWriterMaxBufferLength blocks.
+TEST_F(ProtoUtilsTest, LargeMessageSerializesToSingleSlice) {
+  const size_t kPayloadSize = 3 * kProtoBufferWriterMaxBufferLength + 17;
+  google::protobuf::BytesValue msg;
+  msg.set_value(std::string(kPayloadSize, 'a'));
+  ByteBuffer bb;
+  bool own_buffer;
+  ASSERT_TRUE(SerializationTraits<google::protobuf::BytesValue>::Serialize(
+                  msg, &bb, &own_buffer)
+                  .ok());
+  EXPECT_TRUE(own_buffer);
+  GrpcByteBufferPeer peer(&bb);
+  EXPECT_EQ(peer.c_buffer()->data.raw.slice_buffer.count, 1u);
+  EXPECT_EQ(bb.Length(), msg.ByteSizeLong());
+  google::protobuf::BytesValue parsed;
+  ASSERT_TRUE(
+      SerializationTraits<google::protobuf::BytesValue>::Deserialize(&bb,
+                                                                    &parsed)
+          .ok());
+  EXPECT_EQ(parsed.value(), msg.value());
+}
+
 namespace {
 
 // Set backup_size to 0 to indicate no backup is needed.
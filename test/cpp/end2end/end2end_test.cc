@@ -978,6 +978,37 @@ TEST_P(End2endTest, RequestStreamTwoRequestsWithCoalescingApi) {
   EXPECT_TRUE(s.ok());
 }
 
+TEST_P(End2endTest, RequestStreamWithWriteCorkingPolicy) {
+  ResetStub();
+  EchoRequest request;
+  EchoResponse response;
+  ClientContext context;
+
+  experimental::WriteCorkingPolicy::Options options;
+  options.max_corked_messages = 3;
+  options.max_corked_bytes = 0;
+  options.max_cork_delay = std::chrono::microseconds(0);
+  experimental::WriteCorkingPolicy cork(options);
+  auto stream = stub_->RequestStream(&context, &response);
+  request.set_message("hello");
+  std::string expected;
+  for (int i = 0; i < 7; i++) {
+    WriteOptions write_options = cork.NextWriteOptions();
+    EXPECT_EQ(write_options.get_buffer_hint(), i % 3 != 2);
+    EXPECT_TRUE(stream->Write(request, write_options));
+    expected += request.message();
+  }
+  cork.Flush();
+  WriteOptions write_options = cork.NextWriteOptions();
+  EXPECT_FALSE(write_options.get_buffer_hint());
+  EXPECT_TRUE(stream->Write(request, write_options));
+  expected += request.message();
+  stream->WritesDone();
+  Status s = stream->Finish();
+  EXPECT_EQ(response.message(), expected);
+  EXPECT_TRUE(s.ok());
+}
+
 TEST_P(End2endTest, ResponseStream) {
   ResetStub();
   EchoRequest request;
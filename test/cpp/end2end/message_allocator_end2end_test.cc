@@ -352,6 +352,29 @@ TEST_P(ArenaAllocatorTest, SimpleRpc) {
   EXPECT_EQ(kRpcCount, allocator->allocation_count);
 }
 
+class LibraryArenaAllocatorTest : public MessageAllocatorEnd2endTestBase {};
+
+TEST_P(LibraryArenaAllocatorTest, SimpleRpc) {
+  const int kRpcCount = 10;
+  using Allocator =
+      experimental::ArenaMessageAllocator<EchoRequest, EchoResponse>;
+  std::unique_ptr<Allocator> allocator(new Allocator(16 * 1024));
+  int arena_rpc_count = 0;
+  auto mutator = [&arena_rpc_count](RpcAllocatorState* /*allocator_state*/,
+                                    const EchoRequest* req,
+                                    EchoResponse* resp) {
+    EXPECT_NE(nullptr, req->GetArena());
+    EXPECT_EQ(req->GetArena(), resp->GetArena());
+    arena_rpc_count++;
+  };
+  callback_service_.SetAllocatorMutator(mutator);
+  CreateServer(allocator.get());
+  ResetStub();
+  SendRpcs(kRpcCount);
+  DestroyServer();
+  EXPECT_EQ(kRpcCount, arena_rpc_count);
+}
+
 std::vector<TestScenario> CreateTestScenarios(bool test_insecure) {
   std::vector<TestScenario> scenarios;
   std::vector<std::string> credentials_types{
@@ -387,6 +410,8 @@ INSTANTIATE_TEST_SUITE_P(SimpleAllocatorTest, SimpleAllocatorTest,
                          ::testing::ValuesIn(CreateTestScenarios(true)));
 INSTANTIATE_TEST_SUITE_P(ArenaAllocatorTest, ArenaAllocatorTest,
                          ::testing::ValuesIn(CreateTestScenarios(true)));
+INSTANTIATE_TEST_SUITE_P(LibraryArenaAllocatorTest, LibraryArenaAllocatorTest,
+                         ::testing::ValuesIn(CreateTestScenarios(true)));
 
 }  // namespace
 }  // namespace testing
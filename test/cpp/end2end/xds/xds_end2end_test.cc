@@ -63,6 +63,7 @@
 #include "src/core/ext/xds/xds_api.h"
 #include "src/core/ext/xds/xds_channel_args.h"
 #include "src/core/ext/xds/xds_client.h"
+#include "src/core/ext/xds/xds_endpoint.h"
 #include "src/core/ext/xds/xds_listener.h"
 #include "src/core/lib/address_utils/parse_address.h"
 #include "src/core/lib/channel/channel_args.h"
@@ -261,6 +262,11 @@ class TestType {
     return *this;
   }
 
+  TestType& set_use_delta() {
+    use_delta_ = true;
+    return *this;
+  }
+
   TestType& set_use_xds_credentials() {
     use_xds_credentials_ = true;
     return *this;
@@ -289,6 +295,7 @@ class TestType {
   bool enable_load_reporting() const { return enable_load_reporting_; }
   bool enable_rds_testing() const { return enable_rds_testing_; }
   bool use_v2() const { return use_v2_; }
+  bool use_delta() const { return use_delta_; }
   bool use_xds_credentials() const { return use_xds_credentials_; }
   bool use_csds_streaming() const { return use_csds_streaming_; }
   FilterConfigSetup filter_config_setup() const { return filter_config_setup_; }
@@ -297,6 +304,7 @@ class TestType {
 
   std::string AsString() const {
     std::string retval = use_v2_ ? "V2" : "V3";
+    if (use_delta_) retval += "Delta";
     if (enable_load_reporting_) retval += "WithLoadReporting";
     if (enable_rds_testing_) retval += "Rds";
     if (use_xds_credentials_) retval += "XdsCreds";
@@ -321,6 +329,7 @@ class TestType {
   bool enable_load_reporting_ = false;
   bool enable_rds_testing_ = false;
   bool use_v2_ = false;
+  bool use_delta_ = false;
   bool use_xds_credentials_ = false;
   bool use_csds_streaming_ = false;
   FilterConfigSetup filter_config_setup_ = kHTTPConnectionManagerOriginal;
@@ -577,6 +586,10 @@ class XdsEnd2endTest : public ::testing::TestWithParam<TestType> {
       v2_ = true;
       return *this;
     }
+    BootstrapBuilder& SetDelta() {
+      delta_ = true;
+      return *this;
+    }
     BootstrapBuilder& SetDefaultServer(const std::string& server) {
       top_server_ = server;
       return *this;
@@ -648,10 +661,11 @@ class XdsEnd2endTest : public ::testing::TestWithParam<TestType> {
           "          \"server_features\": [<SERVER_FEATURES>]\n"
           "        }\n"
           "      ]";
-      return absl::StrReplaceAll(
-          kXdsServerTemplate,
-          {{"<SERVER_URI>", server_uri},
-           {"<SERVER_FEATURES>", (v2_ ? "" : "\"xds_v3\"")}});
+      std::string server_features = v2_ ? "" : "\"xds_v3\"";
+      if (delta_) server_features += ", \"xds_delta\"";
+      return absl::StrReplaceAll(kXdsServerTemplate,
+                                 {{"<SERVER_URI>", server_uri},
+                                  {"<SERVER_FEATURES>", server_features}});
     }
 
     std::string MakeNodeText() {
@@ -714,6 +728,7 @@ class XdsEnd2endTest : public ::testing::TestWithParam<TestType> {
     }
 
     bool v2_ = false;
+    bool delta_ = false;
     std::string top_server_;
     std::string client_default_listener_resource_name_template_;
     std::map<std::string /*key*/, PluginInfo> plugins_;
@@ -840,6 +855,9 @@ class XdsEnd2endTest : public ::testing::TestWithParam<TestType> {
     if (GetParam().use_v2()) {
       builder.SetV2();
     }
+    if (GetParam().use_delta()) {
+      builder.SetDelta();
+    }
     bootstrap_ = builder.Build();
     if (GetParam().bootstrap_source() == TestType::kBootstrapFromEnvVar) {
       gpr_setenv("GRPC_XDS_BOOTSTRAP_CONFIG", bootstrap_.c_str());
@@ -2438,6 +2456,193 @@ TEST_P(XdsResolverOnlyTest, KeepUsingLastDataIfBalancerGoesDown) {
   WaitForBackend(1);
 }
 
+class DeltaAdsTest : public BasicTest {
+ protected:
+  // Waits for the client to ACK or NACK a response of the given type.
+  absl::optional<AdsServiceImpl::ResponseState> WaitForResponseState(
+      const std::string& type_url) {
+    const gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+    do {
+      auto response_state =
+          balancer_->ads_service()->GetResponseState(type_url);
+      if (response_state.has_value()) return response_state;
+      gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(10));
+    } while (gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) < 0);
+    return absl::nullopt;
+  }
+};
+
+// Tests that the client deletes a resource the server reports as removed,
+// and gets it again once it is re-added.
+TEST_P(DeltaAdsTest, RemovedResource) {
+  EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends()},
+  });
+  balancer_->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends();
+  // Unset CDS resource.
+  balancer_->ads_service()->UnsetResource(kCdsTypeUrl, kDefaultClusterName);
+  // Wait for RPCs to start failing.
+  do {
+  } while (SendRpc(RpcOptions(), nullptr).ok());
+  // Make sure RPCs are still failing.
+  CheckRpcSendFailure(CheckRpcSendFailureOptions().set_times(100));
+  // Make sure we ACK'ed both the cluster and its removal.
+  for (int i = 0; i < 2; ++i) {
+    auto response_state = WaitForResponseState(kCdsTypeUrl);
+    ASSERT_TRUE(response_state.has_value()) << "timed out waiting for ACK";
+    EXPECT_EQ(response_state->state, AdsServiceImpl::ResponseState::ACKED);
+  }
+  // Re-add the cluster.  The client is still subscribed to it.
+  balancer_->ads_service()->SetCdsResource(default_cluster_);
+  WaitForAllBackends(0, 0, WaitForBackendOptions().set_allow_failures(true));
+}
+
+// Tests that on a new stream, the client reports the versions of the
+// resources it has, and gets only the ones that changed.
+TEST_P(DeltaAdsTest, InitialResourceVersionsOnReconnect) {
+  EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends(0, 1)},
+  });
+  balancer_->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends(0, 1);
+  // The first stream starts with no resources.
+  EXPECT_THAT(
+      balancer_->ads_service()->delta_initial_resource_versions(kCdsTypeUrl),
+      ::testing::IsEmpty());
+  balancer_->Shutdown();
+  // Update backend, just so we can be sure that the client has
+  // reconnected to the balancer.
+  EdsResourceArgs args2({
+      {"locality0", CreateEndpointsForBackends(1, 2)},
+  });
+  balancer_->ads_service()->SetEdsResource(BuildEdsResource(args2));
+  balancer_->Start();
+  WaitForAllBackends(1, 2);
+  EXPECT_THAT(
+      balancer_->ads_service()->delta_initial_resource_versions(kCdsTypeUrl),
+      ::testing::ElementsAre(::testing::Pair(
+          kDefaultClusterName, ::testing::Not(::testing::IsEmpty()))));
+  EXPECT_THAT(
+      balancer_->ads_service()->delta_initial_resource_versions(kEdsTypeUrl),
+      ::testing::ElementsAre(::testing::Pair(
+          kDefaultEdsServiceName, ::testing::Not(::testing::IsEmpty()))));
+  // Only the endpoints changed, so only they were sent and ACKed on the new
+  // stream.  (Response states are cleared when the balancer shuts down.)
+  auto response_state = WaitForResponseState(kEdsTypeUrl);
+  ASSERT_TRUE(response_state.has_value()) << "timed out waiting for ACK";
+  EXPECT_EQ(response_state->state, AdsServiceImpl::ResponseState::ACKED);
+  EXPECT_FALSE(balancer_->ads_service()->cds_response_state().has_value());
+}
+
+// Tests that the client NACKs an invalid resource with the error detail,
+// and ACKs the fixed resource.
+TEST_P(DeltaAdsTest, NacksInvalidResource) {
+  auto cluster = default_cluster_;
+  cluster.set_type(Cluster::STATIC);
+  balancer_->ads_service()->SetCdsResource(cluster);
+  auto response_state = WaitForCdsNack();
+  ASSERT_TRUE(response_state.has_value()) << "timed out waiting for NACK";
+  EXPECT_THAT(response_state->error_message,
+              ::testing::HasSubstr("DiscoveryType is not valid."));
+  // Fix the cluster.
+  EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends()},
+  });
+  balancer_->ads_service()->SetEdsResource(BuildEdsResource(args));
+  balancer_->ads_service()->SetCdsResource(default_cluster_);
+  WaitForAllBackends(0, 0, WaitForBackendOptions().set_allow_failures(true));
+  do {
+    response_state = WaitForResponseState(kCdsTypeUrl);
+    ASSERT_TRUE(response_state.has_value()) << "timed out waiting for ACK";
+  } while (response_state->state == AdsServiceImpl::ResponseState::NACKED);
+}
+
+// Tests that the client unsubscribes from the resources it no longer uses,
+// and gets them again when it subscribes to them again.
+TEST_P(DeltaAdsTest, Unsubscribe) {
+  const char* kNewEdsServiceName = "new_eds_service_name";
+  EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends(0, 2)},
+  });
+  balancer_->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends(0, 2);
+  // Point the cluster to a new EDS resource.
+  EdsResourceArgs args2({
+      {"locality0", CreateEndpointsForBackends(2, 4)},
+  });
+  balancer_->ads_service()->SetEdsResource(
+      BuildEdsResource(args2, kNewEdsServiceName));
+  Cluster new_cluster = default_cluster_;
+  new_cluster.mutable_eds_cluster_config()->set_service_name(
+      kNewEdsServiceName);
+  balancer_->ads_service()->SetCdsResource(new_cluster);
+  WaitForAllBackends(2, 4);
+  // Wait for the client to unsubscribe from the old EDS resource.
+  const gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+  while (balancer_->ads_service()
+             ->delta_unsubscribed_resources(kEdsTypeUrl)
+             .empty()) {
+    ASSERT_LT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline), 0)
+        << "timed out waiting for unsubscription";
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(10));
+  }
+  EXPECT_THAT(
+      balancer_->ads_service()->delta_unsubscribed_resources(kEdsTypeUrl),
+      ::testing::ElementsAre(kDefaultEdsServiceName));
+  // Point the cluster back to the old EDS resource, which the server then
+  // sends again.
+  balancer_->ads_service()->SetCdsResource(default_cluster_);
+  WaitForAllBackends(0, 2);
+}
+
+// Tests that the client does not decode again a resource it already has
+// when the server sends it again with the same version: a LOGICAL_DNS
+// cluster accepted while such clusters were enabled stays in use once they
+// are disabled, until its version changes.
+TEST_P(DeltaAdsTest, SkipsResourcesAlreadyCached) {
+  gpr_setenv("GRPC_XDS_EXPERIMENTAL_ENABLE_AGGREGATE_AND_LOGICAL_DNS_CLUSTER",
+             "true");
+  auto cluster = default_cluster_;
+  cluster.set_type(Cluster::LOGICAL_DNS);
+  auto* address = cluster.mutable_load_assignment()
+                      ->add_endpoints()
+                      ->add_lb_endpoints()
+                      ->mutable_endpoint()
+                      ->mutable_address()
+                      ->mutable_socket_address();
+  address->set_address(kServerName);
+  address->set_port_value(443);
+  balancer_->ads_service()->SetCdsResource(cluster);
+  {
+    grpc_core::ExecCtx exec_ctx;
+    grpc_core::Resolver::Result result;
+    result.addresses = CreateAddressListFromPortList(GetBackendPorts(1, 2));
+    logical_dns_cluster_resolver_response_generator_->SetResponse(
+        std::move(result));
+  }
+  WaitForBackend(1);
+  gpr_unsetenv(
+      "GRPC_XDS_EXPERIMENTAL_ENABLE_AGGREGATE_AND_LOGICAL_DNS_CLUSTER");
+  // Have the server send all resources again on the next stream.
+  balancer_->Shutdown();
+  balancer_->ads_service()->IgnoreDeltaInitialResourceVersions();
+  balancer_->Start();
+  auto response_state = WaitForResponseState(kCdsTypeUrl);
+  ASSERT_TRUE(response_state.has_value()) << "timed out waiting for ACK";
+  EXPECT_EQ(response_state->state, AdsServiceImpl::ResponseState::ACKED);
+  // A new version of the same cluster is decoded, and NACKed.
+  balancer_->ads_service()->SetCdsResource(cluster);
+  response_state = WaitForCdsNack(StatusCode::OK);
+  ASSERT_TRUE(response_state.has_value()) << "timed out waiting for NACK";
+  EXPECT_THAT(response_state->error_message,
+              ::testing::HasSubstr("DiscoveryType is not valid."));
+  // The cached cluster is still in use.
+  ResetBackendCounters();
+  CheckRpcSendOk(10);
+  EXPECT_EQ(backends_[1]->backend_service()->request_count(), 10);
+}
+
 using GlobalXdsClientTest = BasicTest;
 
 TEST_P(GlobalXdsClientTest, MultipleChannelsShareXdsClient) {
@@ -2493,6 +2698,83 @@ TEST_P(
   WaitForBackend(1);
 }
 
+// An XdsClient watcher that records the resource it was last notified of.
+class RecordingResourceWatcher
+    : public grpc_core::XdsClient::ResourceWatcherInterface {
+ public:
+  void OnGenericResourceChanged(
+      const grpc_core::XdsResourceType::ResourceData* resource) override {
+    grpc_core::MutexLock lock(&mu_);
+    resource_ = resource;
+    cv_.SignalAll();
+  }
+  void OnError(grpc_error_handle error) override { GRPC_ERROR_UNREF(error); }
+  void OnResourceDoesNotExist() override {}
+
+  // Waits for a notification of a resource other than \a previous, and
+  // returns it, or nullptr on timeout.  The resource is only compared, never
+  // dereferenced, since the watcher does not keep it alive.
+  const grpc_core::XdsResourceType::ResourceData* WaitForResource(
+      const grpc_core::XdsResourceType::ResourceData* previous = nullptr) {
+    grpc_core::MutexLock lock(&mu_);
+    absl::Time deadline =
+        absl::Now() + absl::Seconds(10 * grpc_test_slowdown_factor());
+    while (resource_ == previous) {
+      if (cv_.WaitWithDeadline(&mu_, deadline)) return nullptr;
+    }
+    return resource_;
+  }
+
+ private:
+  grpc_core::Mutex mu_;
+  grpc_core::CondVar cv_;
+  const grpc_core::XdsResourceType::ResourceData* resource_
+      ABSL_GUARDED_BY(mu_) = nullptr;
+};
+
+// Tests that all watchers of a resource are handed the same decoded copy,
+// both from the cache and on an update.
+TEST_P(GlobalXdsClientTest, WatchersShareResource) {
+  EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends(0, 1)},
+  });
+  balancer_->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForBackend(0);
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  grpc_core::RefCountedPtr<grpc_core::XdsClient> xds_client =
+      grpc_core::XdsClient::GetOrCreate(nullptr, &error);
+  ASSERT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+  auto watcher1 = grpc_core::MakeRefCounted<RecordingResourceWatcher>();
+  auto watcher2 = grpc_core::MakeRefCounted<RecordingResourceWatcher>();
+  const auto* type = grpc_core::XdsEndpointResourceType::Get();
+  {
+    grpc_core::ExecCtx exec_ctx;
+    xds_client->WatchResource(type, kDefaultEdsServiceName, watcher1);
+    xds_client->WatchResource(type, kDefaultEdsServiceName, watcher2);
+  }
+  // Both watchers are notified of the cached resource.
+  const auto* resource = watcher1->WaitForResource();
+  ASSERT_NE(resource, nullptr) << "timed out waiting for cached resource";
+  EXPECT_EQ(watcher2->WaitForResource(), resource);
+  // Both watchers are notified of the update.
+  args = EdsResourceArgs({
+      {"locality0", CreateEndpointsForBackends(1, 2)},
+  });
+  balancer_->ads_service()->SetEdsResource(BuildEdsResource(args));
+  const auto* updated = watcher1->WaitForResource(resource);
+  ASSERT_NE(updated, nullptr) << "timed out waiting for update";
+  EXPECT_EQ(watcher2->WaitForResource(resource), updated);
+  {
+    grpc_core::ExecCtx exec_ctx;
+    xds_client->CancelResourceWatch(type, kDefaultEdsServiceName,
+                                    watcher1.get());
+    xds_client->CancelResourceWatch(type, kDefaultEdsServiceName,
+                                    watcher2.get());
+    xds_client.reset();
+  }
+  WaitForBackend(1);
+}
+
 // Tests that the NACK for multiple bad LDS resources includes both errors.
 TEST_P(GlobalXdsClientTest, MultipleBadResources) {
   constexpr char kServerName2[] = "server.other.com";
@@ -13693,6 +13975,12 @@ INSTANTIATE_TEST_SUITE_P(
     ::testing::Values(TestType(), TestType().set_enable_load_reporting()),
     &TestTypeName);
 
+INSTANTIATE_TEST_SUITE_P(
+    XdsTest, DeltaAdsTest,
+    ::testing::Values(TestType().set_use_delta(),
+                      TestType().set_use_delta().set_enable_rds_testing()),
+    &TestTypeName);
+
 // Runs with bootstrap from env var, so that there's a global XdsClient.
 INSTANTIATE_TEST_SUITE_P(
     XdsTest, GlobalXdsClientTest,
@@ -17,6 +17,7 @@
 #include "test/cpp/end2end/xds/xds_server.h"
 
 #include <deque>
+#include <map>
 #include <set>
 #include <string>
 #include <thread>
@@ -140,6 +141,264 @@ void AdsServiceImpl::ProcessUnsubscriptions(
   }
 }
 
+//
+// AdsServiceImpl::V3RpcService
+//
+
+Status AdsServiceImpl::V3RpcService::DeltaAggregatedResources(
+    ServerContext* context, DeltaStream* stream) {
+  gpr_log(GPR_INFO, "ADS[%p]: DeltaAggregatedResources starts", this);
+  parent_->AddClient(context->peer());
+  parent_->seen_v3_client_ = true;
+  // Take a reference of the AdsServiceImpl object, which will go
+  // out of scope when this request handler returns.  This ensures
+  // that the parent won't be destroyed until this stream is complete.
+  std::shared_ptr<AdsServiceImpl> ads_service_impl =
+      parent_->shared_from_this();
+  DeltaStreamState state;
+  // Spawn a thread to read requests from the stream.
+  // Requests will be delivered to this thread in a queue.
+  std::deque<DeltaDiscoveryRequest> requests;
+  bool stream_closed = false;
+  std::thread reader(std::bind(&V3RpcService::DeltaBlockingRead, this, stream,
+                               &requests, &stream_closed));
+  // Main loop to process requests and updates.
+  while (true) {
+    // Boolean to keep track if the loop received any work to do: a
+    // request or an update; regardless whether a response was actually
+    // sent out.
+    bool did_work = false;
+    absl::optional<DeltaDiscoveryResponse> response;
+    {
+      grpc_core::MutexLock lock(&parent_->ads_mu_);
+      // If the stream has been closed or our parent is being shut
+      // down, stop immediately.
+      if (stream_closed || parent_->ads_done_) break;
+      // Otherwise, see if there's a request to read from the queue.
+      if (!requests.empty()) {
+        DeltaDiscoveryRequest request = std::move(requests.front());
+        requests.pop_front();
+        did_work = true;
+        gpr_log(GPR_INFO,
+                "ADS[%p]: Received delta request for type %s with content %s",
+                this, request.type_url().c_str(),
+                request.DebugString().c_str());
+        ProcessDeltaRequest(request, &state, &response);
+      }
+    }
+    if (response.has_value()) {
+      gpr_log(GPR_INFO, "ADS[%p]: Sending delta response: %s", this,
+              response->DebugString().c_str());
+      stream->Write(response.value());
+    }
+    response.reset();
+    // Look for updates and decide what to handle.
+    {
+      grpc_core::MutexLock lock(&parent_->ads_mu_);
+      if (!state.update_queue.empty()) {
+        const std::string resource_type =
+            std::move(state.update_queue.front().first);
+        const std::string resource_name =
+            std::move(state.update_queue.front().second);
+        state.update_queue.pop_front();
+        did_work = true;
+        gpr_log(GPR_INFO, "ADS[%p]: Received update for type=%s name=%s",
+                this, resource_type.c_str(), resource_name.c_str());
+        const SubscriptionNameMap& subscription_name_map =
+            state.subscription_map[resource_type];
+        if (subscription_name_map.find(resource_name) !=
+            subscription_name_map.end()) {
+          AddDeltaResources(resource_type, {resource_name}, &state, &response);
+        }
+      }
+    }
+    if (response.has_value()) {
+      gpr_log(GPR_INFO, "ADS[%p]: Sending delta update response: %s", this,
+              response->DebugString().c_str());
+      stream->Write(response.value());
+    }
+    {
+      grpc_core::MutexLock lock(&parent_->ads_mu_);
+      if (parent_->ads_done_) break;
+    }
+    // If we didn't find anything to do, delay before the next loop
+    // iteration; otherwise, check whether we should exit and then
+    // immediately continue.
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(did_work ? 0 : 10));
+  }
+  // Done with main loop.  Clean up before returning.
+  // Join reader thread.
+  reader.join();
+  // Clean up any subscriptions that were still active when the call
+  // finished.
+  {
+    grpc_core::MutexLock lock(&parent_->ads_mu_);
+    for (auto& p : state.subscription_map) {
+      const std::string& type_url = p.first;
+      SubscriptionNameMap& subscription_name_map = p.second;
+      for (auto& q : subscription_name_map) {
+        const std::string& resource_name = q.first;
+        SubscriptionState& subscription_state = q.second;
+        ResourceNameMap& resource_name_map =
+            parent_->resource_map_[type_url].resource_name_map;
+        ResourceState& resource_state = resource_name_map[resource_name];
+        resource_state.subscriptions.erase(&subscription_state);
+      }
+    }
+  }
+  gpr_log(GPR_INFO, "ADS[%p]: DeltaAggregatedResources done", this);
+  parent_->RemoveClient(context->peer());
+  return Status::OK;
+}
+
+void AdsServiceImpl::V3RpcService::ProcessDeltaRequest(
+    const DeltaDiscoveryRequest& request, DeltaStreamState* state,
+    absl::optional<DeltaDiscoveryResponse>* response) {
+  NoopMutexLock mu(parent_->ads_mu_);
+  const std::string& resource_type = request.type_url();
+  // Check for ACK or NACK.  Only requests answering a response carry a
+  // nonce; the others only change the subscriptions.
+  if (!request.response_nonce().empty()) {
+    ResponseState response_state;
+    if (!request.has_error_detail()) {
+      response_state.state = ResponseState::ACKED;
+      gpr_log(GPR_INFO, "ADS[%p]: client ACKed resource_type=%s nonce=%s",
+              this, resource_type.c_str(), request.response_nonce().c_str());
+    } else {
+      response_state.state = ResponseState::NACKED;
+      EXPECT_EQ(request.error_detail().code(), GRPC_STATUS_INVALID_ARGUMENT);
+      response_state.error_message = request.error_detail().message();
+      gpr_log(GPR_INFO, "ADS[%p]: client NACKed resource_type=%s nonce=%s: %s",
+              this, resource_type.c_str(), request.response_nonce().c_str(),
+              response_state.error_message.c_str());
+    }
+    parent_->resource_type_response_state_[resource_type].emplace_back(
+        std::move(response_state));
+  }
+  // The first request of a type on a stream reports the versions of the
+  // resources the client already has.
+  auto& client_versions = state->client_versions[resource_type];
+  if (state->seen_types.insert(resource_type).second) {
+    std::map<std::string, std::string> initial_resource_versions(
+        request.initial_resource_versions().begin(),
+        request.initial_resource_versions().end());
+    if (!parent_->ignore_delta_initial_resource_versions_) {
+      client_versions = initial_resource_versions;
+    }
+    parent_->delta_initial_resource_versions_[resource_type] =
+        std::move(initial_resource_versions);
+  } else {
+    EXPECT_EQ(request.initial_resource_versions_size(), 0)
+        << "resource_type: " << resource_type;
+  }
+  for (const std::string& resource_name :
+       request.resource_names_unsubscribe()) {
+    parent_->delta_unsubscribed_resources_[resource_type].insert(
+        resource_name);
+  }
+  // Ignore resource types as requested by tests.
+  if (parent_->resource_types_to_ignore_.find(resource_type) !=
+      parent_->resource_types_to_ignore_.end()) {
+    return;
+  }
+  auto& subscription_name_map = state->subscription_map[resource_type];
+  auto& resource_name_map =
+      parent_->resource_map_[resource_type].resource_name_map;
+  // Process unsubscriptions.
+  std::set<std::string> resources_still_subscribed;
+  for (const auto& p : subscription_name_map) {
+    resources_still_subscribed.insert(p.first);
+  }
+  for (const std::string& resource_name :
+       request.resource_names_unsubscribe()) {
+    resources_still_subscribed.erase(resource_name);
+    client_versions.erase(resource_name);
+  }
+  parent_->ProcessUnsubscriptions(resource_type, resources_still_subscribed,
+                                  &subscription_name_map, &resource_name_map);
+  // Subscribe to the new resources, and send the ones the client does not
+  // have yet.
+  std::vector<std::string> new_subscriptions;
+  for (const std::string& resource_name : request.resource_names_subscribe()) {
+    if (parent_->MaybeSubscribe(resource_type, resource_name,
+                                &subscription_name_map[resource_name],
+                                &resource_name_map[resource_name],
+                                &state->update_queue)) {
+      new_subscriptions.push_back(resource_name);
+    }
+  }
+  AddDeltaResources(resource_type, new_subscriptions, state, response);
+}
+
+void AdsServiceImpl::V3RpcService::AddDeltaResources(
+    const std::string& resource_type,
+    const std::vector<std::string>& resource_names, DeltaStreamState* state,
+    absl::optional<DeltaDiscoveryResponse>* response) {
+  NoopMutexLock mu(parent_->ads_mu_);
+  auto& client_versions = state->client_versions[resource_type];
+  auto& resource_type_state = parent_->resource_map_[resource_type];
+  for (const std::string& resource_name : resource_names) {
+    const ResourceState& resource_state =
+        resource_type_state.resource_name_map[resource_name];
+    auto it = client_versions.find(resource_name);
+    if (!resource_state.resource.has_value()) {
+      // Tell the client to remove the resource if it has it.
+      if (it == client_versions.end()) continue;
+      gpr_log(GPR_INFO, "ADS[%p]: Sending removal for type=%s name=%s", this,
+              resource_type.c_str(), resource_name.c_str());
+      client_versions.erase(it);
+      if (!response->has_value()) response->emplace();
+      (*response)->add_removed_resources(resource_name);
+      continue;
+    }
+    const std::string version =
+        std::to_string(resource_state.resource_type_version);
+    if (it != client_versions.end() && it->second == version) {
+      gpr_log(GPR_INFO,
+              "ADS[%p]: client does not need update for type=%s name=%s",
+              this, resource_type.c_str(), resource_name.c_str());
+      continue;
+    }
+    gpr_log(GPR_INFO, "ADS[%p]: Sending update for type=%s name=%s", this,
+            resource_type.c_str(), resource_name.c_str());
+    client_versions[resource_name] = version;
+    if (!response->has_value()) response->emplace();
+    auto* resource = (*response)->add_resources();
+    resource->set_name(resource_name);
+    resource->set_version(version);
+    resource->mutable_resource()->CopyFrom(resource_state.resource.value());
+  }
+  if (response->has_value()) {
+    (*response)->set_type_url(resource_type);
+    (*response)->set_system_version_info(
+        std::to_string(resource_type_state.resource_type_version));
+    (*response)->set_nonce(std::to_string(++state->nonce));
+  }
+}
+
+void AdsServiceImpl::V3RpcService::DeltaBlockingRead(
+    DeltaStream* stream, std::deque<DeltaDiscoveryRequest>* requests,
+    bool* stream_closed) {
+  DeltaDiscoveryRequest request;
+  bool seen_first_request = false;
+  while (stream->Read(&request)) {
+    if (!seen_first_request) {
+      EXPECT_TRUE(request.has_node());
+      ASSERT_FALSE(request.node().client_features().empty());
+      EXPECT_EQ(request.node().client_features(0),
+                "envoy.lb.does_not_support_overprovisioning");
+      seen_first_request = true;
+    }
+    {
+      grpc_core::MutexLock lock(&parent_->ads_mu_);
+      requests->emplace_back(std::move(request));
+    }
+  }
+  gpr_log(GPR_INFO, "ADS[%p]: Null read, stream closed", this);
+  grpc_core::MutexLock lock(&parent_->ads_mu_);
+  *stream_closed = true;
+}
+
 void AdsServiceImpl::Start() {
   grpc_core::MutexLock lock(&ads_mu_);
   ads_done_ = false;
@@ -18,6 +18,7 @@
 #define GRPC_TEST_CPP_END2END_XDS_XDS_SERVER_H
 
 #include <deque>
+#include <map>
 #include <set>
 #include <string>
 #include <thread>
@@ -77,8 +78,7 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
   };
 
   AdsServiceImpl()
-      : v2_rpc_service_(this, /*is_v2=*/true),
-        v3_rpc_service_(this, /*is_v2=*/false) {}
+      : v2_rpc_service_(this, /*is_v2=*/true), v3_rpc_service_(this) {}
 
   bool seen_v2_client() const { return seen_v2_client_; }
   bool seen_v3_client() const { return seen_v3_client_; }
@@ -141,6 +141,29 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
     resource_type_min_versions_[type_url] = version;
   }
 
+  // Tells the server to send all subscribed resources on a new delta ADS
+  // stream, ignoring the versions the client reports it already has.
+  void IgnoreDeltaInitialResourceVersions() {
+    grpc_core::MutexLock lock(&ads_mu_);
+    ignore_delta_initial_resource_versions_ = true;
+  }
+
+  // Returns the resource versions reported by the client in the first delta
+  // ADS request for a given resource type on the most recent stream.
+  std::map<std::string, std::string> delta_initial_resource_versions(
+      const std::string& type_url) {
+    grpc_core::MutexLock lock(&ads_mu_);
+    return delta_initial_resource_versions_[type_url];
+  }
+
+  // Returns the names of the resources of a given type that the client has
+  // unsubscribed from in delta ADS requests.
+  std::set<std::string> delta_unsubscribed_resources(
+      const std::string& type_url) {
+    grpc_core::MutexLock lock(&ads_mu_);
+    return delta_unsubscribed_resources_[type_url];
+  }
+
   // Get the list of response state for each resource type.
   absl::optional<ResponseState> GetResponseState(const std::string& type_url) {
     grpc_core::MutexLock lock(&ads_mu_);
@@ -351,7 +374,7 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
       return Status::OK;
     }
 
-   private:
+   protected:
     // NB: clang's annotalysis is confused by the use of inner template
     // classes here and *ignores* the exclusive lock annotation on some
     // functions. See https://bugs.llvm.org/show_bug.cgi?id=51368.
@@ -601,6 +624,65 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
     const bool is_v2_;
   };
 
+  // The v3 RPC service, which also implements delta ADS.
+  class V3RpcService
+      : public RpcService<
+            ::envoy::service::discovery::v3::AggregatedDiscoveryService,
+            ::envoy::service::discovery::v3::DiscoveryRequest,
+            ::envoy::service::discovery::v3::DiscoveryResponse> {
+   public:
+    using DeltaDiscoveryRequest =
+        ::envoy::service::discovery::v3::DeltaDiscoveryRequest;
+    using DeltaDiscoveryResponse =
+        ::envoy::service::discovery::v3::DeltaDiscoveryResponse;
+    using DeltaStream =
+        ServerReaderWriter<DeltaDiscoveryResponse, DeltaDiscoveryRequest>;
+
+    explicit V3RpcService(AdsServiceImpl* parent)
+        : RpcService(parent, /*is_v2=*/false) {}
+
+    Status DeltaAggregatedResources(ServerContext* context,
+                                    DeltaStream* stream) override;
+
+   private:
+    // State of a delta ADS stream.
+    struct DeltaStreamState {
+      // Resources (type/name pairs) that have changed since the client
+      // subscribed to them.
+      UpdateQueue update_queue;
+      // Resources that the client is subscribed to keyed by resource type
+      // url.
+      SubscriptionMap subscription_map;
+      // Versions of the resources the client has.
+      std::map<std::string /*type_url*/,
+               std::map<std::string /*resource_name*/, std::string>>
+          client_versions;
+      // Resource types the client has sent a request for.
+      std::set<std::string> seen_types;
+      int nonce = 0;
+    };
+
+    // Processes a request read from the client.
+    // Populates response if needed.
+    void ProcessDeltaRequest(const DeltaDiscoveryRequest& request,
+                             DeltaStreamState* state,
+                             absl::optional<DeltaDiscoveryResponse>* response)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(parent_->ads_mu_);
+
+    // Adds the resources the client does not have yet, or the removal of the
+    // ones it has that no longer exist, to the response.
+    void AddDeltaResources(const std::string& resource_type,
+                           const std::vector<std::string>& resource_names,
+                           DeltaStreamState* state,
+                           absl::optional<DeltaDiscoveryResponse>* response)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(parent_->ads_mu_);
+
+    // Starting a thread to do blocking read on the stream until cancel.
+    void DeltaBlockingRead(DeltaStream* stream,
+                           std::deque<DeltaDiscoveryRequest>* requests,
+                           bool* stream_closed);
+  };
+
   // Checks whether the client needs to receive a newer version of
   // the resource.
   static bool ClientNeedsResourceUpdate(
@@ -637,10 +719,7 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
              ::envoy::api::v2::DiscoveryRequest,
              ::envoy::api::v2::DiscoveryResponse>
       v2_rpc_service_;
-  RpcService<::envoy::service::discovery::v3::AggregatedDiscoveryService,
-             ::envoy::service::discovery::v3::DiscoveryRequest,
-             ::envoy::service::discovery::v3::DiscoveryResponse>
-      v3_rpc_service_;
+  V3RpcService v3_rpc_service_;
 
   std::atomic_bool seen_v2_client_{false};
   std::atomic_bool seen_v3_client_{false};
@@ -654,6 +733,12 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
       ABSL_GUARDED_BY(ads_mu_);
   std::map<std::string /*resource_type*/, int> resource_type_min_versions_
       ABSL_GUARDED_BY(ads_mu_);
+  bool ignore_delta_initial_resource_versions_ ABSL_GUARDED_BY(ads_mu_) =
+      false;
+  std::map<std::string /*resource_type*/, std::map<std::string, std::string>>
+      delta_initial_resource_versions_ ABSL_GUARDED_BY(ads_mu_);
+  std::map<std::string /*resource_type*/, std::set<std::string>>
+      delta_unsubscribed_resources_ ABSL_GUARDED_BY(ads_mu_);
   // An instance data member containing the current state of all resources.
   // Note that an entry will exist whenever either of the following is true:
   // - The resource exists (i.e., has been created by SetResource() and has not
@@ -66,6 +66,28 @@ static void BM_Arena_Batch(benchmark::State& state) {
 }
 BENCHMARK(BM_Arena_Batch)->Ranges({{1, 64 * 1024}, {1, 64}, {1, 1024}});
 
+// Create and destroy an arena through an ArenaPool; compare with
+// BM_Arena_NoOp to see the cost of the malloc/free avoided by recycling.
+static void BM_ArenaPool_NoOp(benchmark::State& state) {
+  grpc_core::ArenaPool pool(1, g_memory_allocator);
+  for (auto _ : state) {
+    pool.Recycle(pool.CreateWithAlloc(state.range(0), 0).first);
+  }
+}
+BENCHMARK(BM_ArenaPool_NoOp)->Range(1, 1024 * 1024);
+
+static void BM_ArenaPool_Batch(benchmark::State& state) {
+  grpc_core::ArenaPool pool(1, g_memory_allocator);
+  for (auto _ : state) {
+    Arena* a = pool.CreateWithAlloc(state.range(0), 0).first;
+    for (int i = 0; i < state.range(1); i++) {
+      a->Alloc(state.range(2));
+    }
+    pool.Recycle(a);
+  }
+}
+BENCHMARK(BM_ArenaPool_Batch)->Ranges({{1, 64 * 1024}, {1, 64}, {1, 1024}});
+
 // Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
 // and others do not. This allows us to support both modes.
 namespace benchmark {
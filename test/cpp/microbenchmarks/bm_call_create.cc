@@ -94,18 +94,35 @@ class BaseChannelFixture {
   grpc_channel* const channel_;
 };
 
-static grpc_channel* CreateChannel() {
+static grpc_channel* CreateChannel(const grpc_channel_args* args = nullptr) {
   grpc_channel_credentials* creds = grpc_insecure_credentials_create();
-  grpc_channel* channel = grpc_channel_create("localhost:1234", creds, nullptr);
+  grpc_channel* channel = grpc_channel_create("localhost:1234", creds, args);
   grpc_channel_credentials_release(creds);
   return channel;
 }
 
+static grpc_arg ArenaPoolArg(int arena_pool_size) {
+  return grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_CALL_ARENA_POOL_SIZE), arena_pool_size);
+}
+
 class InsecureChannel : public BaseChannelFixture {
  public:
   InsecureChannel() : BaseChannelFixture(CreateChannel()) {}
 };
 
+class InsecureChannelWithArenaPool : public BaseChannelFixture {
+ public:
+  InsecureChannelWithArenaPool() : BaseChannelFixture(CreateWithPool()) {}
+
+ private:
+  static grpc_channel* CreateWithPool() {
+    grpc_arg arg = ArenaPoolArg(64);
+    grpc_channel_args args = {1, &arg};
+    return CreateChannel(&args);
+  }
+};
+
 class LameChannel : public BaseChannelFixture {
  public:
   LameChannel()
@@ -131,6 +148,7 @@ static void BM_CallCreateDestroy(benchmark::State& state) {
 }
 
 BENCHMARK_TEMPLATE(BM_CallCreateDestroy, InsecureChannel);
+BENCHMARK_TEMPLATE(BM_CallCreateDestroy, InsecureChannelWithArenaPool);
 BENCHMARK_TEMPLATE(BM_CallCreateDestroy, LameChannel);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -711,21 +729,70 @@ static const grpc_channel_filter isolated_call_filter = {
     GetChannelInfo,         "isolated_call_filter"};
 }  // namespace isolated_call_filter
 
+// A filter that only forwards batches, like client_idle or max_age do on the
+// call path; the channel stack skips these when running batches.
+namespace passthrough_filter {
+
+static void StartTransportOp(grpc_channel_element* elem,
+                             grpc_transport_op* op) {
+  grpc_channel_next_op(elem, op);
+}
+
+static grpc_error_handle InitCallElem(grpc_call_element* /*elem*/,
+                                      const grpc_call_element_args* /*args*/) {
+  return GRPC_ERROR_NONE;
+}
+
+static void SetPollsetOrPollsetSet(grpc_call_element* /*elem*/,
+                                   grpc_polling_entity* /*pollent*/) {}
+
+static void DestroyCallElem(grpc_call_element* /*elem*/,
+                            const grpc_call_final_info* /*final_info*/,
+                            grpc_closure* /*then_sched_closure*/) {}
+
+grpc_error_handle InitChannelElem(grpc_channel_element* /*elem*/,
+                                  grpc_channel_element_args* /*args*/) {
+  return GRPC_ERROR_NONE;
+}
+
+void DestroyChannelElem(grpc_channel_element* /*elem*/) {}
+
+void GetChannelInfo(grpc_channel_element* elem,
+                    const grpc_channel_info* channel_info) {
+  grpc_channel_next_get_info(elem, channel_info);
+}
+
+static const grpc_channel_filter passthrough_filter = {
+    grpc_call_next_op,      nullptr,
+    StartTransportOp,       0,
+    InitCallElem,           SetPollsetOrPollsetSet,
+    DestroyCallElem,        0,
+    InitChannelElem,        DestroyChannelElem,
+    GetChannelInfo,         "passthrough_filter"};
+
+}  // namespace passthrough_filter
+
 class IsolatedCallFixture : public TrackCounters {
  public:
-  IsolatedCallFixture() {
+  explicit IsolatedCallFixture(int arena_pool_size = 0,
+                               int num_passthrough_filters = 0) {
     // We are calling grpc_channel_stack_builder_create() instead of
     // grpc_channel_create() here, which means we're not getting the
     // grpc_init() called by grpc_channel_create(), but we are getting
     // the grpc_shutdown() run by grpc_channel_destroy().  So we need to
     // call grpc_init() manually here to balance things out.
     grpc_init();
+    grpc_arg arena_pool_arg = ArenaPoolArg(arena_pool_size);
+    grpc_channel_args input_args = {1, &arena_pool_arg};
     const grpc_channel_args* args = grpc_core::CoreConfiguration::Get()
                                         .channel_args_preconditioning()
-                                        .PreconditionChannelArgs(nullptr);
+                                        .PreconditionChannelArgs(&input_args);
     grpc_core::ChannelStackBuilder builder("phony");
     builder.SetTarget("phony_target");
     builder.SetChannelArgs(args);
+    for (int i = 0; i < num_passthrough_filters; ++i) {
+      builder.AppendFilter(&passthrough_filter::passthrough_filter, nullptr);
+    }
     builder.AppendFilter(&isolated_call_filter::isolated_call_filter, nullptr);
     {
       grpc_core::ExecCtx exec_ctx;
@@ -750,8 +817,9 @@ class IsolatedCallFixture : public TrackCounters {
   grpc_channel* channel_;
 };
 
+// Arg is the size of the channel's call arena pool (0 disables recycling).
 static void BM_IsolatedCall_NoOp(benchmark::State& state) {
-  IsolatedCallFixture fixture;
+  IsolatedCallFixture fixture(state.range(0));
   gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
   void* method_hdl = grpc_channel_register_call(fixture.channel(), "/foo/bar",
                                                 nullptr, nullptr);
@@ -763,10 +831,11 @@ static void BM_IsolatedCall_NoOp(benchmark::State& state) {
   }
   fixture.Finish(state);
 }
-BENCHMARK(BM_IsolatedCall_NoOp);
+BENCHMARK(BM_IsolatedCall_NoOp)->Arg(0)->Arg(64);
 
+// Arg is the number of pass-through filters stacked above the call filter.
 static void BM_IsolatedCall_Unary(benchmark::State& state) {
-  IsolatedCallFixture fixture;
+  IsolatedCallFixture fixture(0, state.range(0));
   gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
   void* method_hdl = grpc_channel_register_call(fixture.channel(), "/foo/bar",
                                                 nullptr, nullptr);
@@ -809,7 +878,7 @@ static void BM_IsolatedCall_Unary(benchmark::State& state) {
   grpc_metadata_array_destroy(&recv_trailing_metadata);
   grpc_byte_buffer_destroy(send_message);
 }
-BENCHMARK(BM_IsolatedCall_Unary);
+BENCHMARK(BM_IsolatedCall_Unary)->Arg(0)->Arg(4);
 
 static void BM_IsolatedCall_StreamingSend(benchmark::State& state) {
   IsolatedCallFixture fixture;
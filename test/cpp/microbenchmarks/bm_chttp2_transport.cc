@@ -672,6 +672,118 @@ static void BM_TransportStreamRecv(benchmark::State& state) {
 }
 BENCHMARK(BM_TransportStreamRecv)->Range(0, 128 * 1024 * 1024);
 
+// Like BM_TransportStreamRecv, but every frame of the message has already
+// been read off the wire when recv_message is started, as happens for a
+// streaming peer that runs ahead of the application.
+static void BM_TransportStreamRecvBuffered(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  Fixture f(grpc::ChannelArguments(), true);
+  auto* s = new Stream(&f);
+  s->Init(state);
+  grpc_transport_stream_op_batch_payload op_payload(nullptr);
+  grpc_transport_stream_op_batch op;
+  grpc_core::OrphanablePtr<grpc_core::ByteStream> recv_stream;
+  grpc_slice incoming_data = CreateIncomingDataSlice(state.range(0), 16384);
+
+  auto reset_op = [&]() {
+    op = {};
+    op.payload = &op_payload;
+  };
+
+  auto arena = grpc_core::MakeScopedArena(1024, g_memory_allocator);
+  grpc_metadata_batch b(arena.get());
+  RepresentativeClientInitialMetadata::Prepare(&b);
+
+  // Each closure may only be pending once at a time.
+  std::unique_ptr<TestClosure> do_nothing =
+      MakeTestClosure([](grpc_error_handle /*error*/) {});
+  std::unique_ptr<TestClosure> recv_initial_metadata_ready =
+      MakeTestClosure([](grpc_error_handle /*error*/) {});
+  std::unique_ptr<TestClosure> recv_message_ready =
+      MakeTestClosure([](grpc_error_handle /*error*/) {});
+  std::unique_ptr<TestClosure> next_ready =
+      MakeTestClosure([](grpc_error_handle /*error*/) {});
+
+  reset_op();
+  auto b_recv = absl::make_unique<grpc_metadata_batch>(arena.get());
+  op.send_initial_metadata = true;
+  op.payload->send_initial_metadata.send_initial_metadata = &b;
+  op.recv_initial_metadata = true;
+  op.payload->recv_initial_metadata.recv_initial_metadata = b_recv.get();
+  op.payload->recv_initial_metadata.recv_initial_metadata_ready =
+      recv_initial_metadata_ready.get();
+  op.on_complete = do_nothing.get();
+  s->Op(&op);
+  f.PushInput(SLICE_FROM_BUFFER(
+      "\x00\x00\x00\x04\x00\x00\x00\x00\x00"
+      // Generated using:
+      // tools/codegen/core/gen_header_frame.py <
+      // test/cpp/microbenchmarks/representative_server_initial_metadata.headers
+      "\x00\x00X\x01\x04\x00\x00\x00\x01"
+      "\x10\x07:status\x03"
+      "200"
+      "\x10\x0c"
+      "content-type\x10"
+      "application/grpc"
+      "\x10\x14grpc-accept-encoding\x15identity,deflate,gzip"));
+  f.FlushExecCtx();
+
+  grpc_slice recv_slice;
+  while (state.KeepRunning()) {
+    // force outgoing window to be yuge
+    s->chttp2_stream()->flow_control->TestOnlyForceHugeWindow();
+    f.chttp2_transport()->flow_control->TestOnlyForceHugeWindow();
+    f.PushInput(grpc_slice_ref(incoming_data));
+    f.FlushExecCtx();
+    reset_op();
+    op.on_complete = do_nothing.get();
+    op.recv_message = true;
+    op.payload->recv_message.recv_message = &recv_stream;
+    op.payload->recv_message.call_failed_before_recv_message = nullptr;
+    op.payload->recv_message.recv_message_ready = recv_message_ready.get();
+    s->Op(&op);
+    f.FlushExecCtx();
+    GPR_ASSERT(recv_stream != nullptr);
+    uint32_t received = 0;
+    while (received < recv_stream->length()) {
+      if (!recv_stream->Next(recv_stream->length() - received,
+                             next_ready.get())) {
+        f.FlushExecCtx();
+      }
+      GPR_ASSERT(GRPC_LOG_IF_ERROR("Pull", recv_stream->Pull(&recv_slice)));
+      received += GRPC_SLICE_LENGTH(recv_slice);
+      grpc_slice_unref_internal(recv_slice);
+    }
+    recv_stream.reset();
+    f.FlushExecCtx();
+  }
+
+  reset_op();
+  op.cancel_stream = true;
+  op.payload->cancel_stream.cancel_error = GRPC_ERROR_CANCELLED;
+  gpr_event* stream_cancel_done = new gpr_event;
+  gpr_event_init(stream_cancel_done);
+  std::unique_ptr<TestClosure> stream_cancel_closure =
+      MakeTestClosure([&](grpc_error_handle error) {
+        GPR_ASSERT(error == GRPC_ERROR_NONE);
+        gpr_event_set(stream_cancel_done, reinterpret_cast<void*>(1));
+      });
+  op.on_complete = stream_cancel_closure.get();
+  s->Op(&op);
+  f.FlushExecCtx();
+  gpr_event_wait(stream_cancel_done, gpr_inf_future(GPR_CLOCK_REALTIME));
+  done_events.emplace_back(stream_cancel_done);
+  s->DestroyThen(MakeOnceClosure([s, &b_recv](grpc_error_handle /*error*/) {
+    b_recv.reset();
+    delete s;
+  }));
+  f.FlushExecCtx();
+  track_counters.Finish(state);
+  grpc_slice_unref(incoming_data);
+}
+BENCHMARK(BM_TransportStreamRecvBuffered)->Range(0, 16 * 1024 * 1024);
+
 // Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
 // and others do not. This allows us to support both modes.
 namespace benchmark {
@@ -0,0 +1,72 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark unary ping-pong over TCP with blocking completion queue polls and
+   with busy polling (GRPC_POLL_BUSY_SPIN_US) */
+
+#include "src/core/lib/iomgr/iomgr.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/fullstack_unary_ping_pong.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+/*******************************************************************************
+ * CONFIGURATIONS
+ */
+
+// TCP, with completion queue waits busy-polling for up to kSpinUs
+// microseconds before blocking.  Sockets and the epoll set keep the busy
+// polling setting the process started with.
+template <int kSpinUs>
+class BusyPollTCP : public TCP {
+ public:
+  explicit BusyPollTCP(Service* service) : TCP(service) {
+    grpc_iomgr_set_busy_poll_spin_us_for_testing(kSpinUs);
+  }
+
+  ~BusyPollTCP() override { grpc_iomgr_set_busy_poll_spin_us_for_testing(0); }
+};
+
+BENCHMARK_TEMPLATE(BM_UnaryPingPong, TCP, NoOpMutator, NoOpMutator)
+    ->Args({0, 0});
+BENCHMARK_TEMPLATE(BM_UnaryPingPong, BusyPollTCP<10>, NoOpMutator,
+                   NoOpMutator)
+    ->Args({0, 0});
+BENCHMARK_TEMPLATE(BM_UnaryPingPong, BusyPollTCP<50>, NoOpMutator,
+                   NoOpMutator)
+    ->Args({0, 0});
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark posix TCP endpoint reads with each read buffer strategy: slices
+   sized from the endpoint's running estimate and allocated per read
+   ("alloc"), or fixed-size slabs recycled through the read buffer pool
+   ("pool"). */
+
+#include <benchmark/benchmark.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_POSIX_SOCKET_TCP
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/tcp_posix.h"
+#include "src/core/lib/resource_quota/api.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace {
+
+// Streams bytes through a socketpair into a posix TCP endpoint from a
+// writer thread, until the fixture is destroyed.
+class TcpReadFixture {
+ public:
+  TcpReadFixture(size_t msg_size, bool use_read_buffer_pool)
+      : msg_size_(msg_size) {
+    int sv[2];
+    GPR_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    write_fd_ = sv[0];
+    // Only the endpoint side is non-blocking; the writer blocks on a full
+    // socket buffer.
+    int flags = fcntl(sv[1], F_GETFL, 0);
+    GPR_ASSERT(fcntl(sv[1], F_SETFL, flags | O_NONBLOCK) == 0);
+    grpc_core::ExecCtx exec_ctx;
+    pollset_ = static_cast<grpc_pollset*>(gpr_zalloc(grpc_pollset_size()));
+    grpc_pollset_init(pollset_, &mu_);
+    grpc_resource_quota* resource_quota =
+        grpc_resource_quota_create("bm_tcp_read_buffer");
+    grpc_arg args[] = {
+        grpc_channel_arg_pointer_create(
+            const_cast<char*>(GRPC_ARG_RESOURCE_QUOTA), resource_quota,
+            grpc_resource_quota_arg_vtable()),
+        grpc_channel_arg_integer_create(
+            const_cast<char*>(GRPC_ARG_TCP_READ_BUFFER_POOL),
+            use_read_buffer_pool),
+    };
+    grpc_channel_args channel_args = {GPR_ARRAY_SIZE(args), args};
+    ep_ = grpc_tcp_create(grpc_fd_create(sv[1], "bm_tcp_read_buffer", false),
+                          &channel_args, "bm_tcp_read_buffer");
+    grpc_resource_quota_unref(resource_quota);
+    grpc_endpoint_add_to_pollset(ep_, pollset_);
+    grpc_slice_buffer_init(&incoming_);
+    GRPC_CLOSURE_INIT(&read_cb_, OnRead, this, grpc_schedule_on_exec_ctx);
+    writer_ = grpc_core::Thread("bm_tcp_read_buffer_writer", Write, this);
+    writer_.Start();
+  }
+
+  ~TcpReadFixture() {
+    // Fails the writer's pending and next writes.
+    shutdown(write_fd_, SHUT_RDWR);
+    writer_.Join();
+    close(write_fd_);
+    grpc_core::ExecCtx exec_ctx;
+    grpc_slice_buffer_destroy_internal(&incoming_);
+    grpc_endpoint_destroy(ep_);
+    grpc_closure destroyed;
+    GRPC_CLOSURE_INIT(&destroyed, DestroyPollset, pollset_,
+                      grpc_schedule_on_exec_ctx);
+    grpc_pollset_shutdown(pollset_, &destroyed);
+    grpc_core::ExecCtx::Get()->Flush();
+    gpr_free(pollset_);
+  }
+
+  // Reads until at least another message's worth of bytes has arrived.
+  void ReadMessage() {
+    target_read_bytes_ += msg_size_;
+    while (read_bytes_ < target_read_bytes_) ReadOnce();
+  }
+
+  size_t read_bytes() const { return read_bytes_; }
+  size_t num_reads() const { return num_reads_; }
+
+ private:
+  static void Write(void* arg) {
+    TcpReadFixture* self = static_cast<TcpReadFixture*>(arg);
+    char* buf = static_cast<char*>(gpr_malloc(self->msg_size_));
+    memset(buf, 'x', self->msg_size_);
+    for (;;) {
+      size_t written = 0;
+      while (written < self->msg_size_) {
+        ssize_t n = send(self->write_fd_, buf + written,
+                         self->msg_size_ - written, MSG_NOSIGNAL);
+        if (n < 0) {
+          if (errno == EINTR) continue;
+          gpr_free(buf);
+          return;
+        }
+        written += static_cast<size_t>(n);
+      }
+    }
+  }
+
+  void ReadOnce() {
+    grpc_core::ExecCtx exec_ctx;
+    grpc_slice_buffer_reset_and_unref_internal(&incoming_);
+    read_done_ = false;
+    grpc_endpoint_read(ep_, &incoming_, &read_cb_, /*urgent=*/false);
+    grpc_core::ExecCtx::Get()->Flush();
+    gpr_mu_lock(mu_);
+    while (!read_done_) {
+      grpc_pollset_worker* worker = nullptr;
+      GPR_ASSERT(GRPC_LOG_IF_ERROR(
+          "pollset_work",
+          grpc_pollset_work(pollset_, &worker, GRPC_MILLIS_INF_FUTURE)));
+      gpr_mu_unlock(mu_);
+      grpc_core::ExecCtx::Get()->Flush();
+      gpr_mu_lock(mu_);
+    }
+    gpr_mu_unlock(mu_);
+  }
+
+  static void OnRead(void* arg, grpc_error_handle error) {
+    TcpReadFixture* self = static_cast<TcpReadFixture*>(arg);
+    GPR_ASSERT(error == GRPC_ERROR_NONE);
+    gpr_mu_lock(self->mu_);
+    self->read_bytes_ += self->incoming_.length;
+    ++self->num_reads_;
+    self->read_done_ = true;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR("kick",
+                                 grpc_pollset_kick(self->pollset_, nullptr)));
+    gpr_mu_unlock(self->mu_);
+  }
+
+  static void DestroyPollset(void* p, grpc_error_handle /*error*/) {
+    grpc_pollset_destroy(static_cast<grpc_pollset*>(p));
+  }
+
+  const size_t msg_size_;
+  int write_fd_;
+  gpr_mu* mu_;
+  grpc_pollset* pollset_;
+  grpc_endpoint* ep_;
+  grpc_slice_buffer incoming_;
+  grpc_closure read_cb_;
+  grpc_core::Thread writer_;
+  bool read_done_ = false;
+  size_t read_bytes_ = 0;
+  size_t target_read_bytes_ = 0;
+  size_t num_reads_ = 0;
+};
+
+void BM_TcpRead(benchmark::State& state) {
+  TrackCounters track_counters;
+  const size_t msg_size = state.range(0);
+  const bool use_read_buffer_pool = state.range(1) != 0;
+  size_t read_bytes;
+  size_t num_reads;
+  {
+    TcpReadFixture fixture(msg_size, use_read_buffer_pool);
+    for (auto _ : state) {
+      fixture.ReadMessage();
+    }
+    read_bytes = fixture.read_bytes();
+    num_reads = fixture.num_reads();
+  }
+  state.SetBytesProcessed(state.iterations() * msg_size);
+  std::ostringstream label;
+  label << (use_read_buffer_pool ? "pool" : "alloc") << " bytes/read:"
+        << static_cast<double>(read_bytes) / static_cast<double>(num_reads);
+  track_counters.AddLabel(label.str());
+  track_counters.Finish(state);
+}
+
+void TcpReadArgs(benchmark::internal::Benchmark* b) {
+  for (int msg_size : {64, 1024, 16 * 1024, 256 * 1024, 1024 * 1024}) {
+    for (int use_read_buffer_pool : {0, 1}) {
+      b->Args({msg_size, use_read_buffer_pool});
+    }
+  }
+}
+BENCHMARK(BM_TcpRead)->Apply(TcpReadArgs)->UseRealTime();
+
+}  // namespace
+
+#endif /* GRPC_POSIX_SOCKET_TCP */
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,483 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmark how long an XdsClient watching a large synthetic set of EDS
+// resources takes to apply a push that changes only a few of them, over
+// state-of-the-world ADS and over delta ADS.
+
+#include <benchmark/benchmark.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "envoy/config/core/v3/address.upb.h"
+#include "envoy/config/core/v3/base.upb.h"
+#include "envoy/config/endpoint/v3/endpoint.upb.h"
+#include "envoy/config/endpoint/v3/endpoint_components.upb.h"
+#include "envoy/service/discovery/v3/discovery.upb.h"
+#include "google/protobuf/any.upb.h"
+#include "google/protobuf/wrappers.upb.h"
+#include "upb/upb.hpp"
+
+#include <grpc/byte_buffer_reader.h>
+#include <grpc/grpc.h>
+#include <grpc/grpc_security.h>
+#include <grpc/support/log.h>
+
+#include "src/core/ext/xds/upb_utils.h"
+#include "src/core/ext/xds/xds_bootstrap.h"
+#include "src/core/ext/xds/xds_client.h"
+#include "src/core/ext/xds/xds_endpoint.h"
+#include "src/core/lib/gpr/env.h"
+#include "src/core/lib/gprpp/host_port.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+constexpr char kEdsTypeUrl[] =
+    "type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment";
+
+std::string ResourceName(int index) { return absl::StrCat("cluster_", index); }
+
+// Returns resource \a index at \a version; its port changes with the version.
+std::string SerializeClusterLoadAssignment(int index, int version) {
+  upb::Arena arena;
+  std::string name = ResourceName(index);
+  auto* cla = envoy_config_endpoint_v3_ClusterLoadAssignment_new(arena.ptr());
+  envoy_config_endpoint_v3_ClusterLoadAssignment_set_cluster_name(
+      cla, StdStringToUpbString(name));
+  auto* endpoints =
+      envoy_config_endpoint_v3_ClusterLoadAssignment_add_endpoints(cla,
+                                                                   arena.ptr());
+  auto* locality =
+      envoy_config_endpoint_v3_LocalityLbEndpoints_mutable_locality(
+          endpoints, arena.ptr());
+  envoy_config_core_v3_Locality_set_region(locality,
+                                           upb_strview_makez("region"));
+  google_protobuf_UInt32Value_set_value(
+      envoy_config_endpoint_v3_LocalityLbEndpoints_mutable_load_balancing_weight(
+          endpoints, arena.ptr()),
+      1);
+  auto* lb_endpoint =
+      envoy_config_endpoint_v3_LocalityLbEndpoints_add_lb_endpoints(
+          endpoints, arena.ptr());
+  auto* endpoint = envoy_config_endpoint_v3_LbEndpoint_mutable_endpoint(
+      lb_endpoint, arena.ptr());
+  auto* address =
+      envoy_config_endpoint_v3_Endpoint_mutable_address(endpoint, arena.ptr());
+  auto* socket_address =
+      envoy_config_core_v3_Address_mutable_socket_address(address, arena.ptr());
+  envoy_config_core_v3_SocketAddress_set_address(
+      socket_address, upb_strview_makez("127.0.0.1"));
+  envoy_config_core_v3_SocketAddress_set_port_value(socket_address,
+                                                    1000 + version);
+  size_t length;
+  char* bytes = envoy_config_endpoint_v3_ClusterLoadAssignment_serialize(
+      cla, arena.ptr(), &length);
+  return std::string(bytes, length);
+}
+
+// Serves the ADS call of a single XdsClient.  Responses are built and sent
+// from the benchmark thread; requests are received on a thread of its own.
+class FakeControlPlane {
+ public:
+  FakeControlPlane(bool delta, int num_resources)
+      : delta_(delta),
+        num_resources_(num_resources),
+        port_(grpc_pick_unused_port_or_die()),
+        cq_(grpc_completion_queue_create_for_next(nullptr)),
+        server_(grpc_server_create(nullptr, nullptr)),
+        resources_(num_resources) {
+    grpc_metadata_array_init(&request_metadata_);
+    grpc_call_details_init(&call_details_);
+    grpc_server_register_completion_queue(server_, cq_, nullptr);
+    grpc_server_credentials* creds = grpc_insecure_server_credentials_create();
+    GPR_ASSERT(grpc_server_add_http2_port(
+        server_, JoinHostPort("localhost", port_).c_str(), creds));
+    grpc_server_credentials_release(creds);
+    grpc_server_start(server_);
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(server_, &call_, &call_details_,
+                                        &request_metadata_, cq_, cq_,
+                                        Tag(kNewCall)));
+    thread_ = Thread("fake_control_plane", &Serve, this);
+    thread_.Start();
+  }
+
+  ~FakeControlPlane() {
+    grpc_server_shutdown_and_notify(server_, cq_, Tag(kShutdown));
+    grpc_server_cancel_all_calls(server_);
+    thread_.Join();
+    if (call_ != nullptr) grpc_call_unref(call_);
+    grpc_server_destroy(server_);
+    grpc_completion_queue_destroy(cq_);
+    grpc_metadata_array_destroy(&request_metadata_);
+    grpc_call_details_destroy(&call_details_);
+    grpc_byte_buffer_destroy(recv_payload_);
+  }
+
+  int port() const { return port_; }
+
+  void WaitForSubscriptions() {
+    MutexLock lock(&mu_);
+    while (static_cast<int>(subscribed_.size()) < num_resources_) {
+      cv_.Wait(&mu_);
+    }
+  }
+
+  // Moves resources [first, first + count) to \a version and returns the
+  // response announcing it.
+  grpc_slice BuildResponse(int first, int count, int version) {
+    std::vector<int> changed;
+    // Storage for the names referenced by the response.
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i) {
+      int index = (first + i) % num_resources_;
+      resources_[index] = SerializeClusterLoadAssignment(index, version);
+      changed.push_back(index);
+      names.push_back(ResourceName(index));
+    }
+    std::string version_str = absl::StrCat(version);
+    upb::Arena arena;
+    size_t length;
+    char* bytes;
+    if (delta_) {
+      auto* response =
+          envoy_service_discovery_v3_DeltaDiscoveryResponse_new(arena.ptr());
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_set_system_version_info(
+          response, StdStringToUpbString(version_str));
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_set_type_url(
+          response, upb_strview_makez(kEdsTypeUrl));
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_set_nonce(
+          response, StdStringToUpbString(version_str));
+      for (size_t i = 0; i < changed.size(); ++i) {
+        auto* resource =
+            envoy_service_discovery_v3_DeltaDiscoveryResponse_add_resources(
+                response, arena.ptr());
+        envoy_service_discovery_v3_Resource_set_name(
+            resource, StdStringToUpbString(names[i]));
+        envoy_service_discovery_v3_Resource_set_version(
+            resource, StdStringToUpbString(version_str));
+        SetAny(envoy_service_discovery_v3_Resource_mutable_resource(
+                   resource, arena.ptr()),
+               resources_[changed[i]]);
+      }
+      bytes = envoy_service_discovery_v3_DeltaDiscoveryResponse_serialize(
+          response, arena.ptr(), &length);
+    } else {
+      // A state-of-the-world response repeats every resource.
+      auto* response =
+          envoy_service_discovery_v3_DiscoveryResponse_new(arena.ptr());
+      envoy_service_discovery_v3_DiscoveryResponse_set_version_info(
+          response, StdStringToUpbString(version_str));
+      envoy_service_discovery_v3_DiscoveryResponse_set_type_url(
+          response, upb_strview_makez(kEdsTypeUrl));
+      envoy_service_discovery_v3_DiscoveryResponse_set_nonce(
+          response, StdStringToUpbString(version_str));
+      for (const std::string& resource : resources_) {
+        SetAny(envoy_service_discovery_v3_DiscoveryResponse_add_resources(
+                   response, arena.ptr()),
+               resource);
+      }
+      bytes = envoy_service_discovery_v3_DiscoveryResponse_serialize(
+          response, arena.ptr(), &length);
+    }
+    return grpc_slice_from_copied_buffer(bytes, length);
+  }
+
+  // Sends a response built by BuildResponse(); takes ownership of it.
+  void Send(grpc_slice response) {
+    grpc_byte_buffer* payload = grpc_raw_byte_buffer_create(&response, 1);
+    grpc_slice_unref(response);
+    grpc_op op;
+    memset(&op, 0, sizeof(op));
+    op.op = GRPC_OP_SEND_MESSAGE;
+    op.data.send_message.send_message = payload;
+    {
+      MutexLock lock(&mu_);
+      send_done_ = false;
+    }
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(call_, &op, 1, Tag(kSend), nullptr));
+    {
+      MutexLock lock(&mu_);
+      while (!send_done_) cv_.Wait(&mu_);
+    }
+    grpc_byte_buffer_destroy(payload);
+  }
+
+ private:
+  enum TagType { kNewCall = 1, kRecv, kSend, kShutdown };
+
+  static void* Tag(TagType type) {
+    return reinterpret_cast<void*>(static_cast<intptr_t>(type));
+  }
+
+  static void SetAny(google_protobuf_Any* any, const std::string& value) {
+    google_protobuf_Any_set_type_url(any, upb_strview_makez(kEdsTypeUrl));
+    google_protobuf_Any_set_value(any, StdStringToUpbString(value));
+  }
+
+  static void Serve(void* arg) {
+    static_cast<FakeControlPlane*>(arg)->Serve();
+  }
+
+  void Serve() {
+    while (true) {
+      grpc_event ev = grpc_completion_queue_next(
+          cq_, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr);
+      if (ev.type == GRPC_QUEUE_SHUTDOWN) return;
+      GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+      switch (static_cast<TagType>(reinterpret_cast<intptr_t>(ev.tag))) {
+        case kNewCall: {
+          if (!ev.success) break;
+          grpc_op ops[2];
+          memset(ops, 0, sizeof(ops));
+          ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+          ops[1].op = GRPC_OP_RECV_MESSAGE;
+          ops[1].data.recv_message.recv_message = &recv_payload_;
+          GPR_ASSERT(GRPC_CALL_OK ==
+                     grpc_call_start_batch(call_, ops, 2, Tag(kRecv), nullptr));
+          break;
+        }
+        case kRecv: {
+          if (!ev.success || recv_payload_ == nullptr) break;
+          OnRequest();
+          grpc_op op;
+          memset(&op, 0, sizeof(op));
+          op.op = GRPC_OP_RECV_MESSAGE;
+          op.data.recv_message.recv_message = &recv_payload_;
+          GPR_ASSERT(GRPC_CALL_OK ==
+                     grpc_call_start_batch(call_, &op, 1, Tag(kRecv), nullptr));
+          break;
+        }
+        case kSend: {
+          MutexLock lock(&mu_);
+          send_done_ = true;
+          cv_.SignalAll();
+          break;
+        }
+        case kShutdown:
+          grpc_completion_queue_shutdown(cq_);
+          break;
+      }
+    }
+  }
+
+  // Tracks the resources the client subscribed to.
+  void OnRequest() {
+    grpc_byte_buffer_reader reader;
+    GPR_ASSERT(grpc_byte_buffer_reader_init(&reader, recv_payload_));
+    grpc_slice request = grpc_byte_buffer_reader_readall(&reader);
+    grpc_byte_buffer_reader_destroy(&reader);
+    grpc_byte_buffer_destroy(recv_payload_);
+    recv_payload_ = nullptr;
+    const char* buf =
+        reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(request));
+    size_t buf_len = GRPC_SLICE_LENGTH(request);
+    upb::Arena arena;
+    MutexLock lock(&mu_);
+    if (delta_) {
+      auto* msg = envoy_service_discovery_v3_DeltaDiscoveryRequest_parse(
+          buf, buf_len, arena.ptr());
+      GPR_ASSERT(msg != nullptr);
+      size_t size;
+      const upb_strview* names =
+          envoy_service_discovery_v3_DeltaDiscoveryRequest_resource_names_subscribe(
+              msg, &size);
+      for (size_t i = 0; i < size; ++i) {
+        subscribed_.insert(UpbStringToStdString(names[i]));
+      }
+      names =
+          envoy_service_discovery_v3_DeltaDiscoveryRequest_resource_names_unsubscribe(
+              msg, &size);
+      for (size_t i = 0; i < size; ++i) {
+        subscribed_.erase(UpbStringToStdString(names[i]));
+      }
+    } else {
+      auto* msg = envoy_service_discovery_v3_DiscoveryRequest_parse(
+          buf, buf_len, arena.ptr());
+      GPR_ASSERT(msg != nullptr);
+      size_t size;
+      const upb_strview* names =
+          envoy_service_discovery_v3_DiscoveryRequest_resource_names(msg,
+                                                                     &size);
+      subscribed_.clear();
+      for (size_t i = 0; i < size; ++i) {
+        subscribed_.insert(UpbStringToStdString(names[i]));
+      }
+    }
+    grpc_slice_unref(request);
+    cv_.SignalAll();
+  }
+
+  const bool delta_;
+  const int num_resources_;
+  const int port_;
+  grpc_completion_queue* cq_;
+  grpc_server* server_;
+  Thread thread_;
+
+  grpc_call* call_ = nullptr;
+  grpc_call_details call_details_;
+  grpc_metadata_array request_metadata_;
+  grpc_byte_buffer* recv_payload_ = nullptr;
+
+  // Serialized resources, at their current version.
+  std::vector<std::string> resources_;
+
+  Mutex mu_;
+  CondVar cv_;
+  std::set<std::string> subscribed_ ABSL_GUARDED_BY(mu_);
+  bool send_done_ ABSL_GUARDED_BY(mu_) = false;
+};
+
+// Counts the updates delivered to all watchers.
+class UpdateCounter {
+ public:
+  void Increment() {
+    MutexLock lock(&mu_);
+    ++count_;
+    cv_.SignalAll();
+  }
+
+  void WaitFor(int count) {
+    MutexLock lock(&mu_);
+    while (count_ < count) cv_.Wait(&mu_);
+  }
+
+ private:
+  Mutex mu_;
+  CondVar cv_;
+  int count_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+class Watcher : public XdsEndpointResourceType::WatcherInterface {
+ public:
+  explicit Watcher(UpdateCounter* counter) : counter_(counter) {}
+
+  void OnResourceChanged(XdsEndpointResource /*update*/) override {
+    counter_->Increment();
+  }
+  void OnError(grpc_error_handle error) override { GRPC_ERROR_UNREF(error); }
+  void OnResourceDoesNotExist() override {}
+
+ private:
+  UpdateCounter* counter_;
+};
+
+// Args: whether to use delta ADS, the number of resources watched, and the
+// number of resources each push changes.  Each iteration is one push, timed
+// until the client has delivered all of its updates to the watchers.
+void BM_XdsPush(benchmark::State& state) {
+  TrackCounters track_counters;
+  const bool delta = state.range(0) != 0;
+  const int num_resources = state.range(1);
+  const int num_changed = state.range(2);
+  FakeControlPlane control_plane(delta, num_resources);
+  std::string bootstrap = absl::StrFormat(
+      "{"
+      "  \"xds_servers\": [{"
+      "    \"server_uri\": \"%s\","
+      "    \"channel_creds\": [{\"type\": \"insecure\"}],"
+      "    \"server_features\": [\"xds_v3\"%s]"
+      "  }],"
+      "  \"node\": {\"id\": \"bm_xds_delta\"}"
+      "}",
+      JoinHostPort("localhost", control_plane.port()),
+      delta ? ", \"xds_delta\"" : "");
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto xds_bootstrap = XdsBootstrap::Create(bootstrap, &error);
+  GPR_ASSERT(error == GRPC_ERROR_NONE);
+  RefCountedPtr<XdsClient> xds_client;
+  UpdateCounter counter;
+  std::vector<Watcher*> watchers;
+  {
+    ExecCtx exec_ctx;
+    xds_client = MakeRefCounted<XdsClient>(std::move(xds_bootstrap), nullptr);
+    for (int i = 0; i < num_resources; ++i) {
+      auto watcher = MakeRefCounted<Watcher>(&counter);
+      watchers.push_back(watcher.get());
+      XdsEndpointResourceType::StartWatch(xds_client.get(), ResourceName(i),
+                                          std::move(watcher));
+    }
+  }
+  control_plane.WaitForSubscriptions();
+  control_plane.Send(control_plane.BuildResponse(0, num_resources, 1));
+  int expected_updates = num_resources;
+  counter.WaitFor(expected_updates);
+  int version = 1;
+  for (auto _ : state) {
+    // Building the response is the control plane's work, not the client's.
+    state.PauseTiming();
+    grpc_slice response = control_plane.BuildResponse(
+        (version - 1) * num_changed, num_changed, version + 1);
+    ++version;
+    state.ResumeTiming();
+    control_plane.Send(response);
+    expected_updates += num_changed;
+    counter.WaitFor(expected_updates);
+  }
+  {
+    ExecCtx exec_ctx;
+    for (int i = 0; i < num_resources; ++i) {
+      XdsEndpointResourceType::CancelWatch(xds_client.get(), ResourceName(i),
+                                           watchers[i]);
+    }
+    xds_client.reset();
+  }
+  track_counters.Finish(state);
+}
+
+void XdsPushArgs(benchmark::internal::Benchmark* b) {
+  for (int delta : {0, 1}) {
+    for (int num_resources : {1000, 10000}) {
+      b->Args({delta, num_resources, 100});
+    }
+  }
+}
+BENCHMARK(BM_XdsPush)->Apply(XdsPushArgs)->UseRealTime();
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  // Nothing but the backup poller polls the XdsClient's channel here.
+  gpr_setenv("GRPC_CLIENT_CHANNEL_BACKUP_POLL_INTERVAL_MS", "1");
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,205 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmark matching requests against large synthetic route tables and
+// virtual host lists, with the linear search and with the compiled lists the
+// config selectors use.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/support/log.h>
+
+#include "src/core/ext/xds/xds_routing.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+auto* g_memory_allocator = new MemoryAllocator(
+    ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator(
+        "bm_xds_routing"));
+
+class RouteList : public XdsRouting::RouteListIterator {
+ public:
+  void Add(StringMatcher::Type type, absl::string_view path) {
+    auto path_matcher = StringMatcher::Create(type, path);
+    GPR_ASSERT(path_matcher.ok());
+    routes_.emplace_back();
+    routes_.back().path_matcher = std::move(*path_matcher);
+  }
+
+  size_t Size() const override { return routes_.size(); }
+
+  const XdsRouteConfigResource::Route::Matchers& GetMatchersForRoute(
+      size_t index) const override {
+    return routes_[index];
+  }
+
+ private:
+  std::vector<XdsRouteConfigResource::Route::Matchers> routes_;
+};
+
+class VirtualHostList : public XdsRouting::VirtualHostListIterator {
+ public:
+  void Add(std::vector<std::string> domains) {
+    domains_.push_back(std::move(domains));
+  }
+
+  size_t Size() const override { return domains_.size(); }
+
+  const std::vector<std::string>& GetDomainsForVirtualHost(
+      size_t index) const override {
+    return domains_[index];
+  }
+
+ private:
+  std::vector<std::vector<std::string>> domains_;
+};
+
+// About \a num_routes routes, and request paths that hit each kind of route.
+// Each service gets a route per method, then a prefix route, and every tenth
+// service a regex route; a catch-all prefix route comes last.
+struct RouteTable {
+  explicit RouteTable(int num_routes) {
+    const int kMethodsPerService = 8;
+    for (int service = 0; static_cast<int>(routes.Size()) < num_routes - 1;
+         ++service) {
+      std::string service_prefix = absl::StrCat("/pkg.Service", service, "/");
+      for (int method = 0; method < kMethodsPerService; ++method) {
+        routes.Add(StringMatcher::Type::kExact,
+                   absl::StrCat(service_prefix, "Method", method));
+      }
+      routes.Add(StringMatcher::Type::kPrefix, service_prefix);
+      if (service % 10 == 0) {
+        routes.Add(StringMatcher::Type::kSafeRegex,
+                   absl::StrCat("/pkg\\.Regex", service, "/Method[0-9]+"));
+      }
+      paths.push_back(absl::StrCat(service_prefix, "Method",
+                                   service % kMethodsPerService));
+      paths.push_back(absl::StrCat(service_prefix, "Unlisted"));
+      paths.push_back(absl::StrCat("/pkg.Regex", service - service % 10,
+                                   "/Method", service));
+    }
+    routes.Add(StringMatcher::Type::kPrefix, "");
+  }
+
+  RouteList routes;
+  std::vector<std::string> paths;
+};
+
+// One exact domain per virtual host, plus a wildcard virtual host for every
+// hundred, and a catch-all virtual host last.
+struct VirtualHostTable {
+  explicit VirtualHostTable(int num_vhosts) {
+    for (int i = 0; i < num_vhosts; ++i) {
+      std::string domain = absl::StrCat("host", i, ".example.com");
+      vhosts.Add({domain});
+      if (i % 100 == 0) {
+        vhosts.Add({absl::StrCat("*.zone", i, ".example.com")});
+        domains.push_back(absl::StrCat("host.zone", i, ".example.com"));
+      }
+      domains.push_back(std::move(domain));
+    }
+    vhosts.Add({"*"});
+    domains.push_back("unknown.example.org");
+  }
+
+  VirtualHostList vhosts;
+  std::vector<std::string> domains;
+};
+
+static void BM_RouteLinear(benchmark::State& state) {
+  RouteTable table(state.range(0));
+  auto arena = MakeScopedArena(1024, g_memory_allocator);
+  grpc_metadata_batch initial_metadata(arena.get());
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(XdsRouting::GetRouteForRequest(
+        table.routes, table.paths[i++ % table.paths.size()],
+        &initial_metadata));
+  }
+}
+BENCHMARK(BM_RouteLinear)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_RouteCompiled(benchmark::State& state) {
+  RouteTable table(state.range(0));
+  XdsRouting::CompiledRouteList compiled(table.routes);
+  auto arena = MakeScopedArena(1024, g_memory_allocator);
+  grpc_metadata_batch initial_metadata(arena.get());
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compiled.GetRouteForRequest(
+        table.routes, table.paths[i++ % table.paths.size()],
+        &initial_metadata));
+  }
+}
+BENCHMARK(BM_RouteCompiled)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_CompileRouteList(benchmark::State& state) {
+  RouteTable table(state.range(0));
+  for (auto _ : state) {
+    XdsRouting::CompiledRouteList compiled(table.routes);
+    benchmark::DoNotOptimize(&compiled);
+  }
+}
+BENCHMARK(BM_CompileRouteList)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_VirtualHostLinear(benchmark::State& state) {
+  VirtualHostTable table(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(XdsRouting::FindVirtualHostForDomain(
+        table.vhosts, table.domains[i++ % table.domains.size()]));
+  }
+}
+BENCHMARK(BM_VirtualHostLinear)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_VirtualHostCompiled(benchmark::State& state) {
+  VirtualHostTable table(state.range(0));
+  XdsRouting::CompiledVirtualHostList compiled(table.vhosts);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compiled.FindVirtualHostForDomain(
+        table.domains[i++ % table.domains.size()]));
+  }
+}
+BENCHMARK(BM_VirtualHostCompiled)->RangeMultiplier(10)->Range(10, 1000);
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
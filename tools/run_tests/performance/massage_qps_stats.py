@@ -84,6 +84,9 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_tcp_backup_poller_polls"] = massage_qps_stats_helpers.counter(
                     core_stats, "tcp_backup_poller_polls")
+            stats[
+                "core_tcp_zerocopy_read_bytes"] = massage_qps_stats_helpers.counter(
+                    core_stats, "tcp_zerocopy_read_bytes")
             stats["core_http2_op_batches"] = massage_qps_stats_helpers.counter(
                 core_stats, "http2_op_batches")
             stats["core_http2_op_cancel"] = massage_qps_stats_helpers.counter(
@@ -321,6 +324,21 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_cq_ev_queue_transient_pop_failures"] = massage_qps_stats_helpers.counter(
                     core_stats, "cq_ev_queue_transient_pop_failures")
+            stats[
+                "core_message_compress_messages"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compress_messages")
+            stats[
+                "core_message_compress_skipped_messages"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compress_skipped_messages")
+            stats[
+                "core_message_compress_input_bytes"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compress_input_bytes")
+            stats[
+                "core_message_compress_saved_bytes"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compress_saved_bytes")
+            stats[
+                "core_message_compress_micros"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compress_micros")
             h = massage_qps_stats_helpers.histogram(core_stats,
                                                     "call_initial_size")
             stats["core_call_initial_size"] = ",".join(